@@ -6,12 +6,16 @@ License: GPL 2.0
 CI verification run: 2025-12-19T08:30 - Testing merged fixes from PRs #1847 and #1848
 */
 #include "ccextractor.h"
+#include "lib_ccx/ocr.h"
 #include <stdio.h>
 #include <locale.h>
 
 #ifdef _WIN32
 #include <windows.h>
 #include <shellapi.h>
+#else
+#include <sys/wait.h>
+#include <unistd.h>
 #endif
 volatile int terminate_asap = 0;
 
@@ -214,7 +218,10 @@ int start_ccx()
 				break;
 			case CCX_SM_RCWT:
 				mprint("\rAnalyzing data in CCExtractor's binary format\n");
-				tmp = rcwt_loop(ctx);
+				if (ccx_options.input_source == CCX_DS_TCP && ccx_options.tcp_senders > 1)
+					tmp = tcp_senders_loop(ctx);
+				else
+					tmp = rcwt_loop(ctx);
 				if (!ret)
 					ret = tmp;
 				break;
@@ -386,6 +393,9 @@ int start_ccx()
 
 		if (is_decoder_processed_enough(ctx) == CCX_TRUE)
 			break;
+		// A --multiprogram --jobs worker only decodes what the demuxer process sends it
+		if (ccx_options.program_worker >= 0)
+			break;
 	} // file loop
 	close_input_file(ctx);
 
@@ -412,12 +422,19 @@ int start_ccx()
 		mprint("\rone or more user-defined limits were reached.\n");
 	}
 
-#ifdef CURL
+	dinit_libraries(&ctx);
+#ifdef WITH_LIBCURL
+	curl_sink_close();
 	if (curl)
 		curl_easy_cleanup(curl);
 	curl_global_cleanup();
 #endif
-	dinit_libraries(&ctx);
+	print_output_write_stats();
+	ocr_cache_report();
+
+	// The demuxer process prints the summary for its workers
+	if (ccx_options.program_worker >= 0)
+		return ret ? EXIT_OK : EXIT_NO_CAPTIONS;
 
 	if (!ret)
 		mprint("\nNo captions were found in input.\n");
@@ -434,6 +451,113 @@ int start_ccx()
 	return ret ? EXIT_OK : EXIT_NO_CAPTIONS;
 }
 
+#ifndef _WIN32
+/* --jobs: every input file is extracted by its own child process, so the
+   per-file state that still lives in globals (ccx_options, tlt_config, the
+   timing counters) can't leak from one input into another. The parent only
+   keeps up to ccx_options.jobs children running and reports on them. */
+static int start_ccx_jobs(void)
+{
+	char **inputs = ccx_options.inputfile;
+	int nfiles = ccx_options.num_input_files;
+	int running = 0, next = 0, done = 0;
+	int with_captions = 0, without_captions = 0, failed = 0;
+	int last_failure = EXIT_OK;
+	pid_t *pids;
+	time_t start, final;
+
+	pids = calloc(nfiles, sizeof(pid_t));
+	if (!pids)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In start_ccx_jobs: Out of memory allocating job table.\n");
+
+	mprint("Processing %d input files, up to %d at a time\n", nfiles, ccx_options.jobs);
+	time(&start);
+
+	while (done < nfiles)
+	{
+		while (running < ccx_options.jobs && next < nfiles)
+		{
+			pid_t pid;
+
+			// Don't let the children inherit (and print again) anything still buffered
+			fflush(stdout);
+			fflush(stderr);
+			pid = fork();
+			if (pid < 0)
+			{
+				if (!running)
+					fatal(EXIT_NOT_CLASSIFIED, "Unable to start a job for %s: %s\n", inputs[next], strerror(errno));
+				break; // Try again once a running job has finished
+			}
+			if (pid == 0)
+			{
+				ccx_options.inputfile = inputs + next;
+				ccx_options.num_input_files = 1;
+				ccx_options.jobs = 1; // One process per file, its programs aren't split further
+				ccx_options.no_progress_bar = 1;
+				ccx_options.messages_target = 0;
+				ccxr_update_logger_target();
+				exit(start_ccx());
+			}
+			pids[next++] = pid;
+			running++;
+		}
+
+		int status;
+		pid_t pid = wait(&status);
+		if (pid < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			fatal(EXIT_NOT_CLASSIFIED, "In start_ccx_jobs: wait() failed: %s\n", strerror(errno));
+		}
+
+		int i;
+		for (i = 0; i < next && pids[i] != pid; i++)
+			;
+		if (i == next)
+			continue; // Not one of ours
+		running--;
+		done++;
+
+		if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_OK)
+		{
+			with_captions++;
+			mprint("[%d/%d] %s: done\n", done, nfiles, inputs[i]);
+		}
+		else if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_NO_CAPTIONS)
+		{
+			without_captions++;
+			mprint("[%d/%d] %s: no captions found\n", done, nfiles, inputs[i]);
+		}
+		else
+		{
+			failed++;
+			if (WIFEXITED(status))
+			{
+				last_failure = WEXITSTATUS(status);
+				mprint("[%d/%d] %s: failed, exit code %d\n", done, nfiles, inputs[i], last_failure);
+			}
+			else
+			{
+				last_failure = EXIT_NOT_CLASSIFIED;
+				mprint("[%d/%d] %s: terminated by signal %d\n", done, nfiles, inputs[i], WTERMSIG(status));
+			}
+		}
+	}
+	free(pids);
+
+	time(&final);
+	mprint("\rDone, %d files with captions, %d without, %d failed, processing time = %ld seconds\n",
+	       with_captions, without_captions, failed, (long)(final - start));
+	print_end_msg();
+
+	if (failed)
+		return last_failure;
+	return with_captions ? EXIT_OK : EXIT_NO_CAPTIONS;
+}
+#endif
+
 int main(int argc, char *argv[])
 {
 #ifdef _WIN32
@@ -504,6 +628,19 @@ int main(int argc, char *argv[])
 		exit(compile_ret);
 	}
 
+	if (ccx_options.jobs > 1 && ccx_options.num_input_files > 1)
+	{
+#ifndef _WIN32
+		return start_ccx_jobs();
+#else
+		mprint("WARNING: --jobs is not supported on Windows, processing the input files one after another.\n");
+#endif
+	}
+#ifdef _WIN32
+	else if (ccx_options.jobs > 1 && ccx_options.multiprogram)
+		mprint("WARNING: --jobs is not supported on Windows, decoding the programs one after another.\n");
+#endif
+
 	int start_ret = start_ccx();
 	return start_ret;
 }
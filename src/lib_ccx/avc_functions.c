@@ -79,6 +79,7 @@ struct avc_ctx *init_avc(void)
 
 	ctx->last_pic_order_cnt_lsb = -1;
 	ctx->last_slice_pts = -1;
+	ctx->fast_scan = 0;
 
 	ctx->num_nal_unit_type_7 = 0;
 	ctx->num_vcl_hrd = 0;
@@ -100,6 +101,7 @@ void do_NAL(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsigned
 	unsigned char *NAL_stop;
 	int nal_unit_type;
 	int nal_header_size;
+	int parse_rbsp;
 	unsigned char *payload_start;
 
 	// Determine if this is HEVC or H.264 based on NAL header
@@ -119,9 +121,24 @@ void do_NAL(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsigned
 	}
 
 	NAL_stop = NAL_length + NAL_start;
-	NAL_stop = remove_03emu(NAL_start + nal_header_size, NAL_stop);
 	payload_start = NAL_start + nal_header_size;
 
+	// Only unescape the NAL units we parse, and only the slice header of
+	// coded slices: the slice payload is never read, so leave it untouched.
+	if (dec_ctx->avc_ctx->is_hevc)
+		parse_rbsp = (nal_unit_type == HEVC_NAL_PREFIX_SEI || nal_unit_type == HEVC_NAL_SUFFIX_SEI);
+	else if (nal_unit_type == CCX_NAL_TYPE_CODED_SLICE_NON_IDR_PICTURE_1 ||
+		 nal_unit_type == CCX_NAL_TYPE_CODED_SLICE_IDR_PICTURE)
+	{
+		parse_rbsp = dec_ctx->avc_ctx->got_seq_para;
+		if (NAL_stop - payload_start > AVC_SLICE_HEADER_MAX_BYTES)
+			NAL_stop = payload_start + AVC_SLICE_HEADER_MAX_BYTES;
+	}
+	else
+		parse_rbsp = (nal_unit_type == CCX_NAL_TYPE_SEQUENCE_PARAMETER_SET_7 || nal_unit_type == CCX_NAL_TYPE_SEI);
+	if (parse_rbsp && NAL_stop > payload_start)
+		NAL_stop = remove_03emu(payload_start, NAL_stop);
+
 	dvprint("BEGIN NAL unit type: %d length %d ref_idc: %d - Buffered captions before: %d (HEVC: %d)\n",
 		nal_unit_type, NAL_stop - NAL_start - nal_header_size, dec_ctx->avc_ctx->nal_ref_idc,
 		!dec_ctx->avc_ctx->cc_buffer_saved, dec_ctx->avc_ctx->is_hevc);
@@ -197,6 +214,17 @@ void do_NAL(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsigned
 #ifndef DISABLE_RUST
 size_t ccxr_process_avc(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsigned char *avcbuf, size_t avcbuflen, struct cc_subtitle *sub);
 #endif
+#ifdef DISABLE_RUST
+/* With --fast-avc-scan, each H.264 PES packet is taken to hold a single
+   access unit, so scanning can stop at its first coded slice */
+static int stops_access_unit_scan(struct lib_cc_decode *dec_ctx, unsigned char nal_header)
+{
+	int nal_unit_type = nal_header & 0x1F;
+	return dec_ctx->avc_ctx->fast_scan && !dec_ctx->avc_ctx->is_hevc && dec_ctx->avc_ctx->got_seq_para &&
+	       (nal_unit_type == CCX_NAL_TYPE_CODED_SLICE_NON_IDR_PICTURE_1 || nal_unit_type == CCX_NAL_TYPE_CODED_SLICE_IDR_PICTURE);
+}
+#endif
+
 size_t process_avc(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, unsigned char *avcbuf, size_t avcbuflen, struct cc_subtitle *sub)
 {
 #ifndef DISABLE_RUST
@@ -300,6 +328,12 @@ size_t process_avc(struct encoder_ctx *enc_ctx, struct lib_cc_decode *dec_ctx, u
 		dec_ctx->avc_ctx->nal_ref_idc = *NAL_start >> 5;
 		dvprint("process_avc: zeropad %d\n", zeropad);
 		do_NAL(enc_ctx, dec_ctx, NAL_start, NAL_stop - NAL_start, sub);
+		if (stops_access_unit_scan(dec_ctx, *NAL_start))
+		{
+			// SEI NAL units precede the first slice of their access unit,
+			// nothing after it carries captions
+			break;
+		}
 	}
 
 	return avcbuflen;
@@ -1,6 +1,10 @@
 #ifndef AVC_FUNCTION_H
 #define AVC_FUNCTION_H
 
+// slice_header() stops at pic_order_cnt_lsb, which always fits in this many
+// escaped bytes. Also used by the Rust NAL parser.
+#define AVC_SLICE_HEADER_MAX_BYTES 64
+
 struct avc_ctx
 {
 	unsigned char cc_count;
@@ -10,6 +14,7 @@ struct avc_ctx
 	int cc_buffer_saved; // Was the CC buffer saved after it was last updated?
 
 	int is_hevc; // Flag to indicate HEVC (H.265) mode vs H.264
+	int fast_scan; // --fast-avc-scan: a PES packet holds one access unit, stop at its first slice
 	int got_seq_para;
 	unsigned nal_ref_idc;
 	LLONG seq_parameter_set_id;
@@ -1,24 +1,37 @@
 #include "ccx_common_common.h"
+#include "ccx_common_timing.h"
+#include "utility.h"
 
 int cc608_parity_table[256];
 
-/* printf() for fd instead of FILE*, since dprintf is not portable */
+/* printf() for fd instead of FILE*, since dprintf is not portable. Goes
+   through buffered_write() so it keeps its place among the other writes. */
 int fdprintf(int fd, const char *fmt, ...)
 {
-	FILE *file;
-
-	if ((file = fdopen(dup(fd), "w")) == NULL)
-	{
-		return -1;
-	}
-
+	char buf[1024];
+	char *out = buf;
 	va_list ap;
 
 	va_start(ap, fmt);
-	int ret = vfprintf(file, fmt, ap);
-	fclose(file);
+	int ret = vsnprintf(buf, sizeof(buf), fmt, ap);
 	va_end(ap);
+	if (ret < 0)
+		return -1;
+
+	if ((size_t)ret >= sizeof(buf))
+	{
+		out = malloc(ret + 1);
+		if (out == NULL)
+			return -1;
+		va_start(ap, fmt);
+		vsnprintf(out, ret + 1, fmt, ap);
+		va_end(ap);
+	}
 
+	if (buffered_write(fd, out, ret) < ret)
+		ret = -1;
+	if (out != buf)
+		free(out);
 	return ret;
 }
 
@@ -47,7 +47,31 @@ void millis_to_time(LLONG milli, unsigned *hours, unsigned *minutes, unsigned *s
 extern void ccxr_millis_to_time(LLONG milli, unsigned *hours, unsigned *minutes, unsigned *seconds, unsigned *ms);
 
 void freep(void *arg);
-void dbg_print(LLONG mask, const char *fmt, ...);
+void(dbg_print)(LLONG mask, const char *fmt, ...);
+int dbg_print_enabled(LLONG mask);
+
+/* Message types whose dbg_print() calls are compiled out, e.g.
+   -DCCX_DMT_DISABLED=0x7EFF to keep only the generic notices. */
+#ifndef CCX_DMT_DISABLED
+#define CCX_DMT_DISABLED 0
+#endif
+
+/* Test the mask before the arguments are evaluated: callers such as do_cb()
+   format timestamps and caption bytes for every block they print. */
+#define dbg_print(mask, ...)                                                        \
+	do                                                                          \
+	{                                                                           \
+		if (((mask) & ~(LLONG)CCX_DMT_DISABLED) && dbg_print_enabled(mask)) \
+			dbg_print(mask, __VA_ARGS__);                               \
+	} while (0)
+
+/* The same for the decoders, which print through ccx_common_logging */
+#define ccx_dbg(mask, ...)                                                          \
+	do                                                                          \
+	{                                                                           \
+		if (((mask) & ~(LLONG)CCX_DMT_DISABLED) && dbg_print_enabled(mask)) \
+			ccx_common_logging.debug_ftn(mask, __VA_ARGS__);            \
+	} while (0)
 unsigned char *debug_608_to_ASC(unsigned char *ccdata, int channel);
 int add_cc_sub_text(struct cc_subtitle *sub, char *str, LLONG start_time,
 		    LLONG end_time, char *info, char *mode, enum ccx_encoding_type);
@@ -10,6 +10,27 @@
 // 8-10      000000  Padding, required  :-)
 unsigned char rcwt_header[11] = {0xCC, 0xCC, 0xED, 0xCC, 0x00, 0x50, 0, 1, 0, 0, 0};
 
+// File format version 0101 (--rcwt-index) holds the same data as 0001, with
+// byte 8 of the header set to 01 when chunks may be zlib compressed. After
+// the header the file is a sequence of chunks, each with this header:
+// byte(s)   value   description
+// 0-3       tag     "CCDT" data, "CCIX" index or "CCTR" trailer
+// 4         flags   01 = the payload is zlib compressed
+// 5-7       000000  Padding
+// 8-11      size    uint32 payload size as stored
+// 12-15     size    uint32 payload size once uncompressed
+// 16-23     FTS or  "CCDT": int64 FTS of its first data header
+//           offset  "CCIX": int64 file offset of the previous "CCIX", or -1
+//                   "CCTR": int64 file offset of the last "CCIX", or -1
+// A "CCDT" payload is a run of version 0001 data headers and their blocks.
+// A "CCIX" payload lists the "CCDT" chunks written since the previous one
+// as int64 FTS, int64 file offset pairs. "CCTR" has no payload and ends the
+// file; a file cut short can still be read, and indexed by walking the chunk
+// headers.
+const unsigned char RCWT_CHUNK_DATA[4] = {'C', 'C', 'D', 'T'};
+const unsigned char RCWT_CHUNK_INDEX[4] = {'C', 'C', 'I', 'X'};
+const unsigned char RCWT_CHUNK_TRAILER[4] = {'C', 'C', 'T', 'R'};
+
 const unsigned char BROADCAST_HEADER[] = {0xff, 0xff, 0xff, 0xff};
 const unsigned char LITTLE_ENDIAN_BOM[] = {0xff, 0xfe};
 const unsigned char UTF8_BOM[] = {0xef, 0xbb, 0xbf};
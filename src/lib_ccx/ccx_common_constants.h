@@ -28,6 +28,12 @@ extern const unsigned char lc5[1];
 extern const unsigned char lc6[1];
 
 extern unsigned char rcwt_header[11];
+extern const unsigned char RCWT_CHUNK_DATA[4];
+extern const unsigned char RCWT_CHUNK_INDEX[4];
+extern const unsigned char RCWT_CHUNK_TRAILER[4];
+#define RCWT_FORMAT_INDEXED 0x01 // Header byte 6 of chunked, indexed RCWT
+#define RCWT_CHUNK_HEADER_LEN 24
+#define RCWT_CHUNK_ZLIB 0x01
 
 #define ONEPASS 120			/* Bytes we can always look ahead without going out of limits */
 #define BUFSIZE (2048 * 1024 + ONEPASS) /* 2 Mb plus the safety pass */
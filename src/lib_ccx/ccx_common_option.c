@@ -76,9 +76,12 @@ void init_options(struct ccx_s_options *options)
 	options->ocr_quantmode = 0;	  // No quantization (better OCR accuracy for DVB subtitles)
 	options->ocr_line_split = 0;	  // By default, don't split images into lines (pending testing)
 	options->ocr_blacklist = 1;	  // By default, use character blacklist to prevent common OCR errors (| vs I, etc.)
+	options->ocr_threads = 1;	  // By default, OCR runs on the decoding thread
+	options->ocr_cache_file = NULL;	  // By default, OCR results are not saved
 	options->mkvlang = NULL;	  // By default, all the languages are extracted
 	options->ignore_pts_jumps = 1;
 	options->analyze_video_stream = 0;
+	options->fast_avc_scan = 0;
 
 	/*HardsubX related stuff*/
 	options->hardsubx_ocr_mode = 0;
@@ -88,6 +91,9 @@ void init_options(struct ccx_s_options *options)
 	options->hardsubx_conf_thresh = 0.0;
 	options->hardsubx_hue = 0.0;
 	options->hardsubx_lum_thresh = 95.0;
+	options->hardsubx_sub_band = 25;
+	options->hardsubx_sampling = 0;
+	options->hardsubx_sample_interval = 1.0;
 	options->hardsubx_and_common = 0;
 
 	options->transcript_settings = ccx_encoders_default_transcript_settings;
@@ -106,6 +112,7 @@ void init_options(struct ccx_s_options *options)
 	options->tcpport = NULL;
 	options->tcp_password = NULL;
 	options->tcp_desc = NULL;
+	options->tcp_senders = 1; // 1 = serve one sender, see start_tcp_srv()
 	options->srv_addr = NULL;
 	options->srv_port = NULL;
 	options->noautotimeref = 0;	     // Do NOT set time automatically?
@@ -113,6 +120,8 @@ void init_options(struct ccx_s_options *options)
 	options->multiprogram = 0;
 	options->out_interval = -1;
 	options->segment_on_key_frames_only = 0;
+	options->jobs = 1;
+	options->program_worker = -1;
 
 	options->subs_delay = 0;
 
@@ -133,6 +142,8 @@ void init_options(struct ccx_s_options *options)
 	options->enc_cfg.autodash = 0;	// Add dashes (-) before each speaker automatically?
 	options->enc_cfg.trim_subs = 0; // "	Remove spaces at sides?	"
 	options->enc_cfg.in_format = 1;
+	options->enc_cfg.rcwt_index = 0;
+	options->enc_cfg.rcwt_compress = 0;
 	options->enc_cfg.line_terminator_lf = 0; // 0 = CRLF
 	options->enc_cfg.frame_terminator_0 = 0; // 0 = frames terminated by line_terminator_lf
 	options->enc_cfg.start_credits_text = NULL;
@@ -162,6 +173,7 @@ void init_options(struct ccx_s_options *options)
 
 #ifdef WITH_LIBCURL
 	options->curlposturl = NULL;
+	options->curl_batch = 1;
 #endif
 
 	// Prepare time structures
@@ -184,3 +196,15 @@ void init_options(struct ccx_s_options *options)
 	stringztoms(DEF_VAL_ENDCREDITSFORATLEAST, &options->enc_cfg.endcreditsforatleast);
 	stringztoms(DEF_VAL_ENDCREDITSFORATMOST, &options->enc_cfg.endcreditsforatmost);
 }
+
+int encoder_cfg_has_format(const struct encoder_cfg *cfg, enum ccx_output_format format)
+{
+	if (cfg->write_format == format)
+		return 1;
+	for (int i = 0; i < cfg->nb_extra_write_formats; i++)
+	{
+		if (cfg->extra_write_formats[i] == format)
+			return 1;
+	}
+	return 0;
+}
@@ -26,6 +26,9 @@ struct demuxer_cfg
 	unsigned ts_forced_streamtype; // User selected (forced) stream type
 };
 
+// At most one format per file extension can be written in one run
+#define CCX_MAX_EXTRA_WRITE_FORMATS 8
+
 struct encoder_cfg
 {
 	int extract;	      // Extract 1st, 2nd or both fields
@@ -33,6 +36,9 @@ struct encoder_cfg
 	int gui_mode_reports; // If 1, output in stderr progress updates so the GUI can grab them
 	char *output_filename;
 	enum ccx_output_format write_format; // 0=Raw, 1=srt, 2=SMI
+	// Formats written besides write_format from the same decoded captions (-out=srt,webvtt,...)
+	enum ccx_output_format extra_write_formats[CCX_MAX_EXTRA_WRITE_FORMATS];
+	int nb_extra_write_formats;
 	int keep_output_closed;
 	int force_flush; // Force flush on content write
 	int append_mode; // Append mode for output files
@@ -71,6 +77,8 @@ struct encoder_cfg
 	LLONG subs_delay;	// ms to delay (or advance) subs
 	int program_number;
 	unsigned char in_format;
+	int rcwt_index;	   // 1 to write RCWT in indexed chunks, see RCWT_FORMAT_INDEXED
+	int rcwt_compress; // 1 to zlib compress those chunks
 	int nospupngocr; // 1 if we don't want to OCR bitmaps to add the text as comments in the XML file in spupng
 
 	// MCC File
@@ -156,8 +164,11 @@ struct ccx_s_options // Options from user parameters
 	int ocr_quantmode;	  // How to quantize the bitmap before passing to to tesseract (0=no quantization at all, 1=CCExtractor's internal)
 	int ocr_line_split;	  // If 1, split images into lines before OCR (uses PSM 7 for better accuracy)
 	int ocr_blacklist;	  // If 1, use character blacklist to prevent common OCR errors (default: enabled)
+	int ocr_threads;	  // Number of Tesseract instances running OCR of VOBSUB tracks and hardsubx frames in parallel
+	char *ocr_cache_file;	  // Where OCR results are kept between runs (NULL = only for this run)
 	char *mkvlang;		  // The name of the language stream for MKV
 	int analyze_video_stream; // If 1, the video stream will be processed even if we're using a different one for subtitles.
+	int fast_avc_scan;	  // If 1, stop scanning an H.264 PES packet after its first slice header
 
 	/*HardsubX related stuff*/
 	int hardsubx_ocr_mode;
@@ -167,6 +178,9 @@ struct ccx_s_options // Options from user parameters
 	float hardsubx_conf_thresh;
 	float hardsubx_hue;
 	float hardsubx_lum_thresh;
+	int hardsubx_sub_band; // Percentage of the frame height, from the bottom, searched for subtitles
+	int hardsubx_sampling;		// enum hardsubx_sampling_mode
+	float hardsubx_sample_interval; // Seconds between sampled frames, except with --sampling every
 
 	ccx_encoders_transcript_format transcript_settings; // Keeps the settings for generating transcript output files.
 	enum ccx_output_date_format date_format;
@@ -184,6 +198,7 @@ struct ccx_s_options // Options from user parameters
 	char *tcpport;
 	char *tcp_password;
 	char *tcp_desc;
+	int tcp_senders; // >1: serve that many --sendto senders at once, each to its own file
 	char *srv_addr;
 	char *srv_port;
 	int noautotimeref;		  // Do NOT set time automatically?
@@ -194,6 +209,8 @@ struct ccx_s_options // Options from user parameters
 
 	char **inputfile;    // List of files to process
 	int num_input_files; // How many?
+	int jobs;	     // --jobs: input files processed at the same time, or processes sharing the programs of one --multiprogram input
+	int program_worker;  // --multiprogram --jobs: which worker process this is, -1 = not a worker
 	struct demuxer_cfg demux_cfg;
 	struct encoder_cfg enc_cfg;
 	LLONG subs_delay;	  // ms to delay (or advance) subs
@@ -206,9 +223,12 @@ struct ccx_s_options // Options from user parameters
 	int scc_framerate; // SCC input framerate: 0=29.97 (default), 1=24, 2=25, 3=30
 #ifdef WITH_LIBCURL
 	char *curlposturl;
+	unsigned curl_batch; // Most cues per POST. Above 1 they go to /frames/, one per line
 #endif
 };
 
 extern struct ccx_s_options ccx_options;
 void init_options(struct ccx_s_options *options);
+// Whether cfg writes format, as its main format or one of its extra ones
+int encoder_cfg_has_format(const struct encoder_cfg *cfg, enum ccx_output_format format);
 #endif
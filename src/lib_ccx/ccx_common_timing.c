@@ -50,6 +50,45 @@ void ccx_common_timing_init(LLONG *file_position, int no_sync)
 	ccx_common_timing_settings.no_sync = no_sync;
 }
 
+/* The values the timing globals start with */
+void init_timing_globals(struct ccx_timing_globals *g)
+{
+	memset(g, 0, sizeof(*g));
+	g->current_fps = (double)30000.0 / 1001;
+}
+
+void save_timing_globals(struct ccx_timing_globals *g)
+{
+	g->cb_field1 = cb_field1;
+	g->cb_field2 = cb_field2;
+	g->cb_708 = cb_708;
+	g->pts_big_change = pts_big_change;
+	g->current_fps = current_fps;
+	g->frames_since_ref_time = frames_since_ref_time;
+	g->total_frames_count = total_frames_count;
+	g->gop_time = gop_time;
+	g->first_gop_time = first_gop_time;
+	g->printed_gop = printed_gop;
+	g->fts_at_gop_start = fts_at_gop_start;
+	g->gop_rollover = gop_rollover;
+}
+
+void restore_timing_globals(const struct ccx_timing_globals *g)
+{
+	cb_field1 = g->cb_field1;
+	cb_field2 = g->cb_field2;
+	cb_708 = g->cb_708;
+	pts_big_change = g->pts_big_change;
+	current_fps = g->current_fps;
+	frames_since_ref_time = g->frames_since_ref_time;
+	total_frames_count = g->total_frames_count;
+	gop_time = g->gop_time;
+	first_gop_time = g->first_gop_time;
+	printed_gop = g->printed_gop;
+	fts_at_gop_start = g->fts_at_gop_start;
+	gop_rollover = g->gop_rollover;
+}
+
 void dinit_timing_ctx(struct ccx_common_timing_ctx **arg)
 {
 	freep(arg);
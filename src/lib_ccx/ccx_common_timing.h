@@ -72,7 +72,26 @@ extern struct gop_time_code gop_time, first_gop_time, printed_gop;
 extern LLONG fts_at_gop_start;
 extern int gop_rollover;
 
+/* The timing globals above that follow the stream being decoded. In a
+   --multiprogram --jobs worker every decoder keeps its own copy, swapped in
+   while it runs, so a program's timing doesn't depend on which other programs
+   the same worker decodes. */
+struct ccx_timing_globals
+{
+	int cb_field1, cb_field2, cb_708;
+	unsigned pts_big_change;
+	double current_fps;
+	int frames_since_ref_time;
+	unsigned total_frames_count;
+	struct gop_time_code gop_time, first_gop_time, printed_gop;
+	LLONG fts_at_gop_start;
+	int gop_rollover;
+};
+
 void ccx_common_timing_init(LLONG *file_position, int no_sync);
+void init_timing_globals(struct ccx_timing_globals *g);
+void save_timing_globals(struct ccx_timing_globals *g);
+void restore_timing_globals(const struct ccx_timing_globals *g);
 
 void dinit_timing_ctx(struct ccx_common_timing_ctx **arg);
 struct ccx_common_timing_ctx *init_timing_ctx(struct ccx_common_timing_settings_t *cfg);
@@ -264,18 +264,18 @@ void handle_text_attr(const unsigned char c1, const unsigned char c2, ccx_decode
 	context->channel = context->new_channel;
 	if (context->channel != context->my_channel)
 		return;
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\r608: text_attr: %02X %02X", c1, c2);
+	ccx_dbg(CCX_DMT_DECODER_608, "\r608: text_attr: %02X %02X", c1, c2);
 	if (((c1 != 0x11 && c1 != 0x19) ||
 	     (c2 < 0x20 || c2 > 0x2f)))
 	{
-		ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\rThis is not a text attribute!\n");
+		ccx_dbg(CCX_DMT_DECODER_608, "\rThis is not a text attribute!\n");
 	}
 	else
 	{
 		int i = c2 - 0x20;
 		context->current_color = pac2_attribs[i][0];
 		context->font = pac2_attribs[i][1];
-		ccx_common_logging.debug_ftn(
+		ccx_dbg(
 		    CCX_DMT_DECODER_608,
 		    "  --  Color: %s,  font: %s\n",
 		    color_text[context->current_color][0],
@@ -574,7 +574,7 @@ int roll_up(ccx_decoder_608_context *context)
 		}
 	}
 
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\rIn roll-up: %d lines used, first: %d, last: %d\n", rows_orig, firstrow, lastrow);
+	ccx_dbg(CCX_DMT_DECODER_608, "\rIn roll-up: %d lines used, first: %d, last: %d\n", rows_orig, firstrow, lastrow);
 
 	if (lastrow == -1) // Empty screen, nothing to rollup
 		return 0;
@@ -727,9 +727,9 @@ void handle_command(unsigned char c1, const unsigned char c2, ccx_decoder_608_co
 	else if (command == COM_ROLLUP4 && context->settings->force_rollup == 3)
 		command = COM_ROLLUP3;
 
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\rCommand begin: %02X %02X (%s)\n", c1, c2, command_type[command]);
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\rCurrent mode: %d  Position: %d,%d  VisBuf: %d\n", context->mode,
-				     context->cursor_row, context->cursor_column, context->visible_buffer);
+	ccx_dbg(CCX_DMT_DECODER_608, "\rCommand begin: %02X %02X (%s)\n", c1, c2, command_type[command]);
+	ccx_dbg(CCX_DMT_DECODER_608, "\rCurrent mode: %d  Position: %d,%d  VisBuf: %d\n", context->mode,
+		context->cursor_row, context->cursor_column, context->visible_buffer);
 
 	switch (command)
 	{
@@ -917,12 +917,12 @@ void handle_command(unsigned char c1, const unsigned char c2, ccx_decoder_608_co
 			// ccx_common_logging.log_ftn ("to transcribe to a text file.\n");
 			break;
 		default:
-			ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\rNot yet implemented.\n");
+			ccx_dbg(CCX_DMT_DECODER_608, "\rNot yet implemented.\n");
 			break;
 	}
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\rCurrent mode: %d  Position: %d,%d	VisBuf: %d\n", context->mode,
-				     context->cursor_row, context->cursor_column, context->visible_buffer);
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\rCommand end: %02X %02X (%s)\n", c1, c2, command_type[command]);
+	ccx_dbg(CCX_DMT_DECODER_608, "\rCurrent mode: %d  Position: %d,%d	VisBuf: %d\n", context->mode,
+		context->cursor_row, context->cursor_column, context->visible_buffer);
+	ccx_dbg(CCX_DMT_DECODER_608, "\rCommand end: %02X %02X (%s)\n", c1, c2, command_type[command]);
 }
 
 void flush_608_context(ccx_decoder_608_context *context, struct cc_subtitle *sub)
@@ -941,7 +941,7 @@ void handle_double(const unsigned char c1, const unsigned char c2, ccx_decoder_6
 	if (c2 >= 0x30 && c2 <= 0x3f)
 	{
 		c = c2 + 0x50; // So if c>=0x80 && c<=0x8f, it comes from here
-		ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\rDouble: %02X %02X  -->  %c\n", c1, c2, c);
+		ccx_dbg(CCX_DMT_DECODER_608, "\rDouble: %02X %02X  -->  %c\n", c1, c2, c);
 		write_char(c, context);
 	}
 }
@@ -953,7 +953,7 @@ unsigned char handle_extended(unsigned char hi, unsigned char lo, ccx_decoder_60
 	if (context->new_channel > 2)
 	{
 		context->new_channel -= 2;
-		ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\nChannel correction, now %d\n", context->new_channel);
+		ccx_dbg(CCX_DMT_DECODER_608, "\nChannel correction, now %d\n", context->new_channel);
 	}
 	context->channel = context->new_channel;
 	if (context->channel != context->my_channel)
@@ -962,7 +962,7 @@ unsigned char handle_extended(unsigned char hi, unsigned char lo, ccx_decoder_60
 	// For lo values between 0x20-0x3f
 	unsigned char c = 0;
 
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\rExtended: %02X %02X\n", hi, lo);
+	ccx_dbg(CCX_DMT_DECODER_608, "\rExtended: %02X %02X\n", hi, lo);
 	if (lo >= 0x20 && lo <= 0x3f && (hi == 0x12 || hi == 0x13))
 	{
 		switch (hi)
@@ -992,7 +992,7 @@ void handle_pac(unsigned char c1, unsigned char c2, ccx_decoder_608_context *con
 	if (context->new_channel > 2)
 	{
 		context->new_channel -= 2;
-		ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\nChannel correction, now %d\n", context->new_channel);
+		ccx_dbg(CCX_DMT_DECODER_608, "\nChannel correction, now %d\n", context->new_channel);
 	}
 	context->channel = context->new_channel;
 	if (context->channel != context->my_channel)
@@ -1000,7 +1000,7 @@ void handle_pac(unsigned char c1, unsigned char c2, ccx_decoder_608_context *con
 
 	int row = rowdata[((c1 << 1) & 14) | ((c2 >> 5) & 1)];
 
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\rPAC: %02X %02X", c1, c2);
+	ccx_dbg(CCX_DMT_DECODER_608, "\rPAC: %02X %02X", c1, c2);
 
 	if (c2 >= 0x40 && c2 <= 0x5f)
 	{
@@ -1014,15 +1014,15 @@ void handle_pac(unsigned char c1, unsigned char c2, ccx_decoder_608_context *con
 		}
 		else
 		{
-			ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\rThis is not a PAC!!!!!\n");
+			ccx_dbg(CCX_DMT_DECODER_608, "\rThis is not a PAC!!!!!\n");
 			return;
 		}
 	}
 	context->current_color = pac2_attribs[c2][0];
 	context->font = pac2_attribs[c2][1];
 	int indent = pac2_attribs[c2][2];
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "  --  Position: %d:%d, color: %s,  font: %s\n", row,
-				     indent, color_text[context->current_color][0], font_text[context->font]);
+	ccx_dbg(CCX_DMT_DECODER_608, "  --  Position: %d:%d, color: %s,  font: %s\n", row,
+		indent, color_text[context->current_color][0], font_text[context->font]);
 	if (context->settings->default_color == COL_USERDEFINED && (context->current_color == COL_WHITE || context->current_color == COL_TRANSPARENT))
 		context->current_color = COL_USERDEFINED;
 	if (context->mode != MODE_TEXT)
@@ -1063,7 +1063,7 @@ void handle_single(const unsigned char c1, ccx_decoder_608_context *context)
 {
 	if (c1 < 0x20 || context->channel != context->my_channel)
 		return; // We don't allow special stuff here
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "%c", c1);
+	ccx_dbg(CCX_DMT_DECODER_608, "%c", c1);
 
 	write_char(c1, context);
 }
@@ -1094,7 +1094,7 @@ int check_channel(unsigned char c1, ccx_decoder_608_context *context)
 		newchan = 2;
 	if (newchan != context->channel)
 	{
-		ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\nChannel change, now %d\n", newchan);
+		ccx_dbg(CCX_DMT_DECODER_608, "\nChannel change, now %d\n", newchan);
 		if (context->channel != 3) // Don't delete memories if returning from XDS.
 		{
 			// erase_both_memories (wb); // 47cfr15.119.pdf, page 859, part f
@@ -1263,7 +1263,7 @@ int process608(const unsigned char *data, int length, void *private_data, struct
 			// diagnostic output from disCommand()
 			if (context->textprinted == 1)
 			{
-				ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\n");
+				ccx_dbg(CCX_DMT_DECODER_608, "\n");
 				context->textprinted = 0;
 			}
 
@@ -1271,7 +1271,7 @@ int process608(const unsigned char *data, int length, void *private_data, struct
 			{
 				// Duplicate dual code, discard. Correct to do it only in
 				// non-XDS, XDS codes shall not be repeated.
-				ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "Skipping command %02X,%02X Duplicate\n", hi, lo);
+				ccx_dbg(CCX_DMT_DECODER_608, "Skipping command %02X,%02X Duplicate\n", hi, lo);
 				// Ignore only the first repetition
 				context->last_c1 = -1;
 				context->last_c2 = -1;
@@ -1307,7 +1307,7 @@ int process608(const unsigned char *data, int length, void *private_data, struct
 
 				if (context->textprinted == 0)
 				{
-					ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "\n");
+					ccx_dbg(CCX_DMT_DECODER_608, "\n");
 					context->textprinted = 1;
 				}
 
@@ -1320,7 +1320,7 @@ int process608(const unsigned char *data, int length, void *private_data, struct
 
 			if (!context->textprinted && context->channel == context->my_channel)
 			{ // Current FTS information after the characters are shown
-				ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "Current FTS: %s\n", print_mstime_static(get_fts(dec_ctx->timing, context->my_field)));
+				ccx_dbg(CCX_DMT_DECODER_608, "Current FTS: %s\n", print_mstime_static(get_fts(dec_ctx->timing, context->my_field)));
 				// printf("  N:%u", unsigned(fts_now) );
 				// printf("  G:%u", unsigned(fts_global) );
 				// printf("  F:%d %d %d %d\n",
@@ -283,7 +283,7 @@ void dtvcc_get_win_write_interval(dtvcc_window *window, int row_index, int *firs
 
 void dtvcc_window_dump(dtvcc_service_decoder *decoder, dtvcc_window *window)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_GENERIC_NOTICES, "[CEA-708] Window %d dump:\n", window->number);
+	ccx_dbg(CCX_DMT_GENERIC_NOTICES, "[CEA-708] Window %d dump:\n", window->number);
 
 	if (!window->is_defined)
 		return;
@@ -295,7 +295,7 @@ void dtvcc_window_dump(dtvcc_service_decoder *decoder, dtvcc_window *window)
 	print_mstime_buff(window->time_ms_show, "%02u:%02u:%02u:%03u", tbuf1);
 	print_mstime_buff(window->time_ms_hide, "%02u:%02u:%02u:%03u", tbuf2);
 
-	ccx_common_logging.debug_ftn(CCX_DMT_GENERIC_NOTICES, "\r%s --> %s\n", tbuf1, tbuf2);
+	ccx_dbg(CCX_DMT_GENERIC_NOTICES, "\r%s --> %s\n", tbuf1, tbuf2);
 	for (int i = 0; i < CCX_DTVCC_MAX_ROWS; i++)
 	{
 		if (!dtvcc_is_win_row_empty(window, i))
@@ -308,13 +308,13 @@ void dtvcc_window_dump(dtvcc_service_decoder *decoder, dtvcc_window *window)
 				sym = window->rows[i][j];
 				int len = utf16_to_utf8(sym.sym, sym_buf);
 				for (int index = 0; index < len; index++)
-					ccx_common_logging.debug_ftn(CCX_DMT_GENERIC_NOTICES, "%c", sym_buf[index]);
+					ccx_dbg(CCX_DMT_GENERIC_NOTICES, "%c", sym_buf[index]);
 			}
-			ccx_common_logging.debug_ftn(CCX_DMT_GENERIC_NOTICES, "\n");
+			ccx_dbg(CCX_DMT_GENERIC_NOTICES, "\n");
 		}
 	}
 
-	ccx_common_logging.debug_ftn(CCX_DMT_GENERIC_NOTICES, "[CEA-708] Dump done\n", window->number);
+	ccx_dbg(CCX_DMT_GENERIC_NOTICES, "[CEA-708] Dump done\n", window->number);
 }
 
 #endif
@@ -334,7 +334,7 @@ void dtvcc_windows_reset(dtvcc_service_decoder *decoder)
 
 void dtvcc_decoders_reset(dtvcc_ctx *dtvcc)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_decoders_reset: Resetting all decoders\n");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_decoders_reset: Resetting all decoders\n");
 
 	for (int i = 0; i < CCX_DTVCC_MAX_SERVICES; i++)
 	{
@@ -361,9 +361,9 @@ void dtvcc_window_update_time_show(dtvcc_window *window, struct ccx_common_timin
 	char buf[128];
 	window->time_ms_show = get_visible_start(timing, 3);
 	print_mstime_buff(window->time_ms_show, "%02u:%02u:%02u:%03u", buf);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] "
+	ccx_dbg(CCX_DMT_708, "[CEA-708] "
 						  "[W-%d] show time updated to %s\n",
-				     window->number, buf);
+		window->number, buf);
 }
 
 void dtvcc_window_update_time_hide(dtvcc_window *window, struct ccx_common_timing_ctx *timing)
@@ -371,9 +371,9 @@ void dtvcc_window_update_time_hide(dtvcc_window *window, struct ccx_common_timin
 	char buf[128];
 	window->time_ms_hide = get_visible_end(timing, 3);
 	print_mstime_buff(window->time_ms_hide, "%02u:%02u:%02u:%03u", buf);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] "
+	ccx_dbg(CCX_DMT_708, "[CEA-708] "
 						  "[W-%d] hide time updated to %s\n",
-				     window->number, buf);
+		window->number, buf);
 }
 
 void dtvcc_screen_update_time_show(dtvcc_tv_screen *tv, LLONG time)
@@ -381,9 +381,9 @@ void dtvcc_screen_update_time_show(dtvcc_tv_screen *tv, LLONG time)
 	char buf1[128], buf2[128];
 	print_mstime_buff(tv->time_ms_show, "%02u:%02u:%02u:%03u", buf1);
 	print_mstime_buff(time, "%02u:%02u:%02u:%03u", buf2);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] "
+	ccx_dbg(CCX_DMT_708, "[CEA-708] "
 						  "Screen show time: %s -> %s\n",
-				     buf1, buf2);
+		buf1, buf2);
 
 	if (tv->time_ms_show == -1)
 		tv->time_ms_show = time;
@@ -396,9 +396,9 @@ void dtvcc_screen_update_time_hide(dtvcc_tv_screen *tv, LLONG time)
 	char buf1[128], buf2[128];
 	print_mstime_buff(tv->time_ms_hide, "%02u:%02u:%02u:%03u", buf1);
 	print_mstime_buff(time, "%02u:%02u:%02u:%03u", buf2);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] "
+	ccx_dbg(CCX_DMT_708, "[CEA-708] "
 						  "Screen hide time: %s -> %s\n",
-				     buf1, buf2);
+		buf1, buf2);
 
 	if (tv->time_ms_hide == -1)
 		tv->time_ms_hide = time;
@@ -519,14 +519,14 @@ void dtvcc_window_copy_to_screen(dtvcc_service_decoder *decoder, dtvcc_window *w
 	switch (dtvcc_is_window_overlapping(decoder, window))
 	{
 		case OVERLAPPING_WITH_HIGH_PRIORITY:
-			ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_window_copy_to_screen : no handling required \n");
+			ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_window_copy_to_screen : no handling required \n");
 			break;
 		case OVERLAPPED_BY_HIGH_PRIORITY:
-			ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_window_copy_to_screen : window needs to be skipped \n");
+			ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_window_copy_to_screen : window needs to be skipped \n");
 			return;
 	}
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_window_copy_to_screen: W-%d\n", window->number);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_window_copy_to_screen: W-%d\n", window->number);
 	int top, left;
 	// For each window we calculate the top, left position depending on the
 	// anchor
@@ -572,11 +572,11 @@ void dtvcc_window_copy_to_screen(dtvcc_service_decoder *decoder, dtvcc_window *w
 			return;
 			break;
 	}
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] For window %d: Anchor point -> %d, size %d:%d, real position %d:%d\n",
-				     window->number, window->anchor_point, window->row_count, window->col_count,
-				     top, left);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] For window %d: Anchor point -> %d, size %d:%d, real position %d:%d\n",
+		window->number, window->anchor_point, window->row_count, window->col_count,
+		top, left);
 
-	ccx_common_logging.debug_ftn(
+	ccx_dbg(
 	    CCX_DMT_708, "[CEA-708] we have top [%d] and left [%d]\n", top, left);
 
 	top = top < 0 ? 0 : top;
@@ -585,7 +585,7 @@ void dtvcc_window_copy_to_screen(dtvcc_service_decoder *decoder, dtvcc_window *w
 	int copyrows = top + window->row_count >= CCX_DTVCC_SCREENGRID_ROWS ? CCX_DTVCC_SCREENGRID_ROWS - top : window->row_count;
 	int copycols = left + window->col_count >= CCX_DTVCC_SCREENGRID_COLUMNS ? CCX_DTVCC_SCREENGRID_COLUMNS - left : window->col_count;
 
-	ccx_common_logging.debug_ftn(
+	ccx_dbg(
 	    CCX_DMT_708, "[CEA-708] %d*%d will be copied to the TV.\n", copyrows, copycols);
 
 	for (int j = 0; j < copyrows; j++)
@@ -611,7 +611,7 @@ void dtvcc_screen_print(dtvcc_ctx *dtvcc, dtvcc_service_decoder *decoder)
 	// TODO use priorities to solve windows overlap (with a video sample, please)
 	// qsort(wnd, visible, sizeof(dtvcc_window *), dtvcc_compare_win_priorities);
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_screen_print\n");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_screen_print\n");
 
 	dtvcc_screen_update_time_hide(decoder->tv, get_visible_end(dtvcc->timing, 3));
 
@@ -622,10 +622,12 @@ void dtvcc_screen_print(dtvcc_ctx *dtvcc, dtvcc_service_decoder *decoder)
 	decoder->cc_count++;
 	decoder->tv->cc_count++;
 
-	struct encoder_ctx *encoder = (struct encoder_ctx *)dtvcc->encoder;
 	int sn = decoder->tv->service_number;
-	dtvcc_writer_ctx *writer = &encoder->dtvcc_writers[sn - 1];
-	dtvcc_writer_output(writer, decoder, encoder);
+	for (struct encoder_ctx *encoder = (struct encoder_ctx *)dtvcc->encoder; encoder; encoder = encoder->next_format)
+	{
+		dtvcc_writer_ctx *writer = &encoder->dtvcc_writers[sn - 1];
+		dtvcc_writer_output(writer, decoder, encoder);
+	}
 
 	dtvcc_tv_clear(decoder);
 }
@@ -767,7 +769,7 @@ void dtvcc_process_cr(dtvcc_ctx *dtvcc, dtvcc_service_decoder *decoder)
 		dtvcc_window_update_time_hide(window, dtvcc->timing);
 		if (rollup_required)
 		{
-			ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_cr: rolling up\n");
+			ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_cr: rolling up\n");
 			dtvcc_window_copy_to_screen(decoder, window);
 			dtvcc_screen_print(dtvcc, decoder);
 			if (dtvcc->no_rollup)
@@ -781,11 +783,11 @@ void dtvcc_process_cr(dtvcc_ctx *dtvcc, dtvcc_service_decoder *decoder)
 
 void dtvcc_process_character(dtvcc_service_decoder *decoder, dtvcc_symbol symbol)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] %d\n", decoder->current_window);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] %d\n", decoder->current_window);
 	int cw = decoder->current_window;
 	dtvcc_window *window = &decoder->windows[cw];
 
-	ccx_common_logging.debug_ftn(
+	ccx_dbg(
 	    CCX_DMT_708, "[CEA-708] dtvcc_process_character: "
 			 "%c [%02X]  - Window: %d %s, Pen: %d:%d\n",
 	    CCX_DTVCC_SYM(symbol), CCX_DTVCC_SYM(symbol),
@@ -828,7 +830,7 @@ void dtvcc_process_character(dtvcc_service_decoder *decoder, dtvcc_symbol symbol
 
 void dtvcc_handle_CWx_SetCurrentWindow(dtvcc_service_decoder *decoder, int window_id)
 {
-	ccx_common_logging.debug_ftn(
+	ccx_dbg(
 	    CCX_DMT_708, "[CEA-708] dtvcc_handle_CWx_SetCurrentWindow: [%d]\n", window_id);
 	if (decoder->windows[window_id].is_defined)
 		decoder->current_window = window_id;
@@ -840,11 +842,11 @@ void dtvcc_handle_CWx_SetCurrentWindow(dtvcc_service_decoder *decoder, int windo
 
 void dtvcc_handle_CLW_ClearWindows(dtvcc_ctx *dtvcc, dtvcc_service_decoder *decoder, int windows_bitmap)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_CLW_ClearWindows: windows: ");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_CLW_ClearWindows: windows: ");
 	int screen_content_changed = 0,
 	    window_had_content;
 	if (windows_bitmap == 0)
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "none\n");
+		ccx_dbg(CCX_DMT_708, "none\n");
 	else
 	{
 		for (int i = 0; i < CCX_DTVCC_MAX_WINDOWS; i++)
@@ -852,7 +854,7 @@ void dtvcc_handle_CLW_ClearWindows(dtvcc_ctx *dtvcc, dtvcc_service_decoder *deco
 			if (windows_bitmap & 1)
 			{
 				dtvcc_window *window = &decoder->windows[i];
-				ccx_common_logging.debug_ftn(CCX_DMT_708, "[W%d] ", i);
+				ccx_dbg(CCX_DMT_708, "[W%d] ", i);
 				window_had_content = window->is_defined && window->visible && !window->is_empty;
 				if (window_had_content)
 				{
@@ -865,23 +867,23 @@ void dtvcc_handle_CLW_ClearWindows(dtvcc_ctx *dtvcc, dtvcc_service_decoder *deco
 			windows_bitmap >>= 1;
 		}
 	}
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "\n");
+	ccx_dbg(CCX_DMT_708, "\n");
 	if (screen_content_changed)
 		dtvcc_screen_print(dtvcc, decoder);
 }
 
 void dtvcc_handle_DSW_DisplayWindows(dtvcc_service_decoder *decoder, int windows_bitmap, struct ccx_common_timing_ctx *timing)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_DSW_DisplayWindows: windows: ");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_DSW_DisplayWindows: windows: ");
 	if (windows_bitmap == 0)
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "none\n");
+		ccx_dbg(CCX_DMT_708, "none\n");
 	else
 	{
 		for (int i = 0; i < CCX_DTVCC_MAX_WINDOWS; i++)
 		{
 			if (windows_bitmap & 1)
 			{
-				ccx_common_logging.debug_ftn(CCX_DMT_708, "[Window %d] ", i);
+				ccx_dbg(CCX_DMT_708, "[Window %d] ", i);
 				if (!decoder->windows[i].is_defined)
 				{
 					ccx_common_logging.log_ftn("[CEA-708] Error: window %d was not defined\n", i);
@@ -895,7 +897,7 @@ void dtvcc_handle_DSW_DisplayWindows(dtvcc_service_decoder *decoder, int windows
 			}
 			windows_bitmap >>= 1;
 		}
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "\n");
+		ccx_dbg(CCX_DMT_708, "\n");
 	}
 }
 
@@ -903,9 +905,9 @@ void dtvcc_handle_HDW_HideWindows(dtvcc_ctx *dtvcc,
 				  dtvcc_service_decoder *decoder,
 				  int windows_bitmap)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_HDW_HideWindows: windows: ");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_HDW_HideWindows: windows: ");
 	if (windows_bitmap == 0)
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "none\n");
+		ccx_dbg(CCX_DMT_708, "none\n");
 	else
 	{
 		int screen_content_changed = 0;
@@ -913,7 +915,7 @@ void dtvcc_handle_HDW_HideWindows(dtvcc_ctx *dtvcc,
 		{
 			if (windows_bitmap & 1)
 			{
-				ccx_common_logging.debug_ftn(CCX_DMT_708, "[Window %d] ", i);
+				ccx_dbg(CCX_DMT_708, "[Window %d] ", i);
 				if (decoder->windows[i].visible)
 				{
 					screen_content_changed = 1;
@@ -925,7 +927,7 @@ void dtvcc_handle_HDW_HideWindows(dtvcc_ctx *dtvcc,
 			}
 			windows_bitmap >>= 1;
 		}
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "\n");
+		ccx_dbg(CCX_DMT_708, "\n");
 		if (screen_content_changed && !dtvcc_decoder_has_visible_windows(decoder))
 			dtvcc_screen_print(dtvcc, decoder);
 	}
@@ -935,9 +937,9 @@ void dtvcc_handle_TGW_ToggleWindows(dtvcc_ctx *dtvcc,
 				    dtvcc_service_decoder *decoder,
 				    int windows_bitmap)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_TGW_ToggleWindows: windows: ");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_TGW_ToggleWindows: windows: ");
 	if (windows_bitmap == 0)
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "none\n");
+		ccx_dbg(CCX_DMT_708, "none\n");
 	else
 	{
 		int screen_content_changed = 0;
@@ -946,7 +948,7 @@ void dtvcc_handle_TGW_ToggleWindows(dtvcc_ctx *dtvcc,
 			dtvcc_window *window = &decoder->windows[i];
 			if ((windows_bitmap & 1) && window->is_defined)
 			{
-				ccx_common_logging.debug_ftn(CCX_DMT_708, "[W-%d: %d->%d]", i, window->visible, !window->visible);
+				ccx_dbg(CCX_DMT_708, "[W-%d: %d->%d]", i, window->visible, !window->visible);
 				window->visible = !window->visible;
 				if (window->visible)
 					dtvcc_window_update_time_show(window, dtvcc->timing);
@@ -962,7 +964,7 @@ void dtvcc_handle_TGW_ToggleWindows(dtvcc_ctx *dtvcc,
 			}
 			windows_bitmap >>= 1;
 		}
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "\n");
+		ccx_dbg(CCX_DMT_708, "\n");
 		if (screen_content_changed && !dtvcc_decoder_has_visible_windows(decoder))
 			dtvcc_screen_print(dtvcc, decoder);
 	}
@@ -970,9 +972,9 @@ void dtvcc_handle_TGW_ToggleWindows(dtvcc_ctx *dtvcc,
 
 void dtvcc_handle_DFx_DefineWindow(dtvcc_service_decoder *decoder, int window_id, unsigned char *data, struct ccx_common_timing_ctx *timing)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_DFx_DefineWindow: "
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_DFx_DefineWindow: "
 						  "W[%d], attributes: \n",
-				     window_id);
+		window_id);
 
 	dtvcc_window *window = &decoder->windows[window_id];
 
@@ -981,7 +983,7 @@ void dtvcc_handle_DFx_DefineWindow(dtvcc_service_decoder *decoder, int window_id
 		// When a decoder receives a DefineWindow command for an existing window, the
 		// command is to be ignored if the command parameters are unchanged from the
 		// previous window definition.
-		ccx_common_logging.debug_ftn(
+		ccx_dbg(
 		    CCX_DMT_708, "[CEA-708] dtvcc_handle_DFx_DefineWindow: Repeated window definition, ignored\n");
 		return;
 	}
@@ -1011,18 +1013,18 @@ void dtvcc_handle_DFx_DefineWindow(dtvcc_service_decoder *decoder, int window_id
 
 	int do_clear_window = 0;
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Visible: [%s]\n", visible ? "Yes" : "No");
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Priority: [%d]\n", priority);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Row count: [%d]\n", row_count);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Column count: [%d]\n", col_count);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Anchor point: [%d]\n", anchor_point);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Anchor vertical: [%d]\n", anchor_vertical);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Anchor horizontal: [%d]\n", anchor_horizontal);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Relative pos: [%s]\n", relative_pos ? "Yes" : "No");
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Row lock: [%s]\n", row_lock ? "Yes" : "No");
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Column lock: [%s]\n", col_lock ? "Yes" : "No");
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Pen style: [%d]\n", pen_style);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Win style: [%d]\n", win_style);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Visible: [%s]\n", visible ? "Yes" : "No");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Priority: [%d]\n", priority);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Row count: [%d]\n", row_count);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Column count: [%d]\n", col_count);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Anchor point: [%d]\n", anchor_point);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Anchor vertical: [%d]\n", anchor_vertical);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Anchor horizontal: [%d]\n", anchor_horizontal);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Relative pos: [%s]\n", relative_pos ? "Yes" : "No");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Row lock: [%s]\n", row_lock ? "Yes" : "No");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Column lock: [%s]\n", col_lock ? "Yes" : "No");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Pen style: [%d]\n", pen_style);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Win style: [%d]\n", win_style);
 
 	/**
 	 * Korean samples have "anchor_vertical" and "anchor_horizontal" mixed up,
@@ -1152,7 +1154,7 @@ void dtvcc_handle_DFx_DefineWindow(dtvcc_service_decoder *decoder, int window_id
 
 void dtvcc_handle_SWA_SetWindowAttributes(dtvcc_service_decoder *decoder, unsigned char *data)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_SWA_SetWindowAttributes: attributes: \n");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_SWA_SetWindowAttributes: attributes: \n");
 
 	int fill_color = (data[1]) & 0x3f;
 	int fill_opacity = (data[1] >> 6) & 0x03;
@@ -1167,12 +1169,12 @@ void dtvcc_handle_SWA_SetWindowAttributes(dtvcc_service_decoder *decoder, unsign
 	int effect_dir = (data[4] >> 2) & 0x03;
 	int effect_speed = (data[4] >> 4) & 0x0f;
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "       Fill color: [%d]     Fill opacity: [%d]    Border color: [%d]  Border type: [%d]\n",
-				     fill_color, fill_opacity, border_color, border_type01);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "          Justify: [%d]       Scroll dir: [%d]       Print dir: [%d]    Word wrap: [%d]\n",
-				     justify, scroll_dir, print_dir, word_wrap);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "      Border type: [%d]      Display eff: [%d]      Effect dir: [%d] Effect speed: [%d]\n",
-				     border_type, display_eff, effect_dir, effect_speed);
+	ccx_dbg(CCX_DMT_708, "       Fill color: [%d]     Fill opacity: [%d]    Border color: [%d]  Border type: [%d]\n",
+		fill_color, fill_opacity, border_color, border_type01);
+	ccx_dbg(CCX_DMT_708, "          Justify: [%d]       Scroll dir: [%d]       Print dir: [%d]    Word wrap: [%d]\n",
+		justify, scroll_dir, print_dir, word_wrap);
+	ccx_dbg(CCX_DMT_708, "      Border type: [%d]      Display eff: [%d]      Effect dir: [%d] Effect speed: [%d]\n",
+		border_type, display_eff, effect_dir, effect_speed);
 
 	if (decoder->current_window == -1)
 	{
@@ -1200,13 +1202,13 @@ void dtvcc_handle_DLW_DeleteWindows(dtvcc_ctx *dtvcc,
 				    dtvcc_service_decoder *decoder,
 				    int windows_bitmap)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_DLW_DeleteWindows: windows: ");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_DLW_DeleteWindows: windows: ");
 
 	int screen_content_changed = 0, window_had_content = 0;
 	// int current_win_deleted = 0; /* currently unused */
 
 	if (windows_bitmap == 0)
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "none\n");
+		ccx_dbg(CCX_DMT_708, "none\n");
 	else
 	{
 		for (int i = 0; i < CCX_DTVCC_MAX_WINDOWS; i++)
@@ -1214,7 +1216,7 @@ void dtvcc_handle_DLW_DeleteWindows(dtvcc_ctx *dtvcc,
 			if (windows_bitmap & 1)
 			{
 				dtvcc_window *window = &decoder->windows[i];
-				ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Deleting [W-%d]\n", i);
+				ccx_dbg(CCX_DMT_708, "[CEA-708] Deleting [W-%d]\n", i);
 				window_had_content = window->is_defined && window->visible && !window->is_empty;
 				if (window_had_content)
 				{
@@ -1241,14 +1243,14 @@ void dtvcc_handle_DLW_DeleteWindows(dtvcc_ctx *dtvcc,
 			windows_bitmap >>= 1;
 		}
 	}
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "\n");
+	ccx_dbg(CCX_DMT_708, "\n");
 	if (screen_content_changed && !dtvcc_decoder_has_visible_windows(decoder))
 		dtvcc_screen_print(dtvcc, decoder);
 }
 
 void dtvcc_handle_SPA_SetPenAttributes(dtvcc_service_decoder *decoder, unsigned char *data)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_SPA_SetPenAttributes: attributes: \n");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_SPA_SetPenAttributes: attributes: \n");
 
 	int pen_size = (data[1]) & 0x3;
 	int offset = (data[1] >> 2) & 0x3;
@@ -1258,10 +1260,10 @@ void dtvcc_handle_SPA_SetPenAttributes(dtvcc_service_decoder *decoder, unsigned
 	int underline = (data[2] >> 6) & 0x1;
 	int italic = (data[2] >> 7) & 0x1;
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "       Pen size: [%d]     Offset: [%d]  Text tag: [%d]   Font tag: [%d]\n",
-				     pen_size, offset, text_tag, font_tag);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "      Edge type: [%d]  Underline: [%d]    Italic: [%d]\n",
-				     edge_type, underline, italic);
+	ccx_dbg(CCX_DMT_708, "       Pen size: [%d]     Offset: [%d]  Text tag: [%d]   Font tag: [%d]\n",
+		pen_size, offset, text_tag, font_tag);
+	ccx_dbg(CCX_DMT_708, "      Edge type: [%d]  Underline: [%d]    Italic: [%d]\n",
+		edge_type, underline, italic);
 
 	if (decoder->current_window == -1)
 	{
@@ -1292,7 +1294,7 @@ void dtvcc_handle_SPA_SetPenAttributes(dtvcc_service_decoder *decoder, unsigned
 
 void dtvcc_handle_SPC_SetPenColor(dtvcc_service_decoder *decoder, unsigned char *data)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_SPC_SetPenColor: attributes: \n");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_SPC_SetPenColor: attributes: \n");
 
 	int fg_color = (data[1]) & 0x3f;
 	int fg_opacity = (data[1] >> 6) & 0x03;
@@ -1300,12 +1302,12 @@ void dtvcc_handle_SPC_SetPenColor(dtvcc_service_decoder *decoder, unsigned char
 	int bg_opacity = (data[2] >> 6) & 0x03;
 	int edge_color = (data[3]) & 0x3f;
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "      Foreground color: [%d]     Foreground opacity: [%d]\n",
-				     fg_color, fg_opacity);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "      Background color: [%d]     Background opacity: [%d]\n",
-				     bg_color, bg_opacity);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "            Edge color: [%d]\n",
-				     edge_color);
+	ccx_dbg(CCX_DMT_708, "      Foreground color: [%d]     Foreground opacity: [%d]\n",
+		fg_color, fg_opacity);
+	ccx_dbg(CCX_DMT_708, "      Background color: [%d]     Background opacity: [%d]\n",
+		bg_color, bg_opacity);
+	ccx_dbg(CCX_DMT_708, "            Edge color: [%d]\n",
+		edge_color);
 
 	if (decoder->current_window == -1)
 	{
@@ -1334,12 +1336,12 @@ void dtvcc_handle_SPC_SetPenColor(dtvcc_service_decoder *decoder, unsigned char
 
 void dtvcc_handle_SPL_SetPenLocation(dtvcc_service_decoder *decoder, unsigned char *data)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_SPL_SetPenLocation: attributes: \n");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_SPL_SetPenLocation: attributes: \n");
 
 	int row = data[1] & 0x0f;
 	int col = data[2] & 0x3f;
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "      row: [%d]     Column: [%d]\n", row, col);
+	ccx_dbg(CCX_DMT_708, "      row: [%d]     Column: [%d]\n", row, col);
 
 	if (decoder->current_window == -1)
 	{
@@ -1370,16 +1372,16 @@ void dtvcc_handle_RST_Reset(dtvcc_service_decoder *decoder)
 
 void dtvcc_handle_DLY_Delay(dtvcc_service_decoder *decoder, int tenths_of_sec)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_DLY_Delay: "
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_DLY_Delay: "
 						  "delay for [%d] tenths of second",
-				     tenths_of_sec);
+		tenths_of_sec);
 	// TODO: Probably ask for the current FTS and wait for this time before resuming - not sure it's worth it though
 	// TODO: No, seems to me that idea above will not work
 }
 
 void dtvcc_handle_DLC_DelayCancel(dtvcc_service_decoder *decoder)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_DLC_DelayCancel");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_DLC_DelayCancel");
 	// TODO: See above
 }
 
@@ -1403,7 +1405,7 @@ void dtvcc_handle_C0_P16(dtvcc_service_decoder *decoder, unsigned char *data) //
 		CCX_DTVCC_SYM_SET(sym, data[1]);
 	}
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_C0_P16: [%04X]\n", sym.sym);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_C0_P16: [%04X]\n", sym.sym);
 	dtvcc_process_character(decoder, sym);
 }
 
@@ -1417,7 +1419,7 @@ int dtvcc_handle_G0(dtvcc_service_decoder *decoder, unsigned char *data, int dat
 	}
 
 	unsigned char c = data[0];
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] G0: [%02X]  (%c)\n", c, c);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] G0: [%02X]  (%c)\n", c, c);
 	dtvcc_symbol sym;
 	if (c == 0x7F)
 	{ // musical note replaces the Delete command code in ASCII
@@ -1435,7 +1437,7 @@ int dtvcc_handle_G0(dtvcc_service_decoder *decoder, unsigned char *data, int dat
 // G1 Code Set - ISO 8859-1 LATIN-1 Character Set
 int dtvcc_handle_G1(dtvcc_service_decoder *decoder, unsigned char *data, int data_length)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] G1: [%02X]  (%c)\n", data[0], data[0]);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] G1: [%02X]  (%c)\n", data[0], data[0]);
 	unsigned char c = dtvcc_get_internal_from_G1(data[0]);
 	dtvcc_symbol sym;
 	CCX_DTVCC_SYM_SET(sym, c);
@@ -1453,7 +1455,7 @@ int dtvcc_handle_C0(dtvcc_ctx *dtvcc,
 	if (name == NULL)
 		name = "Reserved";
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] C0: [%02X]  (%d)   [%s]\n", c0, data_length, name);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] C0: [%02X]  (%d)   [%s]\n", c0, data_length, name);
 
 	int len = -1;
 	// These commands have a known length even if they are reserved.
@@ -1499,20 +1501,20 @@ int dtvcc_handle_C0(dtvcc_ctx *dtvcc,
 			if (data_length >= 3)
 				dtvcc_handle_C0_P16(decoder, data + 1);
 			else
-				ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_C0: Not enough data for P16\n");
+				ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_C0: Not enough data for P16\n");
 		}
 		len = 3;
 	}
 	if (len == -1)
 	{
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_C0: impossible len == -1");
+		ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_C0: impossible len == -1");
 		return -1;
 	}
 	if (len > data_length)
 	{
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_handle_C0: "
+		ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_handle_C0: "
 							  "command is %d bytes long but we only have %d\n",
-					     len, data_length);
+			len, data_length);
 		return -1;
 	}
 	return len;
@@ -1525,13 +1527,13 @@ int dtvcc_handle_C1(dtvcc_ctx *dtvcc,
 		    int data_length)
 {
 	struct DTVCC_S_COMMANDS_C1 com = DTVCC_COMMANDS_C1[data[0] - 0x80];
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] C1: %s | [%02X]  [%s] [%s] (%d)\n",
-				     print_mstime_static(get_fts(dtvcc->timing, 3)),
-				     data[0], com.name, com.description, com.length);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] C1: %s | [%02X]  [%s] [%s] (%d)\n",
+		print_mstime_static(get_fts(dtvcc->timing, 3)),
+		data[0], com.name, com.description, com.length);
 
 	if (com.length > data_length)
 	{
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] C1: Warning: Not enough bytes for command.\n");
+		ccx_dbg(CCX_DMT_708, "[CEA-708] C1: Warning: Not enough bytes for command.\n");
 		return -1;
 	}
 
@@ -1584,7 +1586,7 @@ int dtvcc_handle_C1(dtvcc_ctx *dtvcc,
 		case DTVCC_C1_RSV94:
 		case DTVCC_C1_RSV95:
 		case DTVCC_C1_RSV96:
-			ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Warning, found Reserved codes, ignored.\n");
+			ccx_dbg(CCX_DMT_708, "[CEA-708] Warning, found Reserved codes, ignored.\n");
 			break;
 		case DTVCC_C1_SWA:
 			dtvcc_handle_SWA_SetWindowAttributes(decoder, data);
@@ -1651,9 +1653,9 @@ int dtvcc_handle_C3(dtvcc_service_decoder *decoder, unsigned char *data, int dat
 int dtvcc_handle_extended_char(dtvcc_service_decoder *decoder, unsigned char *data, int data_length)
 {
 	int used;
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] In dtvcc_handle_extended_char, "
+	ccx_dbg(CCX_DMT_708, "[CEA-708] In dtvcc_handle_extended_char, "
 						  "first data code: [%c], length: [%u]\n",
-				     data[0], data_length);
+		data[0], data_length);
 	if (data_length < 1)
 		return 0;
 
@@ -1716,7 +1718,7 @@ void dtvcc_process_service_block(dtvcc_ctx *dtvcc,
 
 			if (used == -1)
 			{
-				ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_service_block: "
+				ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_service_block: "
 									  "There was a problem handling the data. Reseting service decoder\n");
 				// TODO: Not sure if a local reset is going to be helpful here.
 				// dtvcc_windows_reset(decoder);
@@ -1763,9 +1765,9 @@ void dtvcc_process_current_packet(dtvcc_ctx *dtvcc, int len)
 	if (dtvcc->last_sequence != CCX_DTVCC_NO_LAST_SEQUENCE &&
 	    (dtvcc->last_sequence + 1) % 4 != seq)
 	{
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet: "
+		ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet: "
 							  "Unexpected sequence number, it is [%d] but should be [%d]\n",
-					     seq, (dtvcc->last_sequence + 1) % 4);
+			seq, (dtvcc->last_sequence + 1) % 4);
 		// WARN: if we reset decoders here, buffer will not be written
 		// WARN: resetting decoders breaks some samples
 		// dtvcc_decoders_reset(dtvcc);
@@ -1780,7 +1782,7 @@ void dtvcc_process_current_packet(dtvcc_ctx *dtvcc, int len)
 		int service_number = (pos[0] & 0xE0) >> 5; // 3 more significant bits
 		int block_length = (pos[0] & 0x1F);	   // 5 less significant bits
 
-		ccx_common_logging.debug_ftn(
+		ccx_dbg(
 		    CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet: Standard header: "
 				 "Service number: [%d] Block length: [%d]\n",
 		    service_number, block_length);
@@ -1789,7 +1791,7 @@ void dtvcc_process_current_packet(dtvcc_ctx *dtvcc, int len)
 		{
 			if (pos + 1 >= dtvcc->current_packet + len)
 			{
-				ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet: "
+				ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet: "
 									  "Truncated extended header, stopping.\n");
 				break;
 			}
@@ -1798,7 +1800,7 @@ void dtvcc_process_current_packet(dtvcc_ctx *dtvcc, int len)
 			// printf ("Extended header: Service number: [%d]\n",service_number);
 			if (service_number < 7)
 			{
-				ccx_common_logging.debug_ftn(
+				ccx_dbg(
 				    CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet: "
 						 "Illegal service number in extended header: [%d]\n",
 				    service_number);
@@ -1818,7 +1820,7 @@ void dtvcc_process_current_packet(dtvcc_ctx *dtvcc, int len)
 		pos++;					      // Move to service data
 		if (service_number == 0 && block_length != 0) // Illegal, but specs say what to do...
 		{
-			ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet: "
+			ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet: "
 								  "Data received for service 0, skipping rest of packet.");
 			pos = dtvcc->current_packet + len; // Move to end
 			break;
@@ -1839,14 +1841,14 @@ void dtvcc_process_current_packet(dtvcc_ctx *dtvcc, int len)
 
 	if (pos != dtvcc->current_packet + len) // For some reason we didn't parse the whole packet
 	{
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet:"
+		ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet:"
 							  " There was a problem with this packet, reseting\n");
 		dtvcc_decoders_reset(dtvcc);
 	}
 
 	if (len < 128 && *pos) // Null header is mandatory if there is room
 	{
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet: "
+		ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_current_packet: "
 							  "Warning: Null header expected but not found.\n");
 	}
 }
@@ -47,8 +47,8 @@ void dtvcc_color_to_hex(int color, unsigned *hR, unsigned *hG, unsigned *hB)
 	*hR = (unsigned)(color >> 4);
 	*hG = (unsigned)((color >> 2) & 0x3);
 	*hB = (unsigned)(color & 0x3);
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] Color: %d [%06x] %u %u %u\n",
-				     color, color, *hR, *hG, *hB);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] Color: %d [%06x] %u %u %u\n",
+		color, color, *hR, *hG, *hB);
 }
 
 void dtvcc_change_pen_colors(dtvcc_tv_screen *tv, dtvcc_pen_color pen_color, int row_index, int column_index, struct encoder_ctx *encoder, size_t *buf_len, int open)
@@ -278,7 +278,7 @@ void dtvcc_write_debug(dtvcc_tv_screen *tv)
 	print_mstime_buff(tv->time_ms_show, "%02u:%02u:%02u:%03u", tbuf1);
 	print_mstime_buff(tv->time_ms_hide, "%02u:%02u:%02u:%03u", tbuf2);
 
-	ccx_common_logging.debug_ftn(CCX_DMT_GENERIC_NOTICES, "\r%s --> %s\n", tbuf1, tbuf2);
+	ccx_dbg(CCX_DMT_GENERIC_NOTICES, "\r%s --> %s\n", tbuf1, tbuf2);
 	for (int i = 0; i < CCX_DTVCC_SCREENGRID_ROWS; i++)
 	{
 		if (!dtvcc_is_row_empty(tv, i))
@@ -286,8 +286,8 @@ void dtvcc_write_debug(dtvcc_tv_screen *tv)
 			int first, last;
 			dtvcc_get_write_interval(tv, i, &first, &last);
 			for (int j = first; j <= last; j++)
-				ccx_common_logging.debug_ftn(CCX_DMT_GENERIC_NOTICES, "%c", tv->chars[i][j]);
-			ccx_common_logging.debug_ftn(CCX_DMT_GENERIC_NOTICES, "\n");
+				ccx_dbg(CCX_DMT_GENERIC_NOTICES, "%c", tv->chars[i][j]);
+			ccx_dbg(CCX_DMT_GENERIC_NOTICES, "\n");
 		}
 	}
 }
@@ -653,7 +653,7 @@ void dtvcc_write_done(dtvcc_tv_screen *tv, struct encoder_ctx *encoder)
 			dtvcc_write_sami_footer(tv, encoder);
 			break;
 		default:
-			ccx_common_logging.debug_ftn(
+			ccx_dbg(
 			    CCX_DMT_708, "[CEA-708] dtvcc_write_done: no handling required\n");
 			break;
 	}
@@ -666,7 +666,7 @@ void dtvcc_writer_init(dtvcc_writer_ctx *writer,
 		       enum ccx_output_format write_format,
 		       struct encoder_cfg *cfg)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_writer_init\n");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_writer_init\n");
 	writer->fd = -1;
 	writer->cd = (iconv_t)-1;
 	if ((write_format == CCX_OF_NULL) || (write_format == CCX_OF_MCC))
@@ -675,9 +675,9 @@ void dtvcc_writer_init(dtvcc_writer_ctx *writer,
 		return;
 	}
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_writer_init: "
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_writer_init: "
 						  "[%s][%d][%d]\n",
-				     base_filename, program_number, service_number);
+		base_filename, program_number, service_number);
 
 	const char *ext = get_file_extension(write_format);
 	char suffix[32];
@@ -688,7 +688,7 @@ void dtvcc_writer_init(dtvcc_writer_ctx *writer,
 		ccx_common_logging.fatal_ftn(
 		    EXIT_NOT_ENOUGH_MEMORY, "[CEA-708] dtvcc_decoder_init_write: not enough memory");
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_writer_init: inited [%s]\n", writer->filename);
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_writer_init: inited [%s]\n", writer->filename);
 
 	char *charset = cfg->all_services_charset ? cfg->all_services_charset : cfg->services_charsets[service_number - 1];
 
@@ -726,18 +726,18 @@ void dtvcc_writer_cleanup(dtvcc_writer_ctx *writer)
 
 void dtvcc_writer_output(dtvcc_writer_ctx *writer, dtvcc_service_decoder *decoder, struct encoder_ctx *encoder)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_writer_output: "
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_writer_output: "
 						  "writing... [%s][%d]\n",
-				     writer->filename, writer->fd);
+		writer->filename, writer->fd);
 
 	if (!writer->filename && writer->fd < 0)
 		return;
 
 	if (writer->filename && writer->fd < 0) // first request to write
 	{
-		ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] "
+		ccx_dbg(CCX_DMT_708, "[CEA-708] "
 							  "dtvcc_writer_output: creating %s\n",
-					     writer->filename);
+			writer->filename);
 		writer->fd = open(writer->filename, O_RDWR | O_CREAT | O_TRUNC | O_BINARY, S_IREAD | S_IWRITE);
 		if (writer->fd == -1)
 		{
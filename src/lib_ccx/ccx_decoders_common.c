@@ -29,7 +29,7 @@ LLONG ccxr_get_visible_end(struct ccx_common_timing_ctx *ctx, int current_field)
 LLONG get_visible_start(struct ccx_common_timing_ctx *ctx, int current_field)
 {
 	LLONG fts = ccxr_get_visible_start(ctx, current_field);
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "Visible Start time=%s\n", print_mstime_static(fts));
+	ccx_dbg(CCX_DMT_DECODER_608, "Visible Start time=%s\n", print_mstime_static(fts));
 	return fts;
 }
 
@@ -37,7 +37,7 @@ LLONG get_visible_start(struct ccx_common_timing_ctx *ctx, int current_field)
 LLONG get_visible_end(struct ccx_common_timing_ctx *ctx, int current_field)
 {
 	LLONG fts = ccxr_get_visible_end(ctx, current_field);
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_608, "Visible End time=%s\n", print_mstime_static(fts));
+	ccx_dbg(CCX_DMT_DECODER_608, "Visible End time=%s\n", print_mstime_static(fts));
 	return fts;
 }
 
@@ -234,6 +234,7 @@ void dinit_cc_decode(struct lib_cc_decode **ctx)
 	ccx_decoder_608_dinit_library(&lctx->context_cc608_field_1);
 	ccx_decoder_608_dinit_library(&lctx->context_cc608_field_2);
 	dinit_timing_ctx(&lctx->timing);
+	freep(&lctx->timing_globals);
 	free_decoder_context(lctx->prev);
 	free_subtitle(lctx->dec_sub.prev);
 	/* Free the embedded dec_sub's data field (allocated by write_cc_buffer) */
@@ -281,11 +282,13 @@ struct lib_cc_decode *init_cc_decode(struct ccx_decoders_common_settings_t *sett
 	ctx->xds_ctx = NULL;
 	ctx->vbi_decoder = NULL;
 	ctx->prev = NULL;
+	ctx->timing_globals = NULL;
 	memset(&ctx->dec_sub, 0, sizeof(ctx->dec_sub));
 
 	ctx->avc_ctx = init_avc();
 	if (!ctx->avc_ctx)
 		fatal(EXIT_NOT_ENOUGH_MEMORY, "In init_cc_decode: Out of memory initializing avc_ctx.");
+	ctx->avc_ctx->fast_scan = setting->fast_avc_scan;
 
 	ctx->codec = setting->codec;
 	ctx->timing = init_timing_ctx(&ccx_common_timing_settings);
@@ -445,22 +448,41 @@ struct lib_cc_decode *init_cc_decode(struct ccx_decoders_common_settings_t *sett
 	return ctx;
 }
 
+static int is_608_screen_format(enum ccx_output_format format)
+{
+	return format == CCX_OF_CCD ||
+	       format == CCX_OF_SCC ||
+	       format == CCX_OF_SMPTETT ||
+	       format == CCX_OF_SAMI ||
+	       format == CCX_OF_SRT ||
+	       format == CCX_OF_TRANSCRIPT ||
+	       format == CCX_OF_WEBVTT ||
+	       format == CCX_OF_SPUPNG ||
+	       format == CCX_OF_SSA ||
+	       format == CCX_OF_MCC;
+}
+
+/* Whether one of the formats written (-out=g608,srt: not only the first)
+   needs the last screen the 608 decoder still holds */
+static int writes_608_screens(struct lib_cc_decode *ctx)
+{
+	if (is_608_screen_format(ctx->write_format))
+		return 1;
+	for (int i = 0; i < ccx_options.enc_cfg.nb_extra_write_formats; i++)
+	{
+		if (is_608_screen_format(ccx_options.enc_cfg.extra_write_formats[i]))
+			return 1;
+	}
+	return 0;
+}
+
 void flush_cc_decode(struct lib_cc_decode *ctx, struct cc_subtitle *sub)
 {
 	if (ctx->codec == CCX_CODEC_ATSC_CC)
 	{
 		if (ctx->extract != 2)
 		{
-			if (ctx->write_format == CCX_OF_CCD ||
-			    ctx->write_format == CCX_OF_SCC ||
-			    ctx->write_format == CCX_OF_SMPTETT ||
-			    ctx->write_format == CCX_OF_SAMI ||
-			    ctx->write_format == CCX_OF_SRT ||
-			    ctx->write_format == CCX_OF_TRANSCRIPT ||
-			    ctx->write_format == CCX_OF_WEBVTT ||
-			    ctx->write_format == CCX_OF_SPUPNG ||
-			    ctx->write_format == CCX_OF_SSA ||
-			    ctx->write_format == CCX_OF_MCC)
+			if (writes_608_screens(ctx))
 			{
 				flush_608_context(ctx->context_cc608_field_1, sub);
 			}
@@ -472,17 +494,7 @@ void flush_cc_decode(struct lib_cc_decode *ctx, struct cc_subtitle *sub)
 		}
 		if (ctx->extract != 1)
 		{
-			// TODO: Use a function to prevent repeating these lines
-			if (ctx->write_format == CCX_OF_CCD ||
-			    ctx->write_format == CCX_OF_SCC ||
-			    ctx->write_format == CCX_OF_SMPTETT ||
-			    ctx->write_format == CCX_OF_SAMI ||
-			    ctx->write_format == CCX_OF_SRT ||
-			    ctx->write_format == CCX_OF_TRANSCRIPT ||
-			    ctx->write_format == CCX_OF_WEBVTT ||
-			    ctx->write_format == CCX_OF_SPUPNG ||
-			    ctx->write_format == CCX_OF_SSA ||
-			    ctx->write_format == CCX_OF_MCC)
+			if (writes_608_screens(ctx))
 			{
 				flush_608_context(ctx->context_cc608_field_2, sub);
 			}
@@ -530,6 +542,7 @@ struct encoder_ctx *copy_encoder_context(struct encoder_ctx *ctx)
 	ctx_copy->end_credits_text = NULL;
 	ctx_copy->prev = NULL;
 	ctx_copy->last_string = NULL;
+	// next_format stays shared: the copy writes the other output formats through the same encoders
 
 	if (ctx->buffer)
 	{
@@ -128,6 +128,7 @@ struct ccx_decoders_common_settings_t
 	int xds_write_to_file;
 	void *private_data;
 	int ocr_quantmode;
+	int fast_avc_scan; // Cleared by general_loop() for elementary streams, see avc_ctx.fast_scan
 };
 
 struct lib_cc_decode
@@ -164,6 +165,7 @@ struct lib_cc_decode
 	int program_number;
 	struct list_head list;
 	struct ccx_common_timing_ctx *timing;
+	struct ccx_timing_globals *timing_globals; // --jobs program worker: this program's timing globals while another one is decoded, NULL otherwise
 	enum ccx_code_type codec;
 	// Set to true if data is buffered
 	int has_ccdata_buffered;
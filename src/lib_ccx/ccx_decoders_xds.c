@@ -246,8 +246,8 @@ void process_xds_bytes(struct ccx_decoders_xds_context *ctx, const unsigned char
 	{
 		int xds_class = (hi - 1) / 2; // Start codes 1 and 2 are "class type" 0, 3-4 are 2, and so on.
 		is_new = hi % 2;	      // Start codes are even
-		ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "XDS Start: %u.%u  Is new: %d  | Class: %d (%s), Used buffers: %d\n",
-					     hi, lo, is_new, xds_class, XDSclasses[xds_class], how_many_used(ctx));
+		ccx_dbg(CCX_DMT_DECODER_XDS, "XDS Start: %u.%u  Is new: %d  | Class: %d (%s), Used buffers: %d\n",
+			hi, lo, is_new, xds_class, XDSclasses[xds_class], how_many_used(ctx));
 		int first_free_buf = -1;
 		int matching_buf = -1;
 		for (int i = 0; i < NUM_XDS_BUFFERS; i++)
@@ -293,7 +293,7 @@ void process_xds_bytes(struct ccx_decoders_xds_context *ctx, const unsigned char
 	else
 	{
 		// Informational: 00, or 0x20-0x7F, so 01-0x1f forbidden
-		ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "XDS: %02X.%02X (%c, %c)\n", hi, lo, hi, lo);
+		ccx_dbg(CCX_DMT_DECODER_XDS, "XDS: %02X.%02X (%c, %c)\n", hi, lo, hi, lo);
 		if ((hi > 0 && hi <= 0x1f) || (lo > 0 && lo <= 0x1f))
 		{
 			ccx_common_logging.log_ftn("\rNote: Illegal XDS data");
@@ -363,9 +363,9 @@ void xds_do_copy_generation_management_system(struct cc_subtitle *sub, struct cc
 		ccx_common_logging.log_ftn("\rXDS: %s\n", aps);
 		ccx_common_logging.log_ftn("\rXDS: %s\n", rcd);
 	}
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", copy_permited);
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", aps);
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", rcd);
+	ccx_dbg(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", copy_permited);
+	ccx_dbg(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", aps);
+	ccx_dbg(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", rcd);
 }
 
 void xds_do_content_advisory(struct cc_subtitle *sub, struct ccx_decoders_xds_context *ctx, unsigned c1, unsigned c2)
@@ -480,9 +480,9 @@ void xds_do_content_advisory(struct cc_subtitle *sub, struct ccx_decoders_xds_co
 			if (content[0])
 				ccx_common_logging.log_ftn("\rXDS: %s\n  ", content);
 		}
-		ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", age);
+		ccx_dbg(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", age);
 		if (content[0])
-			ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", content);
+			ccx_dbg(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", content);
 	}
 	if (!a0 ||			  // MPA
 	    (a0 && a1 && !Da2 && !La3) || // Canadian English Language Rating
@@ -492,7 +492,7 @@ void xds_do_content_advisory(struct cc_subtitle *sub, struct ccx_decoders_xds_co
 		xdsprint(sub, ctx, rating);
 		if (changed)
 			ccx_common_logging.log_ftn("\rXDS: %s\n  ", rating);
-		ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", rating);
+		ccx_dbg(CCX_DMT_DECODER_XDS, "\rXDS: %s\n", rating);
 	}
 
 	if (changed && !supported)
@@ -541,9 +541,9 @@ int xds_do_current_and_future(struct cc_subtitle *sub, struct ccx_decoders_xds_c
 				ctx->current_xds_month = month;
 			}
 
-			ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "PIN (Start Time): %s  %02d-%02d %02d:%02d\n",
-						     (ctx->cur_xds_packet_class == XDS_CLASS_CURRENT ? "Current" : "Future"),
-						     date, month, hour, min);
+			ccx_dbg(CCX_DMT_DECODER_XDS, "PIN (Start Time): %s  %02d-%02d %02d:%02d\n",
+				(ctx->cur_xds_packet_class == XDS_CLASS_CURRENT ? "Current" : "Future"),
+				date, month, hour, min);
 			xdsprint(sub, ctx, "PIN (Start Time): %s  %02d-%02d %02d:%02d\n",
 				 (ctx->cur_xds_packet_class == XDS_CLASS_CURRENT ? "Current" : "Future"),
 				 date, month, hour, min);
@@ -567,7 +567,7 @@ int xds_do_current_and_future(struct cc_subtitle *sub, struct ccx_decoders_xds_c
 			if (!ctx->xds_program_length_shown)
 				ccx_common_logging.log_ftn("\rXDS: Program length (HH:MM): %02d:%02d  ", hour, min);
 			else
-				ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\rXDS: Program length (HH:MM): %02d:%02d  ", hour, min);
+				ccx_dbg(CCX_DMT_DECODER_XDS, "\rXDS: Program length (HH:MM): %02d:%02d  ", hour, min);
 
 			xdsprint(sub, ctx, "Program length (HH:MM): %02d:%02d  ", hour, min);
 
@@ -578,20 +578,20 @@ int xds_do_current_and_future(struct cc_subtitle *sub, struct ccx_decoders_xds_c
 				if (!ctx->xds_program_length_shown)
 					ccx_common_logging.log_ftn("Elapsed (HH:MM): %02d:%02d", el_hour, el_min);
 				else
-					ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "Elapsed (HH:MM): %02d:%02d", el_hour, el_min);
+					ccx_dbg(CCX_DMT_DECODER_XDS, "Elapsed (HH:MM): %02d:%02d", el_hour, el_min);
 				xdsprint(sub, ctx, "Elapsed (HH:MM): %02d:%02d", el_hour, el_min);
 			}
 			if (ctx->cur_xds_payload_length > 8) // Next two bytes (optional) available
 			{
 				int el_sec = ctx->cur_xds_payload[6] & 0x3f; // 6 bits
 				if (!ctx->xds_program_length_shown)
-					ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, ":%02d", el_sec);
+					ccx_dbg(CCX_DMT_DECODER_XDS, ":%02d", el_sec);
 				xdsprint(sub, ctx, "Elapsed (SS) :%02d", el_sec);
 			}
 			if (!ctx->xds_program_length_shown)
 				ccx_common_logging.log_ftn("\n");
 			else
-				ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\n");
+				ccx_dbg(CCX_DMT_DECODER_XDS, "\n");
 			ctx->xds_program_length_shown = 1;
 		}
 		break;
@@ -603,7 +603,7 @@ int xds_do_current_and_future(struct cc_subtitle *sub, struct ccx_decoders_xds_c
 			for (i = 2; i < ctx->cur_xds_payload_length - 1; i++)
 				xds_program_name[i - 2] = ctx->cur_xds_payload[i];
 			xds_program_name[i - 2] = 0;
-			ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\rXDS Program name: %s\n", xds_program_name);
+			ccx_dbg(CCX_DMT_DECODER_XDS, "\rXDS Program name: %s\n", xds_program_name);
 			xdsprint(sub, ctx, "Program name: %s", xds_program_name);
 			if (ctx->cur_xds_packet_class == XDS_CLASS_CURRENT &&
 			    strcmp(xds_program_name, ctx->current_xds_program_name)) // Change of program
@@ -706,8 +706,8 @@ int xds_do_current_and_future(struct cc_subtitle *sub, struct ccx_decoders_xds_c
 			}
 			else
 			{
-				ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\rXDS Notice: Aspect ratio info, start line=%u, end line=%u\n", ar_start, ar_end);
-				ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\rXDS Notice: Aspect ratio info, active picture height=%u, ratio=%f\n", active_picture_height, aspect_ratio);
+				ccx_dbg(CCX_DMT_DECODER_XDS, "\rXDS Notice: Aspect ratio info, start line=%u, end line=%u\n", ar_start, ar_end);
+				ccx_dbg(CCX_DMT_DECODER_XDS, "\rXDS Notice: Aspect ratio info, active picture height=%u, ratio=%f\n", active_picture_height, aspect_ratio);
 			}
 		}
 		break;
@@ -741,7 +741,7 @@ int xds_do_current_and_future(struct cc_subtitle *sub, struct ccx_decoders_xds_c
 				}
 				else
 				{
-					ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "\rXDS description line %d: %s\n", line_num, xds_desc);
+					ccx_dbg(CCX_DMT_DECODER_XDS, "\rXDS description line %d: %s\n", line_num, xds_desc);
 				}
 				xdsprint(sub, ctx, "XDS description line %d: %s", line_num, xds_desc);
 				ccx_common_logging.gui_ftn(CCX_COMMON_LOGGING_GUI_XDS_PROGRAM_DESCRIPTION, line_num, xds_desc);
@@ -769,7 +769,7 @@ int xds_do_channel(struct cc_subtitle *sub, struct ccx_decoders_xds_context *ctx
 			for (i = 2; i < ctx->cur_xds_payload_length - 1; i++)
 				xds_network_name[i - 2] = ctx->cur_xds_payload[i];
 			xds_network_name[i - 2] = 0;
-			ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "XDS Network name: %s\n", xds_network_name);
+			ccx_dbg(CCX_DMT_DECODER_XDS, "XDS Network name: %s\n", xds_network_name);
 			xdsprint(sub, ctx, "Network: %s", xds_network_name);
 			if (strcmp(xds_network_name, ctx->current_xds_network_name)) // Change of station
 			{
@@ -790,7 +790,7 @@ int xds_do_channel(struct cc_subtitle *sub, struct ccx_decoders_xds_context *ctx
 					xds_call_letters[i - 2] = ctx->cur_xds_payload[i];
 			}
 			xds_call_letters[i - 2] = 0;
-			ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "XDS Network call letters: %s\n", xds_call_letters);
+			ccx_dbg(CCX_DMT_DECODER_XDS, "XDS Network call letters: %s\n", xds_call_letters);
 			xdsprint(sub, ctx, "Call Letters: %s", xds_call_letters);
 			if (strncmp(xds_call_letters, ctx->current_xds_call_letters, 7)) // Change of station
 			{
@@ -865,8 +865,8 @@ int xds_do_misc(struct ccx_decoders_xds_context *ctx)
 			int reset_seconds = (ctx->cur_xds_payload[5] & 0x20);
 			int day_of_week = ctx->cur_xds_payload[6] & 0x7;
 			int year = (ctx->cur_xds_payload[7] & 0x3f) + 1990;
-			ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "Time of day: (YYYY/MM/DD) %04d/%02d/%02d (HH:SS) %02d:%02d DoW: %d  Reset seconds: %d\n",
-						     year, month, date, hour, min, day_of_week, reset_seconds);
+			ccx_dbg(CCX_DMT_DECODER_XDS, "Time of day: (YYYY/MM/DD) %04d/%02d/%02d (HH:SS) %02d:%02d DoW: %d  Reset seconds: %d\n",
+				year, month, date, hour, min, day_of_week, reset_seconds);
 			break;
 		}
 		case XDS_TYPE_LOCAL_TIME_ZONE:
@@ -877,8 +877,8 @@ int xds_do_misc(struct ccx_decoders_xds_context *ctx)
 			// int b6 = (ctx->cur_xds_payload[2] & 0x40) >>6; // Bit 6 should always be 1
 			int dst = (ctx->cur_xds_payload[2] & 0x20) >> 5; // Daylight Saving Time
 			int hour = ctx->cur_xds_payload[2] & 0x1f;	 // 5 bits
-			ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "Local Time Zone: %02d DST: %d\n",
-						     hour, dst);
+			ccx_dbg(CCX_DMT_DECODER_XDS, "Local Time Zone: %02d DST: %d\n",
+				hour, dst);
 			break;
 		}
 		default:
@@ -910,19 +910,19 @@ void do_end_of_xds(struct cc_subtitle *sub, struct ccx_decoders_xds_context *ctx
 		cs = cs + ctx->cur_xds_payload[i];
 		cs = cs & 0x7f; // Keep 7 bits only
 		int c = ctx->cur_xds_payload[i] & 0x7F;
-		ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "%02X - %c cs: %02X\n",
-					     c, (c >= 0x20) ? c : '?', cs);
+		ccx_dbg(CCX_DMT_DECODER_XDS, "%02X - %c cs: %02X\n",
+			c, (c >= 0x20) ? c : '?', cs);
 	}
 	cs = (128 - cs) & 0x7F; // Convert to 2's complement & discard high-order bit
 
-	ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "End of XDS. Class=%d (%s), size=%d  Checksum OK: %d   Used buffers: %d\n",
-				     ctx->cur_xds_packet_class, XDSclasses[ctx->cur_xds_packet_class],
-				     ctx->cur_xds_payload_length,
-				     cs == expected_checksum, how_many_used(ctx));
+	ccx_dbg(CCX_DMT_DECODER_XDS, "End of XDS. Class=%d (%s), size=%d  Checksum OK: %d   Used buffers: %d\n",
+		ctx->cur_xds_packet_class, XDSclasses[ctx->cur_xds_packet_class],
+		ctx->cur_xds_payload_length,
+		cs == expected_checksum, how_many_used(ctx));
 
 	if (cs != expected_checksum || ctx->cur_xds_payload_length < 3)
 	{
-		ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "Expected checksum: %02X  Calculated: %02X\n", expected_checksum, cs);
+		ccx_dbg(CCX_DMT_DECODER_XDS, "Expected checksum: %02X  Calculated: %02X\n", expected_checksum, cs);
 		clear_xds_buffer(ctx, ctx->cur_xds_buffer_idx);
 		return; // Bad packets ignored as per specs
 	}
@@ -957,7 +957,7 @@ void do_end_of_xds(struct cc_subtitle *sub, struct ccx_decoders_xds_context *ctx
 			was_proc = xds_do_private_data(sub, ctx);
 			break;
 		case XDS_CLASS_OUT_OF_BAND:
-			ccx_common_logging.debug_ftn(CCX_DMT_DECODER_XDS, "Out-of-band data, ignored.");
+			ccx_dbg(CCX_DMT_DECODER_XDS, "Out-of-band data, ignored.");
 			was_proc = 1;
 			break;
 	}
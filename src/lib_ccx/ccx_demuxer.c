@@ -121,7 +121,10 @@ static int ccx_demuxer_open(struct ccx_demuxer *ctx, const char *file)
 			return -1;
 		}
 
-		ctx->infd = start_tcp_srv(ccx_options.tcpport, ccx_options.tcp_password);
+		if (ccx_options.tcp_senders > 1)
+			ctx->infd = start_tcp_senders_srv(ccx_options.tcpport, ccx_options.tcp_password, ccx_options.tcp_senders);
+		else
+			ctx->infd = start_tcp_srv(ccx_options.tcpport, ccx_options.tcp_password);
 	}
 	else
 	{
@@ -324,6 +327,7 @@ void ccx_demuxer_delete(struct ccx_demuxer **ctx)
 #endif
 
 	dinit_cap(lctx);
+	capbuf_pool_free(lctx);
 	freep(&lctx->last_pat_payload);
 	for (i = 0; i < MAX_PSI_PID; i++)
 	{
@@ -15,6 +15,8 @@
 #define TS_PMT_MAP_SIZE 128
 #define MAX_PROGRAM 128
 #define MAX_PROGRAM_NAME_LEN 128
+#define CAPBUF_POOL_SIZE 16
+#define CAPBUF_MIN_SIZE (16 * 1024)
 
 enum STREAM_TYPE
 {
@@ -79,6 +81,24 @@ struct cap_info
 	*/
 	struct list_head pg_stream;
 };
+/* What ts_readstream() learned about a PID. Packets on TS_PID_IGNORED PIDs
+   are skipped in batches without being parsed, see ts_skip_ignored_packets() */
+enum ts_pid_class
+{
+	TS_PID_UNCLASSIFIED = 0,
+	TS_PID_PSI,
+	TS_PID_CAPTION,
+	TS_PID_IGNORED
+};
+
+/* PES assembly buffers released by deleted streams, reused by new ones */
+struct capbuf_pool
+{
+	unsigned char *buf[CAPBUF_POOL_SIZE];
+	int64_t size[CAPBUF_POOL_SIZE];
+	int count;
+};
+
 struct ccx_demuxer
 {
 	int m2ts;
@@ -103,6 +123,8 @@ struct ccx_demuxer
 	enum ccx_code_type codec;
 	enum ccx_code_type nocodec;
 	struct cap_info cinfo_tree;
+	unsigned cinfo_generation; // Bumped when dinit_cap() empties cinfo_tree
+	struct capbuf_pool capbuf_pool;
 
 	/* File handles */
 	int infd;   // descriptor number to input.
@@ -129,6 +151,17 @@ struct ccx_demuxer
 	int num_of_PIDs;
 
 	struct PMT_entry *PIDs_programs[MAX_PID];
+	uint8_t pid_class[MAX_PSI_PID + 1]; // enum ts_pid_class, reset whenever streams or programs change
+
+	/* PID-indexed view of the demuxer_data list handed out by ts_readstream().
+	   Only trusted while data_index_head is the head of the list being queried. */
+	struct demuxer_data *data_index_head;
+	struct demuxer_data *data_by_pid[MAX_PSI_PID + 1];
+	/* Cached results of get_best_data() and get_best_stream(), dropped on PMT change */
+	struct demuxer_data *best_data;
+	int best_data_valid;
+	int best_stream_pid;
+	int best_stream_valid;
 	struct ccx_demux_report freport;
 
 	/* Hauppauge support */
@@ -140,6 +173,7 @@ struct ccx_demuxer
 	unsigned last_pat_length;
 
 	unsigned char *filebuffer;
+	unsigned char tspacket[188]; // TS packet straddling a file buffer refill, see ts_readpacket()
 	LLONG filebuffer_start;	     // Position of buffer start relative to file
 	unsigned int filebuffer_pos; // Position of pointer relative to buffer start
 	unsigned int bytesinbuffer;  // Number of bytes we actually have on buffer
@@ -191,11 +225,16 @@ int update_capinfo(struct ccx_demuxer *ctx, int pid, enum ccx_stream_type stream
 struct cap_info *get_cinfo(struct ccx_demuxer *ctx, int pid);
 int need_cap_info(struct ccx_demuxer *ctx, int program_number);
 int need_cap_info_for_pid(struct ccx_demuxer *ctx, int pid);
-struct demuxer_data *get_best_data(struct demuxer_data *data);
-struct demuxer_data *get_data_stream(struct demuxer_data *data, int pid);
+struct demuxer_data *get_best_data(struct ccx_demuxer *ctx, struct demuxer_data *data);
+struct demuxer_data *get_data_stream(struct ccx_demuxer *ctx, struct demuxer_data *data, int pid);
 int get_best_stream(struct ccx_demuxer *ctx);
 void ignore_other_stream(struct ccx_demuxer *ctx, int pid);
 void dinit_cap(struct ccx_demuxer *ctx);
+void reset_pid_classes(struct ccx_demuxer *ctx);
+void reset_demuxer_data_index(struct ccx_demuxer *ctx);
+int capbuf_reserve(struct ccx_demuxer *ctx, struct cap_info *cinfo, int64_t min_size);
+void capbuf_release(struct ccx_demuxer *ctx, struct cap_info *cinfo);
+void capbuf_pool_free(struct ccx_demuxer *ctx);
 int copy_capbuf_demux_data(struct ccx_demuxer *ctx, struct demuxer_data **data, struct cap_info *cinfo);
 int get_programme_number(struct ccx_demuxer *ctx, int pid);
 struct cap_info *get_best_sib_stream(struct cap_info *program);
@@ -22,12 +22,12 @@ void dtvcc_process_data(struct dtvcc_ctx *dtvcc,
 	switch (cc_type)
 	{
 		case 2:
-			ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_data: DTVCC Channel Packet Data\n");
+			ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_data: DTVCC Channel Packet Data\n");
 			if (cc_valid && dtvcc->is_current_packet_header_parsed)
 			{
 				if (dtvcc->current_packet_length + 2 > CCX_DTVCC_MAX_PACKET_LENGTH)
 				{
-					ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_data: "
+					ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_data: "
 										  "Warning: Legal packet size exceeded (1), data not added.\n");
 				}
 				else
@@ -48,19 +48,19 @@ void dtvcc_process_data(struct dtvcc_ctx *dtvcc,
 			}
 			break;
 		case 3:
-			ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_data: DTVCC Channel Packet Start\n");
+			ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_data: DTVCC Channel Packet Start\n");
 			if (cc_valid)
 			{
 				if (dtvcc->current_packet_length + 2 > CCX_DTVCC_MAX_PACKET_LENGTH)
 				{
-					ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_data: "
+					ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_data: "
 										  "Warning: Legal packet size exceeded (2), data not added.\n");
 				}
 				else
 				{
 					if (dtvcc->is_current_packet_header_parsed)
 					{
-						ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_process_data: "
+						ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_process_data: "
 											  "Warning: Incorrect packet length specified. Packet will be skipped.\n");
 						dtvcc_clear_packet(dtvcc);
 					}
@@ -81,7 +81,7 @@ void dtvcc_process_data(struct dtvcc_ctx *dtvcc,
 
 dtvcc_ctx *dtvcc_init(struct ccx_decoder_dtvcc_settings *opts)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] initializing dtvcc decoder\n");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] initializing dtvcc decoder\n");
 	dtvcc_ctx *ctx = (dtvcc_ctx *)malloc(sizeof(dtvcc_ctx));
 	if (!ctx)
 	{
@@ -105,7 +105,7 @@ dtvcc_ctx *dtvcc_init(struct ccx_decoder_dtvcc_settings *opts)
 	ctx->report_enabled = opts->print_file_reports;
 	ctx->timing = opts->timing;
 
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] initializing services\n");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] initializing services\n");
 
 	for (int i = 0; i < CCX_DTVCC_MAX_SERVICES; i++)
 	{
@@ -131,7 +131,7 @@ dtvcc_ctx *dtvcc_init(struct ccx_decoder_dtvcc_settings *opts)
 
 void dtvcc_free(dtvcc_ctx **ctx_ptr)
 {
-	ccx_common_logging.debug_ftn(CCX_DMT_708, "[CEA-708] dtvcc_free: cleaning up\n");
+	ccx_dbg(CCX_DMT_708, "[CEA-708] dtvcc_free: cleaning up\n");
 
 	dtvcc_ctx *ctx = *ctx_ptr;
 
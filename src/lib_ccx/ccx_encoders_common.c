@@ -139,7 +139,7 @@ int write_subtitle_file_footer(struct encoder_ctx *ctx, struct ccx_s_write *out)
 				dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 			}
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)str);
-			ret = write(out->fh, ctx->buffer, used);
+			ret = buffered_write(out->fh, ctx->buffer, used);
 			if (ret != used)
 			{
 				mprint("WARNING: loss of data\n");
@@ -152,7 +152,7 @@ int write_subtitle_file_footer(struct encoder_ctx *ctx, struct ccx_s_write *out)
 				dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 			}
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)str);
-			ret = write(out->fh, ctx->buffer, used);
+			ret = buffered_write(out->fh, ctx->buffer, used);
 			if (ret != used)
 			{
 				mprint("WARNING: loss of data\n");
@@ -168,7 +168,7 @@ int write_subtitle_file_footer(struct encoder_ctx *ctx, struct ccx_s_write *out)
 				dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 			}
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)str);
-			ret = write(out->fh, ctx->buffer, used);
+			ret = buffered_write(out->fh, ctx->buffer, used);
 			if (ret != used)
 			{
 				mprint("WARNING: loss of data\n");
@@ -176,7 +176,7 @@ int write_subtitle_file_footer(struct encoder_ctx *ctx, struct ccx_s_write *out)
 			break;
 		case CCX_OF_SCC:
 		case CCX_OF_CCD:
-			ret = write(out->fh, ctx->encoded_crlf, ctx->encoded_crlf_length);
+			ret = buffered_write(out->fh, ctx->encoded_crlf, ctx->encoded_crlf_length);
 			break;
 		case CCX_OF_WEBVTT:
 			// Ensure WebVTT header is written even if no subtitles were found (issue #1743)
@@ -200,7 +200,7 @@ static int write_bom(struct encoder_ctx *ctx, struct ccx_s_write *out)
 	{
 		if (ctx->encoding == CCX_ENC_UTF_8)
 		{ // Write BOM
-			ret = write(out->fh, UTF8_BOM, sizeof(UTF8_BOM));
+			ret = buffered_write(out->fh, UTF8_BOM, sizeof(UTF8_BOM));
 			if (ret < sizeof(UTF8_BOM))
 			{
 				mprint("WARNING: Unable to write UTF BOM\n");
@@ -209,7 +209,7 @@ static int write_bom(struct encoder_ctx *ctx, struct ccx_s_write *out)
 		}
 		if (ctx->encoding == CCX_ENC_UNICODE)
 		{ // Write BOM
-			ret = write(out->fh, LITTLE_ENDIAN_BOM, sizeof(LITTLE_ENDIAN_BOM));
+			ret = buffered_write(out->fh, LITTLE_ENDIAN_BOM, sizeof(LITTLE_ENDIAN_BOM));
 			if (ret < sizeof(LITTLE_ENDIAN_BOM))
 			{
 				mprint("WARNING: Unable to write LITTLE_ENDIAN_BOM \n");
@@ -228,14 +228,14 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 	switch (ctx->write_format)
 	{
 		case CCX_OF_CCD:
-			if (write(out->fh, CCD_HEADER, sizeof(CCD_HEADER) - 1) == -1 || write(out->fh, ctx->encoded_crlf, ctx->encoded_crlf_length) == -1)
+			if (buffered_write(out->fh, CCD_HEADER, sizeof(CCD_HEADER) - 1) == -1 || buffered_write(out->fh, ctx->encoded_crlf, ctx->encoded_crlf_length) == -1)
 			{
 				mprint("Unable to write CCD header to file\n");
 				return -1;
 			}
 			break;
 		case CCX_OF_SCC:
-			if (write(out->fh, SCC_HEADER, sizeof(SCC_HEADER) - 1) == -1)
+			if (buffered_write(out->fh, SCC_HEADER, sizeof(SCC_HEADER) - 1) == -1)
 			{
 				mprint("Unable to write SCC header to file\n");
 				return -1;
@@ -251,7 +251,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 				return -1;
 			REQUEST_BUFFER_CAPACITY(ctx, strlen(ssa_header) * 3);
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)ssa_header);
-			if (write(out->fh, ctx->buffer, used) < used)
+			if (buffered_write(out->fh, ctx->buffer, used) < used)
 			{
 				mprint("WARNING: Unable to write complete Buffer \n");
 				return -1;
@@ -275,7 +275,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 				{
 					used = encode_line(ctx, ctx->buffer, (unsigned char *)webvtt_header[i]);
 				}
-				if (write(out->fh, ctx->buffer, used) < used)
+				if (buffered_write(out->fh, ctx->buffer, used) < used)
 				{
 					mprint("WARNING: Unable to write complete Buffer \n");
 					return -1;
@@ -288,7 +288,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 				return -1;
 			REQUEST_BUFFER_CAPACITY(ctx, strlen(sami_header) * 3);
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)sami_header);
-			if (write(out->fh, ctx->buffer, used) < used)
+			if (buffered_write(out->fh, ctx->buffer, used) < used)
 			{
 				mprint("WARNING: Unable to write complete Buffer \n");
 				return -1;
@@ -300,7 +300,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 				return -1;
 			REQUEST_BUFFER_CAPACITY(ctx, strlen(smptett_header) * 3);
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)smptett_header);
-			if (write(out->fh, ctx->buffer, used) < used)
+			if (buffered_write(out->fh, ctx->buffer, used) < used)
 			{
 				mprint("WARNING: Unable to write complete Buffer \n");
 				return -1;
@@ -311,9 +311,24 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 
 			if (ctx->send_to_srv)
 				net_send_header(rcwt_header, sizeof(rcwt_header));
+			else if (ctx->rcwt_index && ctx->in_fileformat == 1 && !out->append_mode)
+			{
+				// Indexed chunks only hold CEA-608 data headers, see rcwt_write()
+				unsigned char header[sizeof(rcwt_header)];
+				memcpy(header, rcwt_header, sizeof(header));
+				header[6] = RCWT_FORMAT_INDEXED;
+				header[8] = ctx->rcwt_compress ? RCWT_CHUNK_ZLIB : 0;
+				if (buffered_write(out->fh, header, sizeof(header)) < 0)
+				{
+					mprint("Unable to write rcwt header\n");
+					return -1;
+				}
+				if (!out->rcwt)
+					rcwt_start_chunks(out, sizeof(header), ctx->rcwt_compress);
+			}
 			else
 			{
-				if (write(out->fh, rcwt_header, sizeof(rcwt_header)) < 0)
+				if (buffered_write(out->fh, rcwt_header, sizeof(rcwt_header)) < 0)
 				{
 					mprint("Unable to write rcwt header\n");
 					return -1;
@@ -322,7 +337,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 
 			break;
 		case CCX_OF_RAW:
-			if (write(out->fh, BROADCAST_HEADER, sizeof(BROADCAST_HEADER)) < sizeof(BROADCAST_HEADER))
+			if (buffered_write(out->fh, BROADCAST_HEADER, sizeof(BROADCAST_HEADER)) < sizeof(BROADCAST_HEADER))
 			{
 				mprint("Unable to write Raw header\n");
 				return -1;
@@ -342,7 +357,7 @@ static int write_subtitle_file_header(struct encoder_ctx *ctx, struct ccx_s_writ
 				return -1;
 			REQUEST_BUFFER_CAPACITY(ctx, strlen(simple_xml_header) * 3);
 			used = encode_line(ctx, ctx->buffer, (unsigned char *)simple_xml_header);
-			if (write(out->fh, ctx->buffer, used) < used)
+			if (buffered_write(out->fh, ctx->buffer, used) < used)
 			{
 				mprint("WARNING: Unable to write complete Buffer \n");
 				return -1;
@@ -379,7 +394,7 @@ int write_cc_subtitle_as_simplexml(struct cc_subtitle *sub, struct encoder_ctx *
 			{
 				continue;
 			}
-			ret = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+			ret = buffered_write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
 			if (ret < context->encoded_crlf_length)
 			{
 				mprint("Warning:Loss of data\n");
@@ -411,14 +426,14 @@ void write_cc_line_as_simplexml(struct eia608_screen *data, struct encoder_ctx *
 	length = get_str_basic(context->subline, data->characters[line_number],
 			       context->trim_subs, CCX_ENC_ASCII, context->encoding, CCX_DECODER_608_SCREEN_WIDTH);
 
-	ret = write(context->out->fh, cap, strlen(cap));
-	ret = write(context->out->fh, context->subline, length);
+	ret = buffered_write(context->out->fh, cap, strlen(cap));
+	ret = buffered_write(context->out->fh, context->subline, length);
 	if (ret < length)
 	{
 		mprint("Warning:Loss of data\n");
 	}
-	ret = write(context->out->fh, cap1, strlen(cap1));
-	ret = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+	ret = buffered_write(context->out->fh, cap1, strlen(cap1));
+	ret = buffered_write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
 }
 
 int write_cc_buffer_as_simplexml(struct eia608_screen *data, struct encoder_ctx *context)
@@ -662,6 +677,7 @@ static int init_output_ctx(struct encoder_ctx *ctx, struct encoder_cfg *cfg)
 		ctx->out[0].filename = NULL;
 		ctx->out[0].with_semaphore = 0;
 		ctx->out[0].semaphore_filename = NULL;
+		enable_output_buffer(&ctx->out[0]);
 		mprint("Sending captions to stdout.\n");
 	}
 
@@ -744,6 +760,7 @@ void dinit_encoder(struct encoder_ctx **arg, LLONG current_fts)
 	// Clean up teletext multi-page output files (issue #665)
 	dinit_teletext_outputs(ctx);
 
+	dinit_encoder(&ctx->next_format, current_fts);
 	free_encoder_context(ctx->prev);
 	dinit_output_ctx(ctx);
 	freep(&ctx->subline);
@@ -752,10 +769,40 @@ void dinit_encoder(struct encoder_ctx **arg, LLONG current_fts)
 	freep(arg);
 }
 
+/* Fill cfg for the encoder writing the first of opt's extra formats, which in
+   turn writes the rest of them. An output file name given in opt gets the
+   extension of that format; the caller frees cfg->output_filename. */
+static void init_next_format_cfg(struct encoder_cfg *cfg, const struct encoder_cfg *opt)
+{
+	*cfg = *opt;
+	cfg->write_format = opt->extra_write_formats[0];
+	cfg->nb_extra_write_formats = opt->nb_extra_write_formats - 1;
+	memcpy(cfg->extra_write_formats, opt->extra_write_formats + 1,
+	       cfg->nb_extra_write_formats * sizeof(cfg->extra_write_formats[0]));
+	cfg->output_filename = NULL;
+	if (opt->output_filename)
+	{
+		char *basefilename = get_basename(opt->output_filename);
+		cfg->output_filename = create_outfilename(basefilename, NULL, get_file_extension(cfg->write_format));
+		free(basefilename);
+		if (!cfg->output_filename)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In init_next_format_cfg: Out of memory allocating output filename.");
+	}
+}
+
 int reset_output_ctx(struct encoder_ctx *ctx, struct encoder_cfg *cfg)
 {
+	int ret;
 	dinit_output_ctx(ctx);
-	return init_output_ctx(ctx, cfg);
+	ret = init_output_ctx(ctx, cfg);
+	if (ret == EXIT_OK && ctx->next_format)
+	{
+		struct encoder_cfg format_cfg;
+		init_next_format_cfg(&format_cfg, cfg);
+		ret = reset_output_ctx(ctx->next_format, &format_cfg);
+		freep(&format_cfg.output_filename);
+	}
+	return ret;
 }
 
 struct encoder_ctx *init_encoder(struct encoder_cfg *opt)
@@ -797,6 +844,8 @@ struct encoder_ctx *init_encoder(struct encoder_cfg *opt)
 		return NULL;
 	}
 	ctx->in_fileformat = opt->in_format;
+	ctx->rcwt_index = opt->rcwt_index;
+	ctx->rcwt_compress = opt->rcwt_compress;
 	ctx->is_pal = (opt->in_format == 2);
 
 	/** used in case of SUB_EOD_MARKER */
@@ -807,7 +856,8 @@ struct encoder_ctx *init_encoder(struct encoder_cfg *opt)
 	ctx->millis_separator = opt->millis_separator;
 	ctx->startcredits_displayed = 0;
 
-	ctx->encoding = opt->encoding;
+	// WebVTT is always UTF-8, the other --out formats keep the encoding asked for
+	ctx->encoding = opt->write_format == CCX_OF_WEBVTT ? CCX_ENC_UTF_8 : opt->encoding;
 	ctx->write_format = opt->write_format;
 
 	ctx->is_mkv = 0;
@@ -899,12 +949,26 @@ struct encoder_ctx *init_encoder(struct encoder_cfg *opt)
 	}
 
 	ctx->prev = NULL;
+
+	ctx->next_format = NULL;
+	if (opt->nb_extra_write_formats > 0)
+	{
+		struct encoder_cfg format_cfg;
+		init_next_format_cfg(&format_cfg, opt);
+		ctx->next_format = init_encoder(&format_cfg);
+		freep(&format_cfg.output_filename);
+		if (!ctx->next_format)
+		{
+			dinit_encoder(&ctx, 0);
+			return NULL;
+		}
+	}
 	return ctx;
 }
 
 void set_encoder_rcwt_fileformat(struct encoder_ctx *ctx, short int format)
 {
-	if (ctx)
+	for (; ctx; ctx = ctx->next_format)
 	{
 		ctx->in_fileformat = format;
 	}
@@ -912,7 +976,7 @@ void set_encoder_rcwt_fileformat(struct encoder_ctx *ctx, short int format)
 
 static int write_newline(struct encoder_ctx *ctx, int lang)
 {
-	return write(ctx->out[lang].fh, ctx->encoded_crlf, ctx->encoded_crlf_length);
+	return buffered_write(ctx->out[lang].fh, ctx->encoded_crlf, ctx->encoded_crlf_length);
 }
 
 struct ccx_s_write *get_output_ctx(struct encoder_ctx *ctx, int lan)
@@ -927,6 +991,126 @@ struct ccx_s_write *get_output_ctx(struct encoder_ctx *ctx, int lan)
 	}
 }
 
+/* Deep copy of sub, for the encoder of another output format: the encoders
+   modify the subtitles they write and free their data. */
+static void deep_copy_subtitle(struct cc_subtitle *copy, struct cc_subtitle *sub)
+{
+	memcpy(copy, sub, sizeof(struct cc_subtitle));
+	copy->prev = NULL;
+	copy->next = NULL;
+	copy->data = NULL;
+	if (sub->data)
+	{
+		switch (sub->type)
+		{
+			case CC_608:
+			{
+				struct eia608_screen *data = malloc(sub->nb_data * sizeof(struct eia608_screen));
+				if (!data)
+					fatal(EXIT_NOT_ENOUGH_MEMORY, "In deep_copy_subtitle: Out of memory.");
+				memcpy(data, sub->data, sub->nb_data * sizeof(struct eia608_screen));
+				for (unsigned int i = 0; i < sub->nb_data; i++)
+				{
+					if (data[i].format != SFORMAT_XDS || !data[i].xds_str)
+						continue;
+					data[i].xds_str = malloc(data[i].xds_len + 1);
+					if (!data[i].xds_str)
+						fatal(EXIT_NOT_ENOUGH_MEMORY, "In deep_copy_subtitle: Out of memory.");
+					memcpy(data[i].xds_str, ((struct eia608_screen *)sub->data)[i].xds_str, data[i].xds_len + 1);
+				}
+				copy->data = data;
+				break;
+			}
+			case CC_BITMAP:
+			{
+				struct cc_bitmap *rect = malloc(sub->nb_data * sizeof(struct cc_bitmap));
+				if (!rect)
+					fatal(EXIT_NOT_ENOUGH_MEMORY, "In deep_copy_subtitle: Out of memory.");
+				memcpy(rect, sub->data, sub->nb_data * sizeof(struct cc_bitmap));
+				for (unsigned int i = 0; i < sub->nb_data; i++)
+				{
+					struct cc_bitmap *orig = (struct cc_bitmap *)sub->data + i;
+					if (orig->data0)
+					{
+						rect[i].data0 = malloc((size_t)orig->w * orig->h);
+						if (!rect[i].data0)
+							fatal(EXIT_NOT_ENOUGH_MEMORY, "In deep_copy_subtitle: Out of memory.");
+						memcpy(rect[i].data0, orig->data0, (size_t)orig->w * orig->h);
+					}
+					if (orig->data1)
+					{
+						rect[i].data1 = malloc(1024); // Palette, 256 colors
+						if (!rect[i].data1)
+							fatal(EXIT_NOT_ENOUGH_MEMORY, "In deep_copy_subtitle: Out of memory.");
+						memcpy(rect[i].data1, orig->data1, 1024);
+					}
+#ifdef ENABLE_OCR
+					if (orig->ocr_text)
+					{
+						rect[i].ocr_text = strdup(orig->ocr_text);
+						if (!rect[i].ocr_text)
+							fatal(EXIT_NOT_ENOUGH_MEMORY, "In deep_copy_subtitle: Out of memory.");
+					}
+#endif
+				}
+				copy->data = rect;
+				break;
+			}
+			case CC_TEXT:
+				copy->data = strdup(sub->data);
+				if (!copy->data)
+					fatal(EXIT_NOT_ENOUGH_MEMORY, "In deep_copy_subtitle: Out of memory.");
+				break;
+			case CC_RAW:
+				copy->data = malloc(sub->nb_data);
+				if (!copy->data)
+					fatal(EXIT_NOT_ENOUGH_MEMORY, "In deep_copy_subtitle: Out of memory.");
+				memcpy(copy->data, sub->data, sub->nb_data);
+				break;
+		}
+	}
+
+	// Text subtitles decoded together are chained, see add_cc_sub_text()
+	if (sub->type == CC_TEXT && sub->next)
+	{
+		copy->next = malloc(sizeof(struct cc_subtitle));
+		if (!copy->next)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In deep_copy_subtitle: Out of memory.");
+		deep_copy_subtitle(copy->next, sub->next);
+		copy->next->prev = copy;
+	}
+}
+
+#ifdef ENABLE_OCR
+/* The OCR colours its text with <font> tags when SRT or WebVTT is among the
+   formats written (see ocr_bitmap()). Remove them for the others. */
+static void drop_ocr_font_tags(struct cc_subtitle *sub)
+{
+	struct cc_bitmap *rect = sub->data;
+
+	for (unsigned int i = 0; rect && i < sub->nb_data; i++)
+	{
+		char *in = rect[i].ocr_text, *out = rect[i].ocr_text;
+		if (!in)
+			continue;
+		while (*in)
+		{
+			if (!strncmp(in, "<font", 5) || !strncmp(in, "</font>", 7))
+			{
+				char *end = strchr(in, '>');
+				if (end)
+				{
+					in = end + 1;
+					continue;
+				}
+			}
+			*out++ = *in++;
+		}
+		*out = '\0';
+	}
+}
+#endif
+
 int encode_sub(struct encoder_ctx *context, struct cc_subtitle *sub)
 {
 	int wrote_something = 0;
@@ -957,6 +1141,35 @@ int encode_sub(struct encoder_ctx *context, struct cc_subtitle *sub)
 		return CCX_OK;
 	}
 
+	// Write the other output formats first, while sub is still untouched
+	if (context->next_format)
+	{
+		struct cc_subtitle copy;
+		deep_copy_subtitle(&copy, sub);
+		context->next_format->timing = context->timing;
+		context->next_format->is_mkv = context->is_mkv;
+		encode_sub(context->next_format, &copy);
+		if (copy.type == CC_BITMAP && copy.data)
+		{
+			// Not every writer frees the bitmaps; the original is freed by its decoder
+			struct cc_bitmap *rect = copy.data;
+			for (unsigned int i = 0; i < copy.nb_data; i++)
+			{
+				freep(&rect[i].data0);
+				freep(&rect[i].data1);
+#ifdef ENABLE_OCR
+				freep(&rect[i].ocr_text);
+#endif
+			}
+		}
+		freep(&copy.data);
+	}
+
+#ifdef ENABLE_OCR
+	if (sub->type == CC_BITMAP && context->write_format != CCX_OF_SRT && context->write_format != CCX_OF_WEBVTT)
+		drop_ocr_font_tags(sub);
+#endif
+
 	context = change_filename(context);
 
 	if (context->sbs_enabled)
@@ -1002,7 +1215,7 @@ int encode_sub(struct encoder_ctx *context, struct cc_subtitle *sub)
 					xds_write_transcript_line_prefix(context, out, data->start_time, data->end_time, data->cur_xds_packet_class);
 					if (data->xds_len > 0)
 					{
-						ret = write(out->fh, data->xds_str, data->xds_len);
+						ret = buffered_write(out->fh, data->xds_str, data->xds_len);
 						if (ret < data->xds_len)
 						{
 							mprint("WARNING:Loss of data\n");
@@ -1191,7 +1404,10 @@ int encode_sub(struct encoder_ctx *context, struct cc_subtitle *sub)
 				net_send_header(sub->data, sub->nb_data);
 			else
 			{
-				ret = write(context->out->fh, sub->data, sub->nb_data);
+				if (context->out->rcwt)
+					ret = rcwt_write(context->out, sub->data, sub->nb_data);
+				else
+					ret = buffered_write(context->out->fh, sub->data, sub->nb_data);
 				if (ret < sub->nb_data)
 				{
 					mprint("WARNING: Loss of data\n");
@@ -1245,6 +1461,9 @@ int encode_sub(struct encoder_ctx *context, struct cc_subtitle *sub)
 
 	if (!sub->nb_data)
 		freep(&sub->data);
+	// Readers of the output (stdout, files being followed) see each subtitle once it is complete
+	if (wrote_something)
+		flush_output_buffer(context->out);
 	if (wrote_something && context->force_flush)
 		fsync(context->out->fh); // Don't buffer
 	return wrote_something;
@@ -1361,7 +1580,7 @@ void switch_output_file(struct lib_ccx_ctx *ctx, struct encoder_ctx *enc_ctx, in
 	if (enc_ctx->out->filename != NULL)
 	{ // Close and release the previous handle
 		free(enc_ctx->out->filename);
-		close(enc_ctx->out->fh);
+		close_output(enc_ctx->out);
 	}
 	const char *ext = get_file_extension(ctx->write_format);
 	char suffix[32];
@@ -1371,6 +1590,7 @@ void switch_output_file(struct lib_ccx_ctx *ctx, struct encoder_ctx *enc_ctx, in
 	{
 		enc_ctx->out->filename = create_outfilename(basename, suffix, ext);
 		enc_ctx->out->fh = open(enc_ctx->out->filename, O_RDWR | O_CREAT | O_TRUNC | O_BINARY, S_IREAD | S_IWRITE);
+		enable_output_buffer(enc_ctx->out);
 		free(basename);
 	}
 
@@ -1472,6 +1692,7 @@ struct ccx_s_write *get_teletext_output(struct encoder_ctx *ctx, uint16_t telete
 	}
 
 	mprint("Creating teletext output file: %s\n", filename);
+	enable_output_buffer(new_out);
 
 	// Store in our array
 	int idx = ctx->tlt_out_count;
@@ -1528,10 +1749,8 @@ void dinit_teletext_outputs(struct encoder_ctx *ctx)
 			write_subtitle_file_footer(ctx, ctx->tlt_out[i]);
 
 			// Close file
-			if (ctx->tlt_out[i]->fh != -1)
-			{
-				close(ctx->tlt_out[i]->fh);
-			}
+			close_output(ctx->tlt_out[i]);
+			release_output_buffer(ctx->tlt_out[i]);
 
 			// Free filename
 			if (ctx->tlt_out[i]->filename != NULL)
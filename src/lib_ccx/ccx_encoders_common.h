@@ -96,6 +96,9 @@ struct encoder_ctx
 	int nb_out;
 	/* Input file format used in Teletext for exceptional output */
 	unsigned int in_fileformat; // 1 = Normal, 2 = Teletext
+	/* Write RCWT as indexed chunks (--rcwt-index), optionally compressed */
+	int rcwt_index;
+	int rcwt_compress;
 	/* Keep output file closed when not actually writing to it and start over each time (add headers, etc) */
 	unsigned int keep_output_closed;
 	/* Force a flush on the file buffer whenever content is written */
@@ -108,6 +111,9 @@ struct encoder_ctx
 	/* Flag saying BOM to be written in each output file */
 	enum ccx_encoding_type encoding;
 	enum ccx_output_format write_format; // 0=Raw, 1=srt, 2=SMI
+	/* Encoder writing the next of the extra output formats, NULL if none. It gets a
+	   copy of every subtitle this one encodes, so all formats share one decode. */
+	struct encoder_ctx *next_format;
 	int generates_file;
 	struct ccx_encoders_transcript_format *transcript_settings; // Keeps the settings for generating transcript output files.
 	int no_bom;
@@ -262,6 +268,8 @@ int write_cc_bitmap_as_smptett(struct cc_subtitle *sub, struct encoder_ctx *cont
 int write_cc_bitmap_as_spupng(struct cc_subtitle *sub, struct encoder_ctx *context);
 int write_cc_bitmap_as_transcript(struct cc_subtitle *sub, struct encoder_ctx *context);
 int write_cc_bitmap_as_libcurl(struct cc_subtitle *sub, struct encoder_ctx *context);
+void curl_sink_poll(void);
+void curl_sink_close(void);
 
 void write_spumux_header(struct encoder_ctx *ctx, struct ccx_s_write *out);
 void write_spumux_footer(struct ccx_s_write *out);
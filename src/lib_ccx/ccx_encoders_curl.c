@@ -1,4 +1,6 @@
 #ifdef WITH_LIBCURL
+#include "lib_ccx.h"
+#include "ccx_common_option.h"
 #include "ccx_decoders_common.h"
 #include "ccx_encoders_common.h"
 #include "utility.h"
@@ -11,18 +13,419 @@
 #include "utf8proc.h"
 
 extern CURL *curl;
-extern CURLcode res;
+
+/* Cues are POSTed from the main thread through a curl multi handle, so a
+   slow or unreachable endpoint never stalls demuxing: curl_sink_pump() only
+   advances the transfer in flight and starts the next one when it is done.
+   It runs for every cue and, through curl_sink_poll(), for every chunk the
+   demuxer reads, so transfers and retries go on between sparse cues.
+   While a request is in flight the cues queue up and go out together in the
+   next one (at most --curlbatch per request). A request that fails is retried
+   with a growing delay; once it has failed CURL_SINK_MAX_RETRIES times, or
+   the queue is full, cues are spilled to a temporary file and sent from
+   there in order when the endpoint answers again. */
+
+#define CURL_SINK_MAX_QUEUED 256     // Cues held in memory before spilling to disk
+#define CURL_SINK_MAX_RETRIES 4	     // Attempts at a request before spilling its cues
+#define CURL_SINK_MAX_RETRY_DELAY 30 // Seconds
+#define CURL_SINK_DRAIN_TIMEOUT 30   // Seconds to wait at exit without any progress
+
+struct curl_cue
+{
+	char *body; // One urlencoded record, without line breaks
+	struct curl_cue *next;
+};
+
+static struct
+{
+	CURLM *multi;
+	CURL *easy; // Reused for every request, so the connection is kept alive
+	char *url;
+
+	struct curl_cue *head, *tail; // Cues waiting in memory
+	unsigned queued;
+
+	FILE *spill;	   // Cues waiting on disk, read back once memory is empty
+	long spill_read;   // Offset of the next cue to read back
+	unsigned spilled;  // Cues in the file not yet read back
+
+	struct curl_cue *batch; // Cues of the request in flight or to retry
+	unsigned batch_len;
+	long batch_spill_pos; // Where the batch was read from the spill file, -1 if from memory
+	char *body;	      // Body of the request in flight, NULL if idle
+	int failures;	      // Failed attempts at the current batch
+	time_t retry_at;
+
+	unsigned long sent, requests, dropped;
+} sink;
+
+static void curl_sink_free_cues(struct curl_cue *cue)
+{
+	while (cue)
+	{
+		struct curl_cue *next = cue->next;
+		free(cue->body);
+		free(cue);
+		cue = next;
+	}
+}
+
+static int curl_sink_spill_cue(const char *body)
+{
+	if (!sink.spill)
+	{
+		sink.spill = tmpfile();
+		sink.spill_read = 0;
+		sink.spilled = 0;
+		if (!sink.spill)
+		{
+			mprint("curl: Unable to create a spill file, dropping cues: %s\n", strerror(errno));
+			return -1;
+		}
+	}
+	fseek(sink.spill, 0, SEEK_END);
+	if (fprintf(sink.spill, "%s\n", body) < 0)
+		return -1;
+	sink.spilled++;
+	return 0;
+}
+
+static void curl_sink_spill_cues(struct curl_cue *cue)
+{
+	for (; cue; cue = cue->next)
+	{
+		if (curl_sink_spill_cue(cue->body) < 0)
+			sink.dropped++;
+	}
+}
+
+static struct curl_cue *curl_sink_new_cue(char *body)
+{
+	struct curl_cue *cue = malloc(sizeof(struct curl_cue));
+	if (!cue)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In curl_sink_new_cue: Out of memory allocating cue.");
+	cue->body = body;
+	cue->next = NULL;
+	return cue;
+}
+
+/* Read the next cue back from the spill file, NULL once it is empty. */
+static struct curl_cue *curl_sink_unspill_cue(void)
+{
+	char *body = NULL;
+	size_t len = 0, size = 0;
+	int c;
+
+	if (!sink.spilled)
+		return NULL;
+	fseek(sink.spill, sink.spill_read, SEEK_SET);
+	while ((c = fgetc(sink.spill)) != EOF && c != '\n')
+	{
+		if (len + 1 >= size)
+		{
+			size = size ? size * 2 : 256;
+			body = realloc(body, size);
+			if (!body)
+				fatal(EXIT_NOT_ENOUGH_MEMORY, "In curl_sink_unspill_cue: Out of memory allocating cue.");
+		}
+		body[len++] = c;
+	}
+	if (c == EOF)
+	{
+		// Only a short write leaves a partial line at the end
+		free(body);
+		sink.spilled = 0;
+		return NULL;
+	}
+	sink.spill_read = ftell(sink.spill);
+	sink.spilled--;
+	if (!body)
+		body = strdup("");
+	else
+		body[len] = '\0';
+	return curl_sink_new_cue(body);
+}
+
+/* Put the cues of a request given up on back on disk ahead of the ones still
+   waiting: the batch first, then the cues queued in memory, then what was
+   already on disk, which is always newer than both. The batch read back from
+   there gets its own CURL_SINK_MAX_RETRIES attempts, starting with the short
+   delays again. */
+static void curl_sink_requeue_batch(void)
+{
+	FILE *older = sink.spill;
+	unsigned count = sink.spilled;
+	char buf[4096];
+	size_t len;
+
+	if (sink.batch_spill_pos >= 0 && !sink.head)
+	{
+		// The batch is still on disk, right in front of the cues that followed it
+		sink.spill_read = sink.batch_spill_pos;
+		sink.spilled += sink.batch_len;
+	}
+	else
+	{
+		sink.spill = NULL;
+		curl_sink_spill_cues(sink.batch);
+		curl_sink_spill_cues(sink.head);
+		if (!count)
+		{
+			if (older)
+				fclose(older);
+		}
+		else if (sink.spill)
+		{
+			fseek(older, sink.spill_read, SEEK_SET);
+			while ((len = fread(buf, 1, sizeof(buf), older)) > 0)
+				fwrite(buf, 1, len, sink.spill);
+			fclose(older);
+			sink.spilled += count;
+		}
+		else
+		{
+			sink.spill = older;
+			sink.spilled = count;
+		}
+	}
+	curl_sink_free_cues(sink.batch);
+	sink.batch = NULL;
+
+	curl_sink_free_cues(sink.head);
+	sink.head = sink.tail = NULL;
+	sink.queued = 0;
+	sink.failures = 0;
+}
+
+static void curl_sink_start(void)
+{
+	struct curl_cue **link = &sink.batch;
+	size_t size = 1;
+
+	if (!sink.batch)
+	{
+		sink.batch_len = 0;
+		sink.batch_spill_pos = -1;
+		if (!sink.head && sink.spilled)
+			sink.batch_spill_pos = sink.spill_read;
+		while (sink.batch_len < ccx_options.curl_batch)
+		{
+			struct curl_cue *cue = sink.head;
+			if (cue)
+			{
+				sink.head = cue->next;
+				if (!sink.head)
+					sink.tail = NULL;
+				sink.queued--;
+			}
+			else if (sink.batch_spill_pos >= 0)
+				cue = curl_sink_unspill_cue();
+			if (!cue)
+				break;
+			cue->next = NULL;
+			*link = cue;
+			link = &cue->next;
+			sink.batch_len++;
+		}
+		if (!sink.batch)
+			return;
+	}
+
+	for (struct curl_cue *cue = sink.batch; cue; cue = cue->next)
+		size += strlen(cue->body) + 1;
+	sink.body = malloc(size);
+	if (!sink.body)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In curl_sink_start: Out of memory allocating request.");
+	sink.body[0] = '\0';
+	for (struct curl_cue *cue = sink.batch; cue; cue = cue->next)
+	{
+		strcat(sink.body, cue->body);
+		if (cue->next)
+			strcat(sink.body, "\n");
+	}
+
+	curl_easy_setopt(sink.easy, CURLOPT_POSTFIELDS, sink.body);
+	curl_multi_add_handle(sink.multi, sink.easy);
+	sink.requests++;
+}
+
+static void curl_sink_done(CURLcode result)
+{
+	long status = 0;
+
+	curl_multi_remove_handle(sink.multi, sink.easy);
+	freep(&sink.body);
+	if (result == CURLE_OK)
+		curl_easy_getinfo(sink.easy, CURLINFO_RESPONSE_CODE, &status);
+
+	if (result == CURLE_OK && status < 500)
+	{
+		if (status >= 400)
+		{
+			// The endpoint refused these cues, sending them again won't help
+			mprint("curl: Endpoint answered %ld, dropping %u cue(s)\n", status, sink.batch_len);
+			sink.dropped += sink.batch_len;
+		}
+		else
+			sink.sent += sink.batch_len;
+		curl_sink_free_cues(sink.batch);
+		sink.batch = NULL;
+		sink.failures = 0;
+		if (sink.spill && !sink.spilled)
+		{
+			fclose(sink.spill);
+			sink.spill = NULL;
+		}
+		return;
+	}
+
+	if (result != CURLE_OK)
+		mprint("curl: POST failed: %s\n", curl_easy_strerror(result));
+	else
+		mprint("curl: Endpoint answered %ld\n", status);
+	sink.failures++;
+	sink.retry_at = time(NULL) + MIN(1 << sink.failures, CURL_SINK_MAX_RETRY_DELAY);
+	if (sink.failures < CURL_SINK_MAX_RETRIES)
+		return;
+
+	// Give up on the batch for now, it is sent again from disk later
+	curl_sink_requeue_batch();
+}
+
+/* Move the request in flight along, waiting up to wait_ms for the endpoint,
+   and start the next one if the previous is done. */
+static void curl_sink_pump(int wait_ms)
+{
+	CURLMsg *msg;
+	int running, left;
+
+	if (sink.body)
+	{
+		curl_multi_perform(sink.multi, &running);
+		if (running && wait_ms)
+		{
+			curl_multi_wait(sink.multi, NULL, 0, wait_ms, NULL);
+			curl_multi_perform(sink.multi, &running);
+		}
+		while ((msg = curl_multi_info_read(sink.multi, &left)))
+		{
+			if (msg->msg == CURLMSG_DONE)
+				curl_sink_done(msg->data.result);
+		}
+	}
+	if (!sink.body && time(NULL) >= sink.retry_at)
+	{
+		curl_sink_start();
+		if (sink.body)
+			curl_multi_perform(sink.multi, &running);
+	}
+}
+
+static void curl_sink_init(void)
+{
+	const char *path = ccx_options.curl_batch > 1 ? "/frames/" : "/frame/";
+	size_t size = strlen(ccx_options.curlposturl) + strlen(path) + 1;
+
+	sink.url = malloc(size);
+	if (!sink.url)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In curl_sink_init: Out of memory allocating url.");
+	snprintf(sink.url, size, "%s%s", ccx_options.curlposturl, path);
+
+	sink.multi = curl_multi_init();
+	sink.easy = curl_easy_init();
+	if (!sink.multi || !sink.easy)
+		fatal(EXIT_NOT_CLASSIFIED, "Unable to init curl.");
+	curl_easy_setopt(sink.easy, CURLOPT_URL, sink.url);
+	curl_easy_setopt(sink.easy, CURLOPT_TCP_KEEPALIVE, 1L);
+	curl_easy_setopt(sink.easy, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt(sink.easy, CURLOPT_CONNECTTIMEOUT, 10L);
+	curl_easy_setopt(sink.easy, CURLOPT_TIMEOUT, 60L);
+}
+
+/* Called from the demux loop to keep the sink going between cues. */
+void curl_sink_poll(void)
+{
+	if (sink.multi)
+		curl_sink_pump(0);
+}
+
+#ifdef ENABLE_OCR
+/* Queue one record, taking ownership of body. */
+static void curl_sink_post(char *body)
+{
+	if (!sink.multi)
+		curl_sink_init();
+
+	if (sink.spilled || sink.queued >= CURL_SINK_MAX_QUEUED)
+	{
+		// Keep the order: nothing goes to memory while older cues are on disk
+		if (curl_sink_spill_cue(body) < 0)
+			sink.dropped++;
+		free(body);
+	}
+	else
+	{
+		struct curl_cue *cue = curl_sink_new_cue(body);
+		if (sink.tail)
+			sink.tail->next = cue;
+		else
+			sink.head = cue;
+		sink.tail = cue;
+		sink.queued++;
+	}
+	curl_sink_pump(0);
+}
+#endif
+
+/* Send what is still queued, giving up once the endpoint has made no progress
+   for CURL_SINK_DRAIN_TIMEOUT seconds, and release the sink. */
+void curl_sink_close(void)
+{
+	time_t last_progress = time(NULL);
+	unsigned long sent = sink.sent;
+
+	if (!sink.multi)
+		return;
+	while ((sink.batch || sink.head || sink.spilled) && time(NULL) - last_progress < CURL_SINK_DRAIN_TIMEOUT)
+	{
+		if (!sink.body && time(NULL) < sink.retry_at)
+			sleep_secs(1);
+		curl_sink_pump(1000);
+		if (sink.sent != sent)
+		{
+			sent = sink.sent;
+			last_progress = time(NULL);
+		}
+	}
+	if (sink.body)
+		curl_multi_remove_handle(sink.multi, sink.easy);
+
+	sink.dropped += sink.queued + sink.spilled;
+	if (sink.batch)
+		sink.dropped += sink.batch_len;
+	mprint("curl: %lu cue(s) sent in %lu request(s)", sink.sent, sink.requests);
+	if (sink.dropped)
+		mprint(", %lu not delivered", sink.dropped);
+	mprint("\n");
+
+	curl_sink_free_cues(sink.head);
+	curl_sink_free_cues(sink.batch);
+	if (sink.spill)
+		fclose(sink.spill);
+	free(sink.body);
+	free(sink.url);
+	curl_easy_cleanup(sink.easy);
+	curl_multi_cleanup(sink.multi);
+	memset(&sink, 0, sizeof(sink));
+}
 
 int write_cc_bitmap_as_libcurl(struct cc_subtitle *sub, struct encoder_ctx *context)
 {
 	int ret = 0;
 #ifdef ENABLE_OCR
 	struct cc_bitmap *rect;
-	unsigned h1, m1, s1, ms1;
-	unsigned h2, m2, s2, ms2;
+	LLONG ms_start, ms_end;
 	char timeline[128];
-	int len = 0;
-	int used;
 	int i = 0;
 	char *str;
 
@@ -36,7 +439,7 @@ int write_cc_bitmap_as_libcurl(struct cc_subtitle *sub, struct encoder_ctx *cont
 		ms_start = sub->start_time;
 		ms_end = sub->end_time;
 	}
-	else if (context->prev_start == -1 && (sub->flags & SUB_EOD_MARKER))
+	else
 	{
 		ms_start = 1;
 		ms_end = sub->start_time;
@@ -48,46 +451,28 @@ int write_cc_bitmap_as_libcurl(struct cc_subtitle *sub, struct encoder_ctx *cont
 	if (sub->flags & SUB_EOD_MARKER)
 		context->prev_start = sub->start_time;
 
-	str = paraof_ocrtext(sub, context->encoded_crlf, context->encoded_crlf_length);
+	str = paraof_ocrtext(sub, context);
 	if (str)
 	{
 		if (context->prev_start != -1 || !(sub->flags & SUB_EOD_MARKER))
 		{
-			millis_to_time(ms_start, &h1, &m1, &s1, &ms1);
-			millis_to_time(ms_end - 1, &h2, &m2, &s2, &ms2); // -1 To prevent overlapping with next line.
 			context->srt_counter++;
-			snprintf(timeline, sizeof(timeline), "group_id=ccextractordev&start_time=%" PRIu64 "&end_time=%" PRIu64 "&lang=en", ms_start, ms_end);
+			snprintf(timeline, sizeof(timeline), "group_id=ccextractordev&start_time=%" PRId64 "&end_time=%" PRId64 "&lang=en", ms_start, ms_end);
 			char *curlline = NULL;
 			curlline = str_reallocncat(curlline, timeline);
 			curlline = str_reallocncat(curlline, "&payload=");
 			char *urlencoded = curl_easy_escape(curl, str, 0);
 			curlline = str_reallocncat(curlline, urlencoded);
 			curl_free(urlencoded);
-			mprint("%s", curlline);
-
-			size_t result_size = strlen(ccx_options.curlposturl) + strlen("/frame/") + 1;
-			char *result = malloc(result_size);
-			if (!result)
-			{
-				fatal(EXIT_NOT_ENOUGH_MEMORY, "In write_cc_bitmap_as_curl: Out of memory allocating result.");
-			}
-			snprintf(result, result_size, "%s/frame/", ccx_options.curlposturl);
-			curl_easy_setopt(curl, CURLOPT_URL, result);
-			curl_easy_setopt(curl, CURLOPT_POSTFIELDS, curlline);
-			free(result);
-
-			res = curl_easy_perform(curl);
-			/* Check for errors */
-			if (res != CURLE_OK)
-				mprint("curl_easy_perform() failed: %s\n",
-				       curl_easy_strerror(res));
+			mprint("%s\n", curlline);
+			curl_sink_post(curlline);
 		}
 		freep(&str);
 	}
 	for (i = 0, rect = sub->data; i < sub->nb_data; i++, rect++)
 	{
-		freep(rect->data);
-		freep(rect->data + 1);
+		freep(&rect->data0);
+		freep(&rect->data1);
 	}
 #endif
 	sub->nb_data = 0;
@@ -22,7 +22,7 @@ int write_stringz_as_sami(char *string, struct encoder_ctx *context, LLONG ms_st
 	}
 
 	used = encode_line(context, context->buffer, (unsigned char *)str);
-	ret = write(context->out->fh, context->buffer, used);
+	ret = buffered_write(context->out->fh, context->buffer, used);
 	if (ret != used)
 		return ret;
 
@@ -70,15 +70,15 @@ int write_stringz_as_sami(char *string, struct encoder_ctx *context, LLONG ms_st
 			dbg_print(CCX_DMT_DECODER_608, "\r");
 			dbg_print(CCX_DMT_DECODER_608, "%s\n", context->subline);
 		}
-		ret = write(context->out->fh, el, u);
+		ret = buffered_write(context->out->fh, el, u);
 		if (ret != u)
 			goto end;
 
-		ret = write(context->out->fh, context->encoded_br, context->encoded_br_length);
+		ret = buffered_write(context->out->fh, context->encoded_br, context->encoded_br_length);
 		if (ret != context->encoded_br_length)
 			goto end;
 
-		ret = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+		ret = buffered_write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
 		if (ret != context->encoded_crlf_length)
 			goto end;
 
@@ -91,7 +91,7 @@ int write_stringz_as_sami(char *string, struct encoder_ctx *context, LLONG ms_st
 		dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 	}
 	used = encode_line(context, context->buffer, (unsigned char *)str);
-	ret = write(context->out->fh, context->buffer, used);
+	ret = buffered_write(context->out->fh, context->buffer, used);
 	if (ret != used)
 		goto end;
 	snprintf(str, sizeof(str),
@@ -101,7 +101,7 @@ int write_stringz_as_sami(char *string, struct encoder_ctx *context, LLONG ms_st
 	{
 		dbg_print(CCX_DMT_DECODER_608, "\r%s\n", str);
 	}
-	ret = write(context->out->fh, context->buffer, used);
+	ret = buffered_write(context->out->fh, context->buffer, used);
 	if (ret != used)
 		goto end;
 
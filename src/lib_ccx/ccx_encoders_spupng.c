@@ -62,11 +62,7 @@ struct spupng_t *spunpg_init(struct ccx_s_write *out)
 		spupng_init_font();
 	}
 
-	if ((sp->fpxml = fdopen(out->fh, "w")) == NULL)
-	{
-		ccx_common_logging.fatal_ftn(CCX_COMMON_EXIT_FILE_CREATION_FAILED, "Cannot open %s: %s\n",
-					     out->filename, strerror(errno));
-	}
+	sp->xml = out;
 	size_t filename_len = strlen(out->filename);
 	sp->dirname = (char *)malloc(
 	    sizeof(char) * (filename_len + 3));
@@ -135,7 +131,7 @@ void spunpg_free(struct spupng_t *sp)
 
 void spupng_write_header(struct spupng_t *sp, int multiple_files, char *first_input_file)
 {
-	fprintf(sp->fpxml, "<subpictures>\n<stream>\n");
+	fdprintf(sp->xml->fh, "<subpictures>\n<stream>\n");
 
 	if (multiple_files)
 	{
@@ -146,15 +142,14 @@ void spupng_write_header(struct spupng_t *sp, int multiple_files, char *first_in
 
 		base = base ? base + 1 : first_input_file;
 
-		fprintf(sp->fpxml, "<!-- %s -->\n", base);
+		fdprintf(sp->xml->fh, "<!-- %s -->\n", base);
 	}
 }
 
 void spupng_write_footer(struct spupng_t *sp)
 {
-	fprintf(sp->fpxml, "</stream>\n</subpictures>\n");
-	fflush(sp->fpxml);
-	fclose(sp->fpxml);
+	fdprintf(sp->xml->fh, "</stream>\n</subpictures>\n");
+	close_output(sp->xml);
 }
 
 void write_spumux_header(struct encoder_ctx *ctx, struct ccx_s_write *out)
@@ -187,21 +182,21 @@ void write_spumux_footer(struct ccx_s_write *out)
 
 void write_sputag_open(struct spupng_t *sp, LLONG ms_start, LLONG ms_end)
 {
-	fprintf(sp->fpxml, "<spu start=\"%.3f\"", ((double)ms_start) / 1000);
-	fprintf(sp->fpxml, " end=\"%.3f\"", ((double)ms_end) / 1000);
-	fprintf(sp->fpxml, " image=\"%s\"", sp->relative_path_png);
-	fprintf(sp->fpxml, " xoffset=\"%d\"", sp->xOffset);
-	fprintf(sp->fpxml, " yoffset=\"%d\"", sp->yOffset);
-	fprintf(sp->fpxml, ">\n");
+	fdprintf(sp->xml->fh, "<spu start=\"%.3f\"", ((double)ms_start) / 1000);
+	fdprintf(sp->xml->fh, " end=\"%.3f\"", ((double)ms_end) / 1000);
+	fdprintf(sp->xml->fh, " image=\"%s\"", sp->relative_path_png);
+	fdprintf(sp->xml->fh, " xoffset=\"%d\"", sp->xOffset);
+	fdprintf(sp->xml->fh, " yoffset=\"%d\"", sp->yOffset);
+	fdprintf(sp->xml->fh, ">\n");
 }
 
 void write_sputag_close(struct spupng_t *sp)
 {
-	fprintf(sp->fpxml, "</spu>\n");
+	fdprintf(sp->xml->fh, "</spu>\n");
 }
 void write_spucomment(struct spupng_t *sp, const char *str)
 {
-	fprintf(sp->fpxml, "<!--\n");
+	fdprintf(sp->xml->fh, "<!--\n");
 
 	const char *p = str;
 	const char *last_safe_pos = str; // Track the last safe position to flush
@@ -214,10 +209,10 @@ void write_spucomment(struct spupng_t *sp, const char *str)
 
 			if (p > last_safe_pos)
 			{
-				fwrite(last_safe_pos, 1, p - last_safe_pos, sp->fpxml);
+				buffered_write(sp->xml->fh, last_safe_pos, p - last_safe_pos);
 			}
 
-			fputc('-', sp->fpxml);
+			buffered_write(sp->xml->fh, "-", 1);
 			p += 2;
 			last_safe_pos = p;
 		}
@@ -229,10 +224,10 @@ void write_spucomment(struct spupng_t *sp, const char *str)
 
 	if (p > last_safe_pos)
 	{
-		fwrite(last_safe_pos, 1, p - last_safe_pos, sp->fpxml);
+		buffered_write(sp->xml->fh, last_safe_pos, p - last_safe_pos);
 	}
 
-	fprintf(sp->fpxml, "\n-->\n");
+	fdprintf(sp->xml->fh, "\n-->\n");
 }
 
 char *get_spupng_filename(void *ctx)
@@ -27,11 +27,15 @@ struct ccx_s_write
 	char *playlist_filename;
 	int renaming_extension; // Used for file rotations
 	int append_mode;	/* Append the file. Prevent overwriting of files */
+	unsigned char *wbuf;	/* Output arena, see buffered_write() */
+	size_t wbuf_used;
+	size_t wbuf_size;
+	struct rcwt_chunk_writer *rcwt; /* Indexed RCWT being written, see rcwt_write() */
 };
 
 struct spupng_t
 {
-	FILE *fpxml;
+	struct ccx_s_write *xml; /* The spumux XML, written through buffered_write() */
 	FILE *fppng;
 	char *dirname;
 	char *pngfile;
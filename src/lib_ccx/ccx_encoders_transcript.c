@@ -146,7 +146,7 @@ int write_cc_subtitle_as_transcript(struct cc_subtitle *sub, struct encoder_ctx
 
 			if (wrote_something)
 			{
-				ret = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+				ret = buffered_write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
 				if (ret < context->encoded_crlf_length)
 				{
 					mprint("Warning:Loss of data\n");
@@ -204,7 +204,7 @@ int write_cc_subtitle_as_transcript(struct cc_subtitle *sub, struct encoder_ctx
 				else
 					fdprintf(context->out->fh, "%s|", sub->mode);
 			}
-			ret = write(context->out->fh, context->subline, length);
+			ret = buffered_write(context->out->fh, context->subline, length);
 			if (ret < length)
 			{
 				mprint("Warning:Loss of data\n");
@@ -214,7 +214,7 @@ int write_cc_subtitle_as_transcript(struct cc_subtitle *sub, struct encoder_ctx
 
 		} while ((str = strtok_r(NULL, "\r\n", &save_str)));
 
-		ret = write(context->out->fh, context->encoded_end_frame, context->encoded_end_frame_length);
+		ret = buffered_write(context->out->fh, context->encoded_end_frame, context->encoded_end_frame_length);
 		if (ret < context->encoded_end_frame_length)
 		{
 			mprint("Warning:Loss of data\n");
@@ -328,7 +328,7 @@ void write_cc_line_as_transcript2(struct eia608_screen *data, struct encoder_ctx
 			fdprintf(context->out->fh, "%s|", mode);
 		}
 
-		ret = write(context->out->fh, context->subline, length);
+		ret = buffered_write(context->out->fh, context->subline, length);
 		if (ret < length)
 		{
 			mprint("Warning:Loss of data\n");
@@ -349,7 +349,7 @@ int write_cc_buffer_as_transcript2(struct eia608_screen *data, struct encoder_ct
 		{
 			if (wrote_something)
 			{
-				ret = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+				ret = buffered_write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
 				if (ret < context->encoded_crlf_length)
 				{
 					mprint("Warning:Loss of data\n");
@@ -363,7 +363,7 @@ int write_cc_buffer_as_transcript2(struct eia608_screen *data, struct encoder_ct
 
 	if (wrote_something)
 	{
-		ret = write(context->out->fh, context->encoded_end_frame, context->encoded_end_frame_length);
+		ret = buffered_write(context->out->fh, context->encoded_end_frame, context->encoded_end_frame_length);
 		if (ret < context->encoded_end_frame_length)
 		{
 			mprint("Warning:Loss of data\n");
@@ -137,7 +137,7 @@ int write_stringz_as_webvtt(char *string, struct encoder_ctx *context, LLONG ms_
 	dbg_print(CCX_DMT_DECODER_608, "\n- - - WEBVTT caption - - -\n");
 	dbg_print(CCX_DMT_DECODER_608, "%s", timeline);
 
-	written = write(context->out->fh, context->buffer, used);
+	written = buffered_write(context->out->fh, context->buffer, used);
 	if (written != used)
 		return -1;
 	int len = strlen(string);
@@ -178,14 +178,14 @@ int write_stringz_as_webvtt(char *string, struct encoder_ctx *context, LLONG ms_
 			dbg_print(CCX_DMT_DECODER_608, "\r");
 			dbg_print(CCX_DMT_DECODER_608, "%s\n", context->subline);
 		}
-		written = write(context->out->fh, el, u);
+		written = buffered_write(context->out->fh, el, u);
 		if (written != u)
 		{
 			free(el);
 			free(unescaped);
 			return -1;
 		}
-		written = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+		written = buffered_write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
 		if (written != context->encoded_crlf_length)
 		{
 			free(el);
@@ -197,7 +197,7 @@ int write_stringz_as_webvtt(char *string, struct encoder_ctx *context, LLONG ms_
 
 	dbg_print(CCX_DMT_DECODER_608, "- - - - - - - - - - - -\r\n");
 
-	written = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+	written = buffered_write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
 	free(el);
 	free(unescaped);
 	if (written != context->encoded_crlf_length)
@@ -463,7 +463,7 @@ int write_cc_buffer_as_webvtt(struct eia608_screen *data, struct encoder_ctx *co
 
 			dbg_print(CCX_DMT_DECODER_608, "\n- - - WEBVTT caption - - -\n");
 			dbg_print(CCX_DMT_DECODER_608, "%s", timeline);
-			written = write(context->out->fh, context->buffer, used);
+			written = buffered_write(context->out->fh, context->buffer, used);
 			if (written != used)
 				return -1;
 
@@ -554,12 +554,12 @@ int write_cc_buffer_as_webvtt(struct eia608_screen *data, struct encoder_ctx *co
 				free(font_events);
 			}
 
-			written = write(context->out->fh,
+			written = buffered_write(context->out->fh,
 					context->encoded_crlf, context->encoded_crlf_length);
 			if (written != context->encoded_crlf_length)
 				return -1;
 
-			written = write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
+			written = buffered_write(context->out->fh, context->encoded_crlf, context->encoded_crlf_length);
 			if (written != context->encoded_crlf_length)
 				return -1;
 
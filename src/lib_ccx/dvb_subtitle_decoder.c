@@ -530,6 +530,19 @@ void *dvbsub_init_decoder(struct dvb_config *cfg)
 
 	return (void *)ctx;
 }
+
+/* The configuration dvb_ctx was created with, so an equal decoder can be made */
+void dvbsub_get_config(void *dvb_ctx, struct dvb_config *cfg)
+{
+	DVBSubContext *ctx = (DVBSubContext *)dvb_ctx;
+
+	memset(cfg, 0, sizeof(struct dvb_config));
+	cfg->n_language = 1;
+	cfg->composition_id[0] = ctx->composition_id;
+	cfg->ancillary_id[0] = ctx->ancillary_id;
+	cfg->lang_index[0] = ctx->lang_index;
+}
+
 int dvbsub_close_decoder(void **dvb_ctx)
 {
 	DVBSubContext *ctx;
@@ -44,6 +44,12 @@ extern "C"
 	 */
 	void *dvbsub_init_decoder(struct dvb_config *cfg);
 
+	/**
+	 * @param dvb_ctx DVB context returned by dvbsub_init_decoder
+	 * @param cfg     filled with the configuration dvb_ctx was created with
+	 */
+	void dvbsub_get_config(void *dvb_ctx, struct dvb_config *cfg);
+
 	int dvbsub_close_decoder(void **dvb_ctx);
 
 	/**
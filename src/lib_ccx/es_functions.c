@@ -18,7 +18,7 @@ static int read_eau_info(struct encoder_ctx *enc_ctx, struct lib_cc_decode *ctx,
 static int extension_and_user_data(struct encoder_ctx *enc_ctx, struct lib_cc_decode *ctx, struct bitstream *esstream, int udtype, struct cc_subtitle *sub);
 static int read_pic_data(struct bitstream *esstream);
 
-#define debug(...) ccx_common_logging.debug_ftn(CCX_DMT_VERBOSE, __VA_ARGS__)
+#define debug(...) ccx_dbg(CCX_DMT_VERBOSE, __VA_ARGS__)
 
 extern uint8_t ccxr_search_start_code(struct bitstream *esstream);
 extern uint8_t ccxr_next_start_code(struct bitstream *esstream);
@@ -80,6 +80,31 @@ static size_t inline buffered_read(struct ccx_demuxer *ctx, unsigned char *buffe
 	return result;
 }
 
+/**
+ * Consume bytes from the input without copying them when possible.
+ *
+ * If all the requested bytes are in the file buffer, a pointer into the
+ * buffer is returned; it stays valid until the next buffered read. Otherwise
+ * (the bytes straddle a refill) they are read into fallback, which must be
+ * able to hold them, and fallback is returned.
+ *
+ * @param result set to the number of bytes consumed; on a short read this
+ *               is less than bytes and the returned data is incomplete.
+ */
+static inline unsigned char *buffered_view(struct ccx_demuxer *ctx, unsigned char *fallback, size_t bytes, size_t *result)
+{
+	unsigned char *view;
+	if (bytes <= buffered_bytes_left(ctx))
+	{
+		view = ctx->filebuffer + ctx->filebuffer_pos;
+		ctx->filebuffer_pos += (unsigned int)bytes;
+		*result = bytes;
+		return view;
+	}
+	*result = buffered_read(ctx, fallback, bytes);
+	return fallback;
+}
+
 /**
  * Read single byte from file buffer and if needed also read file for number of bytes.
  *
@@ -97,7 +97,7 @@ void prepare_for_new_file(struct lib_ccx_ctx *ctx)
 		}
 		for (int i = 0; i < TS_PMT_MAP_SIZE; i++)
 		{
-			ctx->eit_programs[i].array_len = 0;
+			EPG_clear_program(&ctx->eit_programs[i]);
 			ctx->eit_current_events[i] = -1;
 		}
 		ctx->epg_last_output = -1;
@@ -260,6 +260,21 @@ void buffered_seek(struct ccx_demuxer *ctx, int offset)
 	}
 }
 
+/* Continue reading the current file from byte pos, dropping whatever is
+   buffered. Only for regular files. Returns -1, with nothing changed, if the
+   file could not be repositioned. */
+int buffered_seek_to(struct ccx_demuxer *ctx, LLONG pos)
+{
+	if (LSEEK(ctx->infd, pos, SEEK_SET) != pos)
+		return -1;
+	ctx->filebuffer_start = pos;
+	ctx->filebuffer_pos = 0;
+	ctx->bytesinbuffer = 0;
+	ctx->past = pos;
+	position_sanity_check(ctx);
+	return 0;
+}
+
 void sleepandchecktimeout(time_t start)
 {
 	if (ccx_options.input_source == CCX_DS_STDIN)
@@ -4,6 +4,8 @@
 #include <io.h>
 #else
 #include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
 #endif
 
 #include "dvb_subtitle_decoder.h"
@@ -19,6 +21,8 @@
 #include "dvd_subtitle_decoder.h"
 #include "ccx_demuxer_mxf.h"
 #include "ccx_dtvcc.h"
+#include "zlib.h"
+#include "networking.h"
 
 int end_of_file = 0; // End of file?
 
@@ -321,6 +325,51 @@ int ps_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **ppdata)
 	return payload_read;
 }
 
+/* For --startat: the first pack header at or after file position from.
+   Returns 1 and sets *pos to its start and *clock to its SCR base, 0 if there
+   is none in the next CLOCK_SCAN_LIMIT bytes. Moves the file position. Same
+   signature as ts_find_clock(), pid is unused. */
+static int ps_find_clock(struct ccx_demuxer *ctx, LLONG from, int *pid, LLONG *pos, LLONG *clock)
+{
+	unsigned char *buf = malloc(CLOCK_SCAN_CHUNK);
+	LLONG start = from;
+	int found = 0;
+
+	if (buf == NULL)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In ps_find_clock: Out of memory.");
+
+	while (!found && start < from + CLOCK_SCAN_LIMIT && LSEEK(ctx->infd, start, SEEK_SET) == start)
+	{
+		int n = read(ctx->infd, buf, CLOCK_SCAN_CHUNK);
+		int i;
+		if (n < 10)
+			break;
+
+		for (i = 0; i + 9 < n; i++)
+		{
+			const unsigned char *p = buf + i;
+			if (p[0] != 0x00 || p[1] != 0x00 || p[2] != 0x01 || p[3] != 0xBA)
+				continue;
+			if ((p[4] & 0xC4) == 0x44 && (p[6] & 0x04) && (p[8] & 0x04)) // MPEG-2, with marker bits
+				*clock = ((LLONG)((p[4] >> 3) & 0x07) << 30) | ((LLONG)(p[4] & 0x03) << 28) | (p[5] << 20) |
+					 (((p[6] >> 3) & 0x1F) << 15) | ((p[6] & 0x03) << 13) | (p[7] << 5) | (p[8] >> 3);
+			else if ((p[4] & 0xF1) == 0x21 && (p[6] & 0x01) && (p[8] & 0x01)) // MPEG-1
+				*clock = ((LLONG)((p[4] >> 1) & 0x07) << 30) | (p[5] << 22) | ((p[6] >> 1) << 15) |
+					 (p[7] << 7) | (p[8] >> 1);
+			else
+				continue;
+			*pos = start + i;
+			found = 1;
+			break;
+		}
+		if (n < CLOCK_SCAN_CHUNK)
+			break;
+		start += n - 9; // A header may straddle the chunks
+	}
+	free(buf);
+	return found;
+}
+
 // Returns number of bytes read, or CCX_OF for EOF
 int general_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **data)
 {
@@ -715,6 +764,9 @@ int raw_loop(struct lib_ccx_ctx *ctx)
 		ret = general_get_more_data(ctx, &data);
 		if (ret == CCX_EOF)
 			break;
+#ifdef WITH_LIBCURL
+		curl_sink_poll();
+#endif
 
 		// Check if this is DVD raw format using Rust detection
 		if (!is_dvdraw && !is_scc && ccxr_is_dvdraw_header(data->buffer, (unsigned int)data->len))
@@ -1145,12 +1197,12 @@ int process_non_multiprogram_general_loop(struct lib_ccx_ctx *ctx,
 	int pid = get_best_stream(ctx->demux_ctx);
 	if (pid < 0)
 	{
-		*data_node = get_best_data(*datalist);
+		*data_node = get_best_data(ctx->demux_ctx, *datalist);
 	}
 	else
 	{
 		ignore_other_stream(ctx->demux_ctx, pid);
-		*data_node = get_data_stream(*datalist, pid);
+		*data_node = get_data_stream(ctx->demux_ctx, *datalist, pid);
 	}
 
 	if (ccx_options.analyze_video_stream)
@@ -1162,7 +1214,7 @@ int process_non_multiprogram_general_loop(struct lib_ccx_ctx *ctx,
 			struct lib_cc_decode *dec_ctx_video = update_decoder_list_cinfo(ctx, cinfo_video);
 			*enc_ctx = update_encoder_list_cinfo(ctx, cinfo_video);
 			struct cc_subtitle *dec_sub_video = &dec_ctx_video->dec_sub;
-			struct demuxer_data *data_node_video = get_data_stream(*datalist, video_pid);
+			struct demuxer_data *data_node_video = get_data_stream(ctx->demux_ctx, *datalist, video_pid);
 
 			if (data_node_video)
 			{
@@ -1330,7 +1382,7 @@ int process_non_multiprogram_general_loop(struct lib_ccx_ctx *ctx,
 			if (dvb_iter->pid == pid)
 				continue;
 
-			struct demuxer_data *dvb_data = get_data_stream(*datalist, dvb_iter->pid);
+			struct demuxer_data *dvb_data = get_data_stream(ctx->demux_ctx, *datalist, dvb_iter->pid);
 			if (!dvb_data || dvb_data->len == 0)
 				continue;
 
@@ -1376,6 +1428,627 @@ int process_non_multiprogram_general_loop(struct lib_ccx_ctx *ctx,
 	return ret;
 }
 
+/* Line up the decoder/encoder pair of cinfo's program (cinfo is NULL if the
+ * program has no caption stream) and feed it this pass's data_node, NULL if the
+ * pass brought the program nothing. demux_done tells the demuxer has stopped. */
+static int decode_multiprogram_program(struct lib_ccx_ctx *ctx,
+				       struct cap_info *cinfo,
+				       struct demuxer_data *data_node,
+				       struct program_info *pinfo,
+				       int nb_program,
+				       int demux_done,
+				       struct lib_cc_decode **pdec_ctx,
+				       uint64_t *min_pts,
+				       int ret,
+				       int *caps)
+{
+	struct lib_cc_decode *dec_ctx = NULL;
+	struct encoder_ctx *enc_ctx = NULL;
+
+	enc_ctx = update_encoder_list_cinfo(ctx, cinfo);
+	dec_ctx = update_decoder_list_cinfo(ctx, cinfo);
+	*pdec_ctx = dec_ctx;
+	if (ccx_options.program_worker >= 0)
+	{
+		if (!dec_ctx->timing_globals)
+		{
+			dec_ctx->timing_globals = malloc(sizeof(struct ccx_timing_globals));
+			if (!dec_ctx->timing_globals)
+				fatal(EXIT_NOT_ENOUGH_MEMORY, "In decode_multiprogram_program: Out of memory allocating timing globals.");
+			init_timing_globals(dec_ctx->timing_globals);
+		}
+		restore_timing_globals(dec_ctx->timing_globals);
+	}
+#ifndef DISABLE_RUST
+	ccxr_dtvcc_set_encoder(dec_ctx->dtvcc_rust, enc_ctx);
+#else
+	dec_ctx->dtvcc->encoder = (void *)enc_ctx; // WARN: otherwise cea-708 will not work
+#endif
+
+	if (dec_ctx->timing->min_pts == 0x01FFFFFFFFLL) // if we didn't set the min_pts of the program
+	{
+		int p_index = 0; // program index
+		for (int i = 0; i < nb_program; i++)
+		{
+			if (dec_ctx->program_number == pinfo[i].program_number)
+			{
+				p_index = i;
+				break;
+			}
+		}
+
+		if (dec_ctx->codec == CCX_CODEC_TELETEXT) // even if there's no sub data, we still need to set the min_pts
+		{
+			if (pinfo[p_index].got_important_streams_min_pts[PRIVATE_STREAM_1] != UINT64_MAX) // Teletext is synced with subtitle packet PTS
+			{
+				*min_pts = pinfo[p_index].got_important_streams_min_pts[PRIVATE_STREAM_1]; // it means we got the first pts for private stream 1
+				set_current_pts(dec_ctx->timing, *min_pts);
+				set_fts(dec_ctx->timing);
+			}
+		}
+		if (dec_ctx->codec == CCX_CODEC_DVB) // DVB will always have to be in sync with audio (no matter the min_pts of the other streams)
+		{
+			if (pinfo[p_index].got_important_streams_min_pts[AUDIO] != UINT64_MAX) // it means we got the first pts for audio
+			{
+				*min_pts = pinfo[p_index].got_important_streams_min_pts[AUDIO];
+				set_current_pts(dec_ctx->timing, *min_pts);
+				// For DVB subtitles, directly set min_pts to fix negative timestamps
+				if (dec_ctx->timing->min_pts == 0x01FFFFFFFFLL)
+				{
+					dec_ctx->timing->min_pts = *min_pts;
+					dec_ctx->timing->pts_set = 2; // MinPtsSet
+					dec_ctx->timing->sync_pts = *min_pts;
+				}
+				set_fts(dec_ctx->timing);
+			}
+		}
+	}
+
+	if (enc_ctx)
+		enc_ctx->timing = dec_ctx->timing;
+
+	if (!data_node)
+	{
+		if (dec_ctx->timing_globals)
+			save_timing_globals(dec_ctx->timing_globals);
+		return ret;
+	}
+
+	if (data_node->pts != CCX_NOPTS)
+	{
+		set_current_pts(dec_ctx->timing, data_node->pts);
+		// For DVB subtitles, use the first subtitle PTS as min_pts if audio hasn't been seen yet
+		if (dec_ctx->codec == CCX_CODEC_DVB && dec_ctx->timing->min_pts == 0x01FFFFFFFFLL)
+		{
+			dec_ctx->timing->min_pts = data_node->pts;
+			dec_ctx->timing->pts_set = 2; // MinPtsSet
+			dec_ctx->timing->sync_pts = data_node->pts;
+		}
+	}
+
+	ret = process_data(enc_ctx, dec_ctx, data_node);
+	if (enc_ctx != NULL)
+	{
+		if (
+		    ((enc_ctx && (enc_ctx->srt_counter || enc_ctx->cea_708_counter)) ||
+		     dec_ctx->saw_caption_block || ret == 1))
+			*caps = 1;
+	}
+	// Process the last subtitle for DVB
+	if (demux_done || is_decoder_processed_enough(ctx) == CCX_TRUE)
+	{
+		if (data_node->bufferdatatype == CCX_DVB_SUBTITLE && dec_ctx && dec_ctx->dec_sub.prev && dec_ctx->dec_sub.prev->end_time == 0)
+		{
+			dec_ctx->dec_sub.prev->end_time = (dec_ctx->timing->current_pts - dec_ctx->timing->min_pts) / (MPEG_CLOCK_FREQ / 1000);
+			if (enc_ctx != NULL)
+				encode_sub(enc_ctx->prev, dec_ctx->dec_sub.prev);
+			dec_ctx->dec_sub.prev->got_output = 0;
+		}
+	}
+	if (dec_ctx->timing_globals)
+		save_timing_globals(dec_ctx->timing_globals);
+	return ret;
+}
+
+struct program_workers;
+
+#ifndef _WIN32
+/* --multiprogram --jobs: the demuxer stays in this process and deals the
+ * programs out to ccx_options.jobs worker processes by program number. Each
+ * worker runs the decoders and encoders of its programs and writes their
+ * files. Workers are processes rather than threads because the timing globals
+ * are shared with the Rust decoders; a worker swaps them per decoder.
+ *
+ * Every pass of general_loop() sends each program a message, with or without
+ * data, so its decoder sees the same calls as in the serial loop. A message is
+ * a program_worker_msg, nb_streams program_worker_stream entries describing
+ * the program's caption streams and len bytes of data. */
+
+#define PROGRAM_WORKER_MAX_STREAMS 32
+#define PROGRAM_WORKER_BUFFER (64 * 1024) // Messages collected before a write()
+
+// A caption stream as the demuxer set it up, for the worker to do the same
+struct program_worker_stream
+{
+	int pid;
+	enum ccx_stream_type stream;
+	enum ccx_code_type codec;
+	char lang[4];
+	struct dvb_config dvb; // CCX_CODEC_DVB only
+};
+
+struct program_worker_msg
+{
+	int end; // No more messages, flush and exit
+	int program_number;
+	unsigned cinfo_generation; // The worker empties its cinfo_tree too when this changes
+	int encoders_elsewhere;	   // Whether the serial loop would have created an encoder before
+	int nb_streams;
+	int pid; // The stream picked for the program, -1 if none
+	uint64_t got_min_pts[COUNT];
+	int demux_done;
+	int has_data;
+	int data_program_number;
+	int stream_pid;
+	enum ccx_code_type codec;
+	enum ccx_bufferdata_type bufferdatatype;
+	unsigned int rollover_bits;
+	LLONG pts;
+	struct ccx_rational tb;
+	size_t len;
+};
+
+struct program_worker
+{
+	pid_t pid;
+	int fd; // Write end of its pipe, -1 once it is gone
+	unsigned char *buf;
+	size_t used, size;
+};
+
+struct program_workers
+{
+	int count;
+	unsigned long calls; // Programs handed out so far
+	struct program_worker *w;
+};
+
+static int use_program_workers(struct lib_ccx_ctx *ctx, enum ccx_stream_mode_enum stream_mode)
+{
+	return ccx_options.jobs > 1 && ccx_options.program_worker < 0 && ctx->multiprogram &&
+	       stream_mode == CCX_SM_TRANSPORT && ctx->write_format != CCX_OF_NULL &&
+	       ctx->out_interval == -1 && !ccx_options.send_to_srv;
+}
+
+static void program_worker_flush(struct program_workers *workers, int i)
+{
+	struct program_worker *w = &workers->w[i];
+	size_t done = 0;
+
+	while (w->fd >= 0 && done < w->used)
+	{
+		ssize_t n = write(w->fd, w->buf + done, w->used - done);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+		{
+			mprint("WARNING: Program worker %d stopped (%s), its programs are no longer decoded.\n", i, strerror(errno));
+			close(w->fd);
+			w->fd = -1;
+			break;
+		}
+		done += n;
+	}
+	w->used = 0;
+}
+
+static void program_worker_append(struct program_workers *workers, int i, const void *data, size_t len)
+{
+	struct program_worker *w = &workers->w[i];
+
+	if (w->used + len > w->size)
+	{
+		size_t size = w->size ? w->size : PROGRAM_WORKER_BUFFER;
+		while (size < w->used + len)
+			size *= 2;
+		w->buf = realloc(w->buf, size);
+		if (!w->buf)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In program_worker_append: Out of memory allocating message buffer.");
+		w->size = size;
+	}
+	memcpy(w->buf + w->used, data, len);
+	w->used += len;
+}
+
+/* Hand one program's share of this pass to its worker */
+static void program_workers_send(struct lib_ccx_ctx *ctx, struct program_workers *workers,
+				 struct cap_info *program_iter, struct cap_info *cinfo,
+				 struct demuxer_data *data_node, int demux_done)
+{
+	struct ccx_demuxer *demux = ctx->demux_ctx;
+	int i = program_iter->program_number % workers->count;
+	struct program_worker_msg msg;
+	struct program_worker_stream stream;
+	struct cap_info *iter;
+	int p_index = 0;
+
+	if (workers->w[i].fd < 0)
+		return;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.program_number = program_iter->program_number;
+	msg.cinfo_generation = demux->cinfo_generation;
+	msg.encoders_elsewhere = workers->calls++ > 0;
+	msg.pid = cinfo ? cinfo->pid : -1;
+	msg.demux_done = demux_done;
+	for (int p = 0; p < demux->nb_program; p++)
+	{
+		if (demux->pinfo[p].program_number == program_iter->program_number)
+		{
+			p_index = p;
+			break;
+		}
+	}
+	memcpy(msg.got_min_pts, demux->pinfo[p_index].got_important_streams_min_pts, sizeof(msg.got_min_pts));
+	list_for_each_entry(iter, &program_iter->sib_head, sib_stream, struct cap_info)
+	{
+		if (msg.nb_streams < PROGRAM_WORKER_MAX_STREAMS)
+			msg.nb_streams++;
+	}
+	if (data_node)
+	{
+		msg.has_data = 1;
+		msg.data_program_number = data_node->program_number;
+		msg.stream_pid = data_node->stream_pid;
+		msg.codec = data_node->codec;
+		msg.bufferdatatype = data_node->bufferdatatype;
+		msg.rollover_bits = data_node->rollover_bits;
+		msg.pts = data_node->pts;
+		msg.tb = data_node->tb;
+		msg.len = data_node->len;
+	}
+	program_worker_append(workers, i, &msg, sizeof(msg));
+
+	int n = 0;
+	list_for_each_entry(iter, &program_iter->sib_head, sib_stream, struct cap_info)
+	{
+		if (n++ == msg.nb_streams)
+			break;
+		memset(&stream, 0, sizeof(stream));
+		stream.pid = iter->pid;
+		stream.stream = iter->stream;
+		stream.codec = iter->codec;
+		memcpy(stream.lang, iter->lang, sizeof(stream.lang));
+		if (iter->codec == CCX_CODEC_DVB && iter->codec_private_data)
+			dvbsub_get_config(iter->codec_private_data, &stream.dvb);
+		program_worker_append(workers, i, &stream, sizeof(stream));
+	}
+	if (msg.len)
+		program_worker_append(workers, i, data_node->buffer, msg.len);
+
+	if (workers->w[i].used >= PROGRAM_WORKER_BUFFER || ctx->live_stream)
+		program_worker_flush(workers, i);
+}
+
+/* Start the workers. Returns NULL in a worker, with *worker_fd set to the
+ * read end of its pipe. */
+static struct program_workers *start_program_workers(struct lib_ccx_ctx *ctx, int *worker_fd)
+{
+	struct program_workers *workers = malloc(sizeof(struct program_workers));
+	if (!workers)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In start_program_workers: Out of memory allocating workers.");
+	workers->count = ccx_options.jobs;
+	workers->calls = 0;
+	workers->w = calloc(workers->count, sizeof(struct program_worker));
+	if (!workers->w)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In start_program_workers: Out of memory allocating workers.");
+
+	mprint("Decoding the programs in %d worker processes\n", workers->count);
+	// A worker that died is noticed by write() failing
+	signal(SIGPIPE, SIG_IGN);
+	for (int i = 0; i < workers->count; i++)
+	{
+		int fds[2];
+		pid_t pid;
+
+		if (pipe(fds) < 0)
+			fatal(EXIT_NOT_CLASSIFIED, "In start_program_workers: pipe() failed: %s\n", strerror(errno));
+		// Don't let the workers inherit (and print again) anything still buffered
+		fflush(stdout);
+		fflush(stderr);
+		pid = fork();
+		if (pid < 0)
+			fatal(EXIT_NOT_CLASSIFIED, "Unable to start a program worker: %s\n", strerror(errno));
+		if (pid == 0)
+		{
+			close(fds[1]);
+			for (int j = 0; j < i; j++)
+			{
+				close(workers->w[j].fd);
+				free(workers->w[j].buf);
+			}
+			free(workers->w);
+			free(workers);
+			ccx_options.program_worker = i;
+			ccx_options.no_progress_bar = 1;
+			ctx->epg_inited = 0; // The demuxer process writes the EPG
+			*worker_fd = fds[0];
+			return NULL;
+		}
+		close(fds[0]);
+		workers->w[i].pid = pid;
+		workers->w[i].fd = fds[1];
+	}
+	return workers;
+}
+
+/* Tell the workers the demuxer is done and wait for them. Returns whether
+ * any found captions. */
+static int stop_program_workers(struct program_workers *workers)
+{
+	struct program_worker_msg msg;
+	int caps = 0, failed = 0, last_failure = EXIT_OK;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.end = 1;
+	for (int i = 0; i < workers->count; i++)
+	{
+		program_worker_append(workers, i, &msg, sizeof(msg));
+		program_worker_flush(workers, i);
+		if (workers->w[i].fd >= 0)
+			close(workers->w[i].fd);
+	}
+	for (int i = 0; i < workers->count; i++)
+	{
+		int status;
+		while (waitpid(workers->w[i].pid, &status, 0) < 0)
+		{
+			if (errno != EINTR)
+				fatal(EXIT_NOT_CLASSIFIED, "In stop_program_workers: waitpid() failed: %s\n", strerror(errno));
+		}
+		if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_OK)
+			caps = 1;
+		else if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_NO_CAPTIONS)
+		{
+			failed++;
+			last_failure = WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_NOT_CLASSIFIED;
+		}
+		free(workers->w[i].buf);
+	}
+	free(workers->w);
+	free(workers);
+	if (failed)
+		fatal(last_failure, "%d program worker(s) failed, see their messages above.\n", failed);
+	return caps;
+}
+
+static int read_full(int fd, void *buf, size_t len)
+{
+	size_t done = 0;
+
+	while (done < len)
+	{
+		ssize_t n = read(fd, (unsigned char *)buf + done, len - done);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return -1;
+		done += n;
+	}
+	return 0;
+}
+
+/* Set up stream in the worker's demuxer the way the demuxer process did */
+static void mirror_program_stream(struct ccx_demuxer *demux, int pn, struct program_worker_stream *stream)
+{
+	struct cap_info *iter;
+	void *private_data = NULL;
+
+	list_for_each_entry(iter, &demux->cinfo_tree.all_stream, all_stream, struct cap_info)
+	{
+		// update_capinfo() leaves streams alone once they are known
+		if (iter->pid == stream->pid && iter->codec != CCX_CODEC_NONE && iter->stream != CCX_STREAM_TYPE_UNKNOWNSTREAM)
+			return;
+	}
+	if (stream->codec == CCX_CODEC_DVB)
+		private_data = dvbsub_init_decoder(&stream->dvb);
+	else if (stream->codec == CCX_CODEC_ISDB_CC)
+		private_data = init_isdb_decoder();
+	if (update_capinfo(demux, stream->pid, stream->stream, stream->codec, pn, private_data, stream->lang[0] ? stream->lang : NULL) != CCX_OK)
+	{
+		if (stream->codec == CCX_CODEC_DVB)
+			dvbsub_close_decoder(&private_data);
+		else if (stream->codec == CCX_CODEC_ISDB_CC)
+			delete_isdb_decoder(&private_data);
+	}
+}
+
+/* The worker's side: decode the programs the demuxer process sends until it
+ * is done. Returns whether captions were found. */
+static int run_program_worker(struct lib_ccx_ctx *ctx, int fd)
+{
+	struct program_worker_msg msg;
+	struct program_worker_stream streams[PROGRAM_WORKER_MAX_STREAMS];
+	struct program_info *pinfo;
+	struct demuxer_data *data;
+	struct lib_cc_decode *dec_ctx = NULL;
+	unsigned generation = ctx->demux_ctx->cinfo_generation;
+	uint64_t min_pts = UINT64_MAX;
+	size_t size = BUFSIZE;
+	int ret = 0, caps = 0;
+
+	pinfo = calloc(1, sizeof(struct program_info));
+	data = alloc_demuxer_data();
+	if (!pinfo || !data)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In run_program_worker: Out of memory allocating buffers.");
+
+	while (1)
+	{
+		if (read_full(fd, &msg, sizeof(msg)) < 0)
+		{
+			mprint("WARNING: Program worker %d lost the demuxer process.\n", ccx_options.program_worker);
+			break;
+		}
+		if (msg.end)
+			break;
+		if (msg.nb_streams < 0 || msg.nb_streams > PROGRAM_WORKER_MAX_STREAMS ||
+		    read_full(fd, streams, msg.nb_streams * sizeof(struct program_worker_stream)) < 0)
+			fatal(EXIT_NOT_CLASSIFIED, "In run_program_worker: Bad message from the demuxer process.\n");
+		if (msg.len > size)
+		{
+			while (size < msg.len)
+				size *= 2;
+			data->buffer = realloc(data->buffer, size);
+			if (!data->buffer)
+				fatal(EXIT_NOT_ENOUGH_MEMORY, "In run_program_worker: Out of memory allocating data buffer.");
+		}
+		if (msg.len && read_full(fd, data->buffer, msg.len) < 0)
+			fatal(EXIT_NOT_CLASSIFIED, "In run_program_worker: Bad message from the demuxer process.\n");
+
+		if (msg.cinfo_generation != generation)
+		{
+			// The demuxer process saw a new PAT and dropped its streams
+			dinit_cap(ctx->demux_ctx);
+			generation = msg.cinfo_generation;
+		}
+		for (int i = 0; i < msg.nb_streams; i++)
+			mirror_program_stream(ctx->demux_ctx, msg.program_number, &streams[i]);
+		ctx->enc_ctx_elsewhere = msg.encoders_elsewhere;
+
+		struct cap_info *cinfo = NULL;
+		struct cap_info *iter;
+		list_for_each_entry(iter, &ctx->demux_ctx->cinfo_tree.all_stream, all_stream, struct cap_info)
+		{
+			if (iter->pid == msg.pid)
+			{
+				cinfo = iter;
+				break;
+			}
+		}
+
+		pinfo->program_number = msg.program_number;
+		memcpy(pinfo->got_important_streams_min_pts, msg.got_min_pts, sizeof(msg.got_min_pts));
+		data->program_number = msg.data_program_number;
+		data->stream_pid = msg.stream_pid;
+		data->codec = msg.codec;
+		data->bufferdatatype = msg.bufferdatatype;
+		data->rollover_bits = msg.rollover_bits;
+		data->pts = msg.pts;
+		data->tb = msg.tb;
+		data->len = msg.len;
+		ret = decode_multiprogram_program(ctx, cinfo, msg.has_data ? data : NULL, pinfo, 1,
+						  msg.demux_done, &dec_ctx, &min_pts, ret, &caps);
+	}
+	close(fd);
+	delete_demuxer_data(data);
+	free(pinfo);
+	return caps;
+}
+#endif
+
+/* One program's share of a multiprogram general_loop() iteration: pick its
+ * caption stream and feed this pass's data for it to its decoder, or to the
+ * worker process decoding it. */
+static int process_multiprogram_program(struct lib_ccx_ctx *ctx,
+					struct cap_info *program_iter,
+					struct demuxer_data *datalist,
+					struct demuxer_data **pdata_node,
+					struct lib_cc_decode **pdec_ctx,
+					uint64_t *min_pts,
+					int ret,
+					int *caps,
+					struct program_workers *workers)
+{
+	struct cap_info *cinfo = NULL;
+	struct demuxer_data *data_node = NULL;
+
+	cinfo = get_best_sib_stream(program_iter);
+	if (!cinfo)
+	{
+		data_node = get_best_data(ctx->demux_ctx, datalist);
+	}
+	else
+	{
+		ignore_other_sib_stream(program_iter, cinfo->pid);
+		data_node = get_data_stream(ctx->demux_ctx, datalist, cinfo->pid);
+	}
+	*pdata_node = data_node;
+
+#ifndef _WIN32
+	if (workers)
+	{
+		program_workers_send(ctx, workers, program_iter, cinfo, data_node, terminate_asap || end_of_file);
+		return ret;
+	}
+#endif
+	return decode_multiprogram_program(ctx, cinfo, data_node, ctx->demux_ctx->pinfo, ctx->demux_ctx->nb_program,
+					   terminate_asap || end_of_file, pdec_ctx, min_pts, ret, caps);
+}
+
+int is_past_extraction_end(struct lib_cc_decode *dec_ctx)
+{
+	return dec_ctx->extraction_end.set && dec_ctx->timing->pts_set == 2 &&
+	       get_fts(dec_ctx->timing, dec_ctx->current_field) > dec_ctx->extraction_end.time_in_ms + CCX_EXTRACTION_MARGIN_MS;
+}
+
+// Whether the input is a single regular file whose times can be looked up
+int can_seek_input(struct lib_ccx_ctx *ctx)
+{
+	return ccx_options.input_source == CCX_DS_FILE && !ccx_options.live_stream &&
+	       ctx->num_input_files == 1 && ctx->inputsize > 0 && !ctx->multiprogram &&
+	       // The jump in PTS must not be taken for a discontinuity
+	       ccx_common_timing_settings.disable_sync_check && ccx_options.use_gop_as_pts != 1;
+}
+
+/* --startat on a TS or PS file: once dec_ctx has its time reference, bisect
+   the rest of the file on PCR (TS) or SCR (PS) for the position
+   CCX_EXTRACTION_MARGIN_MS before the start time and go on reading from
+   there. Clock values are taken relative to the current position, so a
+   single 33-bit wrap is handled. */
+static void seek_to_extraction_start(struct lib_ccx_ctx *ctx, struct lib_cc_decode *dec_ctx, enum ccx_stream_mode_enum stream_mode)
+{
+	struct ccx_demuxer *demux = ctx->demux_ctx;
+	int (*find_clock)(struct ccx_demuxer *, LLONG, int *, LLONG *, LLONG *) =
+	    stream_mode == CCX_SM_TRANSPORT ? ts_find_clock : ps_find_clock;
+	LLONG skip_ms = dec_ctx->extraction_start.time_in_ms - CCX_EXTRACTION_MARGIN_MS -
+			get_fts(dec_ctx->timing, dec_ctx->current_field);
+	LLONG resume, lo, hi, base, pos, clock;
+	int pid = -1;
+
+	if (skip_ms < CCX_EXTRACTION_MARGIN_MS) // Not worth a seek
+		return;
+	resume = LSEEK(demux->infd, 0, SEEK_CUR);
+	if (resume < 0)
+		return;
+	if (!find_clock(demux, demux->past, &pid, &lo, &base))
+	{
+		LSEEK(demux->infd, resume, SEEK_SET);
+		return;
+	}
+
+	LLONG target = skip_ms * (MPEG_CLOCK_FREQ / 1000);
+	LLONG start = lo;
+	hi = ctx->inputsize;
+	while (hi - lo > CLOCK_SCAN_CHUNK)
+	{
+		LLONG mid = lo + (hi - lo) / 2;
+		if (!find_clock(demux, mid, &pid, &pos, &clock) || pos >= hi)
+			hi = mid;
+		else if (((clock - base) & 0x1FFFFFFFFLL) <= target)
+			lo = pos;
+		else
+			hi = mid;
+	}
+
+	if (lo == start || buffered_seek_to(demux, lo) < 0)
+	{
+		LSEEK(demux->infd, resume, SEEK_SET);
+		return;
+	}
+	mprint("\rSkipping to %s (file position %lld) for --startat\n",
+	       print_mstime_static(dec_ctx->extraction_start.time_in_ms - CCX_EXTRACTION_MARGIN_MS), lo);
+}
+
 int general_loop(struct lib_ccx_ctx *ctx)
 {
 	struct lib_cc_decode *dec_ctx = NULL;
@@ -1385,14 +2058,33 @@ int general_loop(struct lib_ccx_ctx *ctx)
 	int (*get_more_data)(struct lib_ccx_ctx *c, struct demuxer_data **d) = NULL;
 	int ret = 0;
 	int caps = 0;
+	struct program_workers *workers = NULL;
 
 	uint64_t min_pts = UINT64_MAX;
 
 	stream_mode = ctx->demux_ctx->get_stream_mode(ctx->demux_ctx);
 
+	// --fast-avc-scan relies on each PES packet holding one access unit, an
+	// elementary stream is read in arbitrary chunks instead
+	ctx->dec_global_setting->fast_avc_scan = ccx_options.fast_avc_scan;
+	if (ccx_options.fast_avc_scan && stream_mode == CCX_SM_ELEMENTARY_OR_NOT_FOUND)
+	{
+		mprint("WARNING: --fast-avc-scan needs PES packets, ignoring it for this elementary stream input.\n");
+		ctx->dec_global_setting->fast_avc_scan = 0;
+	}
+	list_for_each_entry(dec_ctx, &ctx->dec_ctx_head, list, struct lib_cc_decode)
+	{
+		// Decoders kept from the previous input file
+		dec_ctx->avc_ctx->fast_scan = ctx->dec_global_setting->fast_avc_scan;
+	}
+	dec_ctx = NULL;
+
 	if (stream_mode == CCX_SM_TRANSPORT && ctx->write_format == CCX_OF_NULL)
 		ctx->multiprogram = 1;
 
+	int seek_pending = ccx_options.extraction_start.set && can_seek_input(ctx) &&
+			   (stream_mode == CCX_SM_TRANSPORT || stream_mode == CCX_SM_PROGRAM);
+
 	switch (stream_mode)
 	{
 		case CCX_SM_ELEMENTARY_OR_NOT_FOUND:
@@ -1433,6 +2125,20 @@ int general_loop(struct lib_ccx_ctx *ctx)
 
 	end_of_file = 0;
 
+#ifndef _WIN32
+	if (use_program_workers(ctx, stream_mode))
+	{
+		int worker_fd = -1;
+		workers = start_program_workers(ctx, &worker_fd);
+		if (!workers)
+		{
+			// This is a worker, its data comes from the demuxer process
+			caps = run_program_worker(ctx, worker_fd);
+			end_of_file = 1;
+		}
+	}
+#endif
+
 	while (!terminate_asap && !end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE)
 	{
 		// GET MORE DATA IN BUFFER
@@ -1442,6 +2148,9 @@ int general_loop(struct lib_ccx_ctx *ctx)
 		{
 			end_of_file = 1;
 		}
+#ifdef WITH_LIBCURL
+		curl_sink_poll();
+#endif
 		if (!datalist)
 			continue;
 		position_sanity_check(ctx->demux_ctx);
@@ -1464,110 +2173,22 @@ int general_loop(struct lib_ccx_ctx *ctx)
 			{
 				break;
 			}
+			if (seek_pending && dec_ctx && dec_ctx->timing->pts_set == 2)
+			{
+				seek_pending = 0;
+				seek_to_extraction_start(ctx, dec_ctx, stream_mode);
+			}
+			// The decoders only notice --endat when they get captions
+			if (dec_ctx && is_past_extraction_end(dec_ctx))
+				dec_ctx->processed_enough = 1;
 		}
 		else
 		{
-			struct cap_info *cinfo = NULL;
 			struct cap_info *program_iter = NULL;
 			struct cap_info *ptr = &ctx->demux_ctx->cinfo_tree;
-			struct encoder_ctx *enc_ctx = NULL;
 			list_for_each_entry(program_iter, &ptr->pg_stream, pg_stream, struct cap_info)
 			{
-				cinfo = get_best_sib_stream(program_iter);
-				if (!cinfo)
-				{
-					data_node = get_best_data(datalist);
-				}
-				else
-				{
-					ignore_other_sib_stream(program_iter, cinfo->pid);
-					data_node = get_data_stream(datalist, cinfo->pid);
-				}
-
-				enc_ctx = update_encoder_list_cinfo(ctx, cinfo);
-				dec_ctx = update_decoder_list_cinfo(ctx, cinfo);
-#ifndef DISABLE_RUST
-				ccxr_dtvcc_set_encoder(dec_ctx->dtvcc_rust, enc_ctx);
-#else
-				dec_ctx->dtvcc->encoder = (void *)enc_ctx; // WARN: otherwise cea-708 will not work
-#endif
-
-				if (dec_ctx->timing->min_pts == 0x01FFFFFFFFLL) // if we didn't set the min_pts of the program
-				{
-					int p_index = 0; // program index
-					for (int i = 0; i < ctx->demux_ctx->nb_program; i++)
-					{
-						if (dec_ctx->program_number == ctx->demux_ctx->pinfo[i].program_number)
-						{
-							p_index = i;
-							break;
-						}
-					}
-
-					if (dec_ctx->codec == CCX_CODEC_TELETEXT) // even if there's no sub data, we still need to set the min_pts
-					{
-						if (ctx->demux_ctx->pinfo[p_index].got_important_streams_min_pts[PRIVATE_STREAM_1] != UINT64_MAX) // Teletext is synced with subtitle packet PTS
-						{
-							min_pts = ctx->demux_ctx->pinfo[p_index].got_important_streams_min_pts[PRIVATE_STREAM_1]; // it means we got the first pts for private stream 1
-							set_current_pts(dec_ctx->timing, min_pts);
-							set_fts(dec_ctx->timing);
-						}
-					}
-					if (dec_ctx->codec == CCX_CODEC_DVB) // DVB will always have to be in sync with audio (no matter the min_pts of the other streams)
-					{
-						if (ctx->demux_ctx->pinfo[p_index].got_important_streams_min_pts[AUDIO] != UINT64_MAX) // it means we got the first pts for audio
-						{
-							min_pts = ctx->demux_ctx->pinfo[p_index].got_important_streams_min_pts[AUDIO];
-							set_current_pts(dec_ctx->timing, min_pts);
-							// For DVB subtitles, directly set min_pts to fix negative timestamps
-							if (dec_ctx->timing->min_pts == 0x01FFFFFFFFLL)
-							{
-								dec_ctx->timing->min_pts = min_pts;
-								dec_ctx->timing->pts_set = 2; // MinPtsSet
-								dec_ctx->timing->sync_pts = min_pts;
-							}
-							set_fts(dec_ctx->timing);
-						}
-					}
-				}
-
-				if (enc_ctx)
-					enc_ctx->timing = dec_ctx->timing;
-
-				if (!data_node)
-					continue;
-
-				if (data_node->pts != CCX_NOPTS)
-				{
-					set_current_pts(dec_ctx->timing, data_node->pts);
-					// For DVB subtitles, use the first subtitle PTS as min_pts if audio hasn't been seen yet
-					if (dec_ctx->codec == CCX_CODEC_DVB && dec_ctx->timing->min_pts == 0x01FFFFFFFFLL)
-					{
-						dec_ctx->timing->min_pts = data_node->pts;
-						dec_ctx->timing->pts_set = 2; // MinPtsSet
-						dec_ctx->timing->sync_pts = data_node->pts;
-					}
-				}
-
-				ret = process_data(enc_ctx, dec_ctx, data_node);
-				if (enc_ctx != NULL)
-				{
-					if (
-					    ((enc_ctx && (enc_ctx->srt_counter || enc_ctx->cea_708_counter)) ||
-					     dec_ctx->saw_caption_block || ret == 1))
-						caps = 1;
-				}
-				// Process the last subtitle for DVB
-				if (!(!terminate_asap && !end_of_file && is_decoder_processed_enough(ctx) == CCX_FALSE))
-				{
-					if (data_node->bufferdatatype == CCX_DVB_SUBTITLE && dec_ctx && dec_ctx->dec_sub.prev && dec_ctx->dec_sub.prev->end_time == 0)
-					{
-						dec_ctx->dec_sub.prev->end_time = (dec_ctx->timing->current_pts - dec_ctx->timing->min_pts) / (MPEG_CLOCK_FREQ / 1000);
-						if (enc_ctx != NULL)
-							encode_sub(enc_ctx->prev, dec_ctx->dec_sub.prev);
-						dec_ctx->dec_sub.prev->got_output = 0;
-					}
-				}
+				ret = process_multiprogram_program(ctx, program_iter, datalist, &data_node, &dec_ctx, &min_pts, ret, &caps, workers);
 			}
 			if (!data_node)
 				continue;
@@ -1606,7 +2227,7 @@ int general_loop(struct lib_ccx_ctx *ctx)
 				int progress = (int)((((ctx->total_past + ctx->demux_ctx->past) >> 8) * 100) / (ctx->total_inputsize >> 8));
 				if (ctx->last_reported_progress != progress)
 				{
-					LLONG t = get_fts(dec_ctx->timing, dec_ctx->current_field);
+					LLONG t = dec_ctx ? get_fts(dec_ctx->timing, dec_ctx->current_field) : 0;
 					if (!t && ctx->demux_ctx->global_timestamp_inited)
 						t = ctx->demux_ctx->global_timestamp - ctx->demux_ctx->min_global_timestamp;
 					// For multi-program TS files, different programs can have different
@@ -1649,10 +2270,22 @@ int general_loop(struct lib_ccx_ctx *ctx)
 			net_check_conn();
 	}
 
-	struct encoder_ctx *enc_ctx = update_encoder_list(ctx);
+#ifndef _WIN32
+	if (workers && stop_program_workers(workers))
+		caps = 1;
+#endif
+
+	// Multiprogram decoders flush into their own program's file
+	struct encoder_ctx *enc_ctx = ctx->multiprogram ? NULL : update_encoder_list(ctx);
 
 	list_for_each_entry(dec_ctx, &ctx->dec_ctx_head, list, struct lib_cc_decode)
 	{
+		if (ctx->multiprogram)
+		{
+			enc_ctx = get_encoder_by_pn(ctx, dec_ctx->program_number);
+			if (dec_ctx->timing_globals)
+				restore_timing_globals(dec_ctx->timing_globals);
+		}
 
 		if (dec_ctx->codec == CCX_CODEC_TELETEXT)
 		{
@@ -1670,8 +2303,9 @@ int general_loop(struct lib_ccx_ctx *ctx)
 				}
 			}
 		}
-		// Flush remaining HD captions
-		if (dec_ctx->has_ccdata_buffered)
+		// Flush remaining HD captions, a program whose encoder was never
+		// created has nowhere to write them
+		if (dec_ctx->has_ccdata_buffered && (enc_ctx || !ctx->multiprogram))
 			process_hdcc(enc_ctx, dec_ctx, &dec_ctx->dec_sub);
 
 		mprint("\nNumber of NAL_type_7: %ld\n", dec_ctx->avc_ctx->num_nal_unit_type_7);
@@ -1682,6 +2316,7 @@ int general_loop(struct lib_ccx_ctx *ctx)
 		free(dec_ctx->xds_ctx);
 	}
 
+	reset_demuxer_data_index(ctx->demux_ctx);
 	delete_datalist(datalist);
 	if (ctx->total_past != ctx->total_inputsize && ctx->binary_concat && is_decoder_processed_enough(ctx))
 	{
@@ -1692,6 +2327,221 @@ int general_loop(struct lib_ccx_ctx *ctx)
 	return caps;
 }
 
+/* Indexed RCWT (RCWT_FORMAT_INDEXED): the data headers of the current
+   "CCDT" chunk, uncompressed. */
+struct rcwt_chunk_reader
+{
+	unsigned char *data;
+	size_t data_size;
+	size_t used;
+	size_t pos;
+	unsigned char *packed;
+	size_t packed_size;
+};
+
+// Largest chunk payload accepted, anything bigger is taken for a broken file
+#define RCWT_CHUNK_MAX (16 * 1024 * 1024)
+
+static int rcwt_parse_chunk_header(const unsigned char *header, int *flags, uint32_t *size, uint32_t *raw_size, LLONG *value)
+{
+	if (memcmp(header, RCWT_CHUNK_DATA, 4) && memcmp(header, RCWT_CHUNK_INDEX, 4) && memcmp(header, RCWT_CHUNK_TRAILER, 4))
+		return -1;
+	*flags = header[4];
+	memcpy(size, header + 8, 4);
+	memcpy(raw_size, header + 12, 4);
+	memcpy(value, header + 16, 8);
+	if (*size > RCWT_CHUNK_MAX || *raw_size > RCWT_CHUNK_MAX)
+		return -1;
+	return 0;
+}
+
+static void rcwt_grow(unsigned char **buf, size_t *buf_size, size_t size)
+{
+	if (size <= *buf_size)
+		return;
+	unsigned char *grown = realloc(*buf, size);
+	if (!grown)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In rcwt_grow: Out of memory allocating RCWT chunk.");
+	*buf = grown;
+	*buf_size = size;
+}
+
+/* Load the next "CCDT" chunk into r. Returns 0 at the trailer or at the end
+   of the file, -1 if the file is broken. */
+static int rcwt_next_chunk(struct ccx_demuxer *demux, struct rcwt_chunk_reader *r)
+{
+	unsigned char header[RCWT_CHUNK_HEADER_LEN];
+	uint32_t size, raw_size;
+	LLONG value;
+	int flags;
+	size_t result;
+
+	while (1)
+	{
+		result = buffered_read(demux, header, sizeof(header));
+		demux->past += result;
+		if (result == 0)
+			return 0;
+		if (result != sizeof(header) || rcwt_parse_chunk_header(header, &flags, &size, &raw_size, &value) < 0)
+			return -1;
+		if (!memcmp(header, RCWT_CHUNK_TRAILER, 4))
+			return 0;
+		if (memcmp(header, RCWT_CHUNK_DATA, 4))
+		{
+			result = buffered_skip(demux, size);
+			demux->past += result;
+			if (result != size)
+				return -1;
+			continue;
+		}
+
+		if (flags & RCWT_CHUNK_ZLIB)
+		{
+			uLongf unpacked = raw_size;
+			rcwt_grow(&r->packed, &r->packed_size, size);
+			rcwt_grow(&r->data, &r->data_size, raw_size);
+			result = buffered_read(demux, r->packed, size);
+			demux->past += result;
+			if (result != size || uncompress(r->data, &unpacked, r->packed, size) != Z_OK || unpacked != raw_size)
+				return -1;
+		}
+		else
+		{
+			rcwt_grow(&r->data, &r->data_size, size);
+			result = buffered_read(demux, r->data, size);
+			demux->past += result;
+			if (result != size)
+				return -1;
+			raw_size = size;
+		}
+		r->used = raw_size;
+		r->pos = 0;
+		if (r->used)
+			return 1;
+	}
+}
+
+/* Read like buffered_read(), from the data headers in the chunks. Returns the
+   number of bytes copied, short at the end of the data. */
+static size_t rcwt_chunk_read(struct ccx_demuxer *demux, struct rcwt_chunk_reader *r, unsigned char *buffer, size_t bytes)
+{
+	size_t copied = 0;
+
+	while (copied < bytes)
+	{
+		if (r->pos == r->used)
+		{
+			int ret = rcwt_next_chunk(demux, r);
+			if (ret < 0)
+				mprint("Broken RCWT chunk at file position %lld\n", demux->past);
+			if (ret <= 0)
+				break;
+		}
+		size_t n = MIN(bytes - copied, r->used - r->pos);
+		memcpy(buffer + copied, r->data + r->pos, n);
+		r->pos += n;
+		copied += n;
+	}
+	return copied;
+}
+
+/* --startat on indexed RCWT: look up the last "CCDT" chunk starting
+   CCX_EXTRACTION_MARGIN_MS or more before the start time, in the index
+   chunks found from the trailer or, in a file cut short, by walking the
+   chunk headers, and go on reading from there. */
+static void rcwt_seek_to_extraction_start(struct lib_ccx_ctx *ctx, LLONG first_chunk)
+{
+	struct ccx_demuxer *demux = ctx->demux_ctx;
+	LLONG target = ccx_options.extraction_start.time_in_ms - CCX_EXTRACTION_MARGIN_MS;
+	unsigned char header[RCWT_CHUNK_HEADER_LEN];
+	unsigned char *index = NULL;
+	uint32_t size, raw_size;
+	LLONG value, resume, pos;
+	LLONG best = first_chunk;
+	int flags;
+
+	if (target < CCX_EXTRACTION_MARGIN_MS) // Not worth a seek
+		return;
+	resume = LSEEK(demux->infd, 0, SEEK_CUR);
+	if (resume < 0)
+		return;
+
+	pos = ctx->inputsize - RCWT_CHUNK_HEADER_LEN;
+	if (LSEEK(demux->infd, pos, SEEK_SET) == pos && read(demux->infd, header, sizeof(header)) == sizeof(header) &&
+	    !memcmp(header, RCWT_CHUNK_TRAILER, 4) && rcwt_parse_chunk_header(header, &flags, &size, &raw_size, &value) == 0)
+	{
+		// Index chunks are chained from the last one back
+		for (pos = value; pos > 0 && best == first_chunk;)
+		{
+			if (LSEEK(demux->infd, pos, SEEK_SET) != pos || read(demux->infd, header, sizeof(header)) != sizeof(header) ||
+			    memcmp(header, RCWT_CHUNK_INDEX, 4) || rcwt_parse_chunk_header(header, &flags, &size, &raw_size, &value) < 0)
+				break;
+			index = realloc(index, size ? size : 1);
+			if (!index)
+				fatal(EXIT_NOT_ENOUGH_MEMORY, "In rcwt_seek_to_extraction_start: Out of memory.");
+			if (read(demux->infd, index, size) != (int)size)
+				break;
+			for (uint32_t i = 0; i + 16 <= size; i += 16)
+			{
+				LLONG fts, offset;
+				memcpy(&fts, index + i, 8);
+				memcpy(&offset, index + i + 8, 8);
+				if (fts > target)
+					break;
+				best = offset;
+			}
+			pos = value;
+		}
+		free(index);
+	}
+	else
+	{
+		for (pos = first_chunk; LSEEK(demux->infd, pos, SEEK_SET) == pos;)
+		{
+			if (read(demux->infd, header, sizeof(header)) != sizeof(header) ||
+			    rcwt_parse_chunk_header(header, &flags, &size, &raw_size, &value) < 0 ||
+			    !memcmp(header, RCWT_CHUNK_TRAILER, 4))
+				break;
+			if (!memcmp(header, RCWT_CHUNK_DATA, 4))
+			{
+				if (value > target)
+					break;
+				best = pos;
+			}
+			pos += sizeof(header) + size;
+		}
+	}
+
+	if (best == first_chunk || buffered_seek_to(demux, best) < 0)
+	{
+		LSEEK(demux->infd, resume, SEEK_SET);
+		return;
+	}
+	mprint("\rSkipping to %s (file position %lld) for --startat\n", print_mstime_static(target), best);
+}
+
+/* Feed the cc blocks of one RCWT record, taken at currfts ms, to dec_ctx. */
+static void rcwt_process_record(struct lib_cc_decode *dec_ctx, LLONG currfts, unsigned char *cc, uint16_t cbcount)
+{
+	set_current_pts(dec_ctx->timing, currfts * (MPEG_CLOCK_FREQ / 1000));
+	set_fts(dec_ctx->timing); // Now set the FTS related variables
+
+	for (int j = 0; j < cbcount * 3; j = j + 3)
+	{
+		do_cb(dec_ctx, cc + j, &dec_ctx->dec_sub);
+	}
+}
+
+/* Set minimum and current pts since rcwt has correct time.
+ * Also set pts_set = 2 (MinPtsSet) so the Rust timing code knows
+ * that min_pts is valid and can calculate fts_now properly. */
+static void rcwt_init_timing(struct lib_cc_decode *dec_ctx)
+{
+	dec_ctx->timing->min_pts = 0;
+	dec_ctx->timing->current_pts = 0;
+	dec_ctx->timing->pts_set = 2; // 2 = min_pts set
+}
+
 // Raw caption with FTS file process
 int rcwt_loop(struct lib_ccx_ctx *ctx)
 {
@@ -1707,6 +2557,8 @@ int rcwt_loop(struct lib_ccx_ctx *ctx)
 	LLONG result;
 	struct encoder_ctx *enc_ctx = update_encoder_list(ctx);
 	struct TeletextCtx *telctx;
+	struct rcwt_chunk_reader chunks = {0};
+	int indexed = 0;
 	// As BUFSIZE is a macro this is just a reminder
 	if (BUFSIZE < (3 * 0xFFFF + 10))
 		fatal(CCX_COMMON_EXIT_BUG_BUG, "In rcwt_loop: BUFSIZE too small for RCWT caption block.\n");
@@ -1753,19 +2605,23 @@ int rcwt_loop(struct lib_ccx_ctx *ctx)
 		dec_ctx->codec = CCX_CODEC_TELETEXT;
 		dec_ctx->private_data = telxcc_init();
 	}
+	else if (parsebuf[6] == RCWT_FORMAT_INDEXED && parsebuf[7] == 1)
+	{
+		indexed = 1;
+		if (ccx_options.extraction_start.set && can_seek_input(ctx))
+			rcwt_seek_to_extraction_start(ctx, ctx->demux_ctx->past);
+	}
 	dec_sub = &dec_ctx->dec_sub;
 	telctx = dec_ctx->private_data;
 
-	/* Set minimum and current pts since rcwt has correct time.
-	 * Also set pts_set = 2 (MinPtsSet) so the Rust timing code knows
-	 * that min_pts is valid and can calculate fts_now properly. */
-	dec_ctx->timing->min_pts = 0;
-	dec_ctx->timing->current_pts = 0;
-	dec_ctx->timing->pts_set = 2; // 2 = min_pts set
+	rcwt_init_timing(dec_ctx);
 
 	// Loop until no more data is found
 	while (1)
 	{
+#ifdef WITH_LIBCURL
+		curl_sink_poll();
+#endif
 		if (parsebuf[6] == 0 && parsebuf[7] == 2)
 		{
 			result = buffered_read(ctx->demux_ctx, buf, TELETEXT_CHUNK_LEN);
@@ -1786,8 +2642,13 @@ int rcwt_loop(struct lib_ccx_ctx *ctx)
 		}
 
 		// Read the data header
-		result = buffered_read(ctx->demux_ctx, parsebuf, 10);
-		ctx->demux_ctx->past += result;
+		if (indexed)
+			result = rcwt_chunk_read(ctx->demux_ctx, &chunks, parsebuf, 10);
+		else
+		{
+			result = buffered_read(ctx->demux_ctx, parsebuf, 10);
+			ctx->demux_ctx->past += result;
+		}
 		bread += (int)result;
 
 		if (result != 10)
@@ -1818,8 +2679,13 @@ int rcwt_loop(struct lib_ccx_ctx *ctx)
 				parsebuf = new_parsebuf;
 				parsebufsize = cbcount * 3;
 			}
-			result = buffered_read(ctx->demux_ctx, parsebuf, cbcount * 3);
-			ctx->demux_ctx->past += result;
+			if (indexed)
+				result = rcwt_chunk_read(ctx->demux_ctx, &chunks, parsebuf, cbcount * 3);
+			else
+			{
+				result = buffered_read(ctx->demux_ctx, parsebuf, cbcount * 3);
+				ctx->demux_ctx->past += result;
+			}
 			bread += (int)result;
 			if (result != cbcount * 3)
 			{
@@ -1828,14 +2694,7 @@ int rcwt_loop(struct lib_ccx_ctx *ctx)
 				break;
 			}
 
-			// Process the data
-			set_current_pts(dec_ctx->timing, currfts * (MPEG_CLOCK_FREQ / 1000));
-			set_fts(dec_ctx->timing); // Now set the FTS related variables
-
-			for (int j = 0; j < cbcount * 3; j = j + 3)
-			{
-				do_cb(dec_ctx, parsebuf + j, dec_sub);
-			}
+			rcwt_process_record(dec_ctx, currfts, parsebuf, cbcount);
 		}
 		if (dec_sub->got_output)
 		{
@@ -1843,6 +2702,8 @@ int rcwt_loop(struct lib_ccx_ctx *ctx)
 			encode_sub(enc_ctx, dec_sub);
 			dec_sub->got_output = 0;
 		}
+		if (is_past_extraction_end(dec_ctx))
+			break;
 	} // end while(1)
 
 	dbg_print(CCX_DMT_PARSE, "Processed %d bytes\n", bread);
@@ -1859,6 +2720,272 @@ int rcwt_loop(struct lib_ccx_ctx *ctx)
 
 	/* Free XDS context - similar to cleanup in general_loop */
 	free(dec_ctx->xds_ctx);
+	free(chunks.data);
+	free(chunks.packed);
 	free(parsebuf);
 	return caps;
 }
+
+/*
+ * --tcp-senders: RCWT from several --sendto senders at once. Each sender
+ * gets a channel with its own decoder, encoder and output file. Channels of
+ * senders that sent a --tcp-description are kept when the sender goes away,
+ * so that it picks up the same file when it connects again.
+ */
+struct tcp_sender_channel
+{
+	struct list_head list;
+	char *desc;		 // NULL for a sender without --tcp-description
+	struct net_sender *sender; // NULL while disconnected
+	struct lib_cc_decode *dec_ctx;
+	struct encoder_ctx *enc_ctx;
+	unsigned char *buf; // RCWT bytes not yet making up a whole record
+	size_t buf_used;
+	size_t buf_size;
+};
+
+struct tcp_senders_state
+{
+	struct lib_ccx_ctx *ctx;
+	struct list_head channels;
+	int caps;
+};
+
+static struct tcp_sender_channel *tcp_channel_create(struct tcp_senders_state *state, struct net_sender *sender)
+{
+	struct lib_ccx_ctx *ctx = state->ctx;
+	struct tcp_sender_channel *channel = calloc(1, sizeof(struct tcp_sender_channel));
+	char suffix[64];
+	if (!channel)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In tcp_channel_create: Out of memory allocating channel.");
+
+	if (sender->desc)
+	{
+		// The description ends up in a file name
+		size_t i;
+		channel->desc = strdup(sender->desc);
+		if (!channel->desc)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In tcp_channel_create: Out of memory allocating channel.");
+		snprintf(suffix, sizeof(suffix), "_%s", sender->desc);
+		for (i = 1; suffix[i]; i++)
+		{
+			if (!isalnum((unsigned char)suffix[i]) && suffix[i] != '-' && suffix[i] != '.')
+				suffix[i] = '_';
+		}
+	}
+	else
+		snprintf(suffix, sizeof(suffix), "_%u", sender->id);
+
+	// The sender id tells the channels apart in the decoder and encoder lists
+	ctx->dec_global_setting->codec = CCX_CODEC_ATSC_CC;
+	ctx->dec_global_setting->program_number = sender->id;
+	channel->dec_ctx = init_cc_decode(ctx->dec_global_setting);
+	if (!channel->dec_ctx)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In tcp_channel_create: Not enough memory to init_cc_decode.\n");
+	list_add_tail(&channel->dec_ctx->list, &ctx->dec_ctx_head);
+	rcwt_init_timing(channel->dec_ctx);
+
+	const char *extension = get_file_extension(ccx_options.enc_cfg.write_format);
+	if (ctx->write_format != CCX_OF_NULL && extension)
+	{
+		struct encoder_cfg local_cfg = ccx_options.enc_cfg;
+		char *basefilename = get_basename(ctx->basefilename);
+		local_cfg.program_number = sender->id;
+		local_cfg.output_filename = create_outfilename(basefilename, suffix, extension);
+		free(basefilename);
+		channel->enc_ctx = init_encoder(&local_cfg);
+		if (channel->enc_ctx)
+		{
+			channel->enc_ctx->program_number = sender->id;
+			list_add_tail(&channel->enc_ctx->list, &ctx->enc_ctx_head);
+			channel->enc_ctx->prev = NULL;
+			channel->enc_ctx->write_previous = 0;
+			mprint("Writing captions from sender %u to %s\n", sender->id, local_cfg.output_filename);
+		}
+		free(local_cfg.output_filename);
+	}
+#ifndef DISABLE_RUST
+	ccxr_dtvcc_set_encoder(channel->dec_ctx->dtvcc_rust, channel->enc_ctx);
+#else
+	channel->dec_ctx->dtvcc->encoder = (void *)channel->enc_ctx; // WARN: otherwise cea-708 will not work
+#endif
+
+	list_add_tail(&channel->list, &state->channels);
+	return channel;
+}
+
+/* Write out what the decoder of channel still holds. */
+static void tcp_channel_flush(struct tcp_senders_state *state, struct tcp_sender_channel *channel)
+{
+	struct lib_cc_decode *dec_ctx = channel->dec_ctx;
+
+	flush_cc_decode(dec_ctx, &dec_ctx->dec_sub);
+	if (dec_ctx->dec_sub.got_output)
+	{
+		encode_sub(channel->enc_ctx, &dec_ctx->dec_sub);
+		dec_ctx->dec_sub.got_output = 0;
+	}
+	if (channel->enc_ctx && (channel->enc_ctx->srt_counter || channel->enc_ctx->cea_708_counter))
+		state->caps = 1;
+	if (dec_ctx->saw_caption_block)
+		state->caps = 1;
+}
+
+static void tcp_channel_free(struct tcp_sender_channel *channel)
+{
+	LLONG fts = get_fts(channel->dec_ctx->timing, channel->dec_ctx->current_field);
+
+	list_del(&channel->list);
+	if (channel->enc_ctx)
+	{
+		list_del(&channel->enc_ctx->list);
+		dinit_encoder(&channel->enc_ctx, fts);
+	}
+	freep(&channel->dec_ctx->xds_ctx);
+	list_del(&channel->dec_ctx->list);
+	dinit_cc_decode(&channel->dec_ctx);
+	free(channel->desc);
+	free(channel->buf);
+	free(channel);
+}
+
+static int tcp_senders_on_block(void *opaque, struct net_sender *sender, int header, const unsigned char *data, size_t len)
+{
+	struct tcp_senders_state *state = opaque;
+	struct tcp_sender_channel *channel = sender->data;
+
+	if (header)
+	{
+		/* The RCWT header, sent again after every reconnection. Teletext
+		   senders pass all their data in such blocks, they are not
+		   supported here. */
+		if (len != 11 || memcmp(data, "\xCC\xCC\xED", 3) || data[6] != 0 || data[7] != 1)
+		{
+			mprint("Sender %u: only CEA-608/708 RCWT is supported with --tcp-senders\n", sender->id);
+			return -1;
+		}
+		if (channel)
+			return 0;
+
+		if (sender->desc)
+		{
+			struct tcp_sender_channel *c;
+			list_for_each_entry(c, &state->channels, list, struct tcp_sender_channel)
+			{
+				if (c->desc && !strcmp(c->desc, sender->desc))
+				{
+					channel = c;
+					break;
+				}
+			}
+		}
+		if (channel)
+		{
+			if (channel->sender)
+			{
+				mprint("Sender %u takes over %s from sender %u\n", sender->id, channel->desc, channel->sender->id);
+				channel->sender->data = NULL;
+				net_sender_close(channel->sender);
+			}
+			channel->buf_used = 0; // A record cut short by the old connection
+		}
+		else
+			channel = tcp_channel_create(state, sender);
+		channel->sender = sender;
+		sender->data = channel;
+		return 0;
+	}
+
+	if (!channel)
+	{
+		mprint("Sender %u: caption data before the RCWT header\n", sender->id);
+		return -1;
+	}
+
+	// The records may come split over several blocks
+	if (channel->buf_size - channel->buf_used < len)
+	{
+		size_t size = channel->buf_used + len;
+		unsigned char *buf = realloc(channel->buf, size);
+		if (!buf)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In tcp_senders_on_block: Out of memory.");
+		channel->buf = buf;
+		channel->buf_size = size;
+	}
+	memcpy(channel->buf + channel->buf_used, data, len);
+	channel->buf_used += len;
+
+	size_t pos = 0;
+	struct lib_cc_decode *dec_ctx = channel->dec_ctx;
+	while (channel->buf_used - pos >= 10)
+	{
+		LLONG currfts;
+		uint16_t cbcount;
+		memcpy(&currfts, channel->buf + pos, 8);
+		memcpy(&cbcount, channel->buf + pos + 8, 2);
+		if (channel->buf_used - pos < 10 + (size_t)cbcount * 3)
+			break;
+
+		dbg_print(CCX_DMT_PARSE, "Sender %u: RCWT data header FTS: %s  blocks: %u\n",
+			  sender->id, print_mstime_static(currfts), cbcount);
+		if (cbcount > 0)
+			rcwt_process_record(dec_ctx, currfts, channel->buf + pos + 10, cbcount);
+		if (dec_ctx->dec_sub.got_output)
+		{
+			state->caps = 1;
+			encode_sub(channel->enc_ctx, &dec_ctx->dec_sub);
+			dec_ctx->dec_sub.got_output = 0;
+		}
+		pos += 10 + (size_t)cbcount * 3;
+	}
+	memmove(channel->buf, channel->buf + pos, channel->buf_used - pos);
+	channel->buf_used -= pos;
+	return 0;
+}
+
+static void tcp_senders_on_close(void *opaque, struct net_sender *sender)
+{
+	struct tcp_senders_state *state = opaque;
+	struct tcp_sender_channel *channel = sender->data;
+
+	if (!channel)
+		return;
+	channel->sender = NULL;
+	tcp_channel_flush(state, channel);
+	if (!channel->desc)
+		tcp_channel_free(channel); // Nothing to resume it by
+}
+
+/* Serve the --tcp-senders server started when the demuxer was opened,
+   until SIGTERM. */
+int tcp_senders_loop(struct lib_ccx_ctx *ctx)
+{
+	struct tcp_senders_state state = {0};
+	struct tcp_sender_channel *channel;
+	struct tcp_sender_channel *tmp;
+
+	state.ctx = ctx;
+	INIT_LIST_HEAD(&state.channels);
+
+	while (!terminate_asap)
+	{
+		if (net_senders_poll(1000, tcp_senders_on_block, tcp_senders_on_close, &state) < 0)
+		{
+			mprint("Error waiting for senders: %s\n", strerror(errno));
+			break;
+		}
+	}
+	net_senders_close_all(tcp_senders_on_close, &state);
+
+	// The channels kept for reconnecting senders, their contexts go with the others
+	list_for_each_entry_safe(channel, tmp, &state.channels, list, struct tcp_sender_channel)
+	{
+		freep(&channel->dec_ctx->xds_ctx);
+		list_del(&channel->list);
+		free(channel->desc);
+		free(channel->buf);
+		free(channel);
+	}
+	end_of_file = 1;
+	return state.caps;
+}
@@ -8,8 +8,52 @@
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 
+// Rows above the subtitle band that the colour classifier still needs, since
+// its Sauvola binarization and dilation look this far around each pixel.
+#define HARDSUBX_BAND_MARGIN 16
+
+// Work out which rows of each frame the classifiers read and whether the
+// white-text classifier can use the decoder's luma plane instead of RGB.
+static void hardsubx_setup_band(struct lib_hardsubx_ctx *ctx)
+{
+	int height = ctx->codec_ctx->height;
+	enum AVPixelFormat pix_fmt = ctx->codec_ctx->pix_fmt;
+	const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(pix_fmt);
+
+	if (ctx->tickertext)
+		ctx->band_top = (92 * height) / 100;
+	else
+		ctx->band_top = height * (100 - ctx->sub_band) / 100;
+
+	ctx->luma_source = HARDSUBX_LUMA_NONE;
+	if (desc && !(desc->flags & (AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_HWACCEL)) &&
+	    desc->comp[0].plane == 0 && desc->comp[0].step == 1 && desc->comp[0].depth == 8 &&
+	    (ctx->subcolor == HARDSUBX_COLOR_WHITE || ctx->tickertext))
+	{
+		if (ctx->codec_ctx->color_range == AVCOL_RANGE_JPEG || pix_fmt == AV_PIX_FMT_YUVJ420P ||
+		    pix_fmt == AV_PIX_FMT_YUVJ422P || pix_fmt == AV_PIX_FMT_YUVJ444P ||
+		    pix_fmt == AV_PIX_FMT_YUVJ440P || pix_fmt == AV_PIX_FMT_YUVJ411P)
+			ctx->luma_source = HARDSUBX_LUMA_FULL;
+		else
+			ctx->luma_source = HARDSUBX_LUMA_LIMITED;
+	}
+
+	// Converting a band that starts mid-frame needs the start row to fall
+	// on a chroma row; palettized input is converted whole.
+	if (!desc || (desc->flags & AV_PIX_FMT_FLAG_PAL))
+		ctx->convert_top = 0;
+	else
+	{
+		ctx->convert_top = ctx->band_top;
+		if (ctx->subcolor != HARDSUBX_COLOR_WHITE && !ctx->tickertext)
+			ctx->convert_top = FFMAX(ctx->convert_top - HARDSUBX_BAND_MARGIN, 0);
+		ctx->convert_top &= ~((1 << desc->log2_chroma_h) - 1);
+	}
+}
+
 int hardsubx_process_data(struct lib_hardsubx_ctx *ctx, struct lib_ccx_ctx *ctx_normal)
 {
 	if (avformat_open_input(&ctx->format_ctx, ctx->inputfile[0], NULL, NULL) != 0)
@@ -74,12 +118,15 @@ int hardsubx_process_data(struct lib_hardsubx_ctx *ctx, struct lib_ccx_ctx *ctx_
 	int frame_bytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, ctx->codec_ctx->width, ctx->codec_ctx->height, 16);
 	ctx->rgb_buffer = (uint8_t *)av_malloc(frame_bytes * sizeof(uint8_t));
 
+	hardsubx_setup_band(ctx);
+
+	// Only the rows from convert_top down are ever converted to RGB
 	ctx->sws_ctx = sws_getContext(
 	    ctx->codec_ctx->width,
-	    ctx->codec_ctx->height,
+	    ctx->codec_ctx->height - ctx->convert_top,
 	    ctx->codec_ctx->pix_fmt,
 	    ctx->codec_ctx->width,
-	    ctx->codec_ctx->height,
+	    ctx->codec_ctx->height - ctx->convert_top,
 	    AV_PIX_FMT_RGB24,
 	    SWS_BILINEAR,
 	    NULL, NULL, NULL);
@@ -114,6 +161,8 @@ int hardsubx_process_data(struct lib_hardsubx_ctx *ctx, struct lib_ccx_ctx *ctx_
 	{
 		process_hardsubx_linear_frames_and_normal_subs(ctx, enc_ctx, ctx_normal);
 	}
+	else if (ctx->sampling != HARDSUBX_SAMPLING_EVERY)
+		hardsubx_process_frames_sampled(ctx, enc_ctx);
 	else
 		hardsubx_process_frames_linear(ctx, enc_ctx);
 
@@ -211,6 +260,33 @@ void _hardsubx_params_dump(struct ccx_s_options *options, struct lib_hardsubx_ct
 		mprint("OCR Italic Detection : Off\n");
 	}
 
+	if (ctx->sub_band == 25)
+	{
+		mprint("Subtitle band : bottom 25%% of the frame (Default)\n");
+	}
+	else
+	{
+		mprint("Subtitle band : bottom %d%% of the frame\n", ctx->sub_band);
+	}
+
+	switch (ctx->sampling)
+	{
+		case HARDSUBX_SAMPLING_EVERY:
+			mprint("Frame sampling : Every frame decoded, 1 in 25 classified (Default)\n");
+			break;
+		case HARDSUBX_SAMPLING_SKIP:
+			mprint("Frame sampling : Skip, every %0.2f seconds\n", ctx->sample_interval);
+			break;
+		case HARDSUBX_SAMPLING_SEEK:
+			mprint("Frame sampling : Seek, every %0.2f seconds\n", ctx->sample_interval);
+			break;
+		case HARDSUBX_SAMPLING_ADAPTIVE:
+			mprint("Frame sampling : Adaptive, every %0.2f seconds, refined around changes\n", ctx->sample_interval);
+			break;
+		default:
+			fatal(EXIT_MALFORMED_PARAMETER, "Invalid Frame Sampling Mode");
+	}
+
 	if (ctx->min_sub_duration == 0.5)
 	{
 		mprint("Minimum subtitle duration : 0.5 seconds (Default)\n");
@@ -223,28 +299,67 @@ void _hardsubx_params_dump(struct ccx_s_options *options, struct lib_hardsubx_ct
 	mprint("FFMpeg Media Information:-\n");
 }
 
-struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options)
+// Start a Tesseract instance for lang, NULL if it can't be initialized
+static TessBaseAPI *hardsubx_init_tesseract(char *tessdata_path, char *lang)
 {
-	// Initialize HardsubX data structures
-	struct lib_hardsubx_ctx *ctx = (struct lib_hardsubx_ctx *)malloc(sizeof(struct lib_hardsubx_ctx));
-	if (!ctx)
-		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for HardsubX data structures.");
-	memset(ctx, 0, sizeof(struct lib_hardsubx_ctx));
-
-	ctx->tess_handle = TessBaseAPICreate();
+	TessBaseAPI *handle = TessBaseAPICreate();
 	char *pars_vec = strdup("debug_file");
 	if (pars_vec == NULL)
 	{
 		fatal(EXIT_NOT_ENOUGH_MEMORY,
-		      "In _init_hardsubx: Not enough memory for pars_vec.\n");
+		      "In hardsubx_init_tesseract: Not enough memory for pars_vec.\n");
 	}
 	char *pars_values = strdup("/dev/null");
 	if (pars_values == NULL)
 	{
 		free(pars_vec);
 		fatal(EXIT_NOT_ENOUGH_MEMORY,
-		      "In _init_hardsubx: Not enough memory for pars_values.\n");
+		      "In hardsubx_init_tesseract: Not enough memory for pars_values.\n");
+	}
+
+	int ret = -1;
+
+	if (!strncmp("4.", TessVersion(), 2) || !strncmp("5.", TessVersion(), 2))
+	{
+		char tess_path[1024];
+		if (ccx_options.ocr_oem < 0)
+			ccx_options.ocr_oem = 1;
+		snprintf(tess_path, 1024, "%s%s%s", tessdata_path, "/", "tessdata");
+		ret = TessBaseAPIInit4(handle, tess_path, lang, ccx_options.ocr_oem, NULL, 0, &pars_vec,
+				       &pars_values, 1, false);
+	}
+	else
+	{
+		if (ccx_options.ocr_oem < 0)
+			ccx_options.ocr_oem = 0;
+		ret = TessBaseAPIInit4(handle, tessdata_path, lang, ccx_options.ocr_oem, NULL, 0, &pars_vec,
+				       &pars_values, 1, false);
 	}
+
+	free(pars_vec);
+	free(pars_values);
+	if (ret != 0)
+	{
+		TessBaseAPIDelete(handle);
+		return NULL;
+	}
+	return handle;
+}
+
+static void hardsubx_delete_tesseract(TessBaseAPI *handle)
+{
+	TessBaseAPIEnd(handle);
+	TessBaseAPIDelete(handle);
+}
+
+struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options)
+{
+	// Initialize HardsubX data structures
+	struct lib_hardsubx_ctx *ctx = (struct lib_hardsubx_ctx *)malloc(sizeof(struct lib_hardsubx_ctx));
+	if (!ctx)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory for HardsubX data structures.");
+	memset(ctx, 0, sizeof(struct lib_hardsubx_ctx));
+
 	char *tessdata_path = NULL;
 
 	char *lang = (char *)options->ocrlang;
@@ -257,8 +372,6 @@ struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options)
 		if (strcmp(lang, "eng") == 0)
 		{
 			mprint("eng.traineddata not found! No Switching Possible\n");
-			free(pars_vec);
-			free(pars_values);
 			free(ctx);
 			return NULL;
 		}
@@ -268,41 +381,39 @@ struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options)
 		if (!tessdata_path)
 		{
 			mprint("eng.traineddata not found! No Switching Possible\n");
-			free(pars_vec);
-			free(pars_values);
 			free(ctx);
 			return NULL;
 		}
 	}
 
-	int ret = -1;
-
-	if (!strncmp("4.", TessVersion(), 2) || !strncmp("5.", TessVersion(), 2))
-	{
-		char tess_path[1024];
-		if (ccx_options.ocr_oem < 0)
-			ccx_options.ocr_oem = 1;
-		snprintf(tess_path, 1024, "%s%s%s", tessdata_path, "/", "tessdata");
-		ret = TessBaseAPIInit4(ctx->tess_handle, tess_path, lang, ccx_options.ocr_oem, NULL, 0, &pars_vec,
-				       &pars_values, 1, false);
-	}
-	else
-	{
-		if (ccx_options.ocr_oem < 0)
-			ccx_options.ocr_oem = 0;
-		ret = TessBaseAPIInit4(ctx->tess_handle, tessdata_path, lang, ccx_options.ocr_oem, NULL, 0, &pars_vec,
-				       &pars_values, 1, false);
-	}
-
-	free(pars_vec);
-	free(pars_values);
 	// Note: tessdata_path points to static string or getenv() result, do NOT free
-	if (ret != 0)
+	ctx->tess_handle = hardsubx_init_tesseract(tessdata_path, lang);
+	if (!ctx->tess_handle)
 	{
 		free(ctx);
 		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to initialize Tesseract");
 	}
 
+	// One more instance per OCR worker thread, see hardsubx_init_ocr_queue()
+	if (options->ocr_threads > 1)
+	{
+		ctx->ocr_workers = (TessBaseAPI **)calloc(options->ocr_threads, sizeof(TessBaseAPI *));
+		if (!ctx->ocr_workers)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In _init_hardsubx: Not enough memory for the OCR workers.\n");
+		for (ctx->nb_ocr_workers = 0; ctx->nb_ocr_workers < options->ocr_threads; ctx->nb_ocr_workers++)
+		{
+			ctx->ocr_workers[ctx->nb_ocr_workers] = hardsubx_init_tesseract(tessdata_path, lang);
+			if (!ctx->ocr_workers[ctx->nb_ocr_workers])
+			{
+				mprint("Could not start %d OCR threads, running OCR on the decoding thread\n", options->ocr_threads);
+				while (ctx->nb_ocr_workers > 0)
+					hardsubx_delete_tesseract(ctx->ocr_workers[--ctx->nb_ocr_workers]);
+				freep(&ctx->ocr_workers);
+				break;
+			}
+		}
+	}
+
 	// Initialize attributes common to lib_ccx context
 	ctx->basefilename = get_basename(options->output_filename); // TODO: Check validity, add stdin, network
 	ctx->current_file = -1;
@@ -324,14 +435,16 @@ struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options)
 	ctx->conf_thresh = options->hardsubx_conf_thresh;
 	ctx->hue = options->hardsubx_hue;
 	ctx->lum_thresh = options->hardsubx_lum_thresh;
+	ctx->sub_band = options->hardsubx_sub_band;
+	ctx->sampling = options->hardsubx_sampling;
+	ctx->sample_interval = options->hardsubx_sample_interval;
 	ctx->hardsubx_and_common = options->hardsubx_and_common;
 
 	// Initialize subtitle structure memory
 	ctx->dec_sub = (struct cc_subtitle *)malloc(sizeof(struct cc_subtitle));
 	if (!ctx->dec_sub)
 	{
-		TessBaseAPIEnd(ctx->tess_handle);
-		TessBaseAPIDelete(ctx->tess_handle);
+		hardsubx_delete_tesseract(ctx->tess_handle);
 		free(ctx);
 		fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to initialize subtitle structure.");
 	}
@@ -346,8 +459,10 @@ void _dinit_hardsubx(struct lib_hardsubx_ctx **ctx)
 	// Free all memory allocated to everything in the context
 
 	// Free OCR
-	TessBaseAPIEnd(lctx->tess_handle);
-	TessBaseAPIDelete(lctx->tess_handle);
+	hardsubx_delete_tesseract(lctx->tess_handle);
+	for (int i = 0; i < lctx->nb_ocr_workers; i++)
+		hardsubx_delete_tesseract(lctx->ocr_workers[i]);
+	freep(&lctx->ocr_workers);
 
 	// Free basefilename (allocated by get_basename in _init_hardsubx)
 	freep(&lctx->basefilename);
@@ -384,6 +499,11 @@ void hardsubx(struct ccx_s_options *options, struct lib_ccx_ctx *ctx_normal)
 	time(&end);
 	long processing_time = (long)(end - start);
 	mprint("\rDone, processing time = %ld seconds\n", processing_time);
+	mprint("Time per stage: decode %.2f s, convert %.2f s, classify %.2f s, OCR %.2f s\n",
+	       ctx->decode_time / 1000000.0, ctx->convert_time / 1000000.0,
+	       ctx->classify_time / 1000000.0, ctx->ocr_time / 1000000.0);
+	if (ctx->sampling != HARDSUBX_SAMPLING_EVERY)
+		mprint("Frames decoded: %d, sampled: %d\n", ctx->frames_decoded, ctx->frames_sampled);
 
 	// Free all allocated memory for the data structures
 	_dinit_hardsubx(&ctx);
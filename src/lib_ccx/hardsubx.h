@@ -24,6 +24,23 @@ enum hardsubx_color_type
 	HARDSUBX_COLOR_CUSTOM = 7,
 };
 
+// Where the white-text classifier reads pixel brightness from
+enum hardsubx_luma_source
+{
+	HARDSUBX_LUMA_NONE = 0,	   // RGB24 conversion in rgb_frame
+	HARDSUBX_LUMA_LIMITED = 1, // Y plane of the decoded frame, 16-235
+	HARDSUBX_LUMA_FULL = 2,	   // Y plane of the decoded frame, 0-255
+};
+
+// Which frames the linear search decodes (--sampling)
+enum hardsubx_sampling_mode
+{
+	HARDSUBX_SAMPLING_EVERY = 0,	// Decode every frame, OCR one in 25
+	HARDSUBX_SAMPLING_SKIP = 1,	// Decoder skips non-reference frames or non-keyframes
+	HARDSUBX_SAMPLING_SEEK = 2,	// As SKIP, seeking over gaps longer than a GOP
+	HARDSUBX_SAMPLING_ADAPTIVE = 3, // As SEEK, densely sampling where the text changes
+};
+
 enum hardsubx_ocr_mode
 {
 	HARDSUBX_OCRMODE_FRAME = 0,
@@ -78,6 +95,28 @@ struct lib_hardsubx_ctx
 	float conf_thresh;
 	float hue;
 	float lum_thresh;
+
+	// Region of the frame handed to the classifiers
+	int sub_band;	 // Height of the subtitle band, in percent of the frame height
+	int band_top;	 // First row of the subtitle band
+	int convert_top; // First row converted into rgb_frame
+	int luma_source; // enum hardsubx_luma_source
+
+	// Time spent in each stage, in microseconds
+	int64_t decode_time;
+	int64_t convert_time;
+	int64_t classify_time;
+	int64_t ocr_time;
+
+	// Frame sampling
+	int sampling;	       // enum hardsubx_sampling_mode
+	float sample_interval; // Seconds between samples, except with HARDSUBX_SAMPLING_EVERY
+	int frames_decoded;    // Frames the decoder returned
+	int frames_sampled;    // Frames handed to the classifiers
+
+	// Tesseract instances of the OCR worker threads (--ocr-threads), NULL without
+	TessBaseAPI **ocr_workers;
+	int nb_ocr_workers;
 };
 
 struct lib_hardsubx_ctx *_init_hardsubx(struct ccx_s_options *options);
@@ -88,12 +127,16 @@ int hardsubx_process_data(struct lib_hardsubx_ctx *ctx, struct lib_ccx_ctx *ctx_
 
 // hardsubx_decoder.c
 void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx);
+void hardsubx_process_frames_sampled(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx);
 int hardsubx_process_frames_tickertext(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx);
 void hardsubx_process_frames_binary(struct lib_hardsubx_ctx *ctx);
 char *_process_frame_white_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index);
 char *_process_frame_color_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index);
 void _display_frame(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int timestamp);
 char *_process_frame_tickertext(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int index);
+PIX *_feature_image_white_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height);
+PIX *_feature_image_color_basic(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height);
+char *_ocr_feature_image(struct lib_hardsubx_ctx *ctx, PIX *im);
 void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *hard_ctx, struct encoder_ctx *enc_ctx, struct lib_ccx_ctx *ctx);
 
 // hardsubx_imgops.c
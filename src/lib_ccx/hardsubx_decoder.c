@@ -6,6 +6,8 @@
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+#include <libavutil/time.h>
 #include <libswscale/swscale.h>
 #include <leptonica/allheaders.h>
 #include <tesseract/capi.h>
@@ -14,6 +16,407 @@
 #include "ffmpeg_intgr.h"
 #endif
 
+// Decode one video packet into ctx->frame, keeping count of the time spent.
+static int hardsubx_decode_packet(struct lib_hardsubx_ctx *ctx)
+{
+	int64_t start = av_gettime_relative();
+	int ret;
+
+	avcodec_send_packet(ctx->codec_ctx, &ctx->packet);
+	ret = avcodec_receive_frame(ctx->codec_ctx, ctx->frame);
+	ctx->decode_time += av_gettime_relative() - start;
+	return ret;
+}
+
+// Return the frame the classifiers should read. Without a usable luma plane,
+// only the rows from ctx->convert_top down are converted to RGB24 into
+// ctx->rgb_frame, at their usual position in the frame.
+static AVFrame *hardsubx_convert_frame(struct lib_hardsubx_ctx *ctx)
+{
+	const AVPixFmtDescriptor *desc;
+	const uint8_t *src[4] = {NULL};
+	uint8_t *dst[4] = {NULL};
+	int64_t start;
+
+	if (ctx->luma_source != HARDSUBX_LUMA_NONE)
+		return ctx->frame;
+
+	start = av_gettime_relative();
+	desc = av_pix_fmt_desc_get(ctx->frame->format);
+	for (int i = 0; i < 4 && ctx->frame->data[i]; i++)
+	{
+		int shift = (desc && (i == 1 || i == 2)) ? desc->log2_chroma_h : 0;
+		src[i] = ctx->frame->data[i] + (ctx->convert_top >> shift) * ctx->frame->linesize[i];
+	}
+	dst[0] = ctx->rgb_frame->data[0] + ctx->convert_top * ctx->rgb_frame->linesize[0];
+
+	sws_scale(
+	    ctx->sws_ctx,
+	    src,
+	    ctx->frame->linesize,
+	    0,
+	    ctx->codec_ctx->height - ctx->convert_top,
+	    dst,
+	    ctx->rgb_frame->linesize);
+	ctx->convert_time += av_gettime_relative() - start;
+	return ctx->rgb_frame;
+}
+
+// Run the white or colour classifier over the frame in ctx->frame. The
+// returned text is owned by Rust.
+static char *hardsubx_classify_frame(struct lib_hardsubx_ctx *ctx, int index)
+{
+	// Convert the subtitle band for the classifiers (or use the luma plane directly)
+	AVFrame *band_frame = hardsubx_convert_frame(ctx);
+
+	if (ctx->subcolor == HARDSUBX_COLOR_WHITE)
+		return _process_frame_white_basic(ctx, band_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, index);
+	return _process_frame_color_basic(ctx, band_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, index);
+}
+
+// As hardsubx_classify_frame(), but return a copy of the feature image for
+// the OCR worker threads instead of its text.
+static PIX *hardsubx_frame_features(struct lib_hardsubx_ctx *ctx)
+{
+	AVFrame *band_frame = hardsubx_convert_frame(ctx);
+
+	if (ctx->subcolor == HARDSUBX_COLOR_WHITE)
+		return _feature_image_white_basic(ctx, band_frame, ctx->codec_ctx->width, ctx->codec_ctx->height);
+	return _feature_image_color_basic(ctx, band_frame, ctx->codec_ctx->width, ctx->codec_ctx->height);
+}
+
+static void hardsubx_report_progress(struct lib_hardsubx_ctx *ctx, int64_t pts, int *cur_sec)
+{
+	int total_sec;
+
+	*cur_sec = (int)convert_pts_to_s(pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
+	total_sec = (int)convert_pts_to_s(ctx->format_ctx->duration, AV_TIME_BASE_Q);
+	activity_progress(total_sec > 0 ? (*cur_sec * 100) / total_sec : 0, *cur_sec / 60, *cur_sec % 60);
+}
+
+// Burned-in subtitle on screen, carried from one sampled frame to the next
+struct hardsubx_track
+{
+	int prev_sub_encoded;	  // Previous seen subtitle encoded or not
+	int64_t prev_begin_time;  // Begin and end time of previous seen subtitle
+	int64_t prev_end_time;
+	char *prev_subtitle_text; // Previously seen subtitle text
+};
+
+// Feed the text of a frame shown at time_ms to the track, encoding the
+// previous subtitle once it is gone. Frees subtitle_text.
+static void hardsubx_track_sample(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx, struct hardsubx_track *track,
+				  char *subtitle_text, int64_t time_ms)
+{
+	int dist = 0;
+
+	if ((!subtitle_text && !track->prev_subtitle_text) || (subtitle_text && !strlen(subtitle_text) && !track->prev_subtitle_text))
+	{
+		track->prev_end_time = time_ms;
+	}
+
+	if (subtitle_text)
+	{
+		char *double_enter = strstr(subtitle_text, "\n\n");
+		if (double_enter != NULL)
+			*(double_enter) = '\0';
+	}
+
+	if (!track->prev_sub_encoded && track->prev_subtitle_text)
+	{
+		if (subtitle_text)
+		{
+			dist = edit_distance(subtitle_text, track->prev_subtitle_text, (int)strlen(subtitle_text), (int)strlen(track->prev_subtitle_text));
+			if (dist < (0.2 * MIN(strlen(subtitle_text), strlen(track->prev_subtitle_text))))
+			{
+				dist = -1;
+				free_rust_c_string(subtitle_text);
+				subtitle_text = NULL;
+				track->prev_end_time = time_ms;
+			}
+		}
+		if (dist != -1)
+		{
+			add_cc_sub_text(ctx->dec_sub, track->prev_subtitle_text, track->prev_begin_time, track->prev_end_time, "", "BURN", CCX_ENC_UTF_8);
+			encode_sub(enc_ctx, ctx->dec_sub);
+			track->prev_begin_time = track->prev_end_time + 1;
+			free(track->prev_subtitle_text);
+			track->prev_subtitle_text = NULL;
+			track->prev_sub_encoded = 1;
+			track->prev_end_time = time_ms;
+			if (subtitle_text)
+			{
+				track->prev_subtitle_text = strdup(subtitle_text);
+				if (track->prev_subtitle_text == NULL)
+				{
+					fatal(EXIT_NOT_ENOUGH_MEMORY,
+					      "In hardsubx_track_sample: Not enough memory for subtitle text.\n");
+				}
+				track->prev_sub_encoded = 0;
+			}
+		}
+	}
+
+	// if(ctx->conf_thresh > 0)
+	// {
+	// 	if(ctx->cur_conf >= ctx->prev_conf)
+	// 	{
+	// 		prev_subtitle_text = strdup(subtitle_text);
+	// 		ctx->prev_conf = ctx->cur_conf;
+	// 	}
+	// }
+	// else
+	// {
+	// 	prev_subtitle_text = strdup(subtitle_text);
+	// }
+
+	if (!track->prev_subtitle_text && subtitle_text)
+	{
+		track->prev_begin_time = track->prev_end_time + 1;
+		track->prev_end_time = time_ms;
+		track->prev_subtitle_text = strdup(subtitle_text);
+		if (track->prev_subtitle_text == NULL)
+		{
+			fatal(EXIT_NOT_ENOUGH_MEMORY,
+			      "In hardsubx_track_sample: Not enough memory for subtitle text.\n");
+		}
+		track->prev_sub_encoded = 0;
+	}
+
+	// Free subtitle_text from this sample (was allocated by Rust in _process_frame_*_basic)
+	free_rust_c_string(subtitle_text);
+}
+
+// Encode the subtitle still on screen at the end of the video
+static void hardsubx_track_finish(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx, struct hardsubx_track *track)
+{
+	if (!track->prev_sub_encoded)
+	{
+		add_cc_sub_text(ctx->dec_sub, track->prev_subtitle_text, track->prev_begin_time, track->prev_end_time, "", "BURN", CCX_ENC_UTF_8);
+		encode_sub(enc_ctx, ctx->dec_sub);
+		track->prev_sub_encoded = 1;
+	}
+	free(track->prev_subtitle_text);
+	track->prev_subtitle_text = NULL;
+}
+
+/**
+ * Sampled frames waiting for OCR on the worker threads (--ocr-threads). The
+ * frames are classified on the decoding thread; each worker runs Tesseract on
+ * their feature images with its own copy of the context, holding one of
+ * ctx->ocr_workers. The texts are fed to the track in the order the frames
+ * were submitted, so the output is the same as with OCR on the decoding thread.
+ */
+struct hardsubx_ocr_queue
+{
+	struct ccxr_worker_pool *pool;
+	struct lib_hardsubx_ctx *workers; // One context copy per worker thread
+	void **states;			  // Pointers to them, for the pool
+	int nb_workers;
+	unsigned int limit; // Frames in flight before the decoding thread waits
+};
+
+struct hardsubx_ocr_job
+{
+	PIX *im;      // Feature image, destroyed once read
+	int ocr_mode; // ctx->ocr_mode when the frame was classified
+	int64_t pts;  // In the video stream's time base
+	char *text;   // Owned by Rust
+};
+
+static void hardsubx_ocr_run(void *state, void *arg)
+{
+	struct lib_hardsubx_ctx *worker = state;
+	struct hardsubx_ocr_job *job = arg;
+
+	worker->ocr_mode = job->ocr_mode;
+	job->text = _ocr_feature_image(worker, job->im);
+	pixDestroy(&job->im);
+}
+
+static struct hardsubx_ocr_queue *hardsubx_init_ocr_queue(struct lib_hardsubx_ctx *ctx)
+{
+	struct hardsubx_ocr_queue *queue;
+
+	if (ctx->nb_ocr_workers < 2)
+		return NULL;
+
+	queue = (struct hardsubx_ocr_queue *)malloc(sizeof(struct hardsubx_ocr_queue));
+	if (!queue)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In hardsubx_init_ocr_queue: Out of memory allocating queue.");
+	queue->workers = (struct lib_hardsubx_ctx *)malloc(ctx->nb_ocr_workers * sizeof(struct lib_hardsubx_ctx));
+	queue->states = (void **)malloc(ctx->nb_ocr_workers * sizeof(void *));
+	if (!queue->workers || !queue->states)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In hardsubx_init_ocr_queue: Out of memory allocating workers.");
+	queue->nb_workers = ctx->nb_ocr_workers;
+	queue->limit = 2 * ctx->nb_ocr_workers;
+
+	for (int i = 0; i < queue->nb_workers; i++)
+	{
+		queue->workers[i] = *ctx;
+		queue->workers[i].tess_handle = ctx->ocr_workers[i];
+		queue->workers[i].ocr_time = 0;
+		queue->states[i] = &queue->workers[i];
+	}
+	queue->pool = ccxr_worker_pool_new(queue->states, queue->nb_workers);
+	return queue;
+}
+
+static void hardsubx_ocr_queue_submit(struct hardsubx_ocr_queue *queue, struct lib_hardsubx_ctx *ctx, int64_t pts)
+{
+	struct hardsubx_ocr_job *job = (struct hardsubx_ocr_job *)malloc(sizeof(struct hardsubx_ocr_job));
+	if (!job)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In hardsubx_ocr_queue_submit: Out of memory allocating job.");
+
+	job->im = hardsubx_frame_features(ctx);
+	job->ocr_mode = ctx->ocr_mode;
+	job->pts = pts;
+	job->text = NULL;
+	ccxr_worker_pool_submit(queue->pool, hardsubx_ocr_run, job);
+}
+
+// Feed the frames whose OCR is done to the track, oldest first. Waits for
+// the oldest one while the queue is full, and for all of them with wait set.
+static void hardsubx_ocr_queue_collect(struct hardsubx_ocr_queue *queue, struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx,
+				       struct hardsubx_track *track, int *cur_sec, int wait)
+{
+	AVRational time_base = ctx->format_ctx->streams[ctx->video_stream_id]->time_base;
+	struct hardsubx_ocr_job *job;
+
+	while ((job = ccxr_worker_pool_next(queue->pool, wait || ccxr_worker_pool_pending(queue->pool) >= queue->limit)))
+	{
+		hardsubx_report_progress(ctx, job->pts, cur_sec);
+		hardsubx_track_sample(ctx, enc_ctx, track, job->text, convert_pts_to_ms(job->pts, time_base));
+		free(job);
+	}
+}
+
+static void hardsubx_delete_ocr_queue(struct hardsubx_ocr_queue **arg, struct lib_hardsubx_ctx *ctx)
+{
+	struct hardsubx_ocr_queue *queue = *arg;
+
+	if (!queue)
+		return;
+	ccxr_worker_pool_free(queue->pool);
+	for (int i = 0; i < queue->nb_workers; i++)
+		ctx->ocr_time += queue->workers[i].ocr_time;
+	free(queue->workers);
+	free(queue->states);
+	freep(arg);
+}
+
+// Whether two sampled frames show different subtitles, by the same measure
+// hardsubx_track_sample() uses to merge repeated lines.
+static int hardsubx_text_changed(const char *a, const char *b)
+{
+	size_t len_a = a ? strlen(a) : 0;
+	size_t len_b = b ? strlen(b) : 0;
+
+	if (!len_a || !len_b)
+		return len_a != len_b;
+	return edit_distance((char *)a, (char *)b, (int)len_a, (int)len_b) >= 0.2 * MIN(len_a, len_b);
+}
+
+// State of the sampled search (--sampling skip, seek and adaptive). All
+// timestamps are in the video stream's time base.
+struct hardsubx_sampler
+{
+	int64_t interval; // Spacing of the regular samples
+	int64_t step;	  // Spacing of the dense samples around a change
+	int64_t gop;	  // Distance between the last two keyframes, 0 until known
+	int64_t last_key; // Last keyframe read, AV_NOPTS_VALUE after a seek
+	int64_t pts;	  // Timestamp of the frame in ctx->frame
+	int can_seek;	  // Cleared once seeking has failed
+	int draining;	  // Input exhausted, decoder being flushed
+};
+
+static int64_t hardsubx_frame_pts(AVFrame *frame)
+{
+	if (frame->best_effort_timestamp != AV_NOPTS_VALUE)
+		return frame->best_effort_timestamp;
+	return frame->pts;
+}
+
+// Decode until a frame at or after target comes out of the decoder, which
+// drops the frames selected by discard without decoding them. Returns 0 at
+// the end of the stream.
+static int hardsubx_decode_until(struct lib_hardsubx_ctx *ctx, struct hardsubx_sampler *s, int64_t target, enum AVDiscard discard)
+{
+	ctx->codec_ctx->skip_frame = discard;
+	while (1)
+	{
+		int64_t start = av_gettime_relative();
+		int ret = avcodec_receive_frame(ctx->codec_ctx, ctx->frame);
+		ctx->decode_time += av_gettime_relative() - start;
+
+		if (ret == 0)
+		{
+			ctx->frames_decoded++;
+			s->pts = hardsubx_frame_pts(ctx->frame);
+			if (s->pts != AV_NOPTS_VALUE && s->pts >= target)
+				return 1;
+			continue;
+		}
+		if (ret != AVERROR(EAGAIN) || s->draining)
+			return 0;
+
+		if (av_read_frame(ctx->format_ctx, &ctx->packet) < 0)
+		{
+			// Let the decoder return the frames it still holds
+			avcodec_send_packet(ctx->codec_ctx, NULL);
+			s->draining = 1;
+			continue;
+		}
+		if (ctx->packet.stream_index == ctx->video_stream_id)
+		{
+			int64_t packet_ts = ctx->packet.pts != AV_NOPTS_VALUE ? ctx->packet.pts : ctx->packet.dts;
+			if ((ctx->packet.flags & AV_PKT_FLAG_KEY) && packet_ts != AV_NOPTS_VALUE)
+			{
+				if (s->last_key != AV_NOPTS_VALUE && packet_ts > s->last_key)
+					s->gop = packet_ts - s->last_key;
+				s->last_key = packet_ts;
+			}
+			start = av_gettime_relative();
+			avcodec_send_packet(ctx->codec_ctx, &ctx->packet);
+			ctx->decode_time += av_gettime_relative() - start;
+		}
+		av_packet_unref(&ctx->packet);
+	}
+}
+
+// Seek to the keyframe at or before target. Returns 0 if the input cannot seek.
+static int hardsubx_seek(struct lib_hardsubx_ctx *ctx, struct hardsubx_sampler *s, int64_t target)
+{
+	if (!s->can_seek)
+		return 0;
+	if (av_seek_frame(ctx->format_ctx, ctx->video_stream_id, target, AVSEEK_FLAG_BACKWARD) < 0)
+	{
+		mprint("Seeking in the input failed, decoding sequentially instead\n");
+		s->can_seek = 0;
+		return 0;
+	}
+	avcodec_flush_buffers(ctx->codec_ctx);
+	s->last_key = AV_NOPTS_VALUE;
+	s->draining = 0;
+	return 1;
+}
+
+// Put the first frame at or after target in ctx->frame, for a caller that
+// wants one frame every spacing. Frames the caller cannot want are left
+// undecoded: non-reference frames always, and everything but keyframes when
+// samples are at least a GOP apart. Seeking and adaptive sampling seek over
+// gaps of more than a GOP instead of reading through them.
+static int hardsubx_sample_frame(struct lib_hardsubx_ctx *ctx, struct hardsubx_sampler *s, int64_t target, int64_t spacing)
+{
+	enum AVDiscard discard = AVDISCARD_NONREF;
+
+	if (s->gop > 0 && spacing >= s->gop)
+		discard = AVDISCARD_NONKEY;
+	if (ctx->sampling != HARDSUBX_SAMPLING_SKIP && s->gop > 0 && s->pts != AV_NOPTS_VALUE && target - s->pts > s->gop)
+		hardsubx_seek(ctx, s, target);
+	return hardsubx_decode_until(ctx, s, target, discard);
+}
+
 void _display_frame(struct lib_hardsubx_ctx *ctx, AVFrame *frame, int width, int height, int timestamp)
 {
 	// Debug: Display the frame after processing
@@ -110,23 +513,15 @@ int hardsubx_process_frames_tickertext(struct lib_hardsubx_ctx *ctx, struct enco
 		{
 			frame_number++;
 			// Decode the video stream packet
-			avcodec_send_packet(ctx->codec_ctx, &ctx->packet);
-			if (avcodec_receive_frame(ctx->codec_ctx, ctx->frame) == 0 && frame_number % 1000 == 0)
+			if (hardsubx_decode_packet(ctx) == 0 && frame_number % 1000 == 0)
 			{
 				int64_t current_pts_ms = 0;
 				current_pts_ms = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
 
-				// sws_scale is used to convert the pixel format to RGB24 from all other cases
-				sws_scale(
-				    ctx->sws_ctx,
-				    (uint8_t const *const *)ctx->frame->data,
-				    ctx->frame->linesize,
-				    0,
-				    ctx->codec_ctx->height,
-				    ctx->rgb_frame->data,
-				    ctx->rgb_frame->linesize);
-
-				ticker_text = _process_frame_tickertext(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
+				// Convert the subtitle band for the classifiers (or use the luma plane directly)
+				AVFrame *band_frame = hardsubx_convert_frame(ctx);
+
+				ticker_text = _process_frame_tickertext(ctx, band_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
 				if (ticker_text)
 				{
 					char *ticker_text_copy = strdup(ticker_text);
@@ -217,14 +612,12 @@ void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder
 {
 	// Do an exhaustive linear search over the video
 
-	int prev_sub_encoded = 1; // Previous seen subtitle encoded or not
-	int dist = 0;
-	int cur_sec = 0, total_sec, progress;
+	struct hardsubx_track track = {1, 0, 0, NULL};
+	struct hardsubx_ocr_queue *queue = hardsubx_init_ocr_queue(ctx);
+	AVRational time_base = ctx->format_ctx->streams[ctx->video_stream_id]->time_base;
+	int cur_sec = 0;
 	int frame_number = 0;
-	int64_t prev_begin_time = 0, prev_end_time = 0; // Begin and end time of previous seen subtitle
 	int64_t prev_packet_pts = 0;
-	char *subtitle_text = NULL;	 // Subtitle text of current frame
-	char *prev_subtitle_text = NULL; // Previously seen subtitle text
 
 	while (av_read_frame(ctx->format_ctx, &ctx->packet) >= 0)
 	{
@@ -233,131 +626,125 @@ void hardsubx_process_frames_linear(struct lib_hardsubx_ctx *ctx, struct encoder
 			frame_number++;
 
 			// Decode the video stream packet
-			avcodec_send_packet(ctx->codec_ctx, &ctx->packet);
-			if (avcodec_receive_frame(ctx->codec_ctx, ctx->frame) == 0 && frame_number % 25 == 0)
+			if (hardsubx_decode_packet(ctx) == 0 && frame_number % 25 == 0)
 			{
-				float diff = (float)convert_pts_to_ms(ctx->packet.pts - prev_packet_pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
+				float diff = (float)convert_pts_to_ms(ctx->packet.pts - prev_packet_pts, time_base);
 				if (fabsf(diff) < 1000 * ctx->min_sub_duration) // If the minimum duration of a subtitle line is exceeded, process packet
 					continue;
 
-				// sws_scale is used to convert the pixel format to RGB24 from all other cases
-				sws_scale(
-				    ctx->sws_ctx,
-				    (uint8_t const *const *)ctx->frame->data,
-				    ctx->frame->linesize,
-				    0,
-				    ctx->codec_ctx->height,
-				    ctx->rgb_frame->data,
-				    ctx->rgb_frame->linesize);
-
-				// Send the frame to other functions for processing
-				if (ctx->subcolor == HARDSUBX_COLOR_WHITE)
+				if (queue)
 				{
-					subtitle_text = _process_frame_white_basic(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
+					hardsubx_ocr_queue_submit(queue, ctx, ctx->packet.pts);
+					hardsubx_ocr_queue_collect(queue, ctx, enc_ctx, &track, &cur_sec, 0);
 				}
 				else
 				{
-					subtitle_text = _process_frame_color_basic(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
+					// Send the frame to other functions for processing
+					char *subtitle_text = hardsubx_classify_frame(ctx, frame_number);
+
+					hardsubx_report_progress(ctx, ctx->packet.pts, &cur_sec);
+					hardsubx_track_sample(ctx, enc_ctx, &track, subtitle_text, convert_pts_to_ms(ctx->packet.pts, time_base));
 				}
-				_display_frame(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, frame_number);
+				prev_packet_pts = ctx->packet.pts;
+			}
+		}
+		av_packet_unref(&ctx->packet);
+	}
 
-				cur_sec = (int)convert_pts_to_s(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
-				total_sec = (int)convert_pts_to_s(ctx->format_ctx->duration, AV_TIME_BASE_Q);
-				progress = (cur_sec * 100) / total_sec;
-				activity_progress(progress, cur_sec / 60, cur_sec % 60);
+	if (queue)
+	{
+		hardsubx_ocr_queue_collect(queue, ctx, enc_ctx, &track, &cur_sec, 1);
+		hardsubx_delete_ocr_queue(&queue, ctx);
+	}
+	hardsubx_track_finish(ctx, enc_ctx, &track);
+	activity_progress(100, cur_sec / 60, cur_sec % 60);
+}
 
-				if ((!subtitle_text && !prev_subtitle_text) || (subtitle_text && !strlen(subtitle_text) && !prev_subtitle_text))
-				{
-					prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
-				}
+void hardsubx_process_frames_sampled(struct lib_hardsubx_ctx *ctx, struct encoder_ctx *enc_ctx)
+{
+	// Linear search over the video that only decodes the frames it samples
+
+	AVStream *stream = ctx->format_ctx->streams[ctx->video_stream_id];
+	AVRational ms_base = {1, 1000};
+	struct hardsubx_track track = {1, 0, 0, NULL};
+	struct hardsubx_ocr_queue *queue = NULL;
+	struct hardsubx_sampler s;
+	int cur_sec = 0;
+	int64_t target;
+	int64_t prev_pts = AV_NOPTS_VALUE; // Previous regular sample
+	char *prev_text = NULL;		   // and the text found in it
+
+	memset(&s, 0, sizeof(s));
+	s.interval = FFMAX(av_rescale_q((int64_t)(1000 * ctx->sample_interval), ms_base, stream->time_base), 1);
+	s.step = av_rescale_q((int64_t)(1000 * ctx->min_sub_duration), ms_base, stream->time_base);
+	if (stream->avg_frame_rate.num > 0 && stream->avg_frame_rate.den > 0)
+		s.step = FFMAX(s.step, av_rescale_q(1, av_inv_q(stream->avg_frame_rate), stream->time_base));
+	s.step = FFMAX(s.step, 1);
+	s.last_key = AV_NOPTS_VALUE;
+	s.pts = AV_NOPTS_VALUE;
+	s.can_seek = 1;
+
+	// Adaptive sampling picks the next frame by the text of this one, so its
+	// OCR can't run ahead on the worker threads
+	if (ctx->sampling != HARDSUBX_SAMPLING_ADAPTIVE)
+		queue = hardsubx_init_ocr_queue(ctx);
+
+	target = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+	while (hardsubx_sample_frame(ctx, &s, target, s.interval))
+	{
+		int64_t pts = s.pts;
 
-				if (subtitle_text)
-				{
-					char *double_enter = strstr(subtitle_text, "\n\n");
-					if (double_enter != NULL)
-						*(double_enter) = '\0';
-				}
+		if (queue)
+		{
+			ctx->frames_sampled++;
+			hardsubx_ocr_queue_submit(queue, ctx, pts);
+			hardsubx_ocr_queue_collect(queue, ctx, enc_ctx, &track, &cur_sec, 0);
+			target = pts + s.interval;
+			continue;
+		}
 
-				if (!prev_sub_encoded && prev_subtitle_text)
-				{
-					if (subtitle_text)
-					{
-						dist = edit_distance(subtitle_text, prev_subtitle_text, (int)strlen(subtitle_text), (int)strlen(prev_subtitle_text));
-						if (dist < (0.2 * MIN(strlen(subtitle_text), strlen(prev_subtitle_text))))
-						{
-							dist = -1;
-							free_rust_c_string(subtitle_text);
-							subtitle_text = NULL;
-							prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
-						}
-					}
-					if (dist != -1)
-					{
-						add_cc_sub_text(ctx->dec_sub, prev_subtitle_text, prev_begin_time, prev_end_time, "", "BURN", CCX_ENC_UTF_8);
-						encode_sub(enc_ctx, ctx->dec_sub);
-						prev_begin_time = prev_end_time + 1;
-						free(prev_subtitle_text);
-						prev_subtitle_text = NULL;
-						prev_sub_encoded = 1;
-						prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
-						if (subtitle_text)
-						{
-							prev_subtitle_text = strdup(subtitle_text);
-							if (prev_subtitle_text == NULL)
-							{
-								fatal(EXIT_NOT_ENOUGH_MEMORY,
-								      "In hardsubx_process_frames_linear: Not enough memory for subtitle text.\n");
-							}
-							prev_sub_encoded = 0;
-						}
-					}
-					dist = 0;
-				}
+		char *subtitle_text = hardsubx_classify_frame(ctx, ++ctx->frames_sampled);
 
-				// if(ctx->conf_thresh > 0)
-				// {
-				// 	if(ctx->cur_conf >= ctx->prev_conf)
-				// 	{
-				// 		prev_subtitle_text = strdup(subtitle_text);
-				// 		ctx->prev_conf = ctx->cur_conf;
-				// 	}
-				// }
-				// else
-				// {
-				// 	prev_subtitle_text = strdup(subtitle_text);
-				// }
-
-				if (!prev_subtitle_text && subtitle_text)
-				{
-					prev_begin_time = prev_end_time + 1;
-					prev_end_time = convert_pts_to_ms(ctx->packet.pts, ctx->format_ctx->streams[ctx->video_stream_id]->time_base);
-					prev_subtitle_text = strdup(subtitle_text);
-					if (prev_subtitle_text == NULL)
-					{
-						fatal(EXIT_NOT_ENOUGH_MEMORY,
-						      "In hardsubx_process_frames_linear: Not enough memory for subtitle text.\n");
-					}
-					prev_sub_encoded = 0;
-				}
-				prev_packet_pts = ctx->packet.pts;
+		if (ctx->sampling == HARDSUBX_SAMPLING_ADAPTIVE && prev_pts != AV_NOPTS_VALUE &&
+		    pts - prev_pts > s.step && hardsubx_text_changed(prev_text, subtitle_text) &&
+		    hardsubx_seek(ctx, &s, prev_pts + s.step))
+		{
+			// The text changed since the previous sample: go back and sample
+			// every step up to this frame, so the change is timed precisely.
+			int64_t t = prev_pts + s.step;
+			while (t < pts && hardsubx_sample_frame(ctx, &s, t, s.step) && s.pts < pts)
+			{
+				char *dense_text = hardsubx_classify_frame(ctx, ++ctx->frames_sampled);
+				hardsubx_track_sample(ctx, enc_ctx, &track, dense_text, convert_pts_to_ms(s.pts, stream->time_base));
+				t = s.pts + s.step;
+			}
+		}
 
-				// Free subtitle_text from this iteration (was allocated by Rust in _process_frame_*_basic)
-				free_rust_c_string(subtitle_text);
-				subtitle_text = NULL;
+		free(prev_text);
+		prev_text = NULL;
+		if (subtitle_text)
+		{
+			prev_text = strdup(subtitle_text);
+			if (prev_text == NULL)
+			{
+				fatal(EXIT_NOT_ENOUGH_MEMORY,
+				      "In hardsubx_process_frames_sampled: Not enough memory for subtitle text.\n");
 			}
 		}
-		av_packet_unref(&ctx->packet);
+		prev_pts = pts;
+
+		hardsubx_report_progress(ctx, pts, &cur_sec);
+		hardsubx_track_sample(ctx, enc_ctx, &track, subtitle_text, convert_pts_to_ms(pts, stream->time_base));
+		target = pts + s.interval;
 	}
 
-	if (!prev_sub_encoded)
+	if (queue)
 	{
-		add_cc_sub_text(ctx->dec_sub, prev_subtitle_text, prev_begin_time, prev_end_time, "", "BURN", CCX_ENC_UTF_8);
-		encode_sub(enc_ctx, ctx->dec_sub);
-		prev_sub_encoded = 1;
+		hardsubx_ocr_queue_collect(queue, ctx, enc_ctx, &track, &cur_sec, 1);
+		hardsubx_delete_ocr_queue(&queue, ctx);
 	}
-
-	// Cleanup
-	free(prev_subtitle_text);
+	hardsubx_track_finish(ctx, enc_ctx, &track);
+	free(prev_text);
 	activity_progress(100, cur_sec / 60, cur_sec % 60);
 }
 
@@ -519,9 +906,7 @@ void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *har
 			{
 				frame_number++;
 
-				avcodec_send_packet(hard_ctx->codec_ctx, &hard_ctx->packet);
-				if (avcodec_receive_frame(hard_ctx->codec_ctx,
-							  hard_ctx->frame) == 0 &&
+				if (hardsubx_decode_packet(hard_ctx) == 0 &&
 				    frame_number % 25 == 0)
 				{
 					float diff = (float)convert_pts_to_ms(hard_ctx->packet.pts - prev_packet_pts_hard,
@@ -530,20 +915,13 @@ void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *har
 					if (fabsf(diff) >= 1000 * hard_ctx->min_sub_duration)
 					{
 
-						// sws_scale is used to convert the pixel format to RGB24 from all other cases
-						sws_scale(
-						    hard_ctx->sws_ctx,
-						    (uint8_t const *const *)hard_ctx->frame->data,
-						    hard_ctx->frame->linesize,
-						    0,
-						    hard_ctx->codec_ctx->height,
-						    hard_ctx->rgb_frame->data,
-						    hard_ctx->rgb_frame->linesize);
+						// Convert the subtitle band for the classifiers (or use the luma plane directly)
+						AVFrame *band_frame = hardsubx_convert_frame(hard_ctx);
 
 						if (hard_ctx->subcolor == HARDSUBX_COLOR_WHITE)
 						{
 							subtitle_text_hard = _process_frame_white_basic(hard_ctx,
-													hard_ctx->rgb_frame,
+													band_frame,
 													hard_ctx->codec_ctx->width,
 													hard_ctx->codec_ctx->height,
 													frame_number);
@@ -551,13 +929,12 @@ void process_hardsubx_linear_frames_and_normal_subs(struct lib_hardsubx_ctx *har
 						else
 						{
 							subtitle_text_hard = _process_frame_color_basic(hard_ctx,
-													hard_ctx->rgb_frame,
+													band_frame,
 													hard_ctx->codec_ctx->width,
 													hard_ctx->codec_ctx->height,
 													frame_number);
 						}
 
-						_display_frame(hard_ctx, hard_ctx->rgb_frame, hard_ctx->codec_ctx->width, hard_ctx->codec_ctx->height, frame_number);
 						cur_sec = (int)convert_pts_to_s(hard_ctx->packet.pts, hard_ctx->format_ctx->streams[hard_ctx->video_stream_id]->time_base);
 						total_sec = (int)convert_pts_to_s(hard_ctx->format_ctx->duration, AV_TIME_BASE_Q);
 						progress = (cur_sec * 100) / total_sec;
@@ -669,24 +1046,15 @@ void hardsubx_process_frames_binary(struct lib_hardsubx_ctx *ctx)
 			{
 				if (ctx->packet.stream_index == ctx->video_stream_id)
 				{
-					avcodec_send_packet(ctx->codec_ctx, &ctx->packet);
-					if (avcodec_receive_frame(ctx->codec_ctx, ctx->frame) == 0)
+					if (hardsubx_decode_packet(ctx) == 0)
 					{
 						// printf("%d\n", seek_time);
 						if (ctx->packet.pts < seek_time)
 							continue;
 						// printf("GOT FRAME: %d\n",ctx->packet.pts);
-						// sws_scale is used to convert the pixel format to RGB24 from all other cases
-						sws_scale(
-						    ctx->sws_ctx,
-						    (uint8_t const *const *)ctx->frame->data,
-						    ctx->frame->linesize,
-						    0,
-						    ctx->codec_ctx->height,
-						    ctx->rgb_frame->data,
-						    ctx->rgb_frame->linesize);
 						// Send the frame to other functions for processing
-						_display_frame(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, seconds_time);
+						if (hardsubx_convert_frame(ctx) == ctx->rgb_frame)
+							_display_frame(ctx, ctx->rgb_frame, ctx->codec_ctx->width, ctx->codec_ctx->height, seconds_time);
 						break;
 					}
 				}
@@ -34,6 +34,7 @@ static struct ccx_decoders_common_settings_t *init_decoder_setting(
 	setting->hauppauge_mode = opt->hauppauge_mode;
 	setting->xds_write_to_file = opt->transcript_settings.xds;
 	setting->ocr_quantmode = opt->ocr_quantmode;
+	setting->fast_avc_scan = opt->fast_avc_scan;
 	// program_number, codec, and private_data are zero-initialized by calloc
 
 	return setting;
@@ -496,8 +497,10 @@ struct encoder_ctx *update_encoder_list_cinfo(struct lib_ccx_ctx *ctx, struct ca
 		   PID, or when some other stream (teletext, 608/708) already owns an encoder and
 		   this DVB PID is an extra one alongside it. A recording whose only caption
 		   stream is a single DVB PID still reaches the standard path below, because the
-		   encoder list is empty on that first call, which keeps its filename unchanged. */
-		if (dvb_pid_count >= 2 || !list_empty(&ctx->enc_ctx_head))
+		   encoder list is empty on that first call, which keeps its filename unchanged.
+		   A --jobs program worker only holds the encoders of its own programs, so it
+		   is also told whether the serial loop would have had one by now. */
+		if (dvb_pid_count >= 2 || !list_empty(&ctx->enc_ctx_head) || ctx->enc_ctx_elsewhere)
 		{
 			struct encoder_cfg local_cfg = ccx_options.enc_cfg;
 			local_cfg.program_number = pn;
@@ -150,6 +150,7 @@ struct lib_ccx_ctx
 
 	struct ccx_demuxer *demux_ctx;
 	struct list_head enc_ctx_head;
+	int enc_ctx_elsewhere; // --jobs program worker: the demuxer process gave another worker an encoder before
 	struct ccx_s_mp4Cfg mp4_cfg;
 	int out_interval;
 	int segment_on_key_frames_only;
@@ -181,6 +182,15 @@ int general_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **data);
 int raw_loop(struct lib_ccx_ctx *ctx);
 size_t process_raw(struct lib_cc_decode *ctx, struct cc_subtitle *sub, unsigned char *buffer, size_t len);
 
+// How far before --startat the demuxers start decoding, so that captions
+// loaded earlier are complete, and how far after --endat they keep going
+#define CCX_EXTRACTION_MARGIN_MS 15000
+// Bytes read at a time, and at most, looking for a PCR or SCR to seek by
+#define CLOCK_SCAN_CHUNK (256 * 1024)
+#define CLOCK_SCAN_LIMIT (8 * 1024 * 1024)
+int is_past_extraction_end(struct lib_cc_decode *dec_ctx);
+int can_seek_input(struct lib_ccx_ctx *ctx);
+
 // Rust FFI: McPoodle DVD raw format processing (see src/rust/src/demuxer/dvdraw.rs)
 unsigned int ccxr_process_dvdraw(struct lib_cc_decode *ctx, struct cc_subtitle *sub, const unsigned char *buffer, unsigned int len);
 int ccxr_is_dvdraw_header(const unsigned char *buffer, unsigned int len);
@@ -189,9 +199,27 @@ int ccxr_is_dvdraw_header(const unsigned char *buffer, unsigned int len);
 unsigned int ccxr_process_scc(struct lib_cc_decode *ctx, struct cc_subtitle *sub, const unsigned char *buffer, unsigned int len, int framerate);
 int ccxr_is_scc_file(const unsigned char *buffer, unsigned int len);
 
+// Rust FFI: worker threads running C jobs, each with its own state, returned in
+// submission order (see src/rust/src/worker_pool.rs)
+struct ccxr_worker_pool;
+struct ccxr_worker_pool *ccxr_worker_pool_new(void *const *states, unsigned int count);
+void ccxr_worker_pool_submit(struct ccxr_worker_pool *pool, void (*run)(void *state, void *job), void *job);
+unsigned int ccxr_worker_pool_pending(struct ccxr_worker_pool *pool);
+void *ccxr_worker_pool_next(struct ccxr_worker_pool *pool, int wait);
+void ccxr_worker_pool_free(struct ccxr_worker_pool *pool);
+
+// Rust FFI: OCR results keyed by a SHA-256 of the bitmap, shared by the OCR
+// threads (see src/rust/src/ocr_cache.rs)
+int ccxr_ocr_cache_load(const char *path, const char *settings);
+int ccxr_ocr_cache_lookup(const unsigned char *key, char **text);
+void ccxr_ocr_cache_store(const unsigned char *key, const char *text);
+int ccxr_ocr_cache_save(void);
+void ccxr_ocr_cache_stats(unsigned long long *hits, unsigned long long *misses, unsigned int *entries);
+
 int general_loop(struct lib_ccx_ctx *ctx);
 void process_hex(struct lib_ccx_ctx *ctx, char *filename);
 int rcwt_loop(struct lib_ccx_ctx *ctx);
+int tcp_senders_loop(struct lib_ccx_ctx *ctx);
 
 extern int end_of_file;
 
@@ -236,9 +264,16 @@ void dinit_write(struct ccx_s_write *wb);
 int temporarily_open_output(struct ccx_s_write *wb);
 int temporarily_close_output(struct ccx_s_write *wb);
 int init_write(struct ccx_s_write *wb, char *filename, int with_semaphore);
+void enable_output_buffer(struct ccx_s_write *wb);
+int flush_output_buffer(struct ccx_s_write *wb);
+void release_output_buffer(struct ccx_s_write *wb);
+void close_output(struct ccx_s_write *wb);
+void print_output_write_stats(void);
 int writeraw(const unsigned char *data, int length, void *private_data, struct cc_subtitle *sub);
 void flushbuffer(struct lib_ccx_ctx *ctx, struct ccx_s_write *wb, int closefile);
 void writercwtdata(struct lib_cc_decode *ctx, const unsigned char *data, struct cc_subtitle *sub);
+void rcwt_start_chunks(struct ccx_s_write *wb, LLONG offset, int compress);
+ssize_t rcwt_write(struct ccx_s_write *wb, const unsigned char *data, size_t len);
 
 // stream_functions.c
 int isValidMP4Box(unsigned char *buffer, size_t position, size_t *nextBoxLocation, int *boxScore);
@@ -251,12 +286,14 @@ void init_ts(struct ccx_demuxer *ctx);
 int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload);
 int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data);
 int ts_get_more_data(struct lib_ccx_ctx *ctx, struct demuxer_data **data);
+int ts_find_clock(struct ccx_demuxer *ctx, LLONG from, int *pid, LLONG *pos, LLONG *clock);
 int write_section(struct ccx_demuxer *ctx, struct ts_payload *payload, unsigned char *buf, int size, struct program_info *pinfo);
-void ts_buffer_psi_packet(struct ccx_demuxer *ctx);
+void ts_buffer_psi_packet(struct ccx_demuxer *ctx, unsigned char *tspacket);
 int parse_PMT(struct ccx_demuxer *ctx, unsigned char *buf, int len, struct program_info *pinfo);
 int parse_PAT(struct ccx_demuxer *ctx);
-void parse_EPG_packet(struct lib_ccx_ctx *ctx);
+void parse_EPG_packet(struct lib_ccx_ctx *ctx, unsigned char *tspacket);
 void EPG_free(struct lib_ccx_ctx *ctx);
+void EPG_clear_program(struct EIT_program *program);
 char *EPG_DVB_decode_string(uint8_t *in, size_t size);
 void parse_SDT(struct ccx_demuxer *ctx);
 
@@ -293,6 +330,7 @@ void m_signal(int sig, void (*func)(int));
 #endif
 
 void buffered_seek(struct ccx_demuxer *ctx, int offset);
+int buffered_seek_to(struct ccx_demuxer *ctx, LLONG pos);
 extern void build_parity_table(void);
 
 int tlt_process_pes_packet(struct lib_cc_decode *dec_ctx, uint8_t *buffer, uint16_t size, struct cc_subtitle *sub, int sentence_cap);
@@ -312,7 +350,6 @@ extern int firstcall;
 
 // From ts_functions
 // extern struct ts_payload payload;
-extern unsigned char tspacket[188];
 extern unsigned char *last_pat_payload;
 extern unsigned last_pat_length;
 extern volatile int terminate_asap;
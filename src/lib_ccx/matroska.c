@@ -8,48 +8,114 @@
 #include "dvb_subtitle_decoder.h"
 #include "vobsub_decoder.h"
 
-void skip_bytes(FILE *file, ULLONG n)
+/* The file is read through a large buffer: element ids, sizes and small
+ * values are decoded from memory and positions are worked out without a
+ * syscall. */
+
+// Make at least n bytes readable at file->pos, reading more of the file if
+// needed. Returns how many are readable, fewer than n at the end of the file.
+static size_t fill_buffer(struct matroska_reader *file, size_t n)
 {
-	FSEEK(file, n, SEEK_CUR);
+	size_t avail = file->len - file->pos;
+	if (avail >= n)
+		return avail;
+
+	memmove(file->buffer, file->buffer + file->pos, avail);
+	file->offset += file->pos;
+	file->len = avail;
+	file->pos = 0;
+	if (n > file->capacity)
+	{
+		UBYTE *buffer = realloc(file->buffer, n);
+		if (buffer == NULL)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In fill_buffer: Out of memory.");
+		file->buffer = buffer;
+		file->capacity = n;
+	}
+	file->len += fread(file->buffer + file->len, 1, file->capacity - file->len, file->file);
+	return file->len;
+}
+
+static void read_into(struct matroska_reader *file, UBYTE *dest, ULLONG n)
+{
+	size_t avail = file->len - file->pos;
+	if (n > avail && n > file->capacity)
+	{
+		// Too big to go through the buffer: take what it holds, read the rest directly
+		memcpy(dest, file->buffer + file->pos, avail);
+		file->offset += file->len + (n - avail);
+		file->len = file->pos = 0;
+		if (fread(dest + avail, 1, (size_t)(n - avail), file->file) != n - avail)
+			fatal(1, "reading from file");
+		return;
+	}
+	memcpy(dest, borrow_byte_block(file, n), (size_t)n);
 }
 
-void set_bytes(FILE *file, ULLONG n)
+void skip_bytes(struct matroska_reader *file, ULLONG n)
 {
-	FSEEK(file, n, SEEK_SET);
+	set_bytes(file, get_current_byte(file) + n);
 }
 
-ULLONG get_current_byte(FILE *file)
+void set_bytes(struct matroska_reader *file, ULLONG n)
 {
-	return (ULLONG)FTELL(file);
+	// Only seek forward inside the buffer: borrowed blocks may have been
+	// modified in place by the decoders
+	if (n >= get_current_byte(file) && n <= file->offset + file->len)
+	{
+		file->pos = (size_t)(n - file->offset);
+		return;
+	}
+	FSEEK(file->file, n, SEEK_SET);
+	file->offset = n;
+	file->len = file->pos = 0;
+	file->eof = 0;
 }
 
-UBYTE *read_byte_block(FILE *file, ULLONG n)
+ULLONG get_current_byte(struct matroska_reader *file)
+{
+	return file->offset + file->pos;
+}
+
+UBYTE *borrow_byte_block(struct matroska_reader *file, ULLONG n)
+{
+	if (n > SIZE_MAX || fill_buffer(file, (size_t)n) < n)
+		fatal(1, "reading from file");
+	UBYTE *block = file->buffer + file->pos;
+	file->pos += (size_t)n;
+	return block;
+}
+
+UBYTE *read_byte_block(struct matroska_reader *file, ULLONG n)
 {
 	UBYTE *buffer = malloc((size_t)(sizeof(UBYTE) * n));
 	if (buffer == NULL)
 		fatal(EXIT_NOT_ENOUGH_MEMORY, "In read_byte_block: Out of memory.");
-	if (fread(buffer, 1, (size_t)n, file) != n)
-		fatal(1, "reading from file");
+	read_into(file, buffer, n);
 	return buffer;
 }
 
-char *read_bytes_signed(FILE *file, ULLONG n)
+char *read_bytes_signed(struct matroska_reader *file, ULLONG n)
 {
 	char *buffer = malloc((size_t)(sizeof(UBYTE) * (n + 1)));
 	if (buffer == NULL)
 		fatal(EXIT_NOT_ENOUGH_MEMORY, "In read_bytes_signed: Out of memory.");
-	if (fread(buffer, 1, (size_t)n, file) != n)
-		fatal(1, "reading from file");
+	read_into(file, (UBYTE *)buffer, n);
 	buffer[n] = 0;
 	return buffer;
 }
 
-UBYTE mkv_read_byte(FILE *file)
+UBYTE mkv_read_byte(struct matroska_reader *file)
 {
-	return (UBYTE)fgetc(file);
+	if (file->pos == file->len && fill_buffer(file, 1) == 0)
+	{
+		file->eof = 1;
+		return (UBYTE)EOF;
+	}
+	return file->buffer[file->pos++];
 }
 
-ULLONG read_vint_length(FILE *file)
+ULLONG read_vint_length(struct matroska_reader *file)
 {
 	UBYTE ch = mkv_read_byte(file);
 	int cnt = 0;
@@ -71,46 +137,42 @@ ULLONG read_vint_length(FILE *file)
 	return ret;
 }
 
-UBYTE *read_vint_block(FILE *file)
+UBYTE *read_vint_block(struct matroska_reader *file)
 {
 	ULLONG len = read_vint_length(file);
 	return read_byte_block(file, len);
 }
 
-char *read_vint_block_signed(FILE *file)
+char *read_vint_block_signed(struct matroska_reader *file)
 {
 	ULLONG len = read_vint_length(file);
 	return read_bytes_signed(file, len);
 }
 
-ULLONG read_vint_block_int(FILE *file)
+ULLONG read_vint_block_int(struct matroska_reader *file)
 {
 	ULLONG len = read_vint_length(file);
-	UBYTE *s = read_byte_block(file, len);
-
 	ULLONG res = 0;
-	for (int i = 0; i < len; i++)
+	for (ULLONG i = 0; i < len; i++)
 	{
 		res <<= 8;
-		res += s[i];
+		res += mkv_read_byte(file);
 	}
-
-	free(s);
 	return res;
 }
 
-char *read_vint_block_string(FILE *file)
+char *read_vint_block_string(struct matroska_reader *file)
 {
 	return read_vint_block_signed(file);
 }
 
-void read_vint_block_skip(FILE *file)
+void read_vint_block_skip(struct matroska_reader *file)
 {
 	ULLONG len = read_vint_length(file);
 	skip_bytes(file, len);
 }
 
-void parse_ebml(FILE *file)
+void parse_ebml(struct matroska_reader *file)
 {
 	ULLONG len = read_vint_length(file);
 	ULLONG pos = get_current_byte(file);
@@ -122,7 +184,7 @@ void parse_ebml(FILE *file)
 	{
 		code <<= 8;
 		code += mkv_read_byte(file);
-		if (feof(file))
+		if (file->eof)
 			break;
 		code_len++;
 
@@ -178,7 +240,7 @@ void parse_ebml(FILE *file)
 	}
 }
 
-void parse_segment_info(FILE *file)
+void parse_segment_info(struct matroska_reader *file)
 {
 	ULLONG len = read_vint_length(file);
 	ULLONG pos = get_current_byte(file);
@@ -188,7 +250,7 @@ void parse_segment_info(FILE *file)
 	{
 		code <<= 8;
 		code += mkv_read_byte(file);
-		if (feof(file))
+		if (file->eof)
 			break;
 		code_len++;
 
@@ -302,9 +364,22 @@ int find_sub_track_index(struct matroska_ctx *mkv_ctx, ULLONG track_number)
 	return -1;
 }
 
+/* Whether --mkvlang asks for this track (all tracks when it is not given) */
+static int is_track_selected(struct matroska_sub_track *track, const char *lang)
+{
+	if (!lang)
+		return 1;
+	/* Match against lang_ietf (BCP-47, e.g. "en-US") first,
+	 * then fall back to lang (ISO-639-2, e.g. "eng").
+	 * This lets users pass either form to --mkvlang. */
+	if (track->lang_ietf && strstr(lang, track->lang_ietf) != NULL)
+		return 1;
+	return strstr(lang, track->lang) != NULL;
+}
+
 struct matroska_sub_sentence *parse_segment_cluster_block_group_block(struct matroska_ctx *mkv_ctx, ULLONG cluster_timecode)
 {
-	FILE *file = mkv_ctx->file;
+	struct matroska_reader *file = mkv_ctx->file;
 	ULLONG len = read_vint_length(file);
 	ULLONG pos = get_current_byte(file);
 	ULLONG track_number = read_vint_length(file); // track number is length, not int
@@ -353,6 +428,7 @@ struct matroska_sub_sentence *parse_segment_cluster_block_group_block(struct mat
 		allow gaps in time between display blocks. Another one is when display block is followed by another display block.
 		This code handles both cases but we don't save and use empty blocks as sentences, only time_starts of them. */
 		char *dvb_message = enc_ctx->last_string;
+		enc_ctx->last_string = NULL; // The sentence owns it from here on
 		if (ret < 0 || dvb_message == NULL)
 		{
 			// No text - no sentence is returned. Free the memory
@@ -380,21 +456,7 @@ struct matroska_sub_sentence *parse_segment_cluster_block_group_block(struct mat
 		sentence->text_size = size;
 	}
 
-	if (track->sentence_count == 0)
-	{
-		track->sentences = malloc(sizeof(struct matroska_sub_sentence *));
-		if (track->sentences == NULL)
-			fatal(EXIT_NOT_ENOUGH_MEMORY, "In parse_segment_cluster_block_group_block: Out of memory allocating sentences.");
-	}
-	else
-	{
-		void *tmp = realloc(track->sentences, (track->sentence_count + 1) * sizeof(struct matroska_sub_sentence *));
-		if (tmp == NULL)
-			fatal(EXIT_NOT_ENOUGH_MEMORY, "In parse_segment_cluster_block_group_block: Out of memory reallocating sentences.");
-		track->sentences = tmp;
-	}
-	track->sentences[track->sentence_count] = sentence;
-	track->sentence_count++;
+	add_sub_sentence(mkv_ctx, track, sentence);
 
 	mkv_ctx->current_second = max(mkv_ctx->current_second, sentence->time_start / 1000);
 	activity_progress((int)(get_current_byte(file) * 100 / mkv_ctx->ctx->inputsize),
@@ -406,7 +468,7 @@ struct matroska_sub_sentence *parse_segment_cluster_block_group_block(struct mat
 
 struct matroska_sub_sentence *parse_segment_cluster_block_group_block_additions(struct matroska_ctx *mkv_ctx, ULLONG cluster_timecode)
 {
-	FILE *file = mkv_ctx->file;
+	struct matroska_reader *file = mkv_ctx->file;
 	ULLONG len = read_vint_length(file);
 	ULLONG pos = get_current_byte(file);
 
@@ -464,8 +526,16 @@ struct matroska_sub_sentence *parse_segment_cluster_block_group_block_additions(
 		newBA->comment_size = item_size;
 	}
 
-	// attaching BlockAddition to the cue
-	struct matroska_sub_sentence *sentence = track->sentences[track->sentence_count - 1];
+	newBA->message = message;
+
+	// attaching BlockAddition to the cue, the one not written yet
+	struct matroska_sub_sentence *sentence = track->pending;
+	if (sentence == NULL || sentence->blockaddition != NULL)
+	{
+		free(message);
+		free(newBA);
+		return NULL;
+	}
 	sentence->blockaddition = newBA;
 
 	// returns the sentence (cue) that this BlockAddition is attached to
@@ -474,7 +544,7 @@ struct matroska_sub_sentence *parse_segment_cluster_block_group_block_additions(
 
 void parse_segment_cluster_block_group(struct matroska_ctx *mkv_ctx, ULLONG cluster_timecode)
 {
-	FILE *file = mkv_ctx->file;
+	struct matroska_reader *file = mkv_ctx->file;
 	ULLONG len = read_vint_length(file);
 	ULLONG pos = get_current_byte(file);
 
@@ -488,7 +558,7 @@ void parse_segment_cluster_block_group(struct matroska_ctx *mkv_ctx, ULLONG clus
 	{
 		code <<= 8;
 		code += mkv_read_byte(file);
-		if (feof(file))
+		if (file->eof)
 			break;
 		code_len++;
 
@@ -607,7 +677,7 @@ void parse_segment_cluster_block_group(struct matroska_ctx *mkv_ctx, ULLONG clus
 
 void parse_segment_cluster(struct matroska_ctx *mkv_ctx)
 {
-	FILE *file = mkv_ctx->file;
+	struct matroska_reader *file = mkv_ctx->file;
 	ULLONG len = read_vint_length(file);
 	ULLONG pos = get_current_byte(file);
 
@@ -618,7 +688,7 @@ void parse_segment_cluster(struct matroska_ctx *mkv_ctx)
 	{
 		code <<= 8;
 		code += mkv_read_byte(file);
-		if (feof(file))
+		if (file->eof)
 			break;
 		code_len++;
 
@@ -675,11 +745,14 @@ void parse_segment_cluster(struct matroska_ctx *mkv_ctx)
 	activity_progress((int)(get_current_byte(file) * 100 / mkv_ctx->ctx->inputsize),
 			  (int)(mkv_ctx->current_second / 60),
 			  (int)(mkv_ctx->current_second % 60));
+#ifdef WITH_LIBCURL
+	curl_sink_poll();
+#endif
 }
 
 void parse_simple_block(struct matroska_ctx *mkv_ctx, ULLONG frame_timestamp)
 {
-	FILE *file = mkv_ctx->file;
+	struct matroska_reader *file = mkv_ctx->file;
 
 	struct matroska_avc_frame frame;
 	ULLONG len = read_vint_length(file);
@@ -706,7 +779,7 @@ void parse_simple_block(struct matroska_ctx *mkv_ctx, ULLONG frame_timestamp)
 
 	// Construct the frame
 	frame.len = pos + len - get_current_byte(file);
-	frame.data = read_byte_block(file, frame.len);
+	frame.data = borrow_byte_block(file, frame.len);
 	frame.FTS = frame_timestamp + timecode;
 
 	if (is_hevc)
@@ -715,8 +788,6 @@ void parse_simple_block(struct matroska_ctx *mkv_ctx, ULLONG frame_timestamp)
 		process_mpeg2_frame_mkv(mkv_ctx, frame);
 	else
 		process_avc_frame_mkv(mkv_ctx, frame);
-
-	free(frame.data);
 }
 
 static long bswap32(long v)
@@ -871,7 +942,7 @@ enum matroska_track_subtitle_codec_id get_track_subtitle_codec_id(char *codec_id
 
 void parse_segment_track_entry(struct matroska_ctx *mkv_ctx)
 {
-	FILE *file = mkv_ctx->file;
+	struct matroska_reader *file = mkv_ctx->file;
 	mprint("\nTrack entry:\n");
 
 	ULLONG len = read_vint_length(file);
@@ -894,7 +965,7 @@ void parse_segment_track_entry(struct matroska_ctx *mkv_ctx)
 	{
 		code <<= 8;
 		code += mkv_read_byte(file);
-		if (feof(file))
+		if (file->eof)
 			break;
 		code_len++;
 
@@ -1072,7 +1143,14 @@ void parse_segment_track_entry(struct matroska_ctx *mkv_ctx)
 		sub_track->codec_id_string = codec_id_string;
 		sub_track->sentence_count = 0;
 		sub_track->last_timestamp = 0;
-		sub_track->sentences = NULL;
+		sub_track->pending = NULL;
+		sub_track->output = MATROSKA_OUTPUT_NONE;
+		sub_track->desc = -1;
+		sub_track->idx_desc = -1;
+		sub_track->file_pos = 0;
+		sub_track->vob_ctx = NULL;
+		sub_track->cue_points = 0;
+		sub_track->cue_points_timed = 0;
 		for (int i = 0; i < mkv_ctx->sub_tracks_count; i++)
 			if (strcmp((const char *)mkv_ctx->sub_tracks[i]->lang, (const char *)lang) == 0)
 				sub_track->lang_index++;
@@ -1096,7 +1174,7 @@ void parse_segment_track_entry(struct matroska_ctx *mkv_ctx)
 // Read sequence parameter set for AVC
 void parse_private_codec_data(struct matroska_ctx *mkv_ctx, char *codec_id_string, ULLONG track_number, char *lang)
 {
-	FILE *file = mkv_ctx->file;
+	struct matroska_reader *file = mkv_ctx->file;
 	ULLONG len = read_vint_length(file);
 	unsigned char *data = NULL;
 
@@ -1219,7 +1297,7 @@ void parse_private_codec_data(struct matroska_ctx *mkv_ctx, char *codec_id_strin
 
 void parse_segment_tracks(struct matroska_ctx *mkv_ctx)
 {
-	FILE *file = mkv_ctx->file;
+	struct matroska_reader *file = mkv_ctx->file;
 	ULLONG len = read_vint_length(file);
 	ULLONG pos = get_current_byte(file);
 
@@ -1228,7 +1306,7 @@ void parse_segment_tracks(struct matroska_ctx *mkv_ctx)
 	{
 		code <<= 8;
 		code += mkv_read_byte(file);
-		if (feof(file))
+		if (file->eof)
 			break;
 		code_len++;
 
@@ -1263,37 +1341,398 @@ void parse_segment_tracks(struct matroska_ctx *mkv_ctx)
 	}
 }
 
+static void parse_segment_seek(struct matroska_ctx *mkv_ctx)
+{
+	struct matroska_reader *file = mkv_ctx->file;
+	ULLONG len = read_vint_length(file);
+	ULLONG pos = get_current_byte(file);
+	ULLONG seek_id = 0, seek_position = 0;
+
+	int code = 0, code_len = 0;
+	while (pos + len > get_current_byte(file))
+	{
+		code <<= 8;
+		code += mkv_read_byte(file);
+		if (file->eof)
+			break;
+		code_len++;
+
+		switch (code)
+		{
+			case MATROSKA_SEGMENT_SEEK_ID:
+				seek_id = read_vint_block_int(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_SEGMENT_SEEK_POSITION:
+				seek_position = read_vint_block_int(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+
+				/* Misc ids */
+			case MATROSKA_VOID:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_CRC32:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			default:
+				if (code_len == MATROSKA_MAX_ID_LENGTH)
+				{
+					mprint(MATROSKA_WARNING "Unknown element 0x%x at position " LLD ", skipping this element\n", code,
+					       get_current_byte(file) - MATROSKA_MAX_ID_LENGTH);
+					read_vint_block_skip(file);
+					code = 0;
+					code_len = 0;
+				}
+				break;
+		}
+	}
+
+	if (seek_id == MATROSKA_SEGMENT_CUES && mkv_ctx->cues_position == 0)
+		mkv_ctx->cues_position = seek_position;
+}
+
+void parse_segment_seek_head(struct matroska_ctx *mkv_ctx)
+{
+	struct matroska_reader *file = mkv_ctx->file;
+	ULLONG len = read_vint_length(file);
+	ULLONG pos = get_current_byte(file);
+
+	int code = 0, code_len = 0;
+	while (pos + len > get_current_byte(file))
+	{
+		code <<= 8;
+		code += mkv_read_byte(file);
+		if (file->eof)
+			break;
+		code_len++;
+
+		switch (code)
+		{
+			case MATROSKA_SEGMENT_SEEK:
+				parse_segment_seek(mkv_ctx);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+
+				/* Misc ids */
+			case MATROSKA_VOID:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_CRC32:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			default:
+				if (code_len == MATROSKA_MAX_ID_LENGTH)
+				{
+					mprint(MATROSKA_WARNING "Unknown element 0x%x at position " LLD ", skipping this element\n", code,
+					       get_current_byte(file) - MATROSKA_MAX_ID_LENGTH);
+					read_vint_block_skip(file);
+					code = 0;
+					code_len = 0;
+				}
+				break;
+		}
+	}
+}
+
+static void add_sub_cluster(struct matroska_ctx *mkv_ctx, ULLONG cluster_position)
+{
+	int count = mkv_ctx->sub_clusters_count;
+	// Grow by doubling, the Cues can list one entry per subtitle block
+	if (count == 0 || (count >= 64 && (count & (count - 1)) == 0))
+	{
+		ULLONG *tmp = realloc(mkv_ctx->sub_clusters, sizeof(ULLONG) * (count == 0 ? 64 : count * 2));
+		if (tmp == NULL)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In add_sub_cluster: Out of memory.");
+		mkv_ctx->sub_clusters = tmp;
+	}
+	mkv_ctx->sub_clusters[mkv_ctx->sub_clusters_count++] = cluster_position;
+}
+
+static void parse_segment_cue_track_positions(struct matroska_ctx *mkv_ctx)
+{
+	struct matroska_reader *file = mkv_ctx->file;
+	ULLONG len = read_vint_length(file);
+	ULLONG pos = get_current_byte(file);
+	ULLONG track_number = 0, cluster_position = 0;
+	int has_cluster_position = 0, has_duration = 0;
+
+	int code = 0, code_len = 0;
+	while (pos + len > get_current_byte(file))
+	{
+		code <<= 8;
+		code += mkv_read_byte(file);
+		if (file->eof)
+			break;
+		code_len++;
+
+		switch (code)
+		{
+			case MATROSKA_SEGMENT_CUE_TRACK:
+				track_number = read_vint_block_int(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_SEGMENT_CUE_CLUSTER_POSITION:
+				cluster_position = read_vint_block_int(file);
+				has_cluster_position = 1;
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_SEGMENT_CUE_RELATIVE_POSITION:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_SEGMENT_CUE_DURATION:
+				read_vint_block_skip(file);
+				has_duration = 1;
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_SEGMENT_CUE_BLOCK_NUMBER:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_SEGMENT_CUE_CODEC_STATE:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_SEGMENT_CUE_REFERENCE:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+
+				/* Misc ids */
+			case MATROSKA_VOID:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_CRC32:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			default:
+				if (code_len == MATROSKA_MAX_ID_LENGTH)
+				{
+					mprint(MATROSKA_WARNING "Unknown element 0x%x at position " LLD ", skipping this element\n", code,
+					       get_current_byte(file) - MATROSKA_MAX_ID_LENGTH);
+					read_vint_block_skip(file);
+					code = 0;
+					code_len = 0;
+				}
+				break;
+		}
+	}
+
+	int sub_track_index = find_sub_track_index(mkv_ctx, track_number);
+	if (sub_track_index == -1 || !has_cluster_position)
+		return;
+	struct matroska_sub_track *track = mkv_ctx->sub_tracks[sub_track_index];
+	if (!is_track_selected(track, ccx_options.mkvlang))
+		return;
+	track->cue_points++;
+	if (has_duration)
+		track->cue_points_timed++;
+	add_sub_cluster(mkv_ctx, cluster_position);
+}
+
+static void parse_segment_cue_point(struct matroska_ctx *mkv_ctx)
+{
+	struct matroska_reader *file = mkv_ctx->file;
+	ULLONG len = read_vint_length(file);
+	ULLONG pos = get_current_byte(file);
+
+	int code = 0, code_len = 0;
+	while (pos + len > get_current_byte(file))
+	{
+		code <<= 8;
+		code += mkv_read_byte(file);
+		if (file->eof)
+			break;
+		code_len++;
+
+		switch (code)
+		{
+			case MATROSKA_SEGMENT_CUE_TIME:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_SEGMENT_CUE_TRACK_POSITIONS:
+				parse_segment_cue_track_positions(mkv_ctx);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+
+				/* Misc ids */
+			case MATROSKA_VOID:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_CRC32:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			default:
+				if (code_len == MATROSKA_MAX_ID_LENGTH)
+				{
+					mprint(MATROSKA_WARNING "Unknown element 0x%x at position " LLD ", skipping this element\n", code,
+					       get_current_byte(file) - MATROSKA_MAX_ID_LENGTH);
+					read_vint_block_skip(file);
+					code = 0;
+					code_len = 0;
+				}
+				break;
+		}
+	}
+}
+
+void parse_segment_cues(struct matroska_ctx *mkv_ctx)
+{
+	struct matroska_reader *file = mkv_ctx->file;
+	ULLONG len = read_vint_length(file);
+	ULLONG pos = get_current_byte(file);
+
+	int code = 0, code_len = 0;
+	while (pos + len > get_current_byte(file))
+	{
+		code <<= 8;
+		code += mkv_read_byte(file);
+		if (file->eof)
+			break;
+		code_len++;
+
+		switch (code)
+		{
+			case MATROSKA_SEGMENT_CUE_POINT:
+				parse_segment_cue_point(mkv_ctx);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+
+				/* Misc ids */
+			case MATROSKA_VOID:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			case MATROSKA_CRC32:
+				read_vint_block_skip(file);
+				MATROSKA_SWITCH_BREAK(code, code_len);
+			default:
+				if (code_len == MATROSKA_MAX_ID_LENGTH)
+				{
+					mprint(MATROSKA_WARNING "Unknown element 0x%x at position " LLD ", skipping this element\n", code,
+					       get_current_byte(file) - MATROSKA_MAX_ID_LENGTH);
+					read_vint_block_skip(file);
+					code = 0;
+					code_len = 0;
+				}
+				break;
+		}
+	}
+}
+
+static int compare_positions(const void *a, const void *b)
+{
+	ULLONG x = *(const ULLONG *)a, y = *(const ULLONG *)b;
+	return (x > y) - (x < y);
+}
+
+/* Without a video track to scan for EIA-608/708, only the clusters holding
+ * blocks of the selected subtitle tracks have to be read. The Cues list them
+ * when the muxer indexed every block of the subtitle tracks. Fills
+ * mkv_ctx->sub_clusters if the Cues cover every selected track that way,
+ * leaves it NULL otherwise so that every cluster is read. */
+static void find_sub_clusters(struct matroska_ctx *mkv_ctx)
+{
+	struct matroska_reader *file = mkv_ctx->file;
+
+	mkv_ctx->cues_checked = 1;
+	if (mkv_ctx->avc_track_number > -1 || mkv_ctx->hevc_track_number > -1 || mkv_ctx->mpeg2_track_number > -1)
+		return;
+	if (mkv_ctx->sub_tracks_count == 0 || mkv_ctx->cues_position == 0)
+		return;
+
+	ULLONG resume = get_current_byte(file);
+	set_bytes(file, mkv_ctx->segment_start + mkv_ctx->cues_position);
+	ULLONG id = 0;
+	for (int i = 0; i < MATROSKA_MAX_ID_LENGTH; i++)
+		id = (id << 8) | mkv_read_byte(file);
+	if (id == MATROSKA_SEGMENT_CUES && !file->eof)
+		parse_segment_cues(mkv_ctx);
+	set_bytes(file, resume);
+
+	int selected = 0;
+	for (int i = 0; i < mkv_ctx->sub_tracks_count; i++)
+	{
+		struct matroska_sub_track *track = mkv_ctx->sub_tracks[i];
+		if (!is_track_selected(track, ccx_options.mkvlang))
+			continue;
+		selected++;
+		// Muxers that index each block of a subtitle track (mkvmerge, FFmpeg)
+		// give every entry a CueDuration. Entries without one may only be
+		// seek points, with blocks of the track in clusters they don't list.
+		if (track->cue_points == 0 || track->cue_points_timed < track->cue_points)
+		{
+			// Not fully indexed, its blocks could be in any cluster
+			selected = 0;
+			break;
+		}
+	}
+	if (selected == 0 || mkv_ctx->sub_clusters_count == 0)
+	{
+		freep(&mkv_ctx->sub_clusters);
+		mkv_ctx->sub_clusters_count = 0;
+		return;
+	}
+
+	qsort(mkv_ctx->sub_clusters, mkv_ctx->sub_clusters_count, sizeof(ULLONG), compare_positions);
+	int count = 1;
+	for (int i = 1; i < mkv_ctx->sub_clusters_count; i++)
+		if (mkv_ctx->sub_clusters[i] != mkv_ctx->sub_clusters[count - 1])
+			mkv_ctx->sub_clusters[count++] = mkv_ctx->sub_clusters[i];
+	mkv_ctx->sub_clusters_count = count;
+	mprint("No video track to scan for captions, reading only the %d clusters with subtitles\n", count);
+}
+
+/* With mkv_ctx->sub_clusters, jump over the cluster starting at cluster_start
+ * if it holds no subtitle block: to the next one that does, or to end.
+ * Returns 1 if the cluster was skipped. */
+static int skip_cluster(struct matroska_ctx *mkv_ctx, ULLONG cluster_start, ULLONG end)
+{
+	if (mkv_ctx->sub_clusters == NULL)
+		return 0;
+
+	ULLONG position = cluster_start - mkv_ctx->segment_start;
+	int low = 0, high = mkv_ctx->sub_clusters_count;
+	while (low < high)
+	{
+		int mid = (low + high) / 2;
+		if (mkv_ctx->sub_clusters[mid] < position)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	if (low < mkv_ctx->sub_clusters_count && mkv_ctx->sub_clusters[low] == position)
+		return 0;
+
+	set_bytes(mkv_ctx->file, low < mkv_ctx->sub_clusters_count ? mkv_ctx->segment_start + mkv_ctx->sub_clusters[low] : end);
+	return 1;
+}
+
 void parse_segment(struct matroska_ctx *mkv_ctx)
 {
-	FILE *file = mkv_ctx->file;
+	struct matroska_reader *file = mkv_ctx->file;
 	ULLONG len = read_vint_length(file);
 	ULLONG pos = get_current_byte(file);
+	mkv_ctx->segment_start = pos;
 
 	int code = 0, code_len = 0;
 	while (pos + len > get_current_byte(file))
 	{
 		code <<= 8;
 		code += mkv_read_byte(file);
-		if (feof(file))
+		if (file->eof)
 			break;
 		code_len++;
 		switch (code)
 		{
 			/* Segment ids */
 			case MATROSKA_SEGMENT_SEEK_HEAD:
-				read_vint_block_skip(file);
+				parse_segment_seek_head(mkv_ctx);
 				MATROSKA_SWITCH_BREAK(code, code_len);
 			case MATROSKA_SEGMENT_INFO:
 				parse_segment_info(file);
 				MATROSKA_SWITCH_BREAK(code, code_len);
 			case MATROSKA_SEGMENT_CLUSTER:
-				// read_vint_block_skip(file);
-				parse_segment_cluster(mkv_ctx);
+				if (!mkv_ctx->cues_checked)
+					find_sub_clusters(mkv_ctx);
+				if (!skip_cluster(mkv_ctx, get_current_byte(file) - MATROSKA_MAX_ID_LENGTH, pos + len))
+					parse_segment_cluster(mkv_ctx);
 				MATROSKA_SWITCH_BREAK(code, code_len);
 			case MATROSKA_SEGMENT_TRACKS:
 				parse_segment_tracks(mkv_ctx);
 				MATROSKA_SWITCH_BREAK(code, code_len);
 			case MATROSKA_SEGMENT_CUES:
+				// Cues stored ahead of the clusters, without a SeekHead pointing at them
+				if (mkv_ctx->cues_position == 0)
+					mkv_ctx->cues_position = get_current_byte(file) - MATROSKA_MAX_ID_LENGTH - mkv_ctx->segment_start;
 				read_vint_block_skip(file);
 				MATROSKA_SWITCH_BREAK(code, code_len);
 			case MATROSKA_SEGMENT_ATTACHMENTS:
@@ -1469,15 +1908,9 @@ static int is_text_output_format(enum ccx_output_format format)
 		format == CCX_OF_SAMI || format == CCX_OF_SMPTETT);
 }
 
-/* VOBSUB support: Process VOBSUB track with OCR and output text format */
-static void process_vobsub_track_ocr(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track)
+/* VOBSUB support: Start converting a VOBSUB track to text with OCR */
+static void open_vobsub_track_ocr(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track)
 {
-	if (track->sentence_count == 0)
-	{
-		mprint("\nNo VOBSUB subtitles to process");
-		return;
-	}
-
 	/* Check if OCR is available */
 	if (!vobsub_ocr_available())
 	{
@@ -1487,8 +1920,8 @@ static void process_vobsub_track_ocr(struct matroska_ctx *mkv_ctx, struct matros
 	}
 
 	/* Initialize VOBSUB decoder */
-	struct vobsub_ctx *vob_ctx = init_vobsub_decoder();
-	if (!vob_ctx)
+	track->vob_ctx = init_vobsub_decoder();
+	if (!track->vob_ctx)
 	{
 		fatal(EXIT_NOT_CLASSIFIED,
 		      "VOBSUB to text conversion requires OCR, but initialization failed.\n"
@@ -1498,87 +1931,65 @@ static void process_vobsub_track_ocr(struct matroska_ctx *mkv_ctx, struct matros
 	/* Parse palette from track header (CodecPrivate) */
 	if (track->header)
 	{
-		vobsub_parse_palette(vob_ctx, track->header);
+		vobsub_parse_palette(track->vob_ctx, track->header);
 	}
 
-	mprint("\nProcessing VOBSUB track with OCR (%d subtitles)", track->sentence_count);
+	mprint("\nProcessing VOBSUB track " LLD " with OCR", track->track_number);
+}
 
-	/* Get encoder context for output */
+/* VOBSUB support: Decode one subtitle, run OCR and encode it */
+static void write_vobsub_sentence_ocr(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track,
+				      struct matroska_sub_sentence *sentence, struct matroska_sub_sentence *next)
+{
 	struct encoder_ctx *enc_ctx = update_encoder_list(mkv_ctx->ctx);
 
-	/* Process each subtitle */
-	for (int i = 0; i < track->sentence_count; i++)
+	/* Calculate end time (use next subtitle start if not specified) */
+	ULLONG end_time = sentence->time_end;
+	if (end_time == 0 && next != NULL)
 	{
-		struct matroska_sub_sentence *sentence = track->sentences[i];
-		mkv_ctx->sentence_count++;
-
-		/* Calculate end time (use next subtitle start if not specified) */
-		ULLONG end_time = sentence->time_end;
-		if (end_time == 0 && i + 1 < track->sentence_count)
-		{
-			end_time = track->sentences[i + 1]->time_start - 1;
-		}
-		else if (end_time == 0)
-		{
-			end_time = sentence->time_start + 5000; /* Default 5 second duration */
-		}
-
-		/* Decode SPU and run OCR */
-		struct cc_subtitle sub;
-		memset(&sub, 0, sizeof(sub));
-
-		int ret = vobsub_decode_spu(vob_ctx,
-					    (unsigned char *)sentence->text,
-					    sentence->text_size,
-					    sentence->time_start,
-					    end_time,
-					    &sub);
+		end_time = next->time_start - 1;
+	}
+	else if (end_time == 0)
+	{
+		end_time = sentence->time_start + 5000; /* Default 5 second duration */
+	}
 
-		if (ret == 0 && sub.got_output)
-		{
-			/* Encode the subtitle to output format */
-			encode_sub(enc_ctx, &sub);
+	/* Decode SPU and run OCR */
+	struct cc_subtitle sub;
+	memset(&sub, 0, sizeof(sub));
+
+	int ret = vobsub_decode_spu(track->vob_ctx,
+				    (unsigned char *)sentence->text,
+				    sentence->text_size,
+				    sentence->time_start,
+				    end_time,
+				    &sub);
+
+	if (ret == 0 && sub.got_output)
+		encode_vobsub(enc_ctx, &sub);
+	/* With --ocr-threads, subtitles come back here once OCR'd */
+	while (vobsub_next_output(track->vob_ctx, &sub, 0))
+		encode_vobsub(enc_ctx, &sub);
+}
 
-			/* Free subtitle data */
-			if (sub.data)
-			{
-				struct cc_bitmap *rect = (struct cc_bitmap *)sub.data;
-				for (int j = 0; j < sub.nb_data; j++)
-				{
-					if (rect[j].data0)
-						free(rect[j].data0);
-					if (rect[j].data1)
-						free(rect[j].data1);
-#ifdef ENABLE_OCR
-					if (rect[j].ocr_text)
-						free(rect[j].ocr_text);
-#endif
-				}
-				free(sub.data);
-			}
-		}
+static void close_vobsub_track_ocr(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track)
+{
+	struct encoder_ctx *enc_ctx = update_encoder_list(mkv_ctx->ctx);
+	struct cc_subtitle sub;
 
-		/* Progress indicator */
-		if ((i + 1) % 50 == 0 || i + 1 == track->sentence_count)
-		{
-			mprint("\rProcessing VOBSUB: %d/%d subtitles", i + 1, track->sentence_count);
-		}
-	}
+	while (vobsub_next_output(track->vob_ctx, &sub, 1))
+		encode_vobsub(enc_ctx, &sub);
 
-	delete_vobsub_decoder(&vob_ctx);
-	mprint("\nVOBSUB OCR processing complete");
+	delete_vobsub_decoder(&track->vob_ctx);
+	mprint("\nVOBSUB OCR processing complete (%d subtitles)", track->sentence_count);
 }
 
 /* VOBSUB support: Save VOBSUB track to .idx and .sub files */
 #define VOBSUB_BLOCK_SIZE 2048
-static void save_vobsub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track)
-{
-	if (track->sentence_count == 0)
-	{
-		mprint("\nNo VOBSUB subtitles to write");
-		return;
-	}
 
+/* VOBSUB support: Create the .idx and .sub files and write the .idx header */
+static int open_vobsub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track)
+{
 	// Generate base filename (without extension)
 	const char *basename = get_basename(mkv_ctx->filename);
 	/* Prefer the BCP-47 IETF tag over the legacy ISO-639-2 code. */
@@ -1586,7 +1997,7 @@ static void save_vobsub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_
 	size_t needed = strlen(basename) + strlen(lang_tag) + 32;
 	char *base_filename = malloc(needed);
 	if (base_filename == NULL)
-		fatal(EXIT_NOT_ENOUGH_MEMORY, "In save_vobsub_track: Out of memory.");
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In open_vobsub_track: Out of memory.");
 
 	if (track->lang_index == 0)
 		snprintf(base_filename, needed, "%s_%s", basename, lang_tag);
@@ -1596,13 +2007,13 @@ static void save_vobsub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_
 	// Create .sub filename
 	char *sub_filename = malloc(needed + 5);
 	if (sub_filename == NULL)
-		fatal(EXIT_NOT_ENOUGH_MEMORY, "In save_vobsub_track: Out of memory.");
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In open_vobsub_track: Out of memory.");
 	snprintf(sub_filename, needed + 5, "%s.sub", base_filename);
 
 	// Create .idx filename
 	char *idx_filename = malloc(needed + 5);
 	if (idx_filename == NULL)
-		fatal(EXIT_NOT_ENOUGH_MEMORY, "In save_vobsub_track: Out of memory.");
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In open_vobsub_track: Out of memory.");
 	snprintf(idx_filename, needed + 5, "%s.idx", base_filename);
 
 	mprint("\nOutput files: %s, %s", idx_filename, sub_filename);
@@ -1620,7 +2031,7 @@ static void save_vobsub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_
 		free(base_filename);
 		free(sub_filename);
 		free(idx_filename);
-		return;
+		return -1;
 	}
 
 	// Open .idx file
@@ -1637,7 +2048,7 @@ static void save_vobsub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_
 		free(base_filename);
 		free(sub_filename);
 		free(idx_filename);
-		return;
+		return -1;
 	}
 
 	// Write .idx header (from CodecPrivate)
@@ -1649,64 +2060,65 @@ static void save_vobsub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_
 	snprintf(lang_line, sizeof(lang_line), "\nid: %s, index: 0\n", track->lang);
 	write_wrapped(idx_desc, lang_line, strlen(lang_line));
 
-	// Buffer for PS/PES headers and padding
-	unsigned char header_buf[32];
-	unsigned char zero_buf[VOBSUB_BLOCK_SIZE];
-	memset(zero_buf, 0, VOBSUB_BLOCK_SIZE);
+	track->desc = sub_desc;
+	track->idx_desc = idx_desc;
+	track->file_pos = 0;
 
-	ULLONG file_pos = 0;
-
-	// Write each subtitle
-	for (int i = 0; i < track->sentence_count; i++)
-	{
-		struct matroska_sub_sentence *sentence = track->sentences[i];
-		mkv_ctx->sentence_count++;
-
-		// Convert timestamp to 90kHz PTS
-		ULLONG pts_90khz = sentence->time_start * 90;
-
-		// Write timestamp entry to .idx
-		char timestamp[32];
-		generate_vobsub_timestamp(timestamp, sizeof(timestamp), sentence->time_start);
-		char idx_entry[128];
-		snprintf(idx_entry, sizeof(idx_entry), "timestamp: %s, filepos: %09" LLX_M "\n",
-			 timestamp, file_pos);
-		write_wrapped(idx_desc, idx_entry, strlen(idx_entry));
-
-		// Generate PS Pack header (14 bytes)
-		generate_ps_pack_header(header_buf, pts_90khz);
-		write_wrapped(sub_desc, (char *)header_buf, 14);
-
-		// Generate PES header (15 bytes)
-		int pes_header_len = generate_pes_header(header_buf, pts_90khz, sentence->text_size, 0);
-		write_wrapped(sub_desc, (char *)header_buf, pes_header_len);
-
-		// Write SPU data
-		write_wrapped(sub_desc, sentence->text, sentence->text_size);
-
-		// Calculate bytes written and pad to block boundary
-		ULLONG bytes_written = 14 + pes_header_len + sentence->text_size;
-		ULLONG padding_needed = VOBSUB_BLOCK_SIZE - (bytes_written % VOBSUB_BLOCK_SIZE);
-		if (padding_needed < VOBSUB_BLOCK_SIZE)
-		{
-			write_wrapped(sub_desc, (char *)zero_buf, padding_needed);
-			bytes_written += padding_needed;
-		}
-		file_pos += bytes_written;
-	}
-
-	close(sub_desc);
-	close(idx_desc);
 	free(base_filename);
 	free(sub_filename);
 	free(idx_filename);
+	return 0;
 }
 
-void save_sub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track)
+/* VOBSUB support: Append one subtitle to the .sub file and index it in the .idx */
+static void write_vobsub_sentence(struct matroska_sub_track *track, struct matroska_sub_sentence *sentence)
+{
+	// Buffer for PS/PES headers and padding
+	unsigned char header_buf[32];
+	static const unsigned char zero_buf[VOBSUB_BLOCK_SIZE];
+
+	// Convert timestamp to 90kHz PTS
+	ULLONG pts_90khz = sentence->time_start * 90;
+
+	// Write timestamp entry to .idx
+	char timestamp[32];
+	generate_vobsub_timestamp(timestamp, sizeof(timestamp), sentence->time_start);
+	char idx_entry[128];
+	snprintf(idx_entry, sizeof(idx_entry), "timestamp: %s, filepos: %09" LLX_M "\n",
+		 timestamp, track->file_pos);
+	write_wrapped(track->idx_desc, idx_entry, strlen(idx_entry));
+
+	// Generate PS Pack header (14 bytes)
+	generate_ps_pack_header(header_buf, pts_90khz);
+	write_wrapped(track->desc, (char *)header_buf, 14);
+
+	// Generate PES header (15 bytes)
+	int pes_header_len = generate_pes_header(header_buf, pts_90khz, sentence->text_size, 0);
+	write_wrapped(track->desc, (char *)header_buf, pes_header_len);
+
+	// Write SPU data
+	write_wrapped(track->desc, sentence->text, sentence->text_size);
+
+	// Calculate bytes written and pad to block boundary
+	ULLONG bytes_written = 14 + pes_header_len + sentence->text_size;
+	ULLONG padding_needed = VOBSUB_BLOCK_SIZE - (bytes_written % VOBSUB_BLOCK_SIZE);
+	if (padding_needed < VOBSUB_BLOCK_SIZE)
+	{
+		write_wrapped(track->desc, (char *)zero_buf, padding_needed);
+		bytes_written += padding_needed;
+	}
+	track->file_pos += bytes_written;
+}
+
+void open_sub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track)
 {
 	char *filename;
 	int desc;
 
+	track->output = MATROSKA_OUTPUT_SKIPPED;
+	if (!is_track_selected(track, ccx_options.mkvlang))
+		return;
+
 	// VOBSUB tracks need special handling
 	if (track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_VOBSUB)
 	{
@@ -1715,13 +2127,15 @@ void save_sub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *tra
 		    is_text_output_format(ccx_options.enc_cfg.write_format))
 		{
 			// Use OCR to convert VOBSUB to text
-			process_vobsub_track_ocr(mkv_ctx, track);
+			open_vobsub_track_ocr(mkv_ctx, track);
 		}
 		else
 		{
 			// Output raw idx/sub files
-			save_vobsub_track(mkv_ctx, track);
+			if (open_vobsub_track(mkv_ctx, track) < 0)
+				return;
 		}
+		track->output = MATROSKA_OUTPUT_OPEN;
 		return;
 	}
 
@@ -1750,144 +2164,215 @@ void save_sub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *tra
 	if (track->header != NULL)
 		write_wrapped(desc, track->header, strlen(track->header));
 
-	for (int i = 0; i < track->sentence_count; i++)
-	{
-		struct matroska_sub_sentence *sentence = track->sentences[i];
-		mkv_ctx->sentence_count++;
+	track->desc = desc;
+	track->output = MATROSKA_OUTPUT_OPEN;
+}
 
-		if (track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_WEBVTT)
-		{
-			write_wrapped(desc, "\n\n", 2);
+void write_sub_sentence(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track,
+			struct matroska_sub_sentence *sentence, struct matroska_sub_sentence *next)
+{
+	int desc;
 
-			struct block_addition *blockaddition = sentence->blockaddition;
+	if (track->output == MATROSKA_OUTPUT_NONE)
+		open_sub_track(mkv_ctx, track);
+	if (track->output != MATROSKA_OUTPUT_OPEN)
+		return;
 
-			// writing comment
-			if (blockaddition != NULL)
-			{
-				if (blockaddition->comment != NULL)
-				{
-					write_wrapped(desc, sentence->blockaddition->comment, sentence->blockaddition->comment_size);
-					write_wrapped(desc, "\n", 1);
-				}
-			}
+	desc = track->desc;
+	track->sentence_count++;
+	mkv_ctx->sentence_count++;
 
-			// writing cue identifier
-			if (blockaddition != NULL)
-			{
-				if (blockaddition->cue_identifier != NULL)
-				{
-					write_wrapped(desc, blockaddition->cue_identifier, blockaddition->cue_identifier_size);
-					write_wrapped(desc, "\n", 1);
-				}
-				else if (blockaddition->comment != NULL)
-				{
-					write_wrapped(desc, "\n", 1);
-				}
-			}
+	if (track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_VOBSUB)
+	{
+		if (track->vob_ctx)
+			write_vobsub_sentence_ocr(mkv_ctx, track, sentence, next);
+		else
+			write_vobsub_sentence(track, sentence);
+	}
+	else if (track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_WEBVTT)
+	{
+		write_wrapped(desc, "\n\n", 2);
 
-			// writing cue
-			char *timestamp_start = malloc(sizeof(char) * 80); // being generous
-			if (timestamp_start == NULL)
-				fatal(EXIT_NOT_ENOUGH_MEMORY, "In save_sub_track: Out of memory.");
-			timestamp_to_vtttime(sentence->time_start, timestamp_start);
-			ULLONG time_end = sentence->time_end;
-			if (i + 1 < track->sentence_count)
-				time_end = MIN(time_end, track->sentences[i + 1]->time_start - 1);
-			char *timestamp_end = malloc(sizeof(char) * 80);
-			if (timestamp_end == NULL)
-				fatal(EXIT_NOT_ENOUGH_MEMORY, "In save_sub_track: Out of memory.");
-			timestamp_to_vtttime(time_end, timestamp_end);
-
-			write_wrapped(desc, timestamp_start, strlen(timestamp_start));
-			write_wrapped(desc, " --> ", 5);
-			write_wrapped(desc, timestamp_end, strlen(timestamp_end));
-
-			// writing cue settings list
-			if (blockaddition != NULL)
+		struct block_addition *blockaddition = sentence->blockaddition;
+
+		// writing comment
+		if (blockaddition != NULL)
+		{
+			if (blockaddition->comment != NULL)
 			{
-				if (blockaddition->cue_settings_list != NULL)
-				{
-					write_wrapped(desc, " ", 1);
-					write_wrapped(desc, blockaddition->cue_settings_list, blockaddition->cue_settings_list_size);
-				}
+				write_wrapped(desc, sentence->blockaddition->comment, sentence->blockaddition->comment_size);
+				write_wrapped(desc, "\n", 1);
 			}
-			write_wrapped(desc, "\n", 1);
-
-			int size = 0;
-			while (*(sentence->text + size) == '\n' || *(sentence->text + size) == '\r')
-				size++;
-			write_wrapped(desc, sentence->text + size, sentence->text_size - size);
-
-			free(timestamp_start);
-			free(timestamp_end);
 		}
-		else if (track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_UTF8)
-		{
-			char number[16];
-			snprintf(number, sizeof(number), "%d", i + 1);
-			char *timestamp_start = malloc(sizeof(char) * 80); // being generous
-			if (timestamp_start == NULL)
-				fatal(EXIT_NOT_ENOUGH_MEMORY, "In save_sub_track: Out of memory.");
-			timestamp_to_srttime(sentence->time_start, timestamp_start);
-			ULLONG time_end = sentence->time_end;
-			if (i + 1 < track->sentence_count)
-				time_end = MIN(time_end, track->sentences[i + 1]->time_start - 1);
-			char *timestamp_end = malloc(sizeof(char) * 80);
-			if (timestamp_end == NULL)
-				fatal(EXIT_NOT_ENOUGH_MEMORY, "In save_sub_track: Out of memory.");
-			timestamp_to_srttime(time_end, timestamp_end);
-
-			write_wrapped(desc, number, strlen(number));
-			write_wrapped(desc, "\n", 1);
-			write_wrapped(desc, timestamp_start, strlen(timestamp_start));
-			write_wrapped(desc, " --> ", 5);
-			write_wrapped(desc, timestamp_end, strlen(timestamp_end));
-			write_wrapped(desc, "\n", 1);
-			int size = 0;
-			while (*(sentence->text + size) == '\n' || *(sentence->text + size) == '\r')
-				size++;
-			write_wrapped(desc, sentence->text + size, sentence->text_size - size);
 
-			if (sentence->text[sentence->text_size - 1] == '\n')
+		// writing cue identifier
+		if (blockaddition != NULL)
+		{
+			if (blockaddition->cue_identifier != NULL)
 			{
+				write_wrapped(desc, blockaddition->cue_identifier, blockaddition->cue_identifier_size);
 				write_wrapped(desc, "\n", 1);
 			}
-			else
+			else if (blockaddition->comment != NULL)
 			{
-				write_wrapped(desc, "\n\n", 2);
+				write_wrapped(desc, "\n", 1);
 			}
+		}
 
-			free(timestamp_start);
-			free(timestamp_end);
+		// writing cue
+		char *timestamp_start = malloc(sizeof(char) * 80); // being generous
+		if (timestamp_start == NULL)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In write_sub_sentence: Out of memory.");
+		timestamp_to_vtttime(sentence->time_start, timestamp_start);
+		ULLONG time_end = sentence->time_end;
+		if (next != NULL)
+			time_end = MIN(time_end, next->time_start - 1);
+		char *timestamp_end = malloc(sizeof(char) * 80);
+		if (timestamp_end == NULL)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In write_sub_sentence: Out of memory.");
+		timestamp_to_vtttime(time_end, timestamp_end);
+
+		write_wrapped(desc, timestamp_start, strlen(timestamp_start));
+		write_wrapped(desc, " --> ", 5);
+		write_wrapped(desc, timestamp_end, strlen(timestamp_end));
+
+		// writing cue settings list
+		if (blockaddition != NULL)
+		{
+			if (blockaddition->cue_settings_list != NULL)
+			{
+				write_wrapped(desc, " ", 1);
+				write_wrapped(desc, blockaddition->cue_settings_list, blockaddition->cue_settings_list_size);
+			}
 		}
-		else if (track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_ASS || track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_SSA)
+		write_wrapped(desc, "\n", 1);
+
+		int size = 0;
+		while (*(sentence->text + size) == '\n' || *(sentence->text + size) == '\r')
+			size++;
+		write_wrapped(desc, sentence->text + size, sentence->text_size - size);
+
+		free(timestamp_start);
+		free(timestamp_end);
+	}
+	else if (track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_UTF8)
+	{
+		char number[16];
+		snprintf(number, sizeof(number), "%d", track->sentence_count);
+		char *timestamp_start = malloc(sizeof(char) * 80); // being generous
+		if (timestamp_start == NULL)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In write_sub_sentence: Out of memory.");
+		timestamp_to_srttime(sentence->time_start, timestamp_start);
+		ULLONG time_end = sentence->time_end;
+		if (next != NULL)
+			time_end = MIN(time_end, next->time_start - 1);
+		char *timestamp_end = malloc(sizeof(char) * 80);
+		if (timestamp_end == NULL)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In write_sub_sentence: Out of memory.");
+		timestamp_to_srttime(time_end, timestamp_end);
+
+		write_wrapped(desc, number, strlen(number));
+		write_wrapped(desc, "\n", 1);
+		write_wrapped(desc, timestamp_start, strlen(timestamp_start));
+		write_wrapped(desc, " --> ", 5);
+		write_wrapped(desc, timestamp_end, strlen(timestamp_end));
+		write_wrapped(desc, "\n", 1);
+		int size = 0;
+		while (*(sentence->text + size) == '\n' || *(sentence->text + size) == '\r')
+			size++;
+		write_wrapped(desc, sentence->text + size, sentence->text_size - size);
+
+		if (sentence->text[sentence->text_size - 1] == '\n')
 		{
-			char *timestamp_start = generate_timestamp_ass_ssa(sentence->time_start);
-			ULLONG time_end = sentence->time_end;
-			if (i + 1 < track->sentence_count)
-				time_end = MIN(time_end, track->sentences[i + 1]->time_start - 1);
-			char *timestamp_end = generate_timestamp_ass_ssa(time_end);
-
-			write_wrapped(desc, "Dialogue: Marked=0,", strlen("Dialogue: Marked=0,"));
-			write_wrapped(desc, timestamp_start, strlen(timestamp_start));
-			write_wrapped(desc, ",", 1);
-			write_wrapped(desc, timestamp_end, strlen(timestamp_end));
-			write_wrapped(desc, ",", 1);
-			char *text = ass_ssa_sentence_erase_read_order(sentence->text);
-			char *text_to_free = text; // Save original pointer for freeing
-			while ((text[0] == '\\') && (text[1] == 'n' || text[1] == 'N'))
-				text += 2;
-			write_wrapped(desc, text, strlen(text));
 			write_wrapped(desc, "\n", 1);
+		}
+		else
+		{
+			write_wrapped(desc, "\n\n", 2);
+		}
 
-			free(text_to_free);
-			free(timestamp_start);
-			free(timestamp_end);
+		free(timestamp_start);
+		free(timestamp_end);
+	}
+	else if (track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_ASS || track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_SSA)
+	{
+		char *timestamp_start = generate_timestamp_ass_ssa(sentence->time_start);
+		ULLONG time_end = sentence->time_end;
+		if (next != NULL)
+			time_end = MIN(time_end, next->time_start - 1);
+		char *timestamp_end = generate_timestamp_ass_ssa(time_end);
+
+		write_wrapped(desc, "Dialogue: Marked=0,", strlen("Dialogue: Marked=0,"));
+		write_wrapped(desc, timestamp_start, strlen(timestamp_start));
+		write_wrapped(desc, ",", 1);
+		write_wrapped(desc, timestamp_end, strlen(timestamp_end));
+		write_wrapped(desc, ",", 1);
+		char *text = ass_ssa_sentence_erase_read_order(sentence->text);
+		char *text_to_free = text; // Save original pointer for freeing
+		while ((text[0] == '\\') && (text[1] == 'n' || text[1] == 'N'))
+			text += 2;
+		write_wrapped(desc, text, strlen(text));
+		write_wrapped(desc, "\n", 1);
+
+		free(text_to_free);
+		free(timestamp_start);
+		free(timestamp_end);
+	}
+}
+
+static void free_sub_sentence(struct matroska_sub_sentence *sentence)
+{
+	free(sentence->text);
+	if (sentence->blockaddition != NULL)
+	{
+		free(sentence->blockaddition->message);
+		free(sentence->blockaddition);
+	}
+	free(sentence);
+}
+
+void add_sub_sentence(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track, struct matroska_sub_sentence *sentence)
+{
+	// The pending sentence ends at the latest where this one starts, it can be written now
+	if (track->pending != NULL)
+	{
+		write_sub_sentence(mkv_ctx, track, track->pending, sentence);
+		free_sub_sentence(track->pending);
+	}
+	track->pending = sentence;
+}
+
+void close_sub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track)
+{
+	if (track->pending != NULL)
+	{
+		write_sub_sentence(mkv_ctx, track, track->pending, NULL);
+		free_sub_sentence(track->pending);
+		track->pending = NULL;
+	}
+
+	// Text tracks without any sentence still get a file with their header
+	if (track->output == MATROSKA_OUTPUT_NONE)
+	{
+		if (track->codec_id == MATROSKA_TRACK_SUBTITLE_CODEC_ID_VOBSUB)
+		{
+			if (is_track_selected(track, ccx_options.mkvlang))
+				mprint("\nNo VOBSUB subtitles to write");
+			track->output = MATROSKA_OUTPUT_SKIPPED;
 		}
+		else
+			open_sub_track(mkv_ctx, track);
 	}
+	if (track->output != MATROSKA_OUTPUT_OPEN)
+		return;
 
-	if (desc != 1)
-		close(desc);
+	if (track->vob_ctx)
+		close_vobsub_track_ocr(mkv_ctx, track);
+	else if (track->desc != 1)
+		close(track->desc);
+	if (track->idx_desc >= 0)
+		close(track->idx_desc);
+	track->output = MATROSKA_OUTPUT_SKIPPED;
 }
 
 void free_sub_track(struct matroska_sub_track *track)
@@ -1900,39 +2385,15 @@ void free_sub_track(struct matroska_sub_track *track)
 		free(track->lang_ietf);
 	if (track->codec_id_string != NULL)
 		free(track->codec_id_string);
-	for (int i = 0; i < track->sentence_count; i++)
-	{
-		struct matroska_sub_sentence *sentence = track->sentences[i];
-		free(sentence->text);
-		free(sentence);
-	}
-	if (track->sentences != NULL)
-		free(track->sentences);
+	if (track->pending != NULL)
+		free_sub_sentence(track->pending);
 	free(track);
 }
 
-void matroska_save_all(struct matroska_ctx *mkv_ctx, char *lang)
+void matroska_save_all(struct matroska_ctx *mkv_ctx)
 {
 	for (int i = 0; i < mkv_ctx->sub_tracks_count; i++)
-	{
-		if (lang)
-		{
-			/* Match against lang_ietf (BCP-47, e.g. "en-US") first,
-			 * then fall back to lang (ISO-639-2, e.g. "eng").
-			 * This lets users pass either form to --mkvlang. */
-			int matched = 0;
-			if (mkv_ctx->sub_tracks[i]->lang_ietf &&
-			    strstr(lang, mkv_ctx->sub_tracks[i]->lang_ietf) != NULL)
-				matched = 1;
-			if (!matched &&
-			    strstr(lang, mkv_ctx->sub_tracks[i]->lang) != NULL)
-				matched = 1;
-			if (matched)
-				save_sub_track(mkv_ctx, mkv_ctx->sub_tracks[i]);
-		}
-		else
-			save_sub_track(mkv_ctx, mkv_ctx->sub_tracks[i]);
-	}
+		close_sub_track(mkv_ctx, mkv_ctx->sub_tracks[i]);
 
 	// EIA-608
 	update_decoder_list(mkv_ctx->ctx);
@@ -1948,6 +2409,7 @@ void matroska_free_all(struct matroska_ctx *mkv_ctx)
 	for (int i = 0; i < mkv_ctx->sub_tracks_count; i++)
 		free_sub_track(mkv_ctx->sub_tracks[i]);
 	free(mkv_ctx->sub_tracks);
+	free(mkv_ctx->sub_clusters);
 	free(mkv_ctx);
 }
 
@@ -1957,13 +2419,13 @@ void matroska_parse(struct matroska_ctx *mkv_ctx)
 
 	mprint("\n");
 
-	FILE *file = mkv_ctx->file;
-	while (!feof(file))
+	struct matroska_reader *file = mkv_ctx->file;
+	while (!file->eof)
 	{
 		code <<= 8;
 		code += mkv_read_byte(file);
 		// Check for EOF after reading - feof() is only set after a failed read
-		if (feof(file))
+		if (file->eof)
 			break;
 		code_len++;
 
@@ -2000,18 +2462,36 @@ void matroska_parse(struct matroska_ctx *mkv_ctx)
 	}
 
 	// Close file stream
-	fclose(file);
+	close_file(file);
 
 	mprint("\n");
 }
 
-FILE *create_file(struct lib_ccx_ctx *ctx)
+struct matroska_reader *create_file(struct lib_ccx_ctx *ctx)
 {
 	char *filename = ctx->inputfile[ctx->current_file];
-	FILE *file = fopen(filename, "rb");
+	FILE *stream = fopen(filename, "rb");
+	if (stream == NULL)
+		return NULL;
+
+	struct matroska_reader *file = calloc(1, sizeof(struct matroska_reader));
+	if (file == NULL)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In create_file: Out of memory.");
+	file->buffer = malloc(MATROSKA_READ_BUFFER_SIZE);
+	if (file->buffer == NULL)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In create_file: Out of memory.");
+	file->capacity = MATROSKA_READ_BUFFER_SIZE;
+	file->file = stream;
 	return file;
 }
 
+void close_file(struct matroska_reader *file)
+{
+	fclose(file->file);
+	free(file->buffer);
+	free(file);
+}
+
 int matroska_loop(struct lib_ccx_ctx *ctx)
 {
 	if (ccx_options.write_format_rewritten)
@@ -2026,7 +2506,7 @@ int matroska_loop(struct lib_ccx_ctx *ctx)
 	}
 
 	// Don't need generated input file
-	// Will read bytes by FILE*
+	// Will read bytes through our own buffer
 	close_input_file(ctx);
 
 	struct matroska_ctx *mkv_ctx = malloc(sizeof(struct matroska_ctx));
@@ -2052,6 +2532,11 @@ int matroska_loop(struct lib_ccx_ctx *ctx)
 	mkv_ctx->avc_track_number = -1;
 	mkv_ctx->hevc_track_number = -1;
 	mkv_ctx->mpeg2_track_number = -1;
+	mkv_ctx->segment_start = 0;
+	mkv_ctx->cues_position = 0;
+	mkv_ctx->cues_checked = 0;
+	mkv_ctx->sub_clusters = NULL;
+	mkv_ctx->sub_clusters_count = 0;
 
 	matroska_parse(mkv_ctx);
 
@@ -2059,7 +2544,7 @@ int matroska_loop(struct lib_ccx_ctx *ctx)
 	activity_progress(100, (int)(mkv_ctx->current_second / 60),
 			  (int)(mkv_ctx->current_second % 60));
 
-	matroska_save_all(mkv_ctx, ccx_options.mkvlang);
+	matroska_save_all(mkv_ctx);
 
 	// Save values before freeing mkv_ctx
 	int sentence_count = mkv_ctx->sentence_count;
@@ -71,6 +71,23 @@
 #define MATROSKA_SEGMENT_MUXING_APP 0x4D80
 #define MATROSKA_SEGMENT_WRITING_APP 0x5741
 
+/* Segment seek head ids */
+#define MATROSKA_SEGMENT_SEEK 0x4DBB
+#define MATROSKA_SEGMENT_SEEK_ID 0x53AB
+#define MATROSKA_SEGMENT_SEEK_POSITION 0x53AC
+
+/* Segment cues ids */
+#define MATROSKA_SEGMENT_CUE_POINT 0xBB
+#define MATROSKA_SEGMENT_CUE_TIME 0xB3
+#define MATROSKA_SEGMENT_CUE_TRACK_POSITIONS 0xB7
+#define MATROSKA_SEGMENT_CUE_TRACK 0xF7
+#define MATROSKA_SEGMENT_CUE_CLUSTER_POSITION 0xF1
+#define MATROSKA_SEGMENT_CUE_RELATIVE_POSITION 0xF0
+#define MATROSKA_SEGMENT_CUE_DURATION 0xB2
+#define MATROSKA_SEGMENT_CUE_BLOCK_NUMBER 0x5378
+#define MATROSKA_SEGMENT_CUE_CODEC_STATE 0xEA
+#define MATROSKA_SEGMENT_CUE_REFERENCE 0xDB
+
 /* Segment cluster ids */
 #define MATROSKA_SEGMENT_CLUSTER_TIMECODE 0xE7
 #define MATROSKA_SEGMENT_CLUSTER_SILENT_TRACKS 0x5854
@@ -141,6 +158,7 @@
 /* Other defines */
 #define MATROSKA_MAX_ID_LENGTH 4
 #define MAX_FILE_NAME_SIZE 260
+#define MATROSKA_READ_BUFFER_SIZE (1024 * 1024)
 
 /* Enums */
 enum matroska_track_entry_type
@@ -200,6 +218,15 @@ char *dvb_codec_id = "S_DVBSUB";
 
 /* Structures */
 
+enum matroska_track_output
+{
+	MATROSKA_OUTPUT_NONE = 0, // Not opened yet, done at its first sentence
+	MATROSKA_OUTPUT_OPEN,
+	MATROSKA_OUTPUT_SKIPPED, // Not selected by --mkvlang, failed to open, or closed
+};
+
+struct vobsub_ctx;
+
 struct block_addition
 {
 	char *cue_settings_list;
@@ -208,6 +235,7 @@ struct block_addition
 	ULLONG cue_identifier_size;
 	char *comment;
 	ULLONG comment_size;
+	char *message; // Buffer the fields above point into
 };
 
 struct matroska_sub_sentence
@@ -237,8 +265,27 @@ struct matroska_sub_track
 	char *codec_id_string;
 	ULLONG last_timestamp;
 
-	int sentence_count;
-	struct matroska_sub_sentence **sentences;
+	int sentence_count;		       // Sentences written so far
+	struct matroska_sub_sentence *pending; // Last sentence, written when the next one gives its end time
+	enum matroska_track_output output;
+	int desc;		    // Output file, .sub file for raw VOBSUB
+	int idx_desc;		    // .idx file for raw VOBSUB, -1 otherwise
+	ULLONG file_pos;	    // Bytes written to the .sub file
+	struct vobsub_ctx *vob_ctx; // VOBSUB to text through OCR, NULL otherwise
+	int cue_points;		    // Cues entries pointing at its blocks
+	int cue_points_timed;	    // Of them, entries with a CueDuration
+};
+
+/* The input file, read in large blocks */
+struct matroska_reader
+{
+	FILE *file;
+	UBYTE *buffer;
+	size_t capacity; // Allocated size of buffer
+	size_t len;	 // Bytes of buffer holding file data
+	size_t pos;	 // Next byte to read in buffer
+	ULLONG offset;	 // Position in the file of buffer[0]
+	int eof;	 // Set once a read went past the end of the file, like feof()
 };
 
 struct matroska_ctx
@@ -254,26 +301,32 @@ struct matroska_ctx
 	int sentence_count;
 	char *filename;
 	ULLONG current_second;
-	FILE *file;
+	struct matroska_reader *file;
+	ULLONG segment_start; // Position of the Segment data, which SeekHead and Cues positions are relative to
+	ULLONG cues_position; // Of the Cues from the SeekHead, 0 if unknown
+	int cues_checked;     // Whether the Cues were looked at for sub_clusters
+	ULLONG *sub_clusters; // Sorted positions of the clusters with subtitle blocks. NULL to read every cluster
+	int sub_clusters_count;
 };
 
 /* Bytestream and parser functions */
-void skip_bytes(FILE *file, ULLONG n);
-void set_bytes(FILE *file, ULLONG n);
-ULLONG get_current_byte(FILE *file);
-UBYTE *read_byte_block(FILE *file, ULLONG n);
-char *read_bytes_signed(FILE *file, ULLONG n);
-UBYTE mkv_read_byte(FILE *file);
-
-ULLONG read_vint_length(FILE *file);
-UBYTE *read_vint_block(FILE *file);
-char *read_vint_block_signed(FILE *file);
-ULLONG read_vint_block_int(FILE *file);
-char *read_vint_block_string(FILE *file);
-void read_vint_block_skip(FILE *file);
-
-void parse_ebml(FILE *file);
-void parse_segment_info(FILE *file);
+void skip_bytes(struct matroska_reader *file, ULLONG n);
+void set_bytes(struct matroska_reader *file, ULLONG n);
+ULLONG get_current_byte(struct matroska_reader *file);
+UBYTE *borrow_byte_block(struct matroska_reader *file, ULLONG n);
+UBYTE *read_byte_block(struct matroska_reader *file, ULLONG n);
+char *read_bytes_signed(struct matroska_reader *file, ULLONG n);
+UBYTE mkv_read_byte(struct matroska_reader *file);
+
+ULLONG read_vint_length(struct matroska_reader *file);
+UBYTE *read_vint_block(struct matroska_reader *file);
+char *read_vint_block_signed(struct matroska_reader *file);
+ULLONG read_vint_block_int(struct matroska_reader *file);
+char *read_vint_block_string(struct matroska_reader *file);
+void read_vint_block_skip(struct matroska_reader *file);
+
+void parse_ebml(struct matroska_reader *file);
+void parse_segment_info(struct matroska_reader *file);
 struct matroska_sub_sentence *parse_segment_cluster_block_group_block(struct matroska_ctx *mkv_ctx, ULLONG cluster_timecode);
 void parse_segment_cluster_block_group(struct matroska_ctx *mkv_ctx, ULLONG cluster_timecode);
 void parse_segment_cluster(struct matroska_ctx *mkv_ctx);
@@ -284,6 +337,8 @@ int process_mpeg2_frame_mkv(struct matroska_ctx *mkv_ctx, struct matroska_avc_fr
 void parse_segment_track_entry(struct matroska_ctx *mkv_ctx);
 void parse_private_codec_data(struct matroska_ctx *mkv_ctx, char *codec_id_string, ULLONG track_number, char *lang);
 void parse_segment_tracks(struct matroska_ctx *mkv_ctx);
+void parse_segment_seek_head(struct matroska_ctx *mkv_ctx);
+void parse_segment_cues(struct matroska_ctx *mkv_ctx);
 void parse_segment(struct matroska_ctx *mkv_ctx);
 
 /* Writing and helper functions */
@@ -294,11 +349,16 @@ char *get_track_entry_type_description(enum matroska_track_entry_type type);
 enum matroska_track_subtitle_codec_id get_track_subtitle_codec_id(char *codec_id);
 char *generate_filename_from_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track);
 char *ass_ssa_sentence_erase_read_order(char *text);
-void save_sub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track);
+void open_sub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track);
+void write_sub_sentence(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track,
+			struct matroska_sub_sentence *sentence, struct matroska_sub_sentence *next);
+void add_sub_sentence(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track, struct matroska_sub_sentence *sentence);
+void close_sub_track(struct matroska_ctx *mkv_ctx, struct matroska_sub_track *track);
 void free_sub_track(struct matroska_sub_track *track);
-void matroska_save_all(struct matroska_ctx *mkv_ctx, char *lang);
+void matroska_save_all(struct matroska_ctx *mkv_ctx);
 void matroska_free_all(struct matroska_ctx *mkv_ctx);
 void matroska_parse(struct matroska_ctx *mkv_ctx);
-FILE *create_file(struct lib_ccx_ctx *ctx);
+struct matroska_reader *create_file(struct lib_ccx_ctx *ctx);
+void close_file(struct matroska_reader *file);
 
 #endif // MATROSKA_H
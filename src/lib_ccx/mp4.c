@@ -200,6 +200,46 @@ static int process_hevc_sample(struct lib_ccx_ctx *ctx, u32 timescale, GF_HEVCCo
 
 	return status;
 }
+static int is_sync_sample(GF_ISOFile *f, u32 track, u32 sample_number)
+{
+	u32 sdi;
+	GF_ISOSample *s = gf_isom_get_sample_info(f, track, sample_number, &sdi, NULL);
+	int sync = s != NULL && s->IsRAP;
+	gf_isom_sample_del(&s);
+	return sync;
+}
+
+/* --startat: once sample i (counting from 0) has set the time reference, the
+ * index of the sample to go on with, found in the sample table: the last sync
+ * sample CCX_EXTRACTION_MARGIN_MS or more before the start time. i + 1 when
+ * there is nothing worth skipping. */
+static u32 extraction_start_sample(GF_ISOFile *f, u32 track, u32 timescale, u32 i, u32 sample_count, struct lib_cc_decode *dec_ctx)
+{
+	LLONG skip_ms = dec_ctx->extraction_start.time_in_ms - CCX_EXTRACTION_MARGIN_MS -
+			get_fts(dec_ctx->timing, dec_ctx->current_field);
+	if (skip_ms < CCX_EXTRACTION_MARGIN_MS)
+		return i + 1;
+
+	// Samples are numbered from 1, in decoding order
+	u64 target = gf_isom_get_sample_dts(f, track, i + 1) + (u64)skip_ms * timescale / 1000;
+	u32 lo = i + 1, hi = sample_count;
+	while (lo < hi)
+	{
+		u32 mid = lo + (hi - lo + 1) / 2;
+		if (gf_isom_get_sample_dts(f, track, mid) <= target)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	while (lo > i + 1 && !is_sync_sample(f, track, lo))
+		lo--;
+	if (lo <= i + 1)
+		return i + 1;
+
+	mprint("\rSkipping to sample %u of %u for --startat\n", lo, sample_count);
+	return lo - 1;
+}
+
 static int process_xdvb_track(struct lib_ccx_ctx *ctx, const char *basename, GF_ISOFile *f, u32 track, struct cc_subtitle *sub)
 {
 	u32 timescale, i, sample_count;
@@ -229,6 +269,9 @@ static int process_xdvb_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 	for (i = 0; i < sample_count; i++)
 	{
 		u32 sdi;
+#ifdef WITH_LIBCURL
+		curl_sink_poll();
+#endif
 
 		GF_ISOSample *s = gf_isom_get_sample(f, track, i + 1, &sdi);
 		if (s != NULL)
@@ -276,12 +319,16 @@ static int process_avc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_I
 	}
 
 	timescale = gf_isom_get_media_timescale(f, track);
+	int seek_pending = dec_ctx->extraction_start.set && can_seek_input(ctx);
 
 	status = 0;
 
 	for (i = 0; i < sample_count; i++)
 	{
 		u32 sdi;
+#ifdef WITH_LIBCURL
+		curl_sink_poll();
+#endif
 
 		GF_ISOSample *s = gf_isom_get_sample(f, track, i + 1, &sdi);
 
@@ -315,6 +362,14 @@ static int process_avc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_I
 			}
 		}
 
+		if (seek_pending && dec_ctx->timing->pts_set == 2)
+		{
+			seek_pending = 0;
+			i = extraction_start_sample(f, track, timescale, i, sample_count, dec_ctx) - 1;
+		}
+		if (is_past_extraction_end(dec_ctx))
+			break;
+
 		int progress = (int)((i * 100) / sample_count);
 		if (ctx->last_reported_progress != progress)
 		{
@@ -359,12 +414,16 @@ static int process_hevc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 	}
 
 	timescale = gf_isom_get_media_timescale(f, track);
+	int seek_pending = dec_ctx->extraction_start.set && can_seek_input(ctx);
 
 	status = 0;
 
 	for (i = 0; i < sample_count; i++)
 	{
 		u32 sdi;
+#ifdef WITH_LIBCURL
+		curl_sink_poll();
+#endif
 
 		GF_ISOSample *s = gf_isom_get_sample(f, track, i + 1, &sdi);
 
@@ -398,6 +457,14 @@ static int process_hevc_track(struct lib_ccx_ctx *ctx, const char *basename, GF_
 			}
 		}
 
+		if (seek_pending && dec_ctx->timing->pts_set == 2)
+		{
+			seek_pending = 0;
+			i = extraction_start_sample(f, track, timescale, i, sample_count, dec_ctx) - 1;
+		}
+		if (is_past_extraction_end(dec_ctx))
+			break;
+
 		int progress = (int)((i * 100) / sample_count);
 		if (ctx->last_reported_progress != progress)
 		{
@@ -475,6 +542,9 @@ static int process_vobsub_track(struct lib_ccx_ctx *ctx, GF_ISOFile *f, u32 trac
 	for (i = 0; i < sample_count; i++)
 	{
 		u32 sdi;
+#ifdef WITH_LIBCURL
+		curl_sink_poll();
+#endif
 		GF_ISOSample *s = gf_isom_get_sample(f, track, i + 1, &sdi);
 
 		if (s != NULL)
@@ -512,27 +582,14 @@ static int process_vobsub_track(struct lib_ccx_ctx *ctx, GF_ISOFile *f, u32 trac
 
 			if (ret == 0 && vob_sub.got_output)
 			{
-				/* Encode the subtitle to output format */
-				encode_sub(enc_ctx, &vob_sub);
+				encode_vobsub(enc_ctx, &vob_sub);
+				sub->got_output = 1;
+			}
+			/* With --ocr-threads, subtitles come back here once OCR'd */
+			while (vobsub_next_output(vob_ctx, &vob_sub, 0))
+			{
+				encode_vobsub(enc_ctx, &vob_sub);
 				sub->got_output = 1;
-
-				/* Free subtitle data */
-				if (vob_sub.data)
-				{
-					struct cc_bitmap *rect = (struct cc_bitmap *)vob_sub.data;
-					for (int j = 0; j < vob_sub.nb_data; j++)
-					{
-						if (rect[j].data0)
-							free(rect[j].data0);
-						if (rect[j].data1)
-							free(rect[j].data1);
-#ifdef ENABLE_OCR
-						if (rect[j].ocr_text)
-							free(rect[j].ocr_text);
-#endif
-					}
-					free(vob_sub.data);
-				}
 			}
 
 			gf_isom_sample_del(&s);
@@ -547,6 +604,13 @@ static int process_vobsub_track(struct lib_ccx_ctx *ctx, GF_ISOFile *f, u32 trac
 		}
 	}
 
+	struct cc_subtitle vob_sub;
+	while (vobsub_next_output(vob_ctx, &vob_sub, 1))
+	{
+		encode_vobsub(enc_ctx, &vob_sub);
+		sub->got_output = 1;
+	}
+
 	int cur_sec = (int)(get_fts(dec_ctx->timing, dec_ctx->current_field) / 1000);
 	activity_progress(100, cur_sec / 60, cur_sec % 60);
 
@@ -1091,6 +1155,7 @@ int processmp4(struct lib_ccx_ctx *ctx, struct ccx_s_mp4Cfg *cfg, char *file)
 					switch_output_file(ctx, enc_ctx, i);
 				}
 				unsigned num_samples = gf_isom_get_sample_count(f, i + 1);
+				int seek_pending = dec_ctx->extraction_start.set && can_seek_input(ctx);
 
 				u32 ProcessingStreamDescriptionIndex = 0; // Current track we are processing, 0 = we don't know yet
 				u32 timescale = gf_isom_get_media_timescale(f, i + 1);
@@ -1105,6 +1170,9 @@ int processmp4(struct lib_ccx_ctx *ctx, struct ccx_s_mp4Cfg *cfg, char *file)
 				for (unsigned k = 0; k < num_samples; k++)
 				{
 					u32 StreamDescriptionIndex;
+#ifdef WITH_LIBCURL
+					curl_sink_poll();
+#endif
 					GF_ISOSample *sample = gf_isom_get_sample(f, i + 1, k + 1, &StreamDescriptionIndex);
 					if (ProcessingStreamDescriptionIndex && ProcessingStreamDescriptionIndex != StreamDescriptionIndex)
 					{
@@ -1177,6 +1245,14 @@ int processmp4(struct lib_ccx_ctx *ctx, struct ccx_s_mp4Cfg *cfg, char *file)
 					free(sample->data);
 					free(sample);
 
+					if (seek_pending && dec_ctx->timing->pts_set == 2)
+					{
+						seek_pending = 0;
+						k = extraction_start_sample(f, i + 1, timescale, k, num_samples, dec_ctx) - 1;
+					}
+					if (is_past_extraction_end(dec_ctx))
+						break;
+
 					// End of change
 					int progress = (int)((k * 100) / num_samples);
 					if (ctx->last_reported_progress != progress)
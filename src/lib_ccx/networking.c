@@ -7,6 +7,9 @@
 #include <string.h>
 #include <errno.h>
 #include <assert.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 #ifdef NETWORKING_DEBUG
 #define DEBUG_OUT 1
@@ -651,6 +654,348 @@ int start_tcp_srv(const char *port, const char *pwd)
 	return sockfd;
 }
 
+/*
+ * --tcp-senders: one server for several --sendto senders at once. The
+ * sockets are non-blocking and waited on together (epoll on Linux, select()
+ * elsewhere); the blocks each sender sends are split out of its own input
+ * buffer and handed to the caller, so one slow or dead sender never holds up
+ * the others.
+ */
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // A sender gone away must not kill the server with SIGPIPE
+#endif
+#define SENDER_READ_SIZE 65536	    // Read per sender per wakeup, so they take turns
+#define SENDER_MAX_BLOCK (1 << 20) // Larger blocks are taken for a broken sender
+
+static int senders_listen_sd = -1;
+static const char *senders_pwd;
+static struct net_sender **senders;
+static int nb_senders;
+static int max_senders;
+static unsigned senders_connected; // Ever, gives the ids
+#ifdef __linux__
+static int senders_epoll = -1;
+#endif
+
+static void close_socket(int fd)
+{
+#if _WIN32
+	closesocket(fd);
+#else
+	close(fd);
+#endif
+}
+
+static int socket_would_block(void)
+{
+#if _WIN32
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+	return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+int start_tcp_senders_srv(const char *port, const char *pwd, int max)
+{
+	int fam;
+
+	if (NULL == port)
+		port = DFT_PORT;
+
+	mprint("\n\r----------------------------------------------------------------------\n");
+	mprint("Binding to %s\n", port);
+	senders_listen_sd = tcp_bind(port, &fam);
+	if (senders_listen_sd < 0 || set_nonblocking(senders_listen_sd) < 0)
+		fatal(EXIT_FAILURE, "Unable to start server\n");
+
+	senders = calloc(max, sizeof(struct net_sender *));
+	if (!senders)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In start_tcp_senders_srv: Out of memory allocating senders.");
+	max_senders = max;
+	senders_pwd = pwd;
+
+#ifdef __linux__
+	struct epoll_event ev = {0};
+	senders_epoll = epoll_create1(0);
+	ev.events = EPOLLIN;
+	ev.data.ptr = NULL; // The listening socket
+	if (senders_epoll < 0 || epoll_ctl(senders_epoll, EPOLL_CTL_ADD, senders_listen_sd, &ev) < 0)
+		fatal(EXIT_FAILURE, "In start_tcp_senders_srv: epoll error: %s\n", strerror(errno));
+#endif
+
+	if (pwd != NULL)
+		mprint("Password: %s\n", pwd);
+	mprint("Waiting for up to %d senders\n", max);
+
+	return senders_listen_sd;
+}
+
+static void accept_senders(void)
+{
+	while (1)
+	{
+		struct sockaddr_storage cliaddr;
+		socklen_t clilen = sizeof(cliaddr);
+		char host[NI_MAXHOST];
+		char serv[NI_MAXSERV];
+		struct net_sender *sender;
+		int fd = accept(senders_listen_sd, (struct sockaddr *)&cliaddr, &clilen);
+
+		if (fd < 0)
+			return; // Nobody else waiting, or a connection that went away already
+
+		if (nb_senders == max_senders)
+		{
+			mprint("Too many senders, refusing a new connection\n");
+			char c = CONN_LIMIT;
+			send(fd, &c, 1, MSG_NOSIGNAL);
+			close_socket(fd);
+			continue;
+		}
+		if (set_nonblocking(fd) < 0)
+		{
+			close_socket(fd);
+			continue;
+		}
+#ifdef SO_NOSIGPIPE
+		int one = 1;
+		setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+		sender = calloc(1, sizeof(struct net_sender));
+		if (!sender)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In accept_senders: Out of memory allocating sender.");
+		sender->fd = fd;
+		sender->id = ++senders_connected;
+		if (getnameinfo((struct sockaddr *)&cliaddr, clilen, host, sizeof(host), serv, sizeof(serv),
+				NI_NUMERICHOST | NI_NUMERICSERV) == 0)
+			snprintf(sender->addr, sizeof(sender->addr), "%s:%s", host, serv);
+		else
+			snprintf(sender->addr, sizeof(sender->addr), "?");
+
+#ifdef __linux__
+		struct epoll_event ev = {0};
+		ev.events = EPOLLIN;
+		ev.data.ptr = sender;
+		if (epoll_ctl(senders_epoll, EPOLL_CTL_ADD, fd, &ev) < 0)
+		{
+			mprint("epoll error: %s\n", strerror(errno));
+			close_socket(fd);
+			free(sender);
+			continue;
+		}
+#endif
+		senders[nb_senders++] = sender;
+		mprint("Sender %u connected from %s\n", sender->id, sender->addr);
+	}
+}
+
+/* Disconnect sender at the end of the current net_senders_poll(). */
+void net_sender_close(struct net_sender *sender)
+{
+	sender->closing = 1;
+}
+
+static void free_sender(int i, net_sender_close_fn on_close, void *opaque)
+{
+	struct net_sender *sender = senders[i];
+
+	mprint("Sender %u (%s) disconnected\n", sender->id, sender->desc ? sender->desc : sender->addr);
+	if (on_close)
+		on_close(opaque, sender);
+	close_socket(sender->fd); // Also takes it out of the epoll set
+	free(sender->in);
+	free(sender->desc);
+	free(sender);
+	senders[i] = senders[--nb_senders];
+}
+
+/* Handle the complete blocks in sender->in. Returns -1 if the sender is to
+   be disconnected. */
+static int parse_sender_blocks(struct net_sender *sender, net_sender_block_fn on_block, void *opaque)
+{
+	size_t pos = 0;
+	int ret = 0;
+
+	while (ret == 0 && sender->in_used - pos >= 1 + INT_LEN)
+	{
+		const unsigned char *block = sender->in + pos;
+		char len_str[INT_LEN + 1] = {0};
+		char *end;
+		size_t len;
+
+		memcpy(len_str, block + 1, INT_LEN);
+		len = strtoul(len_str, &end, 10);
+		if (end == len_str || len > SENDER_MAX_BLOCK)
+		{
+			mprint("Sender %u: malformed block\n", sender->id);
+			return -1;
+		}
+		if (sender->in_used - pos < 1 + INT_LEN + len + 2)
+			break;
+		if (block[1 + INT_LEN + len] != '\r' || block[1 + INT_LEN + len + 1] != '\n')
+		{
+			mprint("Sender %u: no end marker in block\n", sender->id);
+			return -1;
+		}
+		pos += 1 + INT_LEN + len + 2;
+
+		const unsigned char *data = block + 1 + INT_LEN;
+		if (!sender->logged_in)
+		{
+			// Like check_password(), the first block is taken for the password
+			if (senders_pwd != NULL &&
+			    (block[0] != PASSWORD || len != strlen(senders_pwd) || memcmp(data, senders_pwd, len)))
+			{
+				mprint("Sender %u: wrong password\n", sender->id);
+				char c = PASSWORD;
+				send(sender->fd, &c, 1, MSG_NOSIGNAL);
+				return -1;
+			}
+			sender->logged_in = 1;
+			continue;
+		}
+		switch (block[0])
+		{
+			case CC_DESC:
+				free(sender->desc);
+				sender->desc = malloc(len + 1);
+				if (!sender->desc)
+					fatal(EXIT_NOT_ENOUGH_MEMORY, "In parse_sender_blocks: Out of memory.");
+				memcpy(sender->desc, data, len);
+				sender->desc[len] = '\0';
+				if (len)
+					mprint("Sender %u is %s\n", sender->id, sender->desc);
+				else
+					freep(&sender->desc);
+				break;
+			case BIN_HEADER:
+			case BIN_DATA:
+				ret = on_block(opaque, sender, block[0] == BIN_HEADER, data, len);
+				break;
+			default: // PING and EPG_DATA
+				break;
+		}
+	}
+
+	memmove(sender->in, sender->in + pos, sender->in_used - pos);
+	sender->in_used -= pos;
+	return ret;
+}
+
+/* Read what sender has sent. Returns -1 when it is to be disconnected. */
+static int read_sender(struct net_sender *sender, net_sender_block_fn on_block, void *opaque)
+{
+	if (sender->in_size - sender->in_used < SENDER_READ_SIZE)
+	{
+		size_t size = sender->in_used + SENDER_READ_SIZE;
+		unsigned char *in = realloc(sender->in, size);
+		if (!in)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In read_sender: Out of memory.");
+		sender->in = in;
+		sender->in_size = size;
+	}
+
+	int n = recv(sender->fd, (char *)sender->in + sender->in_used, SENDER_READ_SIZE, 0);
+	if (n < 0 && socket_would_block())
+		return 0;
+	if (n <= 0)
+		return -1;
+	sender->in_used += n;
+	return parse_sender_blocks(sender, on_block, opaque);
+}
+
+/* Keep the senders from reconnecting, see net_check_conn() */
+static void ping_senders(void)
+{
+	static time_t last_ping = 0;
+	time_t now = time(NULL);
+	char c = PING;
+
+	if (now - last_ping < PING_INTERVAL)
+		return;
+	last_ping = now;
+	for (int i = 0; i < nb_senders; i++)
+	{
+		if (senders[i]->logged_in)
+			send(senders[i]->fd, &c, 1, MSG_NOSIGNAL);
+	}
+}
+
+/*
+ * Wait up to timeout_ms for senders to connect or send something, and hand
+ * the BIN_HEADER and BIN_DATA blocks received to on_block. Returns -1 on
+ * an error other than a signal.
+ */
+int net_senders_poll(int timeout_ms, net_sender_block_fn on_block, net_sender_close_fn on_close, void *opaque)
+{
+	ping_senders();
+
+#ifdef __linux__
+	struct epoll_event events[64];
+	int n = epoll_wait(senders_epoll, events, 64, timeout_ms);
+	if (n < 0)
+		return errno == EINTR ? 0 : -1;
+	for (int i = 0; i < n; i++)
+	{
+		struct net_sender *sender = events[i].data.ptr;
+		if (sender == NULL)
+			accept_senders();
+		else if (!sender->closing && read_sender(sender, on_block, opaque) < 0)
+			sender->closing = 1;
+	}
+#else
+	fd_set fds;
+	int maxfd = senders_listen_sd;
+	struct timeval tv;
+
+	FD_ZERO(&fds);
+	FD_SET(senders_listen_sd, &fds);
+	for (int i = 0; i < nb_senders; i++)
+	{
+		FD_SET(senders[i]->fd, &fds);
+		if (senders[i]->fd > maxfd)
+			maxfd = senders[i]->fd;
+	}
+	tv.tv_sec = timeout_ms / 1000;
+	tv.tv_usec = (timeout_ms % 1000) * 1000;
+	int n = select(maxfd + 1, &fds, NULL, NULL, &tv);
+	if (n < 0)
+		return errno == EINTR ? 0 : -1;
+	for (int i = 0; i < nb_senders; i++)
+	{
+		struct net_sender *sender = senders[i];
+		if (FD_ISSET(sender->fd, &fds) && !sender->closing && read_sender(sender, on_block, opaque) < 0)
+			sender->closing = 1;
+	}
+	if (FD_ISSET(senders_listen_sd, &fds))
+		accept_senders();
+#endif
+
+	for (int i = nb_senders - 1; i >= 0; i--)
+	{
+		if (senders[i]->closing)
+			free_sender(i, on_close, opaque);
+	}
+	return 0;
+}
+
+/* Disconnect every sender and stop listening. */
+void net_senders_close_all(net_sender_close_fn on_close, void *opaque)
+{
+	while (nb_senders)
+		free_sender(nb_senders - 1, on_close, opaque);
+	freep(&senders);
+#ifdef __linux__
+	if (senders_epoll >= 0)
+		close(senders_epoll);
+	senders_epoll = -1;
+#endif
+	if (senders_listen_sd >= 0)
+		close_socket(senders_listen_sd);
+	senders_listen_sd = -1;
+}
+
 int check_password(int fd, const char *pwd)
 {
 	char c;
@@ -25,4 +25,30 @@ int start_tcp_srv(const char *port, const char *pwd);
 
 int start_upd_srv(const char *src, const char *addr, unsigned port);
 
+/* A --sendto sender connected to a --tcp-senders server */
+struct net_sender
+{
+	int fd;
+	unsigned id;	// 1, 2, ... in the order they connected
+	char addr[64];	// host:port
+	char *desc;	// Sent with --tcp-description, NULL if none
+	int logged_in;	// Password checked
+	int closing;	// Closed at the end of the current net_senders_poll()
+	unsigned char *in; // Received bytes not yet split into blocks
+	size_t in_used;
+	size_t in_size;
+	void *data; // For the caller of net_senders_poll()
+};
+
+/* Called with every BIN_HEADER (header = 1) or BIN_DATA block. Returns -1 to
+   disconnect the sender. */
+typedef int (*net_sender_block_fn)(void *opaque, struct net_sender *sender, int header, const unsigned char *data, size_t len);
+/* Called once a sender is gone, before it is freed */
+typedef void (*net_sender_close_fn)(void *opaque, struct net_sender *sender);
+
+int start_tcp_senders_srv(const char *port, const char *pwd, int max_senders);
+int net_senders_poll(int timeout_ms, net_sender_block_fn on_block, net_sender_close_fn on_close, void *opaque);
+void net_sender_close(struct net_sender *sender);
+void net_senders_close_all(net_sender_close_fn on_close, void *opaque);
+
 #endif /* end of include guard: NETWORKING_H */
@@ -8,6 +8,7 @@
 #include <dirent.h>
 #include "ccx_encoders_helpers.h"
 #include "ccx_encoders_spupng.h"
+#include "sha2.h"
 #ifdef _WIN32
 #include <windows.h>
 #elif defined(__APPLE__)
@@ -18,6 +19,7 @@
 struct ocrCtx
 {
 	TessBaseAPI *api;
+	const char *lang; // Tesseract language loaded, part of the OCR cache key
 };
 
 struct transIntensity
@@ -205,6 +207,79 @@ char *probe_tessdata_location(const char *lang)
 	return NULL;
 }
 
+/**
+ * Load the OCR results saved by --ocr-cache, once the Tesseract settings
+ * they depend on are known. Results from other settings are not reused.
+ */
+static void ocr_cache_open(void)
+{
+	static int opened = 0;
+	char settings[256];
+	int loaded;
+
+	if (opened || !ccx_options.ocr_cache_file)
+		return;
+	opened = 1;
+
+	snprintf(settings, sizeof(settings), "tesseract %s oem %d psm %d line-split %d blacklist %d fontcolor %d",
+		 TessVersion(), ccx_options.ocr_oem, ccx_options.psm, ccx_options.ocr_line_split,
+		 ccx_options.ocr_blacklist, !tlt_config.nofontcolor && !ccx_options.nofontcolor);
+	loaded = ccxr_ocr_cache_load(ccx_options.ocr_cache_file, settings);
+	if (loaded < 0)
+		mprint("Could not read OCR cache %s, starting with an empty one\n", ccx_options.ocr_cache_file);
+	else if (loaded > 0)
+		mprint("Loaded %d OCR results from %s\n", loaded, ccx_options.ocr_cache_file);
+}
+
+static void put_le32(uint8_t *buf, uint32_t value)
+{
+	buf[0] = value;
+	buf[1] = value >> 8;
+	buf[2] = value >> 16;
+	buf[3] = value >> 24;
+}
+
+/**
+ * Key of a bitmap in the OCR cache: a digest of everything the recognized
+ * text depends on besides the run-wide Tesseract settings. Integers are
+ * hashed little-endian so saved caches stay valid across machines.
+ */
+static void ocr_cache_key(struct ocrCtx *ctx, struct cc_bitmap *rect, int bgcolor, int ocr_quantmode,
+			  uint8_t key[SHA256_DIGEST_LENGTH])
+{
+	SHA256_CTX sha;
+	uint8_t buf[4];
+	uint32_t *clut = (uint32_t *)rect->data1;
+	int32_t fields[] = {rect->w, rect->h, rect->nb_colors, bgcolor, ocr_quantmode};
+
+	CC_SHA256_Init(&sha);
+	CC_SHA256_Update(&sha, (const uint8_t *)ctx->lang, strlen(ctx->lang) + 1);
+	for (int i = 0; i < sizeof(fields) / sizeof(fields[0]); i++)
+	{
+		put_le32(buf, fields[i]);
+		CC_SHA256_Update(&sha, buf, 4);
+	}
+	for (int i = 0; i < rect->nb_colors; i++)
+	{
+		put_le32(buf, clut[i]);
+		CC_SHA256_Update(&sha, buf, 4);
+	}
+	CC_SHA256_Update(&sha, rect->data0, (size_t)rect->w * rect->h);
+	CC_SHA256_Final(key, &sha);
+}
+
+void ocr_cache_report(void)
+{
+	unsigned long long hits, misses;
+	unsigned int entries;
+
+	ccxr_ocr_cache_stats(&hits, &misses, &entries);
+	if (hits + misses)
+		mprint("OCR cache: %llu hits, %llu misses, %u distinct bitmaps\n", hits, misses, entries);
+	if (ccx_options.ocr_cache_file && ccxr_ocr_cache_save() < 0)
+		mprint("Could not write OCR cache %s\n", ccx_options.ocr_cache_file);
+}
+
 void *init_ocr(int lang_index)
 {
 	int ret = -1;
@@ -296,6 +371,8 @@ void *init_ocr(int lang_index)
 		mprint("Failed TessBaseAPIInit4 %d\n", ret);
 		goto fail;
 	}
+	ctx->lang = lang;
+	ocr_cache_open();
 	return ctx;
 fail:
 	delete_ocr((void **)&ctx);
@@ -1048,9 +1125,9 @@ char *ocr_bitmap(void *arg, png_color *palette, png_byte *alpha, unsigned char *
 
 				if (fabsf(h - h0) > 50) // Color has changed
 				{
-					// Write <font> tags for SRT and WebVTT
-					if (ccx_options.write_format == CCX_OF_SRT ||
-					    ccx_options.write_format == CCX_OF_WEBVTT)
+					// Write <font> tags for SRT and WebVTT, encode_sub() drops them for the other formats
+					if (encoder_cfg_has_format(&ccx_options.enc_cfg, CCX_OF_SRT) ||
+					    encoder_cfg_has_format(&ccx_options.enc_cfg, CCX_OF_WEBVTT))
 					{
 						const char *substr_format;
 						int substr_len;
@@ -1112,8 +1189,8 @@ char *ocr_bitmap(void *arg, png_color *palette, png_byte *alpha, unsigned char *
 			} while (TessPageIteratorNext((TessPageIterator *)ri, level));
 
 			// Write missing <font> or </font> for each line
-			if (ccx_options.write_format == CCX_OF_SRT ||
-			    ccx_options.write_format == CCX_OF_WEBVTT)
+			if (encoder_cfg_has_format(&ccx_options.enc_cfg, CCX_OF_SRT) ||
+			    encoder_cfg_has_format(&ccx_options.enc_cfg, CCX_OF_WEBVTT))
 			{
 				const char *closing_font = "</font>";
 				int length_closing_font = 7; // exclude '\0'
@@ -1432,6 +1509,8 @@ end:
 int ocr_rect(void *arg, struct cc_bitmap *rect, char **str, int bgcolor, int ocr_quantmode)
 {
 	int ret = 0;
+	int cached = 0;
+	uint8_t key[SHA256_DIGEST_LENGTH];
 	png_color *palette = NULL;
 	png_byte *alpha = NULL;
 
@@ -1493,6 +1572,10 @@ int ocr_rect(void *arg, struct cc_bitmap *rect, char **str, int bgcolor, int ocr
 		goto end;
 	}
 
+	// Identical bitmaps come again with every page refresh, reuse their text
+	ocr_cache_key(arg, rect, bgcolor, ocr_quantmode, key);
+	cached = ccxr_ocr_cache_lookup(key, str);
+
 	copy->data = (unsigned char *)malloc(sizeof(unsigned char) * size);
 	if (!copy->data)
 	{
@@ -1531,7 +1614,12 @@ int ocr_rect(void *arg, struct cc_bitmap *rect, char **str, int bgcolor, int ocr
 			break;
 	}
 
-	*str = ocr_bitmap(arg, palette, alpha, rect->data0, rect->w, rect->h, copy);
+	// Quantized even on a cache hit, rect->data0 is also written out as an image
+	if (!cached)
+	{
+		*str = ocr_bitmap(arg, palette, alpha, rect->data0, rect->w, rect->h, copy);
+		ccxr_ocr_cache_store(key, *str);
+	}
 
 end:
 	freep(&palette);
@@ -1655,6 +1743,114 @@ char *paraof_ocrtext(struct cc_subtitle *sub, struct encoder_ctx *context)
 	}
 	return str;
 }
+
+/**
+ * Whole subtitles waiting for OCR on the worker threads (--ocr-threads).
+ * Each worker has its own Tesseract instance, and subtitles come back from
+ * ocr_queue_next() in the order they were submitted.
+ */
+struct ocr_queue
+{
+	struct ccxr_worker_pool *pool;
+	void **workers; // One struct ocrCtx per worker thread
+	unsigned int nb_workers;
+	unsigned int limit; // Subtitles in flight before ocr_queue_full() says so
+};
+
+struct ocr_job
+{
+	struct cc_subtitle sub; // First, so a job can be handed back as its subtitle
+	int bgcolor;
+	int ocr_quantmode;
+};
+
+static void ocr_queue_run(void *state, void *arg)
+{
+	struct ocr_job *job = arg;
+	struct cc_bitmap *rect = job->sub.data;
+
+	for (int i = 0; i < job->sub.nb_data; i++, rect++)
+	{
+		char *ocr_str = NULL;
+		int ret = ocr_rect(state, rect, &ocr_str, job->bgcolor, job->ocr_quantmode);
+		if (ret >= 0 && ocr_str)
+			rect->ocr_text = ocr_str;
+	}
+}
+
+struct ocr_queue *init_ocr_queue(int lang_index, int nb_workers)
+{
+	struct ocr_queue *queue;
+
+	if (nb_workers < 2)
+		return NULL;
+
+	queue = (struct ocr_queue *)malloc(sizeof(struct ocr_queue));
+	if (!queue)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In init_ocr_queue: Out of memory allocating queue.");
+	queue->workers = (void **)calloc(nb_workers, sizeof(void *));
+	if (!queue->workers)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In init_ocr_queue: Out of memory allocating workers.");
+	queue->nb_workers = nb_workers;
+	queue->limit = 2 * nb_workers;
+	queue->pool = NULL;
+
+	for (int i = 0; i < nb_workers; i++)
+	{
+		queue->workers[i] = init_ocr(lang_index);
+		if (!queue->workers[i])
+		{
+			mprint("Could not start %d OCR threads, running OCR on the decoding thread\n", nb_workers);
+			delete_ocr_queue(&queue);
+			return NULL;
+		}
+	}
+
+	queue->pool = ccxr_worker_pool_new(queue->workers, nb_workers);
+	return queue;
+}
+
+void ocr_queue_submit(struct ocr_queue *queue, struct cc_subtitle *sub, int bgcolor, int ocr_quantmode)
+{
+	struct ocr_job *job = (struct ocr_job *)malloc(sizeof(struct ocr_job));
+	if (!job)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In ocr_queue_submit: Out of memory allocating job.");
+
+	job->sub = *sub;
+	job->bgcolor = bgcolor;
+	job->ocr_quantmode = ocr_quantmode;
+	sub->data = NULL;
+	sub->nb_data = 0;
+	ccxr_worker_pool_submit(queue->pool, ocr_queue_run, job);
+}
+
+int ocr_queue_full(struct ocr_queue *queue)
+{
+	return ccxr_worker_pool_pending(queue->pool) >= queue->limit;
+}
+
+struct cc_subtitle *ocr_queue_next(struct ocr_queue *queue, int wait)
+{
+	struct ocr_job *job = ccxr_worker_pool_next(queue->pool, wait);
+	return job ? &job->sub : NULL;
+}
+
+void delete_ocr_queue(struct ocr_queue **arg)
+{
+	struct ocr_queue *queue = *arg;
+
+	if (!queue)
+		return;
+	// Stop the threads before their Tesseract instances go away
+	ccxr_worker_pool_free(queue->pool);
+	for (int i = 0; i < queue->nb_workers; i++)
+	{
+		if (queue->workers[i])
+			delete_ocr(&queue->workers[i]);
+	}
+	free(queue->workers);
+	freep(arg);
+}
 #else
 
 struct image_copy;
@@ -1664,4 +1860,8 @@ char *ocr_bitmap(png_color *palette, png_byte *alpha, unsigned char *indata, uns
 	mprint("ocr not supported without tesseract\n");
 	return NULL;
 }
+
+void ocr_cache_report(void)
+{
+}
 #endif
@@ -18,5 +18,19 @@ void *init_ocr(int lang_index);
 char *ocr_bitmap(void *arg, png_color *palette, png_byte *alpha, unsigned char *indata, int w, int h, struct image_copy *copy);
 int ocr_rect(void *arg, struct cc_bitmap *rect, char **str, int bgcolor, int ocr_quantmode);
 char *paraof_ocrtext(struct cc_subtitle *sub, struct encoder_ctx *context);
+// Print the OCR cache hit rate and save it to --ocr-cache, at exit
+void ocr_cache_report(void);
+
+// OCR of whole subtitles on worker threads, see --ocr-threads.
+// init_ocr_queue() returns NULL when fewer than 2 workers are asked for.
+// ocr_queue_submit() takes over the bitmaps of sub and clears it; subtitles
+// come back from ocr_queue_next() in submission order, with their ocr_text
+// filled in, and must be released with free() once their data is freed.
+struct ocr_queue;
+struct ocr_queue *init_ocr_queue(int lang_index, int nb_workers);
+void ocr_queue_submit(struct ocr_queue *queue, struct cc_subtitle *sub, int bgcolor, int ocr_quantmode);
+int ocr_queue_full(struct ocr_queue *queue);
+struct cc_subtitle *ocr_queue_next(struct ocr_queue *queue, int wait);
+void delete_ocr_queue(struct ocr_queue **queue);
 
 #endif
@@ -1,12 +1,294 @@
 #include "lib_ccx.h"
 #include "ccextractor.h"
 #include "ccx_common_option.h"
+#include "zlib.h"
 #ifdef _WIN32
 #include <io.h>
 #else
 #include <unistd.h>
 #endif
 
+/* Output buffering. Encoders emit lots of tiny fragments (SCC writes
+ * single characters), so every ccx_s_write gets an arena that is only
+ * flushed when full, at the end of each subtitle, and when the handle is
+ * closed. write_wrapped() and buffered_write() take a plain fd, so
+ * the writers owning a buffer are looked up through this table. */
+#define CCX_OUTPUT_BUFFER_SIZE (64 * 1024)
+#define CCX_MAX_BUFFERED_FDS 1024
+
+static struct ccx_s_write *buffered_outputs[CCX_MAX_BUFFERED_FDS];
+static int flush_at_exit_registered = 0;
+static unsigned long long output_write_calls = 0;
+static unsigned long long output_bytes_written = 0;
+
+static ssize_t write_all(int fd, const void *buf, size_t count)
+{
+	const char *p = buf;
+	size_t left = count;
+	while (left)
+	{
+		ssize_t written = write(fd, p, left);
+		output_write_calls++;
+		if (written == -1)
+			return -1;
+		output_bytes_written += written;
+		p += written;
+		left -= written;
+	}
+	return count;
+}
+
+static void flush_all_output_buffers(void)
+{
+	for (int i = 0; i < CCX_MAX_BUFFERED_FDS; i++)
+	{
+		if (buffered_outputs[i] != NULL)
+			flush_output_buffer(buffered_outputs[i]);
+	}
+}
+
+void enable_output_buffer(struct ccx_s_write *wb)
+{
+	if (wb == NULL || wb->fh < 0 || wb->fh >= CCX_MAX_BUFFERED_FDS)
+		return;
+	if (wb->wbuf == NULL)
+	{
+		wb->wbuf = (unsigned char *)malloc(CCX_OUTPUT_BUFFER_SIZE);
+		if (wb->wbuf == NULL)
+			return; // Not fatal, we just keep writing unbuffered
+		wb->wbuf_size = CCX_OUTPUT_BUFFER_SIZE;
+	}
+	wb->wbuf_used = 0;
+	buffered_outputs[wb->fh] = wb;
+	if (!flush_at_exit_registered)
+	{
+		// fatal() and the signal handlers leave through exit()
+		atexit(flush_all_output_buffers);
+		flush_at_exit_registered = 1;
+	}
+}
+
+int flush_output_buffer(struct ccx_s_write *wb)
+{
+	size_t used;
+	if (wb == NULL || wb->wbuf_used == 0)
+		return 0;
+	used = wb->wbuf_used;
+	wb->wbuf_used = 0;
+	if (wb->fh < 0)
+		return -1;
+	return write_all(wb->fh, wb->wbuf, used) == -1 ? -1 : 0;
+}
+
+/* Flush wb's buffer and free it, for writers that are going away. */
+void release_output_buffer(struct ccx_s_write *wb)
+{
+	if (wb == NULL)
+		return;
+	flush_output_buffer(wb);
+	if (wb->fh >= 0 && wb->fh < CCX_MAX_BUFFERED_FDS && buffered_outputs[wb->fh] == wb)
+		buffered_outputs[wb->fh] = NULL;
+	freep(&wb->wbuf);
+	wb->wbuf_size = 0;
+}
+
+/* Indexed RCWT (header byte 6 = RCWT_FORMAT_INDEXED, layout in
+ * ccx_common_constants.c). Records are collected into a data chunk until it
+ * spans RCWT_CHUNK_MS of FTS or RCWT_CHUNK_SIZE bytes, and an index chunk
+ * follows every RCWT_INDEX_EVERY data chunks, so a reader only has to look at
+ * the index chunks to find where a time starts. */
+#define RCWT_CHUNK_MS 5000
+#define RCWT_CHUNK_SIZE (64 * 1024)
+#define RCWT_INDEX_EVERY 64
+
+struct rcwt_chunk_writer
+{
+	int compress;
+	LLONG offset; // File offset of the next chunk
+	unsigned char *data;
+	size_t data_used;
+	size_t data_size;
+	LLONG data_fts; // FTS of the first record in data
+	LLONG index_offset;
+	unsigned char index[RCWT_INDEX_EVERY * 16];
+	int index_used; // Entries
+};
+
+static int rcwt_write_chunk(struct ccx_s_write *wb, const unsigned char *tag, int flags,
+			    const unsigned char *payload, uint32_t size, uint32_t raw_size, LLONG value)
+{
+	unsigned char header[RCWT_CHUNK_HEADER_LEN] = {0};
+
+	memcpy(header, tag, 4);
+	header[4] = flags;
+	memcpy(header + 8, &size, 4);
+	memcpy(header + 12, &raw_size, 4);
+	memcpy(header + 16, &value, 8);
+	if (buffered_write(wb->fh, header, sizeof(header)) < (ssize_t)sizeof(header) ||
+	    (size && buffered_write(wb->fh, payload, size) < (ssize_t)size))
+		return -1;
+	wb->rcwt->offset += sizeof(header) + size;
+	return 0;
+}
+
+static int rcwt_write_index(struct ccx_s_write *wb)
+{
+	struct rcwt_chunk_writer *w = wb->rcwt;
+	LLONG offset = w->offset;
+	uint32_t size = w->index_used * 16;
+
+	if (rcwt_write_chunk(wb, RCWT_CHUNK_INDEX, 0, w->index, size, size, w->index_offset) < 0)
+		return -1;
+	w->index_offset = offset;
+	w->index_used = 0;
+	return 0;
+}
+
+static int rcwt_write_data(struct ccx_s_write *wb)
+{
+	struct rcwt_chunk_writer *w = wb->rcwt;
+	const unsigned char *payload = w->data;
+	unsigned char *packed = NULL;
+	uLongf packed_size;
+	uint32_t size = w->data_used;
+	int flags = 0;
+	int ret;
+
+	if (!w->data_used)
+		return 0;
+	if (w->compress)
+	{
+		packed_size = compressBound(w->data_used);
+		packed = malloc(packed_size);
+		if (!packed)
+			fatal(EXIT_NOT_ENOUGH_MEMORY, "In rcwt_write_data: Out of memory allocating compressed chunk.");
+		if (compress2(packed, &packed_size, w->data, w->data_used, Z_BEST_SPEED) == Z_OK && packed_size < w->data_used)
+		{
+			payload = packed;
+			size = packed_size;
+			flags = RCWT_CHUNK_ZLIB;
+		}
+	}
+
+	memcpy(w->index + 16 * w->index_used, &w->data_fts, 8);
+	memcpy(w->index + 16 * w->index_used + 8, &w->offset, 8);
+	w->index_used++;
+	ret = rcwt_write_chunk(wb, RCWT_CHUNK_DATA, flags, payload, size, w->data_used, w->data_fts);
+	free(packed);
+	w->data_used = 0;
+	if (ret == 0 && w->index_used == RCWT_INDEX_EVERY)
+		ret = rcwt_write_index(wb);
+	return ret;
+}
+
+/* Write what is left and the trailer. The writer is gone afterwards. */
+static void rcwt_finish_chunks(struct ccx_s_write *wb)
+{
+	struct rcwt_chunk_writer *w = wb->rcwt;
+
+	if (!w)
+		return;
+	if (rcwt_write_data(wb) < 0 || (w->index_used && rcwt_write_index(wb) < 0) ||
+	    rcwt_write_chunk(wb, RCWT_CHUNK_TRAILER, 0, NULL, 0, 0, w->index_offset) < 0)
+		mprint("WARNING: Unable to complete the RCWT index\n");
+	free(w->data);
+	freep(&wb->rcwt);
+}
+
+/* Write wb as indexed RCWT from here on. offset is the file position,
+ * i.e. the size of the header already written. */
+void rcwt_start_chunks(struct ccx_s_write *wb, LLONG offset, int compress)
+{
+	struct rcwt_chunk_writer *w = calloc(1, sizeof(struct rcwt_chunk_writer));
+	if (!w || !(w->data = malloc(RCWT_CHUNK_SIZE)))
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In rcwt_start_chunks: Out of memory allocating RCWT chunk.");
+	w->data_size = RCWT_CHUNK_SIZE;
+	w->compress = compress;
+	w->offset = offset;
+	w->index_offset = -1;
+	wb->rcwt = w;
+}
+
+/* Add RCWT records (data header and blocks, as built by writercwtdata()) to
+ * the chunks of wb. Returns len, or -1 on a write error. */
+ssize_t rcwt_write(struct ccx_s_write *wb, const unsigned char *data, size_t len)
+{
+	struct rcwt_chunk_writer *w = wb->rcwt;
+	size_t pos = 0;
+
+	while (pos < len)
+	{
+		LLONG fts;
+		uint16_t cbcount;
+		size_t record = len - pos;
+
+		if (record >= 10)
+		{
+			memcpy(&fts, data + pos, 8);
+			memcpy(&cbcount, data + pos + 8, 2);
+			record = MIN(record, 10 + 3 * (size_t)cbcount);
+			if (w->data_used && (w->data_used + record > RCWT_CHUNK_SIZE || fts - w->data_fts >= RCWT_CHUNK_MS))
+			{
+				if (rcwt_write_data(wb) < 0)
+					return -1;
+			}
+			if (!w->data_used)
+				w->data_fts = fts;
+		}
+		// Records are never split, so a chunk may outgrow RCWT_CHUNK_SIZE
+		if (w->data_used + record > w->data_size)
+		{
+			w->data_size = w->data_used + record;
+			w->data = realloc(w->data, w->data_size);
+			if (!w->data)
+				fatal(EXIT_NOT_ENOUGH_MEMORY, "In rcwt_write: Out of memory allocating RCWT chunk.");
+		}
+		memcpy(w->data + w->data_used, data + pos, record);
+		w->data_used += record;
+		pos += record;
+	}
+	return len;
+}
+
+void close_output(struct ccx_s_write *wb)
+{
+	if (wb->fh < 0)
+		return;
+	rcwt_finish_chunks(wb);
+	flush_output_buffer(wb);
+	if (wb->fh < CCX_MAX_BUFFERED_FDS && buffered_outputs[wb->fh] == wb)
+		buffered_outputs[wb->fh] = NULL;
+	close(wb->fh);
+	wb->fh = -1;
+}
+
+ssize_t buffered_write(int fd, const void *buf, size_t count)
+{
+	struct ccx_s_write *wb = NULL;
+	if (fd >= 0 && fd < CCX_MAX_BUFFERED_FDS)
+		wb = buffered_outputs[fd];
+	if (wb == NULL || wb->fh != fd)
+		return write_all(fd, buf, count);
+
+	if (wb->wbuf_used + count > wb->wbuf_size)
+	{
+		if (flush_output_buffer(wb) == -1)
+			return -1;
+		if (count >= wb->wbuf_size)
+			return write_all(fd, buf, count);
+	}
+	memcpy(wb->wbuf + wb->wbuf_used, buf, count);
+	wb->wbuf_used += count;
+	return count;
+}
+
+void print_output_write_stats(void)
+{
+	if (output_write_calls)
+		mprint("Output: %llu bytes written with %llu write calls\n",
+		       output_bytes_written, output_write_calls);
+}
+
 void dinit_write(struct ccx_s_write *wb)
 {
 	if (wb == NULL)
@@ -15,6 +297,8 @@ void dinit_write(struct ccx_s_write *wb)
 	}
 	if (wb->fh > 0)
 	{
+		rcwt_finish_chunks(wb);
+		release_output_buffer(wb);
 		// Check if the file is empty before closing
 		off_t file_size = lseek(wb->fh, 0, SEEK_END);
 		close(wb->fh);
@@ -27,6 +311,7 @@ void dinit_write(struct ccx_s_write *wb)
 			mprint("Deleted empty output file: %s\n", wb->filename);
 		}
 	}
+	release_output_buffer(wb);
 	freep(&wb->filename);
 	freep(&wb->original_filename);
 	if (wb->with_semaphore && wb->semaphore_filename)
@@ -38,8 +323,7 @@ void dinit_write(struct ccx_s_write *wb)
 
 int temporarily_close_output(struct ccx_s_write *wb)
 {
-	close(wb->fh);
-	wb->fh = -1;
+	close_output(wb);
 	wb->temporarily_closed = 1;
 	return 0;
 }
@@ -59,6 +343,7 @@ int temporarily_open_output(struct ccx_s_write *wb)
 	{
 		return CCX_COMMON_EXIT_FILE_CREATION_FAILED;
 	}
+	enable_output_buffer(wb);
 	wb->temporarily_closed = 0;
 	return EXIT_OK;
 }
@@ -103,6 +388,7 @@ int init_write(struct ccx_s_write *wb, char *filename, int with_semaphore)
 		}
 		close(t);
 	}
+	enable_output_buffer(wb);
 	return EXIT_OK;
 }
 
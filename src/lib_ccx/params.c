@@ -99,6 +99,11 @@ void print_usage(void)
 	mprint("                                   tcp server\n");
 	mprint("            --tcp-description description: Sends to the server short description about\n");
 	mprint("                                  captions e.g. channel name or file name\n");
+	mprint("            --tcp-senders n: With --tcp, serves up to n --sendto senders at once\n");
+	mprint("                             instead of one, writing the captions of each to its\n");
+	mprint("                             own file, named after its --tcp-description or the\n");
+	mprint("                             order it connected in. A sender with a description\n");
+	mprint("                             that reconnects continues its file. Stop with SIGTERM.\n");
 	mprint("Options that affect what will be processed:\n");
 	mprint("      --output-field 1 / 2 / both:\n");
 	mprint("                       				Values: 1 = Output Field 1\n");
@@ -166,7 +171,9 @@ void print_usage(void)
 #ifdef WITH_LIBCURL
 	mprint("                      curl    -> POST plain transcription frame-by-frame to a\n");
 	mprint("                                 URL specified by -curlposturl. Don't produce\n");
-	mprint("                                 any file output.\n");
+	mprint("                                 any file output. With -curlbatch N, up to N\n");
+	mprint("                                 frames are sent per request to /frames/, one\n");
+	mprint("                                 per line.\n");
 #endif
 	mprint("                      smptett -> SMPTE Timed Text (W3C TTML) format.\n");
 	mprint("                      spupng  -> Set of .xml and .png files for use with\n");
@@ -176,7 +183,11 @@ void print_usage(void)
 	mprint("                      report  -> Prints to stdout information about captions\n");
 	mprint("                                 in specified input. Don't produce any file\n");
 	mprint("                                 output\n\n");
-	mprint("       --srt, --dvdraw, --sami, --webvtt, --txt, --ttxt and --null can be used as shorts.\n\n");
+	mprint("       --srt, --dvdraw, --sami, --webvtt, --txt, --ttxt and --null can be used as shorts.\n");
+	mprint("       A comma separated list (e.g. --out=srt,webvtt,scc) writes each format\n");
+	mprint("       from a single pass over the input. The formats must use different\n");
+	mprint("       file extensions; txt, ttxt, bin, raw, dvdraw, mcc, curl, null and\n");
+	mprint("       report can only be used alone, and a list cannot go to --stdout.\n\n");
 
 	mprint("Options that affect how input files will be processed.\n");
 
@@ -235,6 +246,12 @@ void print_usage(void)
 	mprint("         --autoprogram: If there's more than one program in the stream, just use\n");
 	mprint("                       the first one we find that contains a suitable stream.\n");
 	mprint("        --multiprogram: Uses multiple programs from the same input stream.\n");
+	mprint("             --jobs N: Process up to N input files at the same time, each\n");
+	mprint("                       one independently with its own output files.\n");
+	mprint("                       With --multiprogram and one transport stream, demux\n");
+	mprint("                       it once and decode its programs in N worker\n");
+	mprint("                       processes instead. Not supported on Windows, where\n");
+	mprint("                       everything runs one after another.\n");
 	mprint("             --datapid: Don't try to find out the stream for caption/teletext\n");
 	mprint("                       data, just use this one instead.\n");
 	mprint("      --datastreamtype: Instead of selecting the stream by its PID, select it\n");
@@ -268,6 +285,12 @@ void print_usage(void)
 	mprint("                       less or equal than the max allowed..\n");
 	mprint("	   --analyzevideo  Analyze the video stream even if it's not used for\n");
 	mprint("                       subtitles. This allows to provide video information.\n");
+	mprint("   --fast-avc-scan     Assume each H.264 PES packet holds a single access\n");
+	mprint("                       unit and stop scanning it after the first slice\n");
+	mprint("                       header. Saves CPU on high-bitrate sources, but\n");
+	mprint("                       captions in packets carrying several pictures\n");
+	mprint("                       would be missed. Ignored for elementary stream\n");
+	mprint("                       input.\n");
 	mprint("  --timestamp-map      Enable the X-TIMESTAMP-MAP header for WebVTT (HLS)\n");
 	mprint("Levenshtein distance:\n");
 	mprint("           --no-levdist: Don't attempt to correct typos with Levenshtein distance.\n");
@@ -351,6 +374,10 @@ void print_usage(void)
 	mprint("                       e.g use '--txt --stdout --null-terminated' when piping to\n");
 	mprint("                       'websocat -0' (https://github.com/vi/websocat)\n");
 	mprint("                  --df: For MCC Files, force dropframe frame count.\n");
+	mprint("          --rcwt-index: With -out=bin, write the captions in chunks with a time\n");
+	mprint("                       index, so --startat can seek straight to them when\n");
+	mprint("                       the file is read back.\n");
+	mprint("       --rcwt-compress: Like --rcwt-index, and zlib compress the chunks.\n");
 	mprint("            --autodash: Based on position on screen, attempt to determine\n");
 	mprint("                       the different speakers and a dash (-) when each\n");
 	mprint("                       of them talks (.srt/.vtt only, --trim required).\n");
@@ -411,6 +438,18 @@ void print_usage(void)
 	mprint("     --no-ocr-blacklist: Disable the OCR character blacklist. By default,\n");
 	mprint("                       CCExtractor blacklists characters like |, \\, `, _, ~\n");
 	mprint("                       that are commonly misrecognized (e.g. 'I' as '|').\n");
+	mprint("      --ocr-threads n: Run OCR on n threads, each with its own Tesseract\n");
+	mprint("                       instance, while decoding continues. Used for VOBSUB\n");
+	mprint("                       tracks in MP4/MKV files and for --hardsubx (except\n");
+	mprint("                       with --sampling adaptive).\n");
+	mprint("                       Default is 1 (OCR on the decoding thread).\n");
+	mprint("      --ocr-cache file: Keep OCR results in this file between runs.\n");
+	mprint("                       Subtitle bitmaps already recognized by an earlier\n");
+	mprint("                       run with the same OCR settings (e.g. over the same\n");
+	mprint("                       channel) are not passed to Tesseract again. Within\n");
+	mprint("                       a run, repeated bitmaps are always recognized once.\n");
+	mprint("                       At most 10000 results are kept, in memory and in\n");
+	mprint("                       the file; the least recently used go first.\n");
 	mprint("             --mkvlang: For MKV subtitles, select which language's caption\n");
 	mprint("                       stream will be processed. e.g. 'eng' for English.\n");
 	mprint("                       Language codes can be either the 3 letters bibliographic\n");
@@ -638,6 +677,28 @@ void print_usage(void)
 	mprint("                     Recommended values are in the range 80 to 100.\n");
 	mprint("                     The default value is 95\n");
 	mprint("\n");
+	mprint("         --sub-band : Height of the band at the bottom of the frame that\n");
+	mprint("                     is searched for subtitles, as a percentage of the\n");
+	mprint("                     frame height. Only this band is color converted.\n");
+	mprint("                     The default value is 25\n");
+	mprint("                     e.g. --sub-band 40\n");
+	mprint("         --sampling : Choose which frames are decoded for OCR:\n");
+	mprint("                     every (default): decode every frame and OCR one\n");
+	mprint("                     frame in 25.\n");
+	mprint("                     skip: have the decoder skip non-reference frames,\n");
+	mprint("                     or all but keyframes when the sample interval is\n");
+	mprint("                     at least the keyframe interval.\n");
+	mprint("                     seek: like skip, but seek to the next sample when\n");
+	mprint("                     it is more than a keyframe interval away.\n");
+	mprint("                     adaptive: like seek, and sample every\n");
+	mprint("                     --min-sub-duration between two samples whose text\n");
+	mprint("                     differs, to find where the subtitle changed.\n");
+	mprint("                     Not used with --tickertext or --hcc.\n");
+	mprint("                     e.g. --sampling adaptive\n");
+	mprint("  --sample-interval : Seconds between sampled frames, for all --sampling\n");
+	mprint("                     modes but every. The default value is 1.0\n");
+	mprint("                     e.g. --sample-interval 2.5\n");
+	mprint("\n");
 	mprint("		--hcc	   : This option will be used if the file should have both\n");
 	mprint("					 closed captions and burned in subtitles\n");
 	mprint("            An example command for burned-in subtitle extraction is as follows:\n");
@@ -675,6 +736,8 @@ void print_usage(void)
 	mprint("  generate a .srt file, with only data from 3:00 to 5:00 in the input file(s)\n");
 	mprint("  and then add that (huge) delay, which would make the final file start at\n");
 	mprint("  5:00 and end at 7:00.\n");
+	mprint("  On a single TS, PS or MP4 file, the input up to 15 seconds before --startat\n");
+	mprint("  is skipped rather than decoded, and reading stops 15 seconds after --endat.\n");
 	mprint("\n");
 	mprint("Notes on codec options:\n");
 	mprint("  If codec type is not selected then first elementary stream suitable for\n");
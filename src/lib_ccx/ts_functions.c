@@ -15,8 +15,6 @@
 
 #define RAI_MASK 0x40 // byte mask to check if RAI bit is set (random access indicator)
 
-unsigned char tspacket[188]; // Current packet
-
 // struct ts_payload payload;
 
 static unsigned char *haup_capbuf = NULL;
@@ -194,11 +192,14 @@ void init_ts(struct ccx_demuxer *ctx)
 }
 
 // Return 1 for successfully read ts packet
+// The packet is parsed in place in the file buffer; it is only copied (to
+// ctx->tspacket) when it straddles a buffer refill or sync was lost.
 int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload)
 {
 	unsigned int adaptation_field_length = 0;
 	unsigned int adaptation_field_control;
-	long long result;
+	unsigned char *tspacket;
+	size_t result;
 	if (ctx->m2ts)
 	{
 		/* M2TS just adds 4 bytes to each packet (so size goes from 188 to 192)
@@ -207,23 +208,22 @@ int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload)
 		Copy_permission_indicator 2  unimsbf
 		Arrival_time_stamp 30 unimsbf
 		} */
-		unsigned char tp_extra_header[4];
-		result = buffered_read(ctx, tp_extra_header, 4);
+		result = buffered_skip(ctx, 4);
 		ctx->past += result;
 		if (result != 4)
 		{
 			if (result > 0)
-				mprint("Premature end of file (incomplete TS packer header, expected 4 bytes to skip M2TS extra bytes, got %lld).\n", result);
+				mprint("Premature end of file (incomplete TS packer header, expected 4 bytes to skip M2TS extra bytes, got %zu).\n", result);
 			return CCX_EOF;
 		}
 	}
 
-	result = buffered_read(ctx, tspacket, 188);
+	tspacket = buffered_view(ctx, ctx->tspacket, 188, &result);
 	ctx->past += result;
 	if (result != 188)
 	{
 		if (result > 0)
-			mprint("Premature end of file - Transport Stream packet is incomplete (expected 188 bytes, got %lld).\n", result);
+			mprint("Premature end of file - Transport Stream packet is incomplete (expected 188 bytes, got %zu).\n", result);
 		return CCX_EOF;
 	}
 
@@ -250,8 +250,18 @@ int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload)
 			// Found it
 			int atpos = tstemp - tspacket;
 
-			memmove(tspacket, tstemp, (size_t)(tslen - atpos));
-			result = buffered_read(ctx, tspacket + (tslen - atpos), atpos);
+			if (tspacket != ctx->tspacket && (size_t)atpos <= buffered_bytes_left(ctx))
+			{
+				// The rest of the packet directly follows in the file buffer
+				tspacket = tstemp;
+				result = buffered_skip(ctx, atpos);
+			}
+			else
+			{
+				memmove(ctx->tspacket, tstemp, (size_t)(tslen - atpos));
+				tspacket = ctx->tspacket;
+				result = buffered_read(ctx, tspacket + (tslen - atpos), atpos);
+			}
 			ctx->past += result;
 			if (result != atpos)
 			{
@@ -262,7 +272,7 @@ int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload)
 		else
 		{
 			// Read the next 188 bytes.
-			result = buffered_read(ctx, tspacket, tslen);
+			tspacket = buffered_view(ctx, ctx->tspacket, tslen, &result);
 			ctx->past += result;
 			if (result != tslen)
 			{
@@ -302,6 +312,7 @@ int ts_readpacket(struct ccx_demuxer *ctx, struct ts_payload *payload)
 		dump(CCX_DMT_DUMPDEF, tspacket, 188, 0, 0);
 	}
 
+	payload->packet = tspacket;
 	payload->start = tspacket + 4;
 	payload->length = 188 - 4;
 	if (adaptation_field_control & 2)
@@ -443,11 +454,30 @@ void look_for_caption_data(struct ccx_demuxer *ctx, struct ts_payload *payload)
 	}
 }
 
-void delete_demuxer_data_node_by_pid(struct demuxer_data **data, int pid)
+/* The PID index is only good for the list it was built from; anything else
+ * (a fresh list, or a single-node list from another demuxer) starts over. */
+static void sync_demuxer_data_index(struct ccx_demuxer *ctx, struct demuxer_data *data)
+{
+	if (ctx->data_index_head == data)
+		return;
+	reset_demuxer_data_index(ctx);
+	ctx->data_index_head = data;
+	for (; data; data = data->next_stream)
+	{
+		if (data->stream_pid >= 0 && data->stream_pid <= MAX_PSI_PID && !ctx->data_by_pid[data->stream_pid])
+			ctx->data_by_pid[data->stream_pid] = data;
+	}
+}
+
+void delete_demuxer_data_node_by_pid(struct ccx_demuxer *ctx, struct demuxer_data **data, int pid)
 {
 	struct demuxer_data *ptr;
 	struct demuxer_data *sptr = NULL;
 
+	sync_demuxer_data_index(ctx, *data);
+	if (pid < 0 || pid > MAX_PSI_PID || !ctx->data_by_pid[pid])
+		return;
+
 	ptr = *data;
 	while (ptr)
 	{
@@ -467,37 +497,23 @@ void delete_demuxer_data_node_by_pid(struct demuxer_data **data, int pid)
 			ptr = ptr->next_stream;
 		}
 	}
+	ctx->data_by_pid[pid] = NULL;
+	ctx->data_index_head = *data;
+	ctx->best_data_valid = 0;
 }
 
-struct demuxer_data *search_or_alloc_demuxer_data_node_by_pid(struct demuxer_data **data, int pid)
+struct demuxer_data *search_or_alloc_demuxer_data_node_by_pid(struct ccx_demuxer *ctx, struct demuxer_data **data, int pid)
 {
 	struct demuxer_data *ptr;
 	struct demuxer_data *sptr;
-	if (!*data)
-	{
-		*data = alloc_demuxer_data();
-		(*data)->program_number = -1;
-		(*data)->stream_pid = pid;
-		(*data)->bufferdatatype = CCX_UNKNOWN;
-		(*data)->len = 0;
-		(*data)->next_program = NULL;
-		(*data)->next_stream = NULL;
-		return *data;
-	}
-	ptr = *data;
 
-	do
-	{
-		if (ptr->stream_pid == pid)
-		{
-			return ptr;
-		}
-		sptr = ptr;
-		ptr = ptr->next_stream;
-	} while (ptr);
+	sync_demuxer_data_index(ctx, *data);
+	if (pid >= 0 && pid <= MAX_PSI_PID && ctx->data_by_pid[pid])
+		return ctx->data_by_pid[pid];
 
-	sptr->next_stream = alloc_demuxer_data();
-	ptr = sptr->next_stream;
+	ptr = alloc_demuxer_data();
+	if (!ptr)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In search_or_alloc_demuxer_data_node_by_pid: Out of memory allocating demuxer data.");
 	ptr->program_number = -1;
 	ptr->stream_pid = pid;
 	ptr->bufferdatatype = CCX_UNKNOWN;
@@ -505,13 +521,35 @@ struct demuxer_data *search_or_alloc_demuxer_data_node_by_pid(struct demuxer_dat
 	ptr->next_program = NULL;
 	ptr->next_stream = NULL;
 
+	// Append, list order decides get_best_data() ties
+	if (!*data)
+	{
+		*data = ptr;
+		ctx->data_index_head = ptr;
+	}
+	else
+	{
+		for (sptr = *data; sptr->next_stream; sptr = sptr->next_stream)
+			;
+		sptr->next_stream = ptr;
+	}
+	if (pid >= 0 && pid <= MAX_PSI_PID)
+		ctx->data_by_pid[pid] = ptr;
+	ctx->best_data_valid = 0;
+
 	return ptr;
 }
 
-struct demuxer_data *get_best_data(struct demuxer_data *data)
+struct demuxer_data *get_best_data(struct ccx_demuxer *ctx, struct demuxer_data *data)
 {
 	struct demuxer_data *ret = NULL;
 	struct demuxer_data *ptr = data;
+
+	int indexed = data && ctx->data_index_head == data;
+
+	if (indexed && ctx->best_data_valid)
+		return ctx->best_data;
+
 	for (ptr = data; ptr; ptr = ptr->next_stream)
 	{
 		if (ptr->codec == CCX_CODEC_TELETEXT)
@@ -547,6 +585,11 @@ struct demuxer_data *get_best_data(struct demuxer_data *data)
 		}
 	}
 end:
+	if (indexed)
+	{
+		ctx->best_data = ret;
+		ctx->best_data_valid = 1;
+	}
 
 	return ret;
 }
@@ -559,9 +602,13 @@ int copy_capbuf_demux_data(struct ccx_demuxer *ctx, struct demuxer_data **data,
 	long databuflen;
 	struct demuxer_data *ptr;
 
-	ptr = search_or_alloc_demuxer_data_node_by_pid(data, cinfo->pid);
+	ptr = search_or_alloc_demuxer_data_node_by_pid(ctx, data, cinfo->pid);
 	ptr->program_number = cinfo->program_number;
-	ptr->codec = cinfo->codec;
+	if (ptr->codec != cinfo->codec)
+	{
+		ptr->codec = cinfo->codec;
+		ctx->best_data_valid = 0;
+	}
 	ptr->bufferdatatype = get_buffer_type(cinfo);
 
 	if (!cinfo->capbuf || !cinfo->capbuflen)
@@ -664,11 +711,11 @@ void cinfo_cremation(struct ccx_demuxer *ctx, struct demuxer_data **data)
 	list_for_each_entry(iter, &ctx->cinfo_tree.all_stream, all_stream, struct cap_info)
 	{
 		copy_capbuf_demux_data(ctx, data, iter);
-		freep(&iter->capbuf);
+		capbuf_release(ctx, iter);
 	}
 }
 
-int copy_payload_to_capbuf(struct cap_info *cinfo, struct ts_payload *payload)
+int copy_payload_to_capbuf(struct ccx_demuxer *ctx, struct cap_info *cinfo, struct ts_payload *payload)
 {
 
 	if (cinfo->ignore == CCX_TRUE &&
@@ -688,6 +735,8 @@ int copy_payload_to_capbuf(struct cap_info *cinfo, struct ts_payload *payload)
 		{
 			mprint("Notice: Missing PES header\n");
 			dump(CCX_DMT_DUMPDEF, payload->start, payload->length, 0, 0);
+			if (cinfo->saw_pesstart)
+				ctx->best_stream_valid = 0;
 			cinfo->saw_pesstart = 0;
 			errno = EINVAL;
 			return -1;
@@ -701,14 +750,8 @@ int copy_payload_to_capbuf(struct cap_info *cinfo, struct ts_payload *payload)
 		return -1;
 	}
 	int64_t newcapbuflen = (int64_t)cinfo->capbuflen + payload->length;
-	if (newcapbuflen > (int64_t)cinfo->capbufsize)
-	{
-		unsigned char *new_capbuf = (unsigned char *)realloc(cinfo->capbuf, (size_t)newcapbuflen);
-		if (!new_capbuf)
-			return -1;
-		cinfo->capbuf = new_capbuf;
-		cinfo->capbufsize = newcapbuflen; // Note: capbufsize is int in struct cap_info
-	}
+	if (capbuf_reserve(ctx, cinfo, newcapbuflen) != CCX_OK)
+		return -1;
 	memcpy(cinfo->capbuf + cinfo->capbuflen, payload->start, payload->length);
 	cinfo->capbuflen = newcapbuflen; // Note: capbuflen is int in struct cap_info
 
@@ -753,6 +796,120 @@ uint64_t get_pts(uint8_t *buffer)
 	return UINT64_MAX;
 }
 
+#define TS_SKIP_BATCH 64 // Packets whose sync bytes are validated at once
+
+/* Number of leading packets in buf (at most npackets, stride bytes apart)
+   that start with a sync byte. Four packets are tested per step so the
+   common all-synced case is a handful of branches per batch. */
+static size_t ts_count_synced_packets(const unsigned char *buf, size_t npackets, size_t stride)
+{
+	size_t i = 0;
+	for (; i + 4 <= npackets; i += 4)
+	{
+		const unsigned char *p = buf + i * stride;
+		if ((p[0] ^ 0x47) | (p[stride] ^ 0x47) | (p[2 * stride] ^ 0x47) | (p[3 * stride] ^ 0x47))
+			break;
+	}
+	while (i < npackets && buf[i * stride] == 0x47)
+		i++;
+	return i;
+}
+
+/* Consume the buffered packets that belong to TS_PID_IGNORED PIDs without
+   parsing them, stopping at the first one ts_readpacket() has to see (other
+   PIDs, PES starts needed for the PTS statistics, damaged packets, lost
+   sync or a packet straddling the buffer end). Returns the number skipped. */
+static long ts_skip_ignored_packets(struct ccx_demuxer *ctx)
+{
+	size_t stride = ctx->m2ts ? 192 : 188;
+	size_t offset = ctx->m2ts ? 4 : 0;
+	long skipped = 0;
+
+	while (1)
+	{
+		size_t npackets = buffered_bytes_left(ctx) / stride;
+		const unsigned char *buf = ctx->filebuffer + ctx->filebuffer_pos + offset;
+		size_t synced, i;
+
+		if (npackets > TS_SKIP_BATCH)
+			npackets = TS_SKIP_BATCH;
+		synced = ts_count_synced_packets(buf, npackets, stride);
+		for (i = 0; i < synced; i++)
+		{
+			const unsigned char *p = buf + i * stride;
+			unsigned pid = ((p[1] & 0x1F) << 8) | p[2];
+			if (ctx->pid_class[pid] != TS_PID_IGNORED || (p[1] & 0xC0)) // transport_error or pesstart
+				break;
+		}
+		ctx->filebuffer_pos += (unsigned int)(i * stride);
+		ctx->past += i * stride;
+		skipped += i;
+		if (i < TS_SKIP_BATCH)
+			return skipped;
+	}
+}
+
+/* Called once a packet has been fully processed without producing anything.
+   The PID can be skipped from now on unless something else may need it. */
+static void ts_classify_ignored(struct ccx_demuxer *ctx, unsigned pid)
+{
+	if (ctx->nb_program == 0 || ctx->PIDs_seen[pid] < 2)
+		return; // Still learning the stream layout
+	if (pid == HAUPPAGE_CCPID || (ccx_options.xmltv >= 1 && (pid == 0x11 || pid == 0x12 || pid >= 0x1000)))
+		return;
+	for (int j = 0; j < ctx->nb_program; j++)
+	{
+		if (ctx->pinfo[j].pid == (int)pid || ctx->pinfo[j].pcr_pid == (int)pid)
+			return;
+	}
+	ctx->pid_class[pid] = TS_PID_IGNORED;
+}
+
+/* For --startat: the first PCR at or after file position from, looking only
+   at PID *pid, or at the first PID carrying one when *pid is -1. Returns 1 and
+   sets *pos to the start of its packet and *clock to the PCR base, 0 if there
+   is none in the next CLOCK_SCAN_LIMIT bytes. Moves the file position. */
+int ts_find_clock(struct ccx_demuxer *ctx, LLONG from, int *pid, LLONG *pos, LLONG *clock)
+{
+	size_t stride = ctx->m2ts ? 192 : 188;
+	size_t offset = ctx->m2ts ? 4 : 0;
+	unsigned char *buf = malloc(CLOCK_SCAN_CHUNK);
+	LLONG start = from;
+	int found = 0;
+
+	if (buf == NULL)
+		fatal(EXIT_NOT_ENOUGH_MEMORY, "In ts_find_clock: Out of memory.");
+
+	while (!found && start < from + CLOCK_SCAN_LIMIT && LSEEK(ctx->infd, start, SEEK_SET) == start)
+	{
+		int n = read(ctx->infd, buf, CLOCK_SCAN_CHUNK);
+		size_t i = 0;
+		if (n < (int)(4 * stride))
+			break;
+
+		while (i + offset + 3 * stride < (size_t)n && ts_count_synced_packets(buf + i + offset, 4, stride) < 4)
+			i++;
+		for (; i + stride <= (size_t)n && buf[i + offset] == 0x47; i += stride)
+		{
+			const unsigned char *p = buf + i + offset;
+			int packet_pid = ((p[1] & 0x1F) << 8) | p[2];
+			// adaptation_field_control, adaptation_field_length, PCR_flag
+			if (!(p[3] & 0x20) || p[4] < 7 || !(p[5] & 0x10) || (*pid != -1 && packet_pid != *pid))
+				continue;
+			*pid = packet_pid;
+			*pos = start + i;
+			*clock = ((LLONG)p[6] << 25) | (p[7] << 17) | (p[8] << 9) | (p[9] << 1) | (p[10] >> 7);
+			found = 1;
+			break;
+		}
+		if (n < CLOCK_SCAN_CHUNK)
+			break;
+		start += i > 0 ? i : 1;
+	}
+	free(buf);
+	return found;
+}
+
 // Threshold for enabling packet analysis mode when no PAT is found (in bytes)
 #define NO_PAT_THRESHOLD (188 * 1000) // After ~1000 packets
 
@@ -773,6 +930,7 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 
 	do
 	{
+		pcount += ts_skip_ignored_packets(ctx);
 		pcount++;
 
 		// Exit the loop at EOF
@@ -791,7 +949,8 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 		// Check for PAT
 		if (payload.pid == 0) // This is a PAT
 		{
-			ts_buffer_psi_packet(ctx);
+			ctx->pid_class[0] = TS_PID_PSI;
+			ts_buffer_psi_packet(ctx, payload.packet);
 			if (ctx->PID_buffers[payload.pid] != NULL && ctx->PID_buffers[payload.pid]->buffer_length > 0)
 				parse_PAT(ctx); // Returns 1 if there was some data in the buffer already
 			continue;
@@ -799,15 +958,15 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 
 		if (ccx_options.xmltv >= 1 && payload.pid == 0x11)
 		{ // This is SDT (or BAT)
-			ts_buffer_psi_packet(ctx);
+			ts_buffer_psi_packet(ctx, payload.packet);
 			if (ctx->PID_buffers[payload.pid] != NULL && ctx->PID_buffers[payload.pid]->buffer_length > 0)
 				parse_SDT(ctx);
 		}
 
 		if (ccx_options.xmltv >= 1 && payload.pid == 0x12) // This is DVB EIT
-			parse_EPG_packet(ctx->parent);
+			parse_EPG_packet(ctx->parent, payload.packet);
 		if (ccx_options.xmltv >= 1 && payload.pid >= 0x1000) // This may be ATSC EPG packet
-			parse_EPG_packet(ctx->parent);
+			parse_EPG_packet(ctx->parent, payload.packet);
 
 		for (j = 0; j < ctx->nb_program; j++)
 		{
@@ -839,7 +998,8 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 		if (j != ctx->nb_program)
 		{
 			ctx->PIDs_seen[payload.pid] = 2;
-			ts_buffer_psi_packet(ctx);
+			ctx->pid_class[payload.pid] = TS_PID_PSI;
+			ts_buffer_psi_packet(ctx, payload.packet);
 			if (ctx->PID_buffers[payload.pid] != NULL && ctx->PID_buffers[payload.pid]->buffer_length > 0)
 				if (parse_PMT(ctx, ctx->PID_buffers[payload.pid]->buffer + 1, ctx->PID_buffers[payload.pid]->buffer_length - 1, pinfo))
 					gotpes = 1; // Signals that something changed and that we must flush the buffer
@@ -918,7 +1078,10 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 		}
 
 		if (payload.pid == 8191) // Null packet
+		{
+			ctx->pid_class[8191] = TS_PID_IGNORED;
 			continue;
+		}
 		if (payload.pid == 1003 && !ctx->hauppauge_warning_shown && !ccx_options.hauppauge_mode)
 		{
 			// TODO: Change this very weak test for something more decent such as size.
@@ -933,14 +1096,17 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 			int haup_newcapbuflen = haup_capbuflen + payload.length;
 			if (haup_newcapbuflen > haup_capbufsize)
 			{
-				unsigned char *new_haup_capbuf = (unsigned char *)realloc(haup_capbuf, haup_newcapbuflen);
+				long haup_newcapbufsize = haup_capbufsize ? haup_capbufsize * 2 : CAPBUF_MIN_SIZE;
+				if (haup_newcapbufsize < haup_newcapbuflen)
+					haup_newcapbufsize = haup_newcapbuflen;
+				unsigned char *new_haup_capbuf = (unsigned char *)realloc(haup_capbuf, haup_newcapbufsize);
 				if (!new_haup_capbuf)
 				{
 					free(haup_capbuf);
 					fatal(EXIT_NOT_ENOUGH_MEMORY, "Not enough memory to store hauppauge packets");
 				}
 				haup_capbuf = new_haup_capbuf;
-				haup_capbufsize = haup_newcapbuflen;
+				haup_capbufsize = haup_newcapbufsize;
 			}
 			memcpy(haup_capbuf + haup_capbuflen, payload.start, payload.length);
 			haup_capbuflen = haup_newcapbuflen;
@@ -960,8 +1126,11 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 		if (cinfo == NULL)
 		{
 			if (!packet_analysis_mode)
+			{
 				dbg_print(CCX_DMT_PARSE, "Packet (pid %u) skipped - no stream with captions identified yet.\n",
 					  payload.pid);
+				ts_classify_ignored(ctx, payload.pid);
+			}
 			else
 				look_for_caption_data(ctx, &payload);
 			continue;
@@ -992,17 +1161,19 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 
 			if (cinfo->capbuflen > 0)
 			{
-				freep(&cinfo->capbuf);
-				cinfo->capbufsize = 0;
-				cinfo->capbuflen = 0;
-				delete_demuxer_data_node_by_pid(data, cinfo->pid);
+				capbuf_release(ctx, cinfo);
+				delete_demuxer_data_node_by_pid(ctx, data, cinfo->pid);
 			}
+			ts_classify_ignored(ctx, payload.pid);
 			continue;
 		}
+		ctx->pid_class[payload.pid] = TS_PID_CAPTION;
 
 		// Video PES start
 		if (payload.pesstart)
 		{
+			if (!cinfo->saw_pesstart)
+				ctx->best_stream_valid = 0; // get_best_stream() skips ATSC streams without a PES start
 			cinfo->saw_pesstart = 1;
 			cinfo->prev_counter = payload.counter - 1;
 		}
@@ -1030,7 +1201,7 @@ int64_t ts_readstream(struct ccx_demuxer *ctx, struct demuxer_data **data)
 			gotpes = 1;
 		}
 
-		copy_payload_to_capbuf(cinfo, &payload);
+		copy_payload_to_capbuf(ctx, cinfo, &payload);
 		if (ret < 0)
 		{
 			if (errno == EINVAL)
@@ -3,6 +3,7 @@
 
 struct ts_payload
 {
+	unsigned char *packet;		 // Whole TS packet, valid until the next ts_readpacket()
 	unsigned char *start;		 // Payload start
 	unsigned length;		 // Payload length
 	unsigned pesstart;		 // PES or PSI start
@@ -70,9 +71,16 @@ struct EPG_event
 };
 
 #define EPG_MAX_EVENTS 60 * 24 * 7
+#define EPG_EVENT_HASH_BITS 14 // 16384 slots, so the table never gets more than 62% full
+#define EPG_EVENT_HASH_SIZE (1 << EPG_EVENT_HASH_BITS)
 struct EIT_program
 {
 	uint32_t array_len;
 	struct EPG_event epg_events[EPG_MAX_EVENTS];
+	// Open addressing table of event id -> index in epg_events + 1, 0 for a free slot
+	uint16_t event_index[EPG_EVENT_HASH_SIZE];
+	// Indexes of the events added or updated since the last live output
+	uint16_t dirty[EPG_MAX_EVENTS];
+	uint32_t dirty_len;
 };
 #endif
@@ -110,7 +110,7 @@ int get_video_stream(struct ccx_demuxer *ctx)
 	return -1;
 }
 
-int get_best_stream(struct ccx_demuxer *ctx)
+static int find_best_stream(struct ccx_demuxer *ctx)
 {
 	struct cap_info *iter;
 
@@ -141,9 +141,26 @@ int get_best_stream(struct ccx_demuxer *ctx)
 	return -1;
 }
 
-struct demuxer_data *get_data_stream(struct demuxer_data *data, int pid)
+int get_best_stream(struct ccx_demuxer *ctx)
+{
+	if (!ctx->best_stream_valid)
+	{
+		ctx->best_stream_pid = find_best_stream(ctx);
+		ctx->best_stream_valid = 1;
+	}
+	return ctx->best_stream_pid;
+}
+
+struct demuxer_data *get_data_stream(struct ccx_demuxer *ctx, struct demuxer_data *data, int pid)
 {
 	struct demuxer_data *ptr = data;
+
+	if (data && ctx->data_index_head == data && pid >= 0 && pid <= MAX_PSI_PID)
+	{
+		ptr = ctx->data_by_pid[pid];
+		return (ptr && ptr->len > 0) ? ptr : NULL;
+	}
+
 	for (ptr = data; ptr; ptr = ptr->next_stream)
 		if (ptr->stream_pid == pid && ptr->len > 0)
 			return ptr;
@@ -196,6 +213,7 @@ int update_capinfo(struct ccx_demuxer *ctx, int pid, enum ccx_stream_type stream
 	}
 
 	ptr = &ctx->cinfo_tree;
+	reset_pid_classes(ctx);
 
 	list_for_each_entry(tmp, &ptr->all_stream, all_stream, struct cap_info)
 	{
@@ -283,6 +301,84 @@ int update_capinfo(struct ccx_demuxer *ctx, int pid, enum ccx_stream_type stream
 	return 0;
 }
 
+void reset_pid_classes(struct ccx_demuxer *ctx)
+{
+	memset(ctx->pid_class, TS_PID_UNCLASSIFIED, sizeof(ctx->pid_class));
+	ctx->best_data_valid = 0;
+	ctx->best_stream_valid = 0;
+}
+
+void reset_demuxer_data_index(struct ccx_demuxer *ctx)
+{
+	memset(ctx->data_by_pid, 0, sizeof(ctx->data_by_pid));
+	ctx->data_index_head = NULL;
+	ctx->best_data = NULL;
+	ctx->best_data_valid = 0;
+}
+
+/**
+ * Make sure cinfo->capbuf can hold min_size bytes. Capacity grows
+ * geometrically so assembling a PES costs O(log n) reallocs, and a stream
+ * without a buffer first takes one from the pool of released buffers.
+ */
+int capbuf_reserve(struct ccx_demuxer *ctx, struct cap_info *cinfo, int64_t min_size)
+{
+	struct capbuf_pool *pool = &ctx->capbuf_pool;
+	int64_t newsize;
+	unsigned char *newbuf;
+
+	if (cinfo->capbuf == NULL && pool->count > 0)
+	{
+		pool->count--;
+		cinfo->capbuf = pool->buf[pool->count];
+		cinfo->capbufsize = pool->size[pool->count];
+	}
+	if (min_size <= cinfo->capbufsize)
+		return CCX_OK;
+
+	newsize = cinfo->capbufsize > CAPBUF_MIN_SIZE / 2 ? cinfo->capbufsize * 2 : CAPBUF_MIN_SIZE;
+	if (newsize < min_size)
+		newsize = min_size;
+	newbuf = (unsigned char *)realloc(cinfo->capbuf, (size_t)newsize);
+	if (!newbuf)
+		return -1;
+	cinfo->capbuf = newbuf;
+	cinfo->capbufsize = newsize;
+	return CCX_OK;
+}
+
+/* Give the PES assembly buffer of a stream back to the pool */
+void capbuf_release(struct ccx_demuxer *ctx, struct cap_info *cinfo)
+{
+	struct capbuf_pool *pool = &ctx->capbuf_pool;
+
+	if (cinfo->capbuf != NULL)
+	{
+		if (pool->count < CAPBUF_POOL_SIZE && cinfo->capbufsize > 0)
+		{
+			pool->buf[pool->count] = cinfo->capbuf;
+			pool->size[pool->count] = cinfo->capbufsize;
+			pool->count++;
+		}
+		else
+			free(cinfo->capbuf);
+	}
+	cinfo->capbuf = NULL;
+	cinfo->capbufsize = 0;
+	cinfo->capbuflen = 0;
+}
+
+void capbuf_pool_free(struct ccx_demuxer *ctx)
+{
+	struct capbuf_pool *pool = &ctx->capbuf_pool;
+
+	while (pool->count > 0)
+	{
+		pool->count--;
+		freep(&pool->buf[pool->count]);
+	}
+}
+
 void dinit_cap(struct ccx_demuxer *ctx)
 {
 	struct cap_info *iter;
@@ -292,7 +388,7 @@ void dinit_cap(struct ccx_demuxer *ctx)
 	{
 		iter = list_entry(ctx->cinfo_tree.all_stream.next, struct cap_info, all_stream);
 		list_del(&iter->all_stream);
-		freep(&iter->capbuf);
+		capbuf_release(ctx, iter);
 		// Free codec-specific private data to prevent memory leaks
 		// The pointer may have been NULLed by dinit_libraries if it was shared
 		if (iter->codec_private_data)
@@ -322,6 +418,8 @@ void dinit_cap(struct ccx_demuxer *ctx)
 	INIT_LIST_HEAD(&ctx->cinfo_tree.all_stream);
 	INIT_LIST_HEAD(&ctx->cinfo_tree.sib_stream);
 	INIT_LIST_HEAD(&ctx->cinfo_tree.pg_stream);
+	ctx->cinfo_generation++;
+	reset_pid_classes(ctx);
 }
 
 struct cap_info *get_cinfo(struct ccx_demuxer *ctx, int pid)
@@ -55,6 +55,7 @@ void clear_PMT_array(struct ccx_demuxer *ctx)
 	{
 		ctx->nb_program = 0;
 	}
+	reset_pid_classes(ctx);
 }
 
 int need_program(struct ccx_demuxer *ctx)
@@ -86,6 +87,7 @@ int update_pinfo(struct ccx_demuxer *ctx, int pid, int program_number)
 		ctx->pinfo[ctx->nb_program].got_important_streams_min_pts[i] = UINT64_MAX;
 	}
 	ctx->nb_program++;
+	reset_pid_classes(ctx);
 
 	return CCX_OK;
 }
@@ -208,7 +210,12 @@ int parse_PMT(struct ccx_demuxer *ctx, unsigned char *buf, int len, struct progr
 		return 0;
 	}
 
-	pinfo->pcr_pid = (((buf[8] & 0x1F) << 8) | buf[9]);
+	int16_t pcr_pid = (((buf[8] & 0x1F) << 8) | buf[9]);
+	if (pinfo->pcr_pid != pcr_pid)
+	{
+		pinfo->pcr_pid = pcr_pid;
+		reset_pid_classes(ctx); // The PCR PID must not be skipped
+	}
 	pi_length = (((buf[10] & 0x0F) << 8) | buf[11]);
 
 	if (12 + pi_length > len)
@@ -386,7 +393,7 @@ int parse_PMT(struct ccx_demuxer *ctx, unsigned char *buf, int len, struct progr
 				{
 					struct dvb_config cnf;
 #ifndef ENABLE_OCR
-					if (ccx_options.write_format != CCX_OF_SPUPNG)
+					if (!encoder_cfg_has_format(&ccx_options.enc_cfg, CCX_OF_SPUPNG))
 					{
 						mprint("DVB subtitles detected, OCR subsystem not present. Use --out=spupng for graphic output\n");
 						continue;
@@ -532,7 +539,7 @@ int parse_PMT(struct ccx_demuxer *ctx, unsigned char *buf, int len, struct progr
 	return must_flush;
 }
 
-void ts_buffer_psi_packet(struct ccx_demuxer *ctx)
+void ts_buffer_psi_packet(struct ccx_demuxer *ctx, unsigned char *tspacket)
 {
 	unsigned char *payload_start = tspacket + 4;
 	unsigned payload_length = 188 - 4;
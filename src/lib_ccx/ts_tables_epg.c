@@ -389,6 +389,48 @@ void EPG_print_event(struct EPG_event *event, uint32_t channel, FILE *f)
 	fprintf(f, "\n\t</programme>\n");
 }
 
+// Forget all events of a program, e.g. when a new input file starts.
+void EPG_clear_program(struct EIT_program *program)
+{
+	program->array_len = 0;
+	program->dirty_len = 0;
+	memset(program->event_index, 0, sizeof(program->event_index));
+}
+
+static uint32_t EPG_event_hash(uint32_t id)
+{
+	return (id * 2654435761u) >> (32 - EPG_EVENT_HASH_BITS);
+}
+
+// Return the slot of event_index holding the event with this id, or the free
+// slot where it would go.
+static uint32_t EPG_event_slot(struct EIT_program *program, uint32_t id)
+{
+	uint32_t slot = EPG_event_hash(id);
+	while (program->event_index[slot] != 0 && program->epg_events[program->event_index[slot] - 1].id != id)
+		slot = (slot + 1) & (EPG_EVENT_HASH_SIZE - 1);
+	return slot;
+}
+
+// Return the stored event with this id, NULL if there is none.
+struct EPG_event *EPG_find_event(struct EIT_program *program, uint32_t id)
+{
+	uint32_t slot = EPG_event_slot(program, id);
+	if (program->event_index[slot] == 0)
+		return NULL;
+	return &program->epg_events[program->event_index[slot] - 1];
+}
+
+// Queue the event at this index for the next live output, unless it already
+// is: live_output is false exactly for the events in the dirty list.
+static void EPG_mark_dirty(struct EIT_program *program, uint32_t index)
+{
+	if (program->epg_events[index].live_output == false)
+		return;
+	program->epg_events[index].live_output = false;
+	program->dirty[program->dirty_len++] = index;
+}
+
 void EPG_output_net(struct lib_ccx_ctx *ctx)
 {
 	int i;
@@ -411,12 +453,9 @@ void EPG_output_net(struct lib_ccx_ctx *ctx)
 	if (i == ctx->demux_ctx->nb_program)
 		return;
 
-	for (j = 0; j < ctx->eit_programs[i].array_len; j++)
+	for (j = 0; j < ctx->eit_programs[i].dirty_len; j++)
 	{
-		event = &(ctx->eit_programs[i].epg_events[j]);
-		if (event->live_output == true)
-			continue;
-
+		event = &(ctx->eit_programs[i].epg_events[ctx->eit_programs[i].dirty[j]]);
 		event->live_output = true;
 
 		char *category = NULL;
@@ -430,10 +469,12 @@ void EPG_output_net(struct lib_ccx_ctx *ctx)
 		    event->ISO_639_language_code,
 		    category);
 	}
+	ctx->eit_programs[i].dirty_len = 0;
 }
 
 // Creates fills and closes a new XMLTV file for live mode output.
-// File should include only events not previously output.
+// File should include only events not previously output, which are the ones
+// in the dirty lists, so the events already written are not looked at again.
 void EPG_output_live(struct lib_ccx_ctx *ctx)
 {
 	int c = false, i, j;
@@ -441,11 +482,8 @@ void EPG_output_live(struct lib_ccx_ctx *ctx)
 	char *filename, *finalfilename;
 	for (i = 0; i < ctx->demux_ctx->nb_program; i++)
 	{
-		for (j = 0; j < ctx->eit_programs[i].array_len; j++)
-			if (ctx->eit_programs[i].epg_events[j].live_output == false)
-			{
-				c = true;
-			}
+		if (ctx->eit_programs[i].dirty_len > 0)
+			c = true;
 	}
 	if (!c)
 		return;
@@ -498,12 +536,13 @@ void EPG_output_live(struct lib_ccx_ctx *ctx)
 
 	for (i = 0; i < ctx->demux_ctx->nb_program; i++)
 	{
-		for (j = 0; j < ctx->eit_programs[i].array_len; j++)
-			if (ctx->eit_programs[i].epg_events[j].live_output == false)
-			{
-				ctx->eit_programs[i].epg_events[j].live_output = true;
-				EPG_print_event(&ctx->eit_programs[i].epg_events[j], ctx->demux_ctx->pinfo[i].program_number, f);
-			}
+		for (j = 0; j < ctx->eit_programs[i].dirty_len; j++)
+		{
+			struct EPG_event *event = &ctx->eit_programs[i].epg_events[ctx->eit_programs[i].dirty[j]];
+			event->live_output = true;
+			EPG_print_event(event, ctx->demux_ctx->pinfo[i].program_number, f);
+		}
+		ctx->eit_programs[i].dirty_len = 0;
 	}
 	fprintf(f, "</tv>");
 	fclose(f);
@@ -594,11 +633,9 @@ void EPG_output(struct lib_ccx_ctx *ctx)
 			for (i = 0; i < ctx->demux_ctx->nb_program; i++)
 			{
 				ce = ctx->eit_current_events[i];
-				for (j = 0; j < ctx->eit_programs[i].array_len; j++)
-				{
-					if (ce == ctx->eit_programs[i].epg_events[j].id)
-						EPG_print_event(&ctx->eit_programs[i].epg_events[j], ctx->demux_ctx->pinfo[i].program_number, f);
-				}
+				struct EPG_event *event = EPG_find_event(&ctx->eit_programs[i], ce);
+				if (event != NULL)
+					EPG_print_event(event, ctx->demux_ctx->pinfo[i].program_number, f);
 			}
 		}
 		fprintf(f, "</tv>");
@@ -635,27 +672,39 @@ int EPG_event_cmp(struct EPG_event *e1, struct EPG_event *e2)
 // Return FALSE if nothing changed, TRUE if this is a new or updated event.
 int EPG_add_event(struct lib_ccx_ctx *ctx, int32_t pmt_map, struct EPG_event *event)
 {
-	int j;
+	struct EIT_program *program = &ctx->eit_programs[pmt_map];
+	uint32_t slot = EPG_event_slot(program, event->id);
+	uint32_t index;
 
-	for (j = 0; j < ctx->eit_programs[pmt_map].array_len; j++)
+	if (program->event_index[slot] != 0)
 	{
-		if (ctx->eit_programs[pmt_map].epg_events[j].id == event->id)
+		index = program->event_index[slot] - 1;
+		if (EPG_event_cmp(event, &program->epg_events[index]))
 		{
-			if (EPG_event_cmp(event, &ctx->eit_programs[pmt_map].epg_events[j]))
-				return false; // event already in array, nothing to do
-			else
-			{ // event with this id is already in the array but something has changed. Update it.
-				event->count = ctx->eit_programs[pmt_map].epg_events[j].count;
-				EPG_free_event(&ctx->eit_programs[pmt_map].epg_events[j]);
-				memcpy(&ctx->eit_programs[pmt_map].epg_events[j], event, sizeof(struct EPG_event));
-				return true;
-			}
+			EPG_free_event(event); // event already in array, nothing to do
+			return false;
 		}
+		// event with this id is already in the array but something has changed. Update it.
+		event->count = program->epg_events[index].count;
+		event->live_output = program->epg_events[index].live_output;
+		EPG_free_event(&program->epg_events[index]);
+		memcpy(&program->epg_events[index], event, sizeof(struct EPG_event));
+		EPG_mark_dirty(program, index);
+		return true;
+	}
+	if (program->array_len == EPG_MAX_EVENTS)
+	{
+		dbg_print(CCX_DMT_GENERIC_NOTICES, "\rWarning: Too many EPG events for one program, ignoring event %u.\n", event->id);
+		EPG_free_event(event);
+		return false;
 	}
 	// id not in array. Add new event;
+	index = program->array_len++;
 	event->count = 0;
-	memcpy(&ctx->eit_programs[pmt_map].epg_events[ctx->eit_programs[pmt_map].array_len], event, sizeof(struct EPG_event));
-	ctx->eit_programs[pmt_map].array_len++;
+	event->live_output = true;
+	memcpy(&program->epg_events[index], event, sizeof(struct EPG_event));
+	program->event_index[slot] = index + 1;
+	EPG_mark_dirty(program, index);
 	return true;
 }
 
@@ -1207,8 +1256,9 @@ void EPG_ATSC_decode_ETT(struct lib_ccx_ctx *ctx, uint8_t *payload_start, uint32
 	uint32_t ETM_id;
 	uint16_t source_id;
 	int32_t pmt_map = -1;
-	int i, j;
+	int i;
 	uint32_t extended_text_offset;
+	struct EPG_event *event = NULL;
 
 	if (size < 14)
 		return;
@@ -1237,38 +1287,17 @@ void EPG_ATSC_decode_ETT(struct lib_ccx_ctx *ctx, uint8_t *payload_start, uint32
 		return;
 
 	// Match by exact ETM_id (must match per ATSC A/65)
-	int found_match = 0;
-
 	// First try exact match in the mapped program
 	if (pmt_map < TS_PMT_MAP_SIZE)
-	{
-		for (j = 0; j < ctx->eit_programs[pmt_map].array_len; j++)
-		{
-			struct EPG_event *event = &ctx->eit_programs[pmt_map].epg_events[j];
-			if (event->id == ETM_id)
-			{
-				EPG_ATSC_decode_ETT_text(payload_start + extended_text_offset,
-							 size - extended_text_offset, event);
-				found_match = 1;
-				break;
-			}
-		}
-	}
+		event = EPG_find_event(&ctx->eit_programs[pmt_map], ETM_id);
 
 	// If not found, try fallback storage (TS_PMT_MAP_SIZE)
-	if (!found_match)
-	{
-		for (j = 0; j < ctx->eit_programs[TS_PMT_MAP_SIZE].array_len; j++)
-		{
-			struct EPG_event *event = &ctx->eit_programs[TS_PMT_MAP_SIZE].epg_events[j];
-			if (event->id == ETM_id)
-			{
-				EPG_ATSC_decode_ETT_text(payload_start + extended_text_offset,
-							 size - extended_text_offset, event);
-				break;
-			}
-		}
-	}
+	if (event == NULL)
+		event = EPG_find_event(&ctx->eit_programs[TS_PMT_MAP_SIZE], ETM_id);
+
+	if (event != NULL)
+		EPG_ATSC_decode_ETT_text(payload_start + extended_text_offset,
+					 size - extended_text_offset, event);
 }
 
 // Converts ATSC VCT short_name (7 UTF-16BE chars) to UTF-8
@@ -1553,7 +1582,7 @@ void EPG_parse_table(struct lib_ccx_ctx *ctx, uint8_t *b, uint32_t size)
 }
 
 // reconstructs DVB EIT and ATSC tables
-void parse_EPG_packet(struct lib_ccx_ctx *ctx)
+void parse_EPG_packet(struct lib_ccx_ctx *ctx, unsigned char *tspacket)
 {
 	unsigned char *payload_start = tspacket + 4;
 	unsigned payload_length = 188 - 4;
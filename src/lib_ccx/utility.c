@@ -145,14 +145,8 @@ void print_error(int mode, const char *fmt, ...)
 
 void write_wrapped(int fd, const char *buf, size_t count)
 {
-	while (count)
-	{
-		ssize_t written = write(fd, buf, count);
-		if (written == -1)
-			fatal(1, "writing to file");
-		buf += written;
-		count -= written;
-	}
+	if (buffered_write(fd, buf, count) == -1)
+		fatal(1, "writing to file");
 }
 
 /* Write formatted message to stderr and then exit. */
@@ -197,16 +191,22 @@ void mprint(const char *fmt, ...)
 	va_end(args);
 }
 
-/* Shorten some debug output code. */
-void dbg_print(LLONG mask, const char *fmt, ...)
+/* Whether messages of this type are printed. */
+int dbg_print_enabled(LLONG mask)
 {
-	va_list args;
 	LLONG t;
 	if (!ccx_options.messages_target)
-		return;
+		return 0;
 	t = temp_debug ? (ccx_options.debug_mask_on_debug | ccx_options.debug_mask) : ccx_options.debug_mask; // Mask override?
+	return (mask & t) != 0;
+}
 
-	if (mask & t)
+/* Shorten some debug output code. Called through the dbg_print() macro, or
+   directly as ccx_common_logging.debug_ftn. */
+void(dbg_print)(LLONG mask, const char *fmt, ...)
+{
+	va_list args;
+	if (dbg_print_enabled(mask))
 	{
 		va_start(args, fmt);
 		if (ccx_options.messages_target == CCX_MESSAGES_STDOUT)
@@ -351,7 +351,7 @@ struct encoder_ctx *change_filename(struct encoder_ctx *enc_ctx)
 	if (enc_ctx->out->fh != -1)
 	{
 		if (enc_ctx->out->fh > 0)
-			close(enc_ctx->out->fh);
+			close_output(enc_ctx->out);
 		enc_ctx->out->fh = -1;
 		int iter;
 		size_t filename_len = strlen(enc_ctx->out->filename);
@@ -406,6 +406,7 @@ struct encoder_ctx *change_filename(struct encoder_ctx *enc_ctx)
 			mprint("Failed to create a new rotation file\n");
 			return temp_encoder;
 		}
+		enable_output_buffer(enc_ctx->out);
 		free(temp_encoder);
 		change_filename_requested = 0;
 		return enc_ctx;
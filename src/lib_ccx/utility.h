@@ -57,5 +57,6 @@ char *strtok_r(char *str, const char *delim, char **saveptr);
 #endif //_WIN32
 
 void write_wrapped(int fd, const char *buf, size_t count);
+ssize_t buffered_write(int fd, const void *buf, size_t count);
 
 #endif // CC_UTILITY_H
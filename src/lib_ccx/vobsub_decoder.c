@@ -46,7 +46,8 @@ struct vobsub_ctx
 	struct vobsub_ctrl_seq ctrl;
 	unsigned char *bitmap; /* Decoded bitmap */
 #ifdef ENABLE_OCR
-	void *ocr_ctx; /* OCR context */
+	void *ocr_ctx;		     /* OCR context */
+	struct ocr_queue *ocr_queue; /* OCR worker threads, with --ocr-threads */
 #endif
 };
 
@@ -314,6 +315,10 @@ struct vobsub_ctx *init_vobsub_decoder(void)
 	memset(ctx, 0, sizeof(struct vobsub_ctx));
 
 #ifdef ENABLE_OCR
+	ctx->ocr_queue = init_ocr_queue(1, ccx_options.ocr_threads);
+	if (ctx->ocr_queue)
+		return ctx;
+
 	ctx->ocr_ctx = init_ocr(1); /* 1 = default language index (English) */
 	if (!ctx->ocr_ctx)
 	{
@@ -470,8 +475,14 @@ int vobsub_decode_spu(struct vobsub_ctx *ctx,
 	rect->linesize0 = w;
 
 #ifdef ENABLE_OCR
+	if (ctx->ocr_queue)
+	{
+		/* OCR runs on a worker thread, vobsub_next_output() hands the subtitle back */
+		ocr_queue_submit(ctx->ocr_queue, sub, 0, 1); /* quantmode=1 */
+		sub->got_output = 0;
+	}
 	/* Run OCR if available */
-	if (ctx->ocr_ctx)
+	else if (ctx->ocr_ctx)
 	{
 		char *ocr_str = NULL;
 		int ret = ocr_rect(ctx->ocr_ctx, rect, &ocr_str, 0, 1); /* quantmode=1 */
@@ -488,6 +499,49 @@ int vobsub_decode_spu(struct vobsub_ctx *ctx,
 	return 0;
 }
 
+int vobsub_next_output(struct vobsub_ctx *ctx, struct cc_subtitle *sub, int flush)
+{
+#ifdef ENABLE_OCR
+	struct cc_subtitle *done;
+
+	if (!ctx->ocr_queue)
+		return 0;
+
+	/* Only wait for the workers when enough subtitles are in flight */
+	done = ocr_queue_next(ctx->ocr_queue, flush || ocr_queue_full(ctx->ocr_queue));
+	if (!done)
+		return 0;
+	*sub = *done;
+	free(done);
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+/* Encode a decoded VOBSUB subtitle to the output format and free its data */
+void encode_vobsub(struct encoder_ctx *enc_ctx, struct cc_subtitle *sub)
+{
+	encode_sub(enc_ctx, sub);
+
+	if (sub->data)
+	{
+		struct cc_bitmap *rect = (struct cc_bitmap *)sub->data;
+		for (int j = 0; j < sub->nb_data; j++)
+		{
+			if (rect[j].data0)
+				free(rect[j].data0);
+			if (rect[j].data1)
+				free(rect[j].data1);
+#ifdef ENABLE_OCR
+			if (rect[j].ocr_text)
+				free(rect[j].ocr_text);
+#endif
+		}
+		free(sub->data);
+	}
+}
+
 int vobsub_ocr_available(void)
 {
 #ifdef ENABLE_OCR
@@ -505,6 +559,7 @@ void delete_vobsub_decoder(struct vobsub_ctx **ctx)
 	struct vobsub_ctx *c = *ctx;
 
 #ifdef ENABLE_OCR
+	delete_ocr_queue(&c->ocr_queue);
 	if (c->ocr_ctx)
 		delete_ocr(&c->ocr_ctx);
 #endif
@@ -3,6 +3,8 @@
 
 #include "ccx_decoders_structs.h"
 
+struct encoder_ctx;
+
 /**
  * VOBSUB decoder context - opaque structure
  */
@@ -38,6 +40,25 @@ int vobsub_decode_spu(struct vobsub_ctx *ctx,
 		      long long start_time, long long end_time,
 		      struct cc_subtitle *sub);
 
+/**
+ * Fetch the next subtitle whose OCR ran on a worker thread (--ocr-threads).
+ * With OCR threads, vobsub_decode_spu() only queues the subtitle; call this
+ * after each decode to collect finished subtitles in decode order, and with
+ * flush set until it returns 0 once the track is done.
+ * @param ctx VOBSUB decoder context
+ * @param sub Output subtitle structure, owned by the caller as after vobsub_decode_spu()
+ * @param flush 1 to wait for all queued subtitles, 0 to wait only when too many are queued
+ * @return 1 if sub was filled, 0 if no subtitle is ready
+ */
+int vobsub_next_output(struct vobsub_ctx *ctx, struct cc_subtitle *sub, int flush);
+
+/**
+ * Encode a decoded VOBSUB subtitle to the output format and free its bitmaps
+ * @param enc_ctx Encoder of the track
+ * @param sub Subtitle from vobsub_decode_spu() or vobsub_next_output()
+ */
+void encode_vobsub(struct encoder_ctx *enc_ctx, struct cc_subtitle *sub);
+
 /**
  * Check if VOBSUB OCR is available (compiled with OCR support)
  * @return 1 if OCR available, 0 otherwise
@@ -59,6 +59,10 @@ fn main() {
         "ccxr_dtvcc_process_data",
     ]);
 
+    let allowlist_vars = [
+        "AVC_SLICE_HEADER_MAX_BYTES", // shared with avc/core.rs
+    ];
+
     let mut allowlist_types = Vec::new();
     allowlist_types.extend_from_slice(&[
         // Match both lowercase (dtvcc_*) and uppercase (DTVCC_*) patterns
@@ -177,6 +181,10 @@ fn main() {
         builder = builder.allowlist_function(fn_name);
     }
 
+    for var_name in allowlist_vars {
+        builder = builder.allowlist_var(var_name);
+    }
+
     for rust_enum in RUSTIFIED_ENUMS {
         builder = builder.rustified_enum(rust_enum);
     }
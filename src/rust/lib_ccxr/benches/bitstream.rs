@@ -0,0 +1,248 @@
+//! Compares the word-at-a-time `BitStreamRust` reader with the previous
+//! bit-by-bit extraction on the headers the decoders actually parse.
+//!
+//! Run with `cargo bench --bench bitstream`.
+
+use std::hint::black_box;
+use std::time::{Duration, Instant};
+
+use lib_ccxr::common::{BitStreamRust, BitstreamError};
+use lib_ccxr::fatal;
+use lib_ccxr::util::log::ExitCause;
+
+/// H.264 SPS RBSP (High profile, 1920x1080 interlaced), NAL header stripped.
+const H264_SPS: &[u8] = &[
+    0x64, 0x00, 0x28, 0xAC, 0xD9, 0x40, 0x78, 0x02, 0x27, 0xE5, 0xC0, 0x44, 0x00, 0x00, 0x03, 0x00,
+    0x04, 0x00, 0x00, 0x03, 0x00, 0xF0, 0x3C, 0x60, 0xC6, 0x58,
+];
+
+/// Start of an H.264 IDR slice (field coded), NAL header stripped.
+const H264_SLICE: &[u8] = &[
+    0x88, 0x84, 0x00, 0x33, 0xFF, 0xC0, 0x7E, 0x10, 0x00, 0x5C, 0x21, 0x9A, 0x40, 0x11, 0x02, 0x8F,
+];
+
+/// MPEG-2 picture header followed by a picture coding extension, start codes stripped.
+const MPEG2_PICTURE: &[u8] = &[
+    0x00, 0x57, 0xFF, 0xFF, 0xF8, 0x00, 0x00, 0x01, 0xB5, 0x8F, 0xFF, 0xF3, 0x41, 0x80,
+];
+
+/// The previous `BitStreamRust` extraction, one loop iteration per bit, kept
+/// here verbatim (checks and bookkeeping included) as the baseline.
+struct BitwiseReader<'a> {
+    data: &'a [u8],
+    pos: usize,
+    bpos: u8,
+    bits_left: i64,
+    _i_pos: usize,
+    _i_bpos: u8,
+}
+
+impl<'a> BitwiseReader<'a> {
+    fn new(data: &'a [u8]) -> Self {
+        Self {
+            data,
+            pos: 0,
+            bpos: 8,
+            bits_left: data.len() as i64 * 8,
+            _i_pos: 0,
+            _i_bpos: 0,
+        }
+    }
+
+    fn next_bits(&mut self, bnum: u32) -> Result<u64, BitstreamError> {
+        if bnum > 64 {
+            fatal!(cause = ExitCause::Bug; "In next_bits: Argument is greater than the maximum bit number i.e. 64: {}!", bnum);
+        }
+        if self.pos > self.data.len() {
+            fatal!(cause = ExitCause::Bug; "In next_bits: Bitstream can not have negative length!");
+        }
+        if self.bits_left <= 0 {
+            self.bits_left -= bnum as i64;
+            return Ok(0);
+        }
+        self.bits_left =
+            (self.data.len() as i64 - self.pos as i64 - 1) * 8 + self.bpos as i64 - bnum as i64;
+        if self.bits_left < 0 {
+            return Ok(0);
+        }
+        if bnum == 0 {
+            return Ok(0);
+        }
+
+        let mut vbit = self.bpos as i32;
+        let mut vpos = self.pos;
+        let mut res = 0u64;
+        let mut remaining_bits = bnum;
+
+        if !(1..=8).contains(&vbit) {
+            fatal!(cause = ExitCause::Bug; "In next_bits: Illegal bit position value {}!", vbit);
+        }
+
+        loop {
+            if vpos >= self.data.len() {
+                fatal!(cause = ExitCause::Bug; "In next_bits: Trying to read after end of data ...");
+            }
+            res |= if self.data[vpos] & (0x01 << (vbit - 1)) != 0 {
+                1
+            } else {
+                0
+            };
+            vbit -= 1;
+            remaining_bits -= 1;
+            if vbit == 0 {
+                vpos += 1;
+                vbit = 8;
+            }
+            if remaining_bits != 0 {
+                res <<= 1;
+            } else {
+                break;
+            }
+        }
+
+        self._i_bpos = vbit as u8;
+        self._i_pos = vpos;
+        Ok(res)
+    }
+
+    fn read_bits(&mut self, bnum: u32) -> Result<u64, BitstreamError> {
+        let res = self.next_bits(bnum)?;
+        if bnum == 0 || self.bits_left < 0 {
+            return Ok(0);
+        }
+        self.bpos = self._i_bpos;
+        self.pos = self._i_pos;
+        Ok(res)
+    }
+
+    fn read_exp_golomb_unsigned(&mut self) -> Result<u64, BitstreamError> {
+        let mut zeros = 0;
+        while self.read_bits(1)? == 0 && self.bits_left >= 0 {
+            zeros += 1;
+        }
+        let remaining_bits = self.read_bits(zeros)?;
+        Ok(((1u64 << zeros) - 1) + remaining_bits)
+    }
+}
+
+trait HeaderReader {
+    fn bits(&mut self, n: u32) -> u64;
+    fn ue(&mut self) -> u64;
+}
+
+impl HeaderReader for BitwiseReader<'_> {
+    fn bits(&mut self, n: u32) -> u64 {
+        self.read_bits(n).unwrap_or(0)
+    }
+
+    fn ue(&mut self) -> u64 {
+        self.read_exp_golomb_unsigned().unwrap_or(0)
+    }
+}
+
+impl HeaderReader for BitStreamRust<'_> {
+    fn bits(&mut self, n: u32) -> u64 {
+        self.read_bits(n).unwrap_or(0)
+    }
+
+    fn ue(&mut self) -> u64 {
+        self.read_exp_golomb_unsigned().unwrap_or(0)
+    }
+}
+
+fn parse_sps<R: HeaderReader>(r: &mut R) -> u64 {
+    let mut acc = r.bits(8) + r.bits(8) + r.bits(8); // profile, constraints, level
+    acc += r.ue(); // seq_parameter_set_id
+    acc += r.ue() + r.ue() + r.ue(); // chroma_format_idc, bit depths
+    acc += r.bits(1) + r.bits(1); // qpprime_y_zero_transform_bypass, seq_scaling_matrix_present
+    acc += r.ue(); // log2_max_frame_num_minus4
+    acc += r.ue(); // pic_order_cnt_type
+    acc += r.ue(); // log2_max_pic_order_cnt_lsb_minus4
+    acc += r.ue() + r.bits(1); // max_num_ref_frames, gaps_in_frame_num_allowed
+    acc += r.ue() + r.ue(); // pic_width_in_mbs_minus1, pic_height_in_map_units_minus1
+    acc += r.bits(1) + r.bits(1) + r.bits(1) + r.bits(1); // frame_mbs_only .. frame_cropping
+    acc + r.bits(1) // vui_parameters_present
+}
+
+fn parse_slice_header<R: HeaderReader>(r: &mut R) -> u64 {
+    let mut acc = r.ue() + r.ue() + r.ue(); // first_mb_in_slice, slice_type, pic_parameter_set_id
+    acc += r.bits(4); // frame_num
+    acc += r.bits(1) + r.bits(1); // field_pic_flag, bottom_field_flag
+    acc += r.ue(); // idr_pic_id
+    acc += r.bits(8); // pic_order_cnt_lsb
+    acc + r.ue() // dec_ref_pic_marking / slice_qp_delta
+}
+
+fn parse_mpeg2_picture<R: HeaderReader>(r: &mut R) -> u64 {
+    let mut acc = r.bits(10) + r.bits(3) + r.bits(16); // temporal_reference, coding type, vbv_delay
+    acc += r.bits(3) + r.bits(32); // stuffing up to the extension start code
+    acc += r.bits(4); // extension_start_code_identifier
+    for _ in 0..4 {
+        acc += r.bits(4); // f_code[s][t]
+    }
+    acc += r.bits(2) + r.bits(2); // intra_dc_precision, picture_structure
+    for _ in 0..10 {
+        acc += r.bits(1); // top_field_first .. composite_display_flag
+    }
+    acc
+}
+
+/// Best of several rounds, to keep scheduler noise out of the comparison.
+fn run<F: FnMut() -> u64>(name: &str, iterations: u32, mut f: F) -> Duration {
+    const ROUNDS: u32 = 7;
+    let mut best = Duration::MAX;
+    let mut acc = 0u64;
+    for _ in 0..ROUNDS {
+        let start = Instant::now();
+        for _ in 0..iterations {
+            acc = acc.wrapping_add(f());
+        }
+        best = best.min(start.elapsed());
+    }
+    black_box(acc);
+    println!(
+        "{:<32} {:>8.1} ns/header",
+        name,
+        best.as_nanos() as f64 / iterations as f64
+    );
+    best
+}
+
+fn bench(
+    name: &str,
+    data: &'static [u8],
+    parse_bitwise: fn(&mut BitwiseReader<'static>) -> u64,
+    parse_word: fn(&mut BitStreamRust<'static>) -> u64,
+) {
+    const ITERATIONS: u32 = 500_000;
+
+    let bitwise = run(&format!("{name} (bitwise)"), ITERATIONS, || {
+        let mut r = BitwiseReader::new(black_box(data));
+        parse_bitwise(&mut r)
+    });
+    let word = run(&format!("{name} (reservoir)"), ITERATIONS, || {
+        let mut r = BitStreamRust::new(black_box(data)).unwrap();
+        parse_word(&mut r)
+    });
+    println!(
+        "{:<32} {:>8.2}x\n",
+        "speedup",
+        bitwise.as_secs_f64() / word.as_secs_f64()
+    );
+}
+
+fn main() {
+    bench("H.264 SPS", H264_SPS, parse_sps, parse_sps);
+    bench(
+        "H.264 slice header",
+        H264_SLICE,
+        parse_slice_header,
+        parse_slice_header,
+    );
+    bench(
+        "MPEG-2 picture header",
+        MPEG2_PICTURE,
+        parse_mpeg2_picture,
+        parse_mpeg2_picture,
+    );
+}
@@ -48,7 +48,37 @@ impl<'a> BitStreamRust<'a> {
         })
     }
 
+    /// Return bits `skip..skip + bnum` counted from the MSB of the byte at `pos`.
+    /// The caller guarantees those bits exist, `skip` < 8 and 1 <= `bnum` <= 64.
+    #[inline]
+    fn peek_from(&self, pos: usize, skip: u32, bnum: u32) -> u64 {
+        let total = skip + bnum;
+        if total > 64 {
+            // Up to 7 + 64 bits: spans 9 bytes
+            let mut w = 0u128;
+            for (i, &b) in self.data[pos..pos + 9].iter().enumerate() {
+                w |= (b as u128) << (120 - 8 * i);
+            }
+            return ((w << skip) >> (128 - bnum)) as u64;
+        }
+        let w = match self.data.get(pos..pos + 8) {
+            Some(bytes) => u64::from_be_bytes(bytes.try_into().unwrap()),
+            None => {
+                let mut w = 0u64;
+                for (i, &b) in self.data[pos..pos + total.div_ceil(8) as usize]
+                    .iter()
+                    .enumerate()
+                {
+                    w |= (b as u64) << (56 - 8 * i);
+                }
+                w
+            }
+        };
+        (w << skip) >> (64 - bnum)
+    }
+
     /// Peek at next `bnum` bits without advancing. MSB first.
+    #[inline]
     pub fn next_bits(&mut self, bnum: u32) -> Result<u64, BitstreamError> {
         if bnum > 64 {
             fatal!(cause = ExitCause::Bug; "In next_bits: Argument is greater than the maximum bit number i.e. 64: {}!", bnum);
@@ -76,40 +106,19 @@ impl<'a> BitStreamRust<'a> {
             return Ok(0);
         }
 
-        let mut vbit = self.bpos as i32;
-        let mut vpos = self.pos;
-        let mut res = 0u64;
-        let mut remaining_bits = bnum;
-
+        let vbit = self.bpos as u32;
         if !(1..=8).contains(&vbit) {
             fatal!(cause = ExitCause::Bug; "In next_bits: Illegal bit position value {}!", vbit);
         }
 
-        loop {
-            if vpos >= self.data.len() {
-                // We should not get here ...
-                fatal!(cause = ExitCause::Bug; "In next_bits: Trying to read after end of data ...");
-            }
+        // Extract the whole field with shifts from a big-endian word loaded
+        // at the current byte instead of walking it bit by bit.
+        let skip = 8 - vbit;
+        let total = skip + bnum;
+        let res = self.peek_from(self.pos, skip, bnum);
 
-            res |= if self.data[vpos] & (0x01 << (vbit - 1)) != 0 {
-                1
-            } else {
-                0
-            };
-            vbit -= 1;
-            remaining_bits -= 1;
-
-            if vbit == 0 {
-                vpos += 1;
-                vbit = 8;
-            }
-
-            if remaining_bits != 0 {
-                res <<= 1;
-            } else {
-                break;
-            }
-        }
+        let vpos = self.pos + (total / 8) as usize;
+        let vbit = 8 - total % 8;
 
         // Remember the bitstream position
         self._i_bpos = vbit as u8;
@@ -118,6 +127,7 @@ impl<'a> BitStreamRust<'a> {
         Ok(res)
     }
     /// Read and commit `bnum` bits. On underflow or zero, returns 0.
+    #[inline]
     pub fn read_bits(&mut self, bnum: u32) -> Result<u64, BitstreamError> {
         let res = self.next_bits(bnum)?;
 
@@ -284,9 +294,29 @@ impl<'a> BitStreamRust<'a> {
     }
 
     /// Read unsigned Exp-Golomb code from bitstream
+    #[inline]
     pub fn read_exp_golomb_unsigned(&mut self) -> Result<u64, BitstreamError> {
         let mut zeros = 0;
 
+        // Decode codes of up to 32 bits with one peek and a leading-zero count;
+        // longer prefixes and codes running into the end of the data take the
+        // bit-by-bit path below.
+        let avail = (self.data.len() as i64 - self.pos as i64 - 1) * 8 + self.bpos as i64;
+        if self.bits_left > 0 && avail > 0 && (1..=8).contains(&self.bpos) {
+            let n = avail.min(32) as u32;
+            let peek = self.peek_from(self.pos, 8 - self.bpos as u32, n) as u32;
+            let len = 2 * (peek.leading_zeros() - (32 - n)) + 1;
+            if len <= n {
+                let total = 8 - self.bpos as u32 + len;
+                self.pos += (total / 8) as usize;
+                self.bpos = (8 - total % 8) as u8;
+                self._i_pos = self.pos;
+                self._i_bpos = self.bpos;
+                self.bits_left = avail - len as i64;
+                return Ok((peek >> (n - len)) as u64 - 1);
+            }
+        }
+
         // Count leading zeros
         while self.read_bits(1)? == 0 && self.bits_left >= 0 {
             zeros += 1;
@@ -586,4 +616,40 @@ mod tests {
         bs.next_bits(5).unwrap();
         assert_eq!(bs.bits_left, 19);
     }
+
+    #[test]
+    fn test_unaligned_64_bit_read() {
+        // 9 bytes: a 64-bit field starting 3 bits into the first byte
+        let data = [0xE1, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0xA0];
+        let mut bs = BitStreamRust::new(&data).unwrap();
+
+        assert_eq!(bs.read_bits(3).unwrap(), 0b111);
+        assert_eq!(bs.read_bits(64).unwrap(), 0x091A_2B3C_4D5E_6F7D);
+        assert_eq!((bs.pos, bs.bpos), (8, 5));
+        assert_eq!(bs.bits_left, 5);
+    }
+
+    #[test]
+    fn test_exp_golomb_codes() {
+        // 1 | 010 | 011 | 00100 | 0000001000000 -> 0, 1, 2, 3, 63
+        let data = [0b1010_0110, 0b0100_0000, 0b0010_0000, 0b0000_0000];
+        let mut bs = BitStreamRust::new(&data).unwrap();
+
+        assert_eq!(bs.read_exp_golomb_unsigned().unwrap(), 0);
+        assert_eq!(bs.read_exp_golomb_unsigned().unwrap(), 1);
+        assert_eq!(bs.read_exp_golomb_unsigned().unwrap(), 2);
+        assert_eq!(bs.read_exp_golomb_unsigned().unwrap(), 3);
+        assert_eq!(bs.read_exp_golomb_unsigned().unwrap(), 63);
+        assert_eq!(bs.bits_left, 7);
+    }
+
+    #[test]
+    fn test_exp_golomb_past_end() {
+        // The prefix runs off the end of the data: same result as bit-by-bit
+        let data = [0x00];
+        let mut bs = BitStreamRust::new(&data).unwrap();
+
+        assert_eq!(bs.read_exp_golomb_unsigned().unwrap(), 0xFF);
+        assert!(bs.bits_left < 0);
+    }
 }
@@ -4,6 +4,10 @@ use strum_macros::{EnumString, FromRepr};
 
 pub const DTVCC_MAX_SERVICES: usize = 63;
 
+/// Output formats that can be written besides the first one in a single run.
+/// Same as `CCX_MAX_EXTRA_WRITE_FORMATS` in C.
+pub const MAX_EXTRA_WRITE_FORMATS: usize = 8;
+
 /// An enum of all the available formats for the subtitle output.
 #[derive(Default, Copy, Clone, Debug, PartialEq, Eq)]
 pub enum OutputFormat {
@@ -5,7 +5,7 @@ use std::path::PathBuf;
 use crate::common::{
     DataSource, Language, OutputFormat, SelectCodec, StreamMode, StreamType, DTVCC_MAX_SERVICES,
 };
-use crate::hardsubx::{ColorHue, OcrMode};
+use crate::hardsubx::{ColorHue, OcrMode, SamplingMode};
 use crate::time::units::{Timestamp, TimestampFormat};
 use crate::util::encoding::Encoding;
 use crate::util::log::{DebugMessageFlag, DebugMessageMask, OutputTarget};
@@ -218,6 +218,7 @@ impl Default for EncoderConfig {
             gui_mode_reports: false,
             output_filename: String::default(),
             write_format: OutputFormat::default(),
+            extra_write_formats: Vec::new(),
             keep_output_closed: false,
             force_flush: false,
             append_mode: false,
@@ -252,6 +253,8 @@ impl Default for EncoderConfig {
             subs_delay: Timestamp::default(),
             program_number: 0,
             in_format: 1,
+            rcwt_index: false,
+            rcwt_compress: false,
             nospupngocr: false,
             force_dropframe: false,
             render_font: PathBuf::default(),
@@ -273,6 +276,8 @@ pub struct EncoderConfig {
     pub gui_mode_reports: bool,
     pub output_filename: String,
     pub write_format: OutputFormat,
+    /// Formats written besides `write_format` from the same decoded captions
+    pub extra_write_formats: Vec<OutputFormat>,
     pub keep_output_closed: bool,
     /// Force flush on content write
     pub force_flush: bool,
@@ -331,6 +336,10 @@ pub struct EncoderConfig {
     pub subs_delay: Timestamp,
     pub program_number: u32,
     pub in_format: u8,
+    /// Write RCWT in indexed chunks (--rcwt-index)
+    pub rcwt_index: bool,
+    /// zlib compress those chunks (--rcwt-compress)
+    pub rcwt_compress: bool,
     // true if we don't want to OCR bitmaps to add the text as comments in the XML file in spupng
     pub nospupngocr: bool,
 
@@ -470,11 +479,17 @@ pub struct Options {
     pub ocr_line_split: bool,
     /// If true, use character blacklist to prevent common OCR errors (e.g. | vs I)
     pub ocr_blacklist: bool,
+    /// Number of Tesseract instances running OCR in parallel
+    pub ocr_threads: u32,
+    /// File keeping OCR results between runs, keyed by bitmap hash
+    pub ocr_cache_file: Option<String>,
     /// Language filter for MKV subtitle tracks.
     /// Accepts comma-separated ISO 639-2 codes (e.g., "eng,fre") or BCP 47 tags (e.g., "en-US,fr-CA").
     pub mkvlang: Option<super::MkvLangFilter>,
     /// If true, the video stream will be processed even if we're using a different one for subtitles.
     pub analyze_video_stream: bool,
+    /// If true, stop scanning an H.264 PES packet after its first slice header.
+    pub fast_avc_scan: bool,
 
     /*HardsubX related stuff*/
     pub hardsubx_ocr_mode: OcrMode,
@@ -483,6 +498,11 @@ pub struct Options {
     pub hardsubx_conf_thresh: f64,
     pub hardsubx_hue: ColorHue,
     pub hardsubx_lum_thresh: f64,
+    /// Percentage of the frame height, from the bottom, searched for subtitles
+    pub hardsubx_sub_band: u32,
+    /// Which frames are decoded for OCR
+    pub hardsubx_sampling: SamplingMode,
+    pub hardsubx_sample_interval: Timestamp,
 
     /// Keeps the settings for generating transcript output files.
     pub transcript_settings: EncodersTranscriptFormat,
@@ -501,6 +521,8 @@ pub struct Options {
     pub tcpport: Option<u16>,
     pub tcp_password: Option<String>,
     pub tcp_desc: Option<String>,
+    /// More than 1: serve that many --sendto senders at once, each to its own file
+    pub tcp_senders: u32,
     pub srv_addr: Option<String>,
     pub srv_port: Option<u16>,
     /// Do NOT set time automatically?
@@ -512,6 +534,8 @@ pub struct Options {
 
     /// List of files to process
     pub inputfile: Option<Vec<String>>,
+    /// How many input files to process at the same time (--jobs)
+    pub jobs: u32,
     pub demux_cfg: DemuxerConfig,
     pub enc_cfg: EncoderConfig,
     /// ms to delay (or advance) subs
@@ -534,6 +558,9 @@ pub struct Options {
 
     #[cfg(feature = "with_libcurl")]
     pub curlposturl: Option<Url>,
+    /// Most cues sent per request with out=curl (--curlbatch)
+    #[cfg(feature = "with_libcurl")]
+    pub curl_batch: u32,
 }
 
 impl Default for Options {
@@ -597,14 +624,20 @@ impl Default for Options {
             ocr_quantmode: 0, // No quantization - better OCR accuracy for DVB subtitles
             ocr_line_split: false, // Don't split images into lines by default
             ocr_blacklist: true, // Use character blacklist by default to prevent | vs I errors
+            ocr_threads: 1,
+            ocr_cache_file: Default::default(),
             mkvlang: Default::default(),
             analyze_video_stream: Default::default(),
+            fast_avc_scan: Default::default(),
             hardsubx_ocr_mode: Default::default(),
             hardsubx_min_sub_duration: Timestamp::from_millis(500),
             hardsubx_detect_italics: Default::default(),
             hardsubx_conf_thresh: Default::default(),
             hardsubx_hue: Default::default(),
             hardsubx_lum_thresh: 95.0,
+            hardsubx_sub_band: 25,
+            hardsubx_sampling: Default::default(),
+            hardsubx_sample_interval: Timestamp::from_millis(1000),
             transcript_settings: Default::default(),
             date_format: Default::default(),
             send_to_srv: Default::default(),
@@ -618,12 +651,14 @@ impl Default for Options {
             tcpport: Default::default(),
             tcp_password: Default::default(),
             tcp_desc: Default::default(),
+            tcp_senders: 1,
             srv_addr: Default::default(),
             srv_port: Default::default(),
             noautotimeref: Default::default(),
             input_source: DataSource::default(),
             output_filename: Default::default(),
             inputfile: Default::default(),
+            jobs: 1,
             demux_cfg: Default::default(),
             enc_cfg: Default::default(),
             subs_delay: Default::default(),
@@ -641,6 +676,8 @@ impl Default for Options {
                 DebugMessageFlag::VERBOSE,
             ),
             curlposturl: Default::default(),
+            #[cfg(feature = "with_libcurl")]
+            curl_batch: 1,
         }
     }
 }
@@ -6,6 +6,20 @@ pub enum OcrMode {
     Letter = 2,
 }
 
+/// Which frames the burned-in subtitle extractor decodes.
+#[derive(Default, Debug, Clone, Copy, PartialEq, Eq)]
+pub enum SamplingMode {
+    /// Decode every frame, OCR one in 25.
+    #[default]
+    Every = 0,
+    /// Let the decoder skip non-reference frames, or non-keyframes.
+    Skip = 1,
+    /// Like `Skip`, seeking over long gaps between samples.
+    Seek = 2,
+    /// Like `Seek`, sampling densely where the subtitle text changes.
+    Adaptive = 3,
+}
+
 #[derive(Default, Debug, Clone, Copy)]
 pub enum ColorHue {
     #[default]
@@ -78,6 +78,8 @@ Notes on times:
   generate a .srt file, with only data from 3:00 to 5:00 in the input file(s)
   and then add that (huge) delay, which would make the final file start at
   5:00 and end at 7:00.
+  On a single TS, PS or MP4 file, the input up to 15 seconds before --startat
+  is skipped rather than decoded, and reading stops 15 seconds after --endat.
 
 Notes on codec options:
   If codec type is not selected then first elementary stream suitable for 
@@ -202,6 +204,14 @@ pub struct Args {
     /// captions e.g. channel name or file name
     #[arg(long, value_name="port", verbatim_doc_comment, help_heading=NETWORK_SUPPORT)]
     pub tcp_description: Option<String>,
+    /// With --tcp, serves up to n --sendto senders at once
+    /// instead of one, writing the captions of each to
+    /// its own file. Senders are told apart in the file
+    /// names by their --tcp-description, or else by the
+    /// order they connected in; a sender with a description
+    /// that reconnects continues its file. Stop with SIGTERM.
+    #[arg(long, value_name="n", verbatim_doc_comment, help_heading=NETWORK_SUPPORT)]
+    pub tcp_senders: Option<u32>,
     /// Values: 1 = Output Field 1
     ///         2 = Output Field 2
     ///         both = Both Output Field 1 and 2
@@ -250,8 +260,10 @@ pub struct Args {
     pub mkv: bool,
     #[arg(long, hide = true)]
     pub dvr_ms: bool,
-    #[arg(long, value_name="format", help_heading=OUTPUT_FORMATS)]
-    pub out: Option<OutFormat>,
+    /// Output format. A comma separated list (e.g. srt,webvtt,scc) writes
+    /// each of the formats from a single pass over the input.
+    #[arg(long, value_name="format", value_delimiter=',', help_heading=OUTPUT_FORMATS)]
+    pub out: Option<Vec<OutFormat>>,
 
     /// Format for -out=report output (e.g. json)
     #[arg(long = "report-format", value_name = "FORMAT", help_heading=OUTPUT_FORMATS)]
@@ -371,6 +383,14 @@ pub struct Args {
     /// Uses multiple programs from the same input stream.
     #[arg(long, verbatim_doc_comment, help_heading=OPTIONS_AFFECTING_INPUT_FILES)]
     pub multiprogram: bool,
+    /// Process up to N input files at the same time, each
+    /// one independently with its own output files.
+    /// With --multiprogram and one transport stream, demux
+    /// it once and decode its programs in N worker
+    /// processes instead. Not supported on Windows, where
+    /// everything runs one after another.
+    #[arg(long, value_name="N", verbatim_doc_comment, help_heading=OPTIONS_AFFECTING_INPUT_FILES)]
+    pub jobs: Option<u32>,
     /// List all tracks found in the input file and exit without
     /// processing. Useful for exploring media files before extraction.
     #[arg(long = "list-tracks", short = 'L', verbatim_doc_comment, help_heading=OPTIONS_AFFECTING_INPUT_FILES)]
@@ -428,6 +448,14 @@ pub struct Args {
     /// subtitles. This allows to provide video information.
     #[arg(long, verbatim_doc_comment, help_heading=OPTIONS_AFFECTING_INPUT_FILES)]
     pub analyzevideo: bool,
+    /// Assume each H.264 PES packet holds a single access unit
+    /// and stop scanning it after the first slice header,
+    /// instead of searching every slice for start codes.
+    /// Saves CPU on high-bitrate sources, but captions in
+    /// packets carrying several pictures would be missed.
+    /// Ignored for elementary stream input.
+    #[arg(long, verbatim_doc_comment, help_heading=OPTIONS_AFFECTING_INPUT_FILES)]
+    pub fast_avc_scan: bool,
     /// Enable the X-TIMESTAMP-MAP header for WebVTT (HLS)
     #[arg(long, verbatim_doc_comment, help_heading=OPTIONS_AFFECTING_INPUT_FILES)]
     pub timestamp_map: bool,
@@ -571,6 +599,14 @@ pub struct Args {
     /// For MCC Files, force dropframe frame count.
     #[arg(long, verbatim_doc_comment, help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
     pub df: bool,
+    /// With -out=bin, write the captions in chunks with a time
+    /// index, so --startat can seek straight to them when
+    /// the file is read back.
+    #[arg(long, verbatim_doc_comment, help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
+    pub rcwt_index: bool,
+    /// Like --rcwt-index, and zlib compress the chunks.
+    #[arg(long, verbatim_doc_comment, help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
+    pub rcwt_compress: bool,
     /// Based on position on screen, attempt to determine
     /// the different speakers and a dash (-) when each
     /// of them talks (.srt/.vtt only, --trim required).
@@ -658,6 +694,22 @@ pub struct Args {
     /// Use this flag to disable the blacklist.
     #[arg(long, verbatim_doc_comment, help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
     pub no_ocr_blacklist: bool,
+    /// Run OCR on n threads, each with its own Tesseract
+    /// instance, while decoding continues. Used for VOBSUB
+    /// tracks in MP4/MKV files and for --hardsubx (except
+    /// with --sampling adaptive).
+    /// Default is 1 (OCR on the decoding thread).
+    #[arg(long = "ocr-threads", verbatim_doc_comment, value_name="n", help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
+    pub ocr_threads: Option<u32>,
+    /// Keep OCR results in this file between runs.
+    /// Subtitle bitmaps already recognized by an earlier
+    /// run with the same OCR settings (e.g. over the same
+    /// channel) are not passed to Tesseract again. Within
+    /// a run, repeated bitmaps are always recognized once.
+    /// At most 10000 results are kept, in memory and in
+    /// the file; the least recently used go first.
+    #[arg(long = "ocr-cache", verbatim_doc_comment, value_name="file", help_heading=OUTPUT_AFFECTING_OUTPUT_FILES)]
+    pub ocr_cache: Option<String>,
     /// For MKV subtitles, select which language's caption
     /// stream will be processed. e.g. 'eng' for English.
     /// Language codes can be either the 3 letters bibliographic
@@ -967,6 +1019,33 @@ pub struct Args {
     /// The default value is 95
     #[arg(long = "whiteness-thresh", verbatim_doc_comment, value_name="threshold", help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
     pub whiteness_thresh: Option<f32>,
+    /// Height of the band at the bottom of the frame that
+    /// is searched for subtitles, as a percentage of the
+    /// frame height. Only this band is color converted.
+    /// The default value is 25
+    /// e.g. --sub-band 40
+    #[arg(long = "sub-band", verbatim_doc_comment, value_name="percent", help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
+    pub sub_band: Option<u32>,
+    /// Choose which frames are decoded for OCR:
+    /// every (default): decode every frame and OCR one
+    /// frame in 25.
+    /// skip: have the decoder skip non-reference frames,
+    /// or all but keyframes when the sample interval is
+    /// at least the keyframe interval.
+    /// seek: like skip, but seek to the next sample when
+    /// it is more than a keyframe interval away.
+    /// adaptive: like seek, and sample every
+    /// --min-sub-duration between two samples whose text
+    /// differs, to find where the subtitle changed.
+    /// Not used with --tickertext or --hcc.
+    /// e.g. --sampling adaptive
+    #[arg(long, verbatim_doc_comment, value_name="mode", help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
+    pub sampling: Option<String>,
+    /// Seconds between sampled frames, for all --sampling
+    /// modes but every. The default value is 1.0
+    /// e.g. --sample-interval 2.5
+    #[arg(long = "sample-interval", verbatim_doc_comment, value_name="seconds", help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
+    pub sample_interval: Option<f32>,
     /// This option will be used if the file should have both
     /// closed captions and burned in subtitles
     #[arg(long, verbatim_doc_comment, help_heading=BURNEDIN_SUBTITLE_EXTRACTION)]
@@ -974,6 +1053,9 @@ pub struct Args {
     #[cfg(feature = "with_libcurl")]
     #[arg(long, hide = true)]
     pub curlposturl: Option<String>,
+    #[cfg(feature = "with_libcurl")]
+    #[arg(long, hide = true)]
+    pub curlbatch: Option<u32>,
 }
 
 #[derive(Debug, Copy, Clone, PartialEq, Eq, PartialOrd, Ord, ValueEnum)]
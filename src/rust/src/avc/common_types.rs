@@ -10,6 +10,7 @@ pub struct AvcContextRust {
     pub cc_buffer_saved: bool,
 
     pub is_hevc: bool,
+    pub fast_scan: bool,
     pub got_seq_para: bool,
     pub nal_ref_idc: u32,
     pub seq_parameter_set_id: i64,
@@ -57,6 +58,7 @@ impl Default for AvcContextRust {
             cc_buffer_saved: true,
 
             is_hevc: false,
+            fast_scan: false,
             got_seq_para: false,
             nal_ref_idc: 0,
             seq_parameter_set_id: 0,
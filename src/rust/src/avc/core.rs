@@ -1,7 +1,9 @@
 use crate::avc::common_types::*;
 use crate::avc::nal::*;
 use crate::avc::sei::*;
-use crate::bindings::{cc_subtitle, encoder_ctx, lib_cc_decode, realloc};
+use crate::bindings::{
+    cc_subtitle, encoder_ctx, lib_cc_decode, realloc, AVC_SLICE_HEADER_MAX_BYTES,
+};
 use crate::ctorust::FromCType;
 use crate::libccxr_exports::time::ccxr_set_fts;
 use crate::{anchor_hdcc, current_fps, process_hdcc, store_hdcc, MPEG_CLOCK_FREQ};
@@ -64,13 +66,63 @@ fn is_hevc_vcl_nal(nal_type: u8) -> bool {
     nal_type <= 21
 }
 
+/// Upper bound on the escaped bytes of a slice NAL that `slice_header` can
+/// consume; it stops after pic_order_cnt_lsb, which is well inside this.
+/// Shared with the C do_NAL() through avc_functions.h.
+const SLICE_HEADER_MAX_BYTES: usize = AVC_SLICE_HEADER_MAX_BYTES as usize;
+
+thread_local! {
+    static NAL_SCRATCH: std::cell::Cell<Vec<u8>> = const { std::cell::Cell::new(Vec::new()) };
+}
+
+/// RBSP scratch buffer reused across NAL units, so that unescaping a NAL
+/// does not allocate once the buffer has grown to the largest SEI/SPS seen.
+/// It is handed back to the thread-local slot when dropped.
+struct NalScratch(Vec<u8>);
+
+impl NalScratch {
+    fn take() -> Self {
+        NalScratch(NAL_SCRATCH.with(|s| s.take()))
+    }
+}
+
+impl Drop for NalScratch {
+    fn drop(&mut self) {
+        let buf = std::mem::take(&mut self.0);
+        NAL_SCRATCH.with(|s| s.set(buf));
+    }
+}
+
+impl std::ops::Deref for NalScratch {
+    type Target = Vec<u8>;
+    fn deref(&self) -> &Vec<u8> {
+        &self.0
+    }
+}
+
+impl std::ops::DerefMut for NalScratch {
+    fn deref_mut(&mut self) -> &mut Vec<u8> {
+        &mut self.0
+    }
+}
+
+/// Copy `payload` into `rbsp` and strip its emulation prevention bytes.
+/// Returns the RBSP length, or None if the payload is not a valid EBSP.
+fn load_rbsp(rbsp: &mut Vec<u8>, payload: &[u8]) -> Option<usize> {
+    rbsp.clear();
+    rbsp.extend_from_slice(payload);
+    let len = remove_03emu(rbsp)?;
+    rbsp.truncate(len);
+    Some(len)
+}
+
 /// Process NAL unit data
 /// # Safety
 /// This function is unsafe because it processes raw NAL data
 pub unsafe fn do_nal(
     enc_ctx: &mut encoder_ctx,
     dec_ctx: &mut lib_cc_decode,
-    nal_start: &mut [u8],
+    nal_start: &[u8],
     nal_length: i64,
     sub: &mut cc_subtitle,
 ) -> Result<(), Box<dyn std::error::Error>> {
@@ -101,30 +153,53 @@ pub unsafe fn do_nal(
         return Ok(());
     }
 
-    // Get the working slice (skip header bytes for remove_03emu)
     if original_length <= nal_header_size {
         return Ok(());
     }
-    let mut working_buffer = nal_start[nal_header_size..original_length].to_vec();
+    let payload = &nal_start[nal_header_size..original_length];
 
-    let processed_length = match remove_03emu(&mut working_buffer) {
-        Some(len) => len,
-        None => {
+    // Only the NAL types that are actually parsed need their emulation
+    // prevention bytes removed, and slices are only parsed up to the end of
+    // the slice header, so everything else is left in the caller's buffer.
+    let got_seq_para = (*dec_ctx.avc_ctx).got_seq_para != 0;
+    let rbsp_limit = if is_hevc {
+        match nal_unit_type_raw {
+            HEVC_NAL_PREFIX_SEI | HEVC_NAL_SUFFIX_SEI if got_seq_para => Some(payload.len()),
+            _ => None,
+        }
+    } else {
+        match nal_unit_type {
+            AvcNalType::SequenceParameterSet7 => Some(payload.len()),
+            AvcNalType::Sei if got_seq_para => Some(payload.len()),
+            AvcNalType::CodedSliceNonIdrPicture1 | AvcNalType::CodedSliceIdrPicture
+                if got_seq_para =>
+            {
+                Some(payload.len().min(SLICE_HEADER_MAX_BYTES))
+            }
+            _ => None,
+        }
+    };
+
+    let mut working_buffer = NalScratch::take();
+    if let Some(limit) = rbsp_limit {
+        if load_rbsp(&mut working_buffer, &payload[..limit]).is_none() {
             info!(
                 "Notice: NAL of type {} had to be skipped because remove_03emu failed. (HEVC: {})",
                 nal_unit_type_raw, is_hevc
             );
             return Ok(());
         }
+    }
+    let rbsp_length = if rbsp_limit.is_some() {
+        working_buffer.len()
+    } else {
+        payload.len()
     };
 
-    // Truncate buffer to actual processed length
-    working_buffer.truncate(processed_length);
-
     debug!(msg_type = DebugMessageFlag::VIDEO_STREAM;
         "BEGIN NAL unit type: {} length {} ref_idc: {} - Buffered captions before: {} (HEVC: {})",
         nal_unit_type_raw,
-        working_buffer.len(),
+        rbsp_length,
         (*dec_ctx.avc_ctx).nal_ref_idc,
         if (*dec_ctx.avc_ctx).cc_buffer_saved != 0 { 0 } else { 1 },
         is_hevc
@@ -334,7 +409,7 @@ pub unsafe fn do_nal(
     debug!(msg_type = DebugMessageFlag::VIDEO_STREAM;
         "END   NAL unit type: {} length {} ref_idc: {} - Buffered captions after: {}",
         nal_unit_type_raw,
-        working_buffer.len(),
+        rbsp_length,
         (*dec_ctx.avc_ctx).nal_ref_idc,
         if (*dec_ctx.avc_ctx).cc_buffer_saved != 0 { 0 } else { 1 }
     );
@@ -515,35 +590,95 @@ pub enum AvcError {
     ForbiddenZeroBit(String),
     Other(String),
 }
+/// Find the first `0x00 0x00` pair in `slice`, returning the offset of its
+/// first byte. Inside a NAL unit such a pair only occurs in front of an
+/// emulation prevention byte, so this skips over the many lone zero bytes
+/// of slice data that a plain zero search would stop at.
 #[cfg(any(target_arch = "x86", target_arch = "x86_64"))]
-fn find_next_zero(slice: &[u8]) -> Option<usize> {
+fn find_zero_pair(slice: &[u8]) -> Option<usize> {
+    if is_x86_feature_detected!("avx2") {
+        // SAFETY: AVX2 support was checked just above.
+        unsafe { find_zero_pair_avx2(slice) }
+    } else if is_x86_feature_detected!("sse2") {
+        // SAFETY: SSE2 support was checked just above.
+        unsafe { find_zero_pair_sse2(slice) }
+    } else {
+        find_zero_pair_from(slice, 0)
+    }
+}
+
+#[cfg(not(any(target_arch = "x86", target_arch = "x86_64")))]
+fn find_zero_pair(slice: &[u8]) -> Option<usize> {
+    find_zero_pair_from(slice, 0)
+}
+
+fn find_zero_pair_from(slice: &[u8], start: usize) -> Option<usize> {
+    slice
+        .get(start..)?
+        .windows(2)
+        .position(|w| w[0] == 0x00 && w[1] == 0x00)
+        .map(|pos| start + pos)
+}
+
+#[cfg(any(target_arch = "x86", target_arch = "x86_64"))]
+#[target_feature(enable = "avx2")]
+unsafe fn find_zero_pair_avx2(slice: &[u8]) -> Option<usize> {
     let len = slice.len();
+    let ptr = slice.as_ptr();
+    let zero = _mm256_setzero_si256();
     let mut i = 0;
+    // Compare each byte and its successor with zero; the second load is
+    // offset by one so both stay inside the slice.
+    while i + 33 <= len {
+        let cur = _mm256_loadu_si256(ptr.add(i) as *const __m256i);
+        let next = _mm256_loadu_si256(ptr.add(i + 1) as *const __m256i);
+        let pair = _mm256_and_si256(_mm256_cmpeq_epi8(cur, zero), _mm256_cmpeq_epi8(next, zero));
+        let mask = _mm256_movemask_epi8(pair) as u32;
+        if mask != 0 {
+            return Some(i + mask.trailing_zeros() as usize);
+        }
+        i += 32;
+    }
+    find_zero_pair_from(slice, i)
+}
+
+#[cfg(any(target_arch = "x86", target_arch = "x86_64"))]
+#[target_feature(enable = "sse2")]
+unsafe fn find_zero_pair_sse2(slice: &[u8]) -> Option<usize> {
+    let len = slice.len();
     let ptr = slice.as_ptr();
-    if is_x86_feature_detected!("sse2") {
-        unsafe {
-            let zero = _mm_set1_epi8(0);
-            while i + 16 <= len {
-                let chunk = _mm_loadu_si128(ptr.add(i) as *const __m128i);
-                let cmp = _mm_cmpeq_epi8(chunk, zero);
-                let mask = _mm_movemask_epi8(cmp);
-                if mask != 0 {
-                    return Some(i + mask.trailing_zeros() as usize);
-                }
-                i += 16;
-            }
+    let zero = _mm_setzero_si128();
+    let mut i = 0;
+    while i + 17 <= len {
+        let cur = _mm_loadu_si128(ptr.add(i) as *const __m128i);
+        let next = _mm_loadu_si128(ptr.add(i + 1) as *const __m128i);
+        let pair = _mm_and_si128(_mm_cmpeq_epi8(cur, zero), _mm_cmpeq_epi8(next, zero));
+        let mask = _mm_movemask_epi8(pair) as u32;
+        if mask != 0 {
+            return Some(i + mask.trailing_zeros() as usize);
         }
+        i += 16;
     }
-    slice[i..]
-        .iter()
-        .position(|&b| b == 0x00)
-        .map(|pos| i + pos)
+    find_zero_pair_from(slice, i)
 }
 
-#[cfg(not(any(target_arch = "x86", target_arch = "x86_64")))]
-fn find_next_zero(slice: &[u8]) -> Option<usize> {
-    slice.iter().position(|&b| b == 0x00)
+/// Find where the NAL unit that continues at `from` ends, i.e. the first
+/// `0x00 0x00 0x00` or `0x00 0x00 0x01` at or after `from`.
+fn find_nal_end(buf: &[u8], from: usize) -> Option<usize> {
+    let mut pos = from;
+    while pos + 2 < buf.len() {
+        let zero_pos = pos + find_zero_pair(&buf[pos..buf.len() - 1])?;
+        if zero_pos + 2 >= buf.len() {
+            return None;
+        }
+        if buf[zero_pos + 2] <= 0x01 {
+            return Some(zero_pos);
+        }
+        pos = zero_pos + 1;
+    }
+    None
 }
+
 /// Find the first NAL start code (0x00 0x00 0x01 or 0x00 0x00 0x00 0x01) in a buffer.
 /// Returns the position of the 0x01 byte if found, or None if not found.
 fn find_nal_start_code(buf: &[u8]) -> Option<usize> {
@@ -569,6 +704,27 @@ fn find_nal_start_code(buf: &[u8]) -> Option<usize> {
     None
 }
 
+/// With --fast-avc-scan, each H.264 PES packet is taken to hold a single
+/// access unit, so scanning can stop at its first coded slice: SEI NAL units
+/// must precede the first VCL NAL unit of their access unit.
+///
+/// # Safety
+/// `dec_ctx.avc_ctx` must be a valid pointer.
+unsafe fn stops_access_unit_scan(dec_ctx: &lib_cc_decode, nal_header: Option<&u8>) -> bool {
+    let header = match nal_header {
+        Some(&header) => header,
+        None => return false,
+    };
+    (*dec_ctx.avc_ctx).fast_scan != 0
+        && (*dec_ctx.avc_ctx).is_hevc == 0
+        && (*dec_ctx.avc_ctx).got_seq_para != 0
+        && header & 0x80 == 0
+        && matches!(
+            AvcNalType::from_ctype(header & 0x1F),
+            Some(AvcNalType::CodedSliceNonIdrPicture1 | AvcNalType::CodedSliceIdrPicture)
+        )
+}
+
 /// # Safety
 /// This function is unsafe because it dereferences raw pointers and calls `dump` and `do_nal`.
 pub unsafe fn process_avc(
@@ -653,65 +809,26 @@ pub unsafe fn process_avc(
         }
 
         let nal_start_pos = buffer_position + 1;
-        let mut nal_stop_pos = working_len;
+        let nal_stop_pos;
 
         buffer_position += 1;
-        let restlen = working_len.saturating_sub(buffer_position + 2);
-
-        // Use optimized zero search
-        if restlen > 0 {
-            if let Some(zero_offset) =
-                find_next_zero(&working_buf[buffer_position..buffer_position + restlen])
-            {
-                let zero_pos = buffer_position + zero_offset;
-
-                if zero_pos + 2 < working_len {
-                    if working_buf[zero_pos + 1] == 0x00
-                        && (working_buf[zero_pos + 2] | 0x01) == 0x01
-                    {
-                        nal_stop_pos = zero_pos;
-                        buffer_position = zero_pos + 2;
-                    } else {
-                        // Continue searching from after this zero
-                        buffer_position = zero_pos + 1;
-                        // Recursive search for next start code
-                        while buffer_position < working_len.saturating_sub(2) {
-                            if let Some(next_zero_offset) = find_next_zero(
-                                &working_buf[buffer_position..working_len.saturating_sub(2)],
-                            ) {
-                                let next_zero_pos = buffer_position + next_zero_offset;
-                                if next_zero_pos + 2 < working_len {
-                                    if working_buf[next_zero_pos + 1] == 0x00
-                                        && (working_buf[next_zero_pos + 2] | 0x01) == 0x01
-                                    {
-                                        nal_stop_pos = next_zero_pos;
-                                        buffer_position = next_zero_pos + 2;
-                                        break;
-                                    }
-                                } else {
-                                    nal_stop_pos = working_len;
-                                    buffer_position = working_len;
-                                    break;
-                                }
-                                buffer_position = next_zero_pos + 1;
-                            } else {
-                                nal_stop_pos = working_len;
-                                buffer_position = working_len;
-                                break;
-                            }
-                        }
-                    }
-                } else {
+        if stops_access_unit_scan(dec_ctx, working_buf.get(nal_start_pos)) {
+            // Only the slice header is parsed, and nothing after the first
+            // slice of the access unit carries captions: hand the rest of the
+            // buffer to do_nal without looking for the end of the slice.
+            nal_stop_pos = working_len;
+            buffer_position = working_len;
+        } else {
+            match find_nal_end(working_buf, buffer_position) {
+                Some(zero_pos) => {
+                    nal_stop_pos = zero_pos;
+                    buffer_position = zero_pos + 2;
+                }
+                None => {
                     nal_stop_pos = working_len;
                     buffer_position = working_len;
                 }
-            } else {
-                nal_stop_pos = working_len;
-                buffer_position = working_len;
             }
-        } else {
-            nal_stop_pos = working_len;
-            buffer_position = working_len;
         }
 
         if nal_start_pos >= working_len {
@@ -734,9 +851,9 @@ pub unsafe fn process_avc(
 
         debug!(msg_type = DebugMessageFlag::VIDEO_STREAM; "process_avc: zeropad {}", zeropad);
         let nal_length = (nal_stop_pos - nal_start_pos) as i64;
-        let mut nal_slice = working_buf[nal_start_pos..nal_stop_pos].to_vec();
+        let nal_slice = &working_buf[nal_start_pos..nal_stop_pos];
 
-        if let Err(e) = do_nal(enc_ctx, dec_ctx, &mut nal_slice, nal_length, sub) {
+        if let Err(e) = do_nal(enc_ctx, dec_ctx, nal_slice, nal_length, sub) {
             info!("Error processing NAL unit: {}", e);
         }
     }
@@ -795,4 +912,53 @@ mod tests {
         let buf = [0x00, 0x00, 0x02, 0x00, 0x00, 0x01, 0x65];
         assert_eq!(find_nal_start_code(&buf), Some(5));
     }
+
+    #[test]
+    fn test_load_rbsp_reuses_scratch() {
+        let mut rbsp = NalScratch::take();
+        assert_eq!(
+            load_rbsp(&mut rbsp, &[0x00, 0x00, 0x03, 0x01, 0x42]),
+            Some(4)
+        );
+        assert_eq!(&rbsp[..], &[0x00, 0x00, 0x01, 0x42]);
+        let capacity = rbsp.capacity();
+        drop(rbsp);
+
+        // The buffer comes back with its allocation and stale contents cleared
+        let mut rbsp = NalScratch::take();
+        assert_eq!(rbsp.capacity(), capacity);
+        assert_eq!(load_rbsp(&mut rbsp, &[0x65]), Some(1));
+        assert_eq!(&rbsp[..], &[0x65]);
+
+        // 0x000002 cannot occur in a valid EBSP
+        assert_eq!(load_rbsp(&mut rbsp, &[0x00, 0x00, 0x02]), None);
+    }
+
+    #[test]
+    fn test_find_zero_pair_skips_lone_zeros() {
+        let mut buf = vec![0x5A; 100];
+        for i in (0..90).step_by(3) {
+            buf[i] = 0x00;
+        }
+        buf[95] = 0x00;
+        buf[96] = 0x00;
+        assert_eq!(find_zero_pair(&buf), Some(95));
+        assert_eq!(find_zero_pair(&buf[..96]), None);
+        assert_eq!(find_zero_pair(&[0x00, 0x00]), Some(0));
+    }
+
+    #[test]
+    fn test_find_nal_end() {
+        // Emulation prevention sequence inside the NAL, then a start code
+        let buf = [
+            0x65, 0x88, 0x00, 0x00, 0x03, 0x01, 0x00, 0x42, 0x00, 0x00, 0x01, 0x06,
+        ];
+        assert_eq!(find_nal_end(&buf, 1), Some(8));
+        // Trailing zeros of a 4-byte start code count as the end too
+        let buf = [0x06, 0x05, 0x00, 0x00, 0x00, 0x01];
+        assert_eq!(find_nal_end(&buf, 1), Some(2));
+        // A pair right at the end of the buffer is not a start code
+        let buf = [0x06, 0x05, 0x11, 0x00, 0x00];
+        assert_eq!(find_nal_end(&buf, 1), None);
+    }
 }
@@ -24,10 +24,11 @@ use lib_ccxr::common::OutputFormat;
 use lib_ccxr::common::SelectCodec;
 use lib_ccxr::common::StreamMode;
 use lib_ccxr::common::StreamType;
+use lib_ccxr::common::MAX_EXTRA_WRITE_FORMATS;
 use lib_ccxr::common::{BufferdataType, CommonTimingCtx};
 use lib_ccxr::common::{Codec, DataSource};
 use lib_ccxr::hardsubx::ColorHue;
-use lib_ccxr::hardsubx::OcrMode;
+use lib_ccxr::hardsubx::{OcrMode, SamplingMode};
 use lib_ccxr::teletext::TeletextConfig;
 use lib_ccxr::time::units::Timestamp;
 use lib_ccxr::time::units::TimestampFormat;
@@ -189,18 +190,29 @@ pub unsafe fn copy_from_rust(ccx_s_options: *mut ccx_s_options, options: Options
     (*ccx_s_options).ocr_quantmode = options.ocr_quantmode as _;
     (*ccx_s_options).ocr_line_split = options.ocr_line_split as _;
     (*ccx_s_options).ocr_blacklist = options.ocr_blacklist as _;
+    (*ccx_s_options).ocr_threads = options.ocr_threads as _;
+    if let Some(ref ocr_cache_file) = options.ocr_cache_file {
+        (*ccx_s_options).ocr_cache_file =
+            replace_rust_c_string((*ccx_s_options).ocr_cache_file, ocr_cache_file.as_str());
+    }
     if let Some(ref mkvlang) = options.mkvlang {
         (*ccx_s_options).mkvlang =
             replace_rust_c_string((*ccx_s_options).mkvlang, mkvlang.as_raw_str());
     }
     (*ccx_s_options).analyze_video_stream = options.analyze_video_stream as _;
+    (*ccx_s_options).fast_avc_scan = options.fast_avc_scan as _;
     (*ccx_s_options).hardsubx_ocr_mode = options.hardsubx_ocr_mode.to_ctype();
     (*ccx_s_options).hardsubx_subcolor = options.hardsubx_hue.to_ctype();
-    (*ccx_s_options).hardsubx_min_sub_duration = options.hardsubx_min_sub_duration.seconds() as _;
+    (*ccx_s_options).hardsubx_min_sub_duration =
+        options.hardsubx_min_sub_duration.millis() as f32 / 1000.0;
     (*ccx_s_options).hardsubx_detect_italics = options.hardsubx_detect_italics as _;
     (*ccx_s_options).hardsubx_conf_thresh = options.hardsubx_conf_thresh as _;
     (*ccx_s_options).hardsubx_hue = options.hardsubx_hue.get_hue() as _;
     (*ccx_s_options).hardsubx_lum_thresh = options.hardsubx_lum_thresh as _;
+    (*ccx_s_options).hardsubx_sub_band = options.hardsubx_sub_band as _;
+    (*ccx_s_options).hardsubx_sampling = options.hardsubx_sampling.to_ctype();
+    (*ccx_s_options).hardsubx_sample_interval =
+        options.hardsubx_sample_interval.millis() as f32 / 1000.0;
     (*ccx_s_options).transcript_settings = options.transcript_settings.to_ctype();
     (*ccx_s_options).date_format = options.date_format.to_ctype();
     (*ccx_s_options).write_format_rewritten = options.write_format_rewritten as _;
@@ -233,6 +245,7 @@ pub unsafe fn copy_from_rust(ccx_s_options: *mut ccx_s_options, options: Options
             &options.tcp_desc.clone().unwrap(),
         );
     }
+    (*ccx_s_options).tcp_senders = options.tcp_senders as _;
     if options.srv_addr.is_some() {
         (*ccx_s_options).srv_addr = replace_rust_c_string(
             (*ccx_s_options).srv_addr,
@@ -284,6 +297,7 @@ pub unsafe fn copy_from_rust(ccx_s_options: *mut ccx_s_options, options: Options
     (*ccx_s_options).ignore_pts_jumps = options.ignore_pts_jumps as _;
     (*ccx_s_options).multiprogram = options.multiprogram as _;
     (*ccx_s_options).out_interval = options.out_interval;
+    (*ccx_s_options).jobs = options.jobs as _;
     (*ccx_s_options).segment_on_key_frames_only = options.segment_on_key_frames_only as _;
     (*ccx_s_options).scc_framerate = options.scc_framerate;
     // Also copy to enc_cfg so the encoder uses the same frame rate for SCC output
@@ -297,6 +311,7 @@ pub unsafe fn copy_from_rust(ccx_s_options: *mut ccx_s_options, options: Options
                 options.curlposturl.as_ref().unwrap_or_default().as_str(),
             );
         }
+        (*ccx_s_options).curl_batch = options.curl_batch as _;
     }
 }
 
@@ -437,6 +452,10 @@ pub unsafe fn copy_to_rust(ccx_s_options: *const ccx_s_options) -> Options {
     options.ocr_quantmode = (*ccx_s_options).ocr_quantmode as u8;
     options.ocr_line_split = (*ccx_s_options).ocr_line_split != 0;
     options.ocr_blacklist = (*ccx_s_options).ocr_blacklist != 0;
+    options.ocr_threads = (*ccx_s_options).ocr_threads as u32;
+    if !(*ccx_s_options).ocr_cache_file.is_null() {
+        options.ocr_cache_file = Some(c_char_to_string((*ccx_s_options).ocr_cache_file));
+    }
 
     // Handle mkvlang (C string to Option<MkvLangFilter>)
     if !(*ccx_s_options).mkvlang.is_null() {
@@ -445,15 +464,21 @@ pub unsafe fn copy_to_rust(ccx_s_options: *const ccx_s_options) -> Options {
     }
 
     options.analyze_video_stream = (*ccx_s_options).analyze_video_stream != 0;
+    options.fast_avc_scan = (*ccx_s_options).fast_avc_scan != 0;
     options.hardsubx_ocr_mode =
         OcrMode::from_ctype((*ccx_s_options).hardsubx_ocr_mode).unwrap_or(OcrMode::Frame);
     options.hardsubx_min_sub_duration =
-        Timestamp::from_millis((*ccx_s_options).hardsubx_min_sub_duration as i64);
+        Timestamp::from_millis(((*ccx_s_options).hardsubx_min_sub_duration * 1000.0) as i64);
     options.hardsubx_detect_italics = (*ccx_s_options).hardsubx_detect_italics != 0;
     options.hardsubx_conf_thresh = (*ccx_s_options).hardsubx_conf_thresh as f64;
     options.hardsubx_hue = ColorHue::from_ctype((*ccx_s_options).hardsubx_hue as f64 as c_int)
         .unwrap_or(ColorHue::White);
     options.hardsubx_lum_thresh = (*ccx_s_options).hardsubx_lum_thresh as f64;
+    options.hardsubx_sub_band = (*ccx_s_options).hardsubx_sub_band as u32;
+    options.hardsubx_sampling =
+        SamplingMode::from_ctype((*ccx_s_options).hardsubx_sampling).unwrap_or(SamplingMode::Every);
+    options.hardsubx_sample_interval =
+        Timestamp::from_millis(((*ccx_s_options).hardsubx_sample_interval * 1000.0) as i64);
 
     // Handle transcript_settings
     options.transcript_settings =
@@ -502,6 +527,8 @@ pub unsafe fn copy_to_rust(ccx_s_options: *const ccx_s_options) -> Options {
         options.tcp_desc = Some(c_char_to_string((*ccx_s_options).tcp_desc));
     }
 
+    options.tcp_senders = (*ccx_s_options).tcp_senders as u32;
+
     if !(*ccx_s_options).srv_addr.is_null() {
         options.srv_addr = Some(c_char_to_string((*ccx_s_options).srv_addr));
     }
@@ -549,6 +576,7 @@ pub unsafe fn copy_to_rust(ccx_s_options: *const ccx_s_options) -> Options {
     options.ignore_pts_jumps = (*ccx_s_options).ignore_pts_jumps != 0;
     options.multiprogram = (*ccx_s_options).multiprogram != 0;
     options.out_interval = (*ccx_s_options).out_interval;
+    options.jobs = (*ccx_s_options).jobs as _;
     options.segment_on_key_frames_only = (*ccx_s_options).segment_on_key_frames_only != 0;
     options.scc_framerate = (*ccx_s_options).scc_framerate;
     options.scc_accurate_timing = (*ccx_s_options).enc_cfg.scc_accurate_timing != 0;
@@ -559,6 +587,10 @@ pub unsafe fn copy_to_rust(ccx_s_options: *const ccx_s_options) -> Options {
         let url_str = c_char_to_string((*ccx_s_options).curlposturl);
         options.curlposturl = url_str.parse::<Url>().ok();
     }
+    #[cfg(feature = "with_libcurl")]
+    {
+        options.curl_batch = (*ccx_s_options).curl_batch as _;
+    }
 
     options
 }
@@ -716,6 +748,13 @@ impl CType<i32> for OcrMode {
     }
 }
 
+impl CType<i32> for SamplingMode {
+    /// Convert to C variant of `i32`.
+    unsafe fn to_ctype(&self) -> i32 {
+        *self as i32
+    }
+}
+
 impl CType<i32> for ColorHue {
     /// Convert to C variant of `i32`.
     unsafe fn to_ctype(&self) -> i32 {
@@ -931,12 +970,22 @@ pub unsafe fn free_encoder_cfg_strings(cfg: &encoder_cfg) {
 
 impl CType<encoder_cfg> for EncoderConfig {
     unsafe fn to_ctype(&self) -> encoder_cfg {
+        let mut extra_write_formats = [ccx_output_format::CCX_OF_NULL; MAX_EXTRA_WRITE_FORMATS];
+        for (c, format) in extra_write_formats
+            .iter_mut()
+            .zip(&self.extra_write_formats)
+        {
+            *c = format.to_ctype();
+        }
         encoder_cfg {
             extract: self.extract as _,
             dtvcc_extract: self.dtvcc_extract as _,
             gui_mode_reports: self.gui_mode_reports as _,
             output_filename: string_to_c_char(&self.output_filename),
             write_format: self.write_format.to_ctype(),
+            extra_write_formats,
+            nb_extra_write_formats: self.extra_write_formats.len().min(MAX_EXTRA_WRITE_FORMATS)
+                as _,
             keep_output_closed: self.keep_output_closed as _,
             force_flush: self.force_flush as _,
             append_mode: self.append_mode as _,
@@ -973,6 +1022,8 @@ impl CType<encoder_cfg> for EncoderConfig {
             subs_delay: self.subs_delay.millis(),
             program_number: self.program_number as _,
             in_format: self.in_format,
+            rcwt_index: self.rcwt_index as _,
+            rcwt_compress: self.rcwt_compress as _,
             nospupngocr: self.nospupngocr as _,
             force_dropframe: self.force_dropframe as _,
             render_font: string_to_c_char(self.render_font.to_str().unwrap_or_default()),
@@ -1171,6 +1222,7 @@ impl CType<avc_ctx> for AvcContextRust {
             cc_buffer_saved: if self.cc_buffer_saved { 1 } else { 0 },
 
             is_hevc: if self.is_hevc { 1 } else { 0 },
+            fast_scan: if self.fast_scan { 1 } else { 0 },
             got_seq_para: if self.got_seq_para { 1 } else { 0 },
             nal_ref_idc: self.nal_ref_idc,
             seq_parameter_set_id: self.seq_parameter_set_id,
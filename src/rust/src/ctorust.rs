@@ -178,6 +178,17 @@ impl FromCType<c_int> for lib_ccxr::hardsubx::OcrMode {
     }
 }
 
+impl FromCType<c_int> for lib_ccxr::hardsubx::SamplingMode {
+    unsafe fn from_ctype(mode: c_int) -> Option<Self> {
+        Some(match mode {
+            1 => lib_ccxr::hardsubx::SamplingMode::Skip,
+            2 => lib_ccxr::hardsubx::SamplingMode::Seek,
+            3 => lib_ccxr::hardsubx::SamplingMode::Adaptive,
+            _ => lib_ccxr::hardsubx::SamplingMode::Every,
+        })
+    }
+}
+
 impl FromCType<c_int> for lib_ccxr::hardsubx::ColorHue {
     unsafe fn from_ctype(hue: c_int) -> Option<Self> {
         Some(match hue {
@@ -404,12 +415,20 @@ impl FromCType<encoder_cfg> for EncoderConfig {
             all_services_charset: cfg.all_services_charset,
         };
 
+        let extra_write_formats = cfg
+            .extra_write_formats
+            .iter()
+            .take(cfg.nb_extra_write_formats.max(0) as usize)
+            .map(|&format| lib_ccxr::common::OutputFormat::from_ctype(format))
+            .collect::<Option<Vec<_>>>()?;
+
         Some(EncoderConfig {
             extract: cfg.extract as u8,
             dtvcc_extract: cfg.dtvcc_extract != 0,
             gui_mode_reports: cfg.gui_mode_reports != 0,
             output_filename,
             write_format: lib_ccxr::common::OutputFormat::from_ctype(cfg.write_format)?,
+            extra_write_formats,
             keep_output_closed: cfg.keep_output_closed != 0,
             force_flush: cfg.force_flush != 0,
             append_mode: cfg.append_mode != 0,
@@ -446,6 +465,8 @@ impl FromCType<encoder_cfg> for EncoderConfig {
             subs_delay: Timestamp::from_millis(cfg.subs_delay),
             program_number: cfg.program_number as u32,
             in_format: cfg.in_format,
+            rcwt_index: cfg.rcwt_index != 0,
+            rcwt_compress: cfg.rcwt_compress != 0,
             nospupngocr: cfg.nospupngocr != 0,
             force_dropframe: cfg.force_dropframe != 0,
             render_font,
@@ -776,6 +797,7 @@ impl FromCType<avc_ctx> for AvcContextRust {
             cc_buffer_saved: ctx.cc_buffer_saved != 0,
 
             is_hevc: ctx.is_hevc != 0,
+            fast_scan: ctx.fast_scan != 0,
             got_seq_para: ctx.got_seq_para != 0,
             nal_ref_idc: ctx.nal_ref_idc,
             seq_parameter_set_id: ctx.seq_parameter_set_id,
@@ -873,25 +873,31 @@ impl dtvcc_service_decoder {
             let tv = &mut (*self.tv);
             tv.cc_count += 1;
             let sn = tv.service_number;
-            let writer_ctx = &mut encoder.dtvcc_writers[(sn - 1) as usize];
             tv.update_time_hide(timing.get_visible_end(3));
-            let transcript_settings = if !encoder.transcript_settings.is_null() {
-                &*encoder.transcript_settings
-            } else {
-                &ccx_encoders_transcript_format::default()
-            };
-            let end_frame = &encoder.encoded_end_frame[..encoder.encoded_end_frame_length as usize];
-            let mut writer = Writer::new(
-                &mut encoder.cea_708_counter,
-                encoder.subs_delay,
-                encoder.write_format,
-                writer_ctx,
-                encoder.no_font_color,
-                transcript_settings,
-                encoder.no_bom,
-                end_frame,
-            );
-            tv.writer_output(&mut writer).unwrap();
+            // Each output format has its own encoder, chained through next_format
+            let mut encoder: *mut encoder_ctx = encoder;
+            while !encoder.is_null() {
+                let enc = &mut *encoder;
+                let writer_ctx = &mut enc.dtvcc_writers[(sn - 1) as usize];
+                let transcript_settings = if !enc.transcript_settings.is_null() {
+                    &*enc.transcript_settings
+                } else {
+                    &ccx_encoders_transcript_format::default()
+                };
+                let end_frame = &enc.encoded_end_frame[..enc.encoded_end_frame_length as usize];
+                let mut writer = Writer::new(
+                    &mut enc.cea_708_counter,
+                    enc.subs_delay,
+                    enc.write_format,
+                    writer_ctx,
+                    enc.no_font_color,
+                    transcript_settings,
+                    enc.no_bom,
+                    end_frame,
+                );
+                tv.writer_output(&mut writer).unwrap();
+                encoder = enc.next_format;
+            }
             tv.clear();
         }
     }
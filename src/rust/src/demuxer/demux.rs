@@ -16,7 +16,7 @@ use crate::{bindings::_open_osfhandle, file_functions::file::open_windows};
 use cfg_if::cfg_if;
 #[cfg(unix)]
 use std::os::fd::{FromRawFd, IntoRawFd};
-use std::os::raw::{c_char, c_uint};
+use std::os::raw::{c_char, c_int, c_uint};
 #[cfg(windows)]
 use std::os::windows::io::IntoRawHandle;
 use std::path::Path;
@@ -24,9 +24,11 @@ use std::ptr::{null, null_mut};
 
 cfg_if! {
     if #[cfg(test)] {
-        use crate::demuxer::demux::tests::{print_file_report, start_tcp_srv, start_upd_srv};
+        use crate::demuxer::demux::tests::{
+            print_file_report, start_tcp_senders_srv, start_tcp_srv, start_upd_srv,
+        };
     } else {
-        use crate::{print_file_report, start_tcp_srv, start_upd_srv};
+        use crate::{print_file_report, start_tcp_senders_srv, start_tcp_srv, start_upd_srv};
         #[cfg(feature = "enable_ffmpeg")]
         use crate::init_ffmpeg;
     }
@@ -215,14 +217,19 @@ impl CcxDemuxer<'_> {
                 let port_cstring = ccx_options
                     .tcpport
                     .map(|port| CString::new(port.to_string()).unwrap());
-
-                self.infd = start_tcp_srv(
-                    port_cstring.as_deref().map_or(null(), |cs| cs.as_ptr()),
-                    ccx_options
-                        .tcp_password
-                        .as_deref()
-                        .map_or(null(), |s| s.as_ptr() as *const c_char),
-                );
+                let port = port_cstring.as_deref().map_or(null(), |cs| cs.as_ptr());
+                let pwd = ccx_options
+                    .tcp_password
+                    .as_deref()
+                    .map_or(null(), |s| s.as_ptr() as *const c_char);
+
+                // start_ccx() reads --tcp-senders input with tcp_senders_loop(), which
+                // polls the listening socket start_tcp_senders_srv() sets up
+                self.infd = if ccx_options.tcp_senders > 1 {
+                    start_tcp_senders_srv(port, pwd, ccx_options.tcp_senders as c_int)
+                } else {
+                    start_tcp_srv(port, pwd)
+                };
             }
             _ => {
                 let file_result = File::open(Path::new(file_name));
@@ -381,6 +388,9 @@ mod tests {
     pub fn start_tcp_srv(_port: *const c_char, _pwd: *const c_char) -> c_int {
         0
     }
+    pub fn start_tcp_senders_srv(_port: *const c_char, _pwd: *const c_char, _max: c_int) -> c_int {
+        7
+    }
     pub fn start_upd_srv(_src: *const c_char, _addr: *const c_char, _port: c_uint) -> c_int {
         0
     }
@@ -648,6 +658,24 @@ mod tests {
             demuxer.close(&mut Options::default());
         }
     }
+    #[test]
+    #[serial]
+    fn test_open_tcp_senders_uses_senders_srv() {
+        // tcp_senders_loop() runs when tcp_senders > 1 and needs the socket of
+        // start_tcp_senders_srv(), a single sender keeps start_tcp_srv()
+        for (senders, infd) in [(1, 0), (4, 7)] {
+            let mut demuxer = CcxDemuxer::default();
+            demuxer.auto_stream = StreamMode::Transport;
+            let mut options = Options::default();
+            options.input_source = DataSource::Tcp;
+            options.tcp_senders = senders;
+            unsafe {
+                assert_eq!(demuxer.open("", &mut options), 0);
+            }
+            assert_eq!(demuxer.infd, infd);
+        }
+    }
+
     // #[serial]
     // #[test]
     #[allow(unused)]
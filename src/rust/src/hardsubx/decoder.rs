@@ -4,16 +4,20 @@ use leptonica_sys::*;
 // #[cfg(feature = "hardsubx_ocr")]
 // use rsmpeg::*;
 
+use std::cell::RefCell;
 use std::ffi;
 use std::os::raw::c_char;
 use std::process::exit;
-use std::ptr::null;
+use std::ptr::{null, null_mut};
+use std::time::Instant;
 
 #[cfg(feature = "hardsubx_ocr")]
 // use crate::bindings::{hardsubx_ocr_mode_HARDSUBX_OCRMODE_WORD};
 use crate::bindings::AVFrame;
 use crate::hardsubx::classifier::*;
-use crate::hardsubx::imgops::{rgb_to_hsv, rgb_to_lab};
+use crate::hardsubx::imgops::{
+    gray_and_hue_row, gray_and_luminance_luma_row, gray_and_luminance_row, luminance_threshold,
+};
 use crate::hardsubx::lib_hardsubx_ctx;
 use crate::utils::string_to_c_char;
 
@@ -24,6 +28,10 @@ static EXIT_MALFORMED_PARAMETER: i32 = 7;
 static HARDSUBX_OCRMODE_WORD: i32 = 1;
 // static HARDSUBX_OCRMODE_LETTER: i32 = 2;
 
+// enum hardsubx_luma_source
+static HARDSUBX_LUMA_NONE: i32 = 0;
+static HARDSUBX_LUMA_FULL: i32 = 2;
+
 // enum hardsubx_ocr_mode {
 //     HARDSUBX_OCRMODE_FRAME,
 //     HARDSUBX_OCRMODE_WORD,
@@ -68,81 +76,221 @@ pub unsafe fn dispatch_classifier_functions(ctx: *mut lib_hardsubx_ctx, im: *mut
     }
 }
 
-/// # Safety
-/// The function dereferences a raw pointer
-/// The function also calls other functions whose safety is not guaranteed
-/// The function returns a raw pointer of a String created in Rust
-/// This has to be deallocated at some point using from_raw() lest it be a memory leak
-#[no_mangle]
-pub unsafe extern "C" fn _process_frame_white_basic(
-    ctx: *mut lib_hardsubx_ctx,
-    frame: *mut AVFrame,
-    width: ::std::os::raw::c_int,
-    height: ::std::os::raw::c_int,
-    _index: ::std::os::raw::c_int,
-) -> *mut ::std::os::raw::c_char {
-    let mut im: *mut Pix = pixCreate(width, height, 32);
-    let mut lum_im: *mut Pix = pixCreate(width, height, 32);
-    let frame_deref = *frame;
-
-    for i in (3 * height / 4)..height {
-        for j in 0..width {
-            let p: isize = (j * 3 + i * frame_deref.linesize[0]) as isize;
-            let r: i32 = (*(frame_deref.data[0]).offset(p)).into();
-            let g: i32 = (*(frame_deref.data[0]).offset(p + 1)).into();
-            let b: i32 = (*(frame_deref.data[0]).offset(p + 2)).into();
-            pixSetRGBPixel(im, j, i, r, g, b);
-
-            let mut L: f32 = 0.0;
-            let mut A: f32 = 0.0;
-            let mut B: f32 = 0.0;
-
-            rgb_to_lab(r as f32, g as f32, b as f32, &mut L, &mut A, &mut B);
-
-            if L > (*ctx).lum_thresh {
-                pixSetRGBPixel(lum_im, j, i, 255, 255, 255);
-            } else {
-                pixSetRGBPixel(lum_im, j, i, 0, 0, 0);
+/// Run OCR on the feature image, adding the time spent to the context's
+/// stage timing.
+unsafe fn timed_ocr(ctx: *mut lib_hardsubx_ctx, im: *mut Pix) -> String {
+    let start = Instant::now();
+    let text = dispatch_classifier_functions(ctx, im);
+    (*ctx).ocr_time += start.elapsed().as_micros() as i64;
+    text
+}
+
+/// 32 bpp white as written by `pixSetRGBPixel(pix, x, y, 255, 255, 255)`.
+const FEATURE_WHITE: u32 = 0xFFFF_FF00;
+
+#[derive(Clone, Copy, PartialEq, Eq)]
+enum FrameKind {
+    Luminance { start_row: i32 },
+    Hue,
+}
+
+/// Images reused from one sampled frame to the next: the gray conversion of
+/// the frame (and of its hue-matching pixels), the luminance mask and the
+/// feature image handed to Tesseract. Rows outside the region a kernel
+/// writes are never touched, so they stay zero as in a freshly created Pix.
+struct FrameBuffers {
+    width: i32,
+    height: i32,
+    kind: FrameKind,
+    gray: *mut Pix,
+    hue_gray: *mut Pix,
+    feat: *mut Pix,
+    lum: Vec<u8>,
+    row: Vec<u8>,
+    hue_row: Vec<u8>,
+}
+
+impl FrameBuffers {
+    unsafe fn new(width: i32, height: i32, kind: FrameKind) -> Self {
+        let hue_gray = match kind {
+            FrameKind::Hue => pixCreate(width, height, 8),
+            FrameKind::Luminance { .. } => null_mut(),
+        };
+        let lum_rows = match kind {
+            FrameKind::Luminance { start_row } => (height - start_row).max(0),
+            FrameKind::Hue => 0,
+        };
+        FrameBuffers {
+            width,
+            height,
+            kind,
+            gray: pixCreate(width, height, 8),
+            hue_gray,
+            feat: pixCreate(width, height, 32),
+            lum: vec![0; (lum_rows * width) as usize],
+            row: vec![0; width as usize],
+            hue_row: vec![0; width as usize],
+        }
+    }
+}
+
+impl Drop for FrameBuffers {
+    fn drop(&mut self) {
+        unsafe {
+            pixDestroy(&mut self.gray);
+            pixDestroy(&mut self.feat);
+            if !self.hue_gray.is_null() {
+                pixDestroy(&mut self.hue_gray);
             }
         }
     }
+}
 
-    let mut gray_im: *mut Pix = pixConvertRGBToGray(im, 0.0, 0.0, 0.0);
-    let mut sobel_edge_im: *mut Pix = pixSobelEdgeFilter(gray_im, L_VERTICAL_EDGES as i32);
-    let mut dilate_gray_im: *mut Pix = pixDilateGray(sobel_edge_im, 21, 11);
-    let mut edge_im: *mut Pix = pixThresholdToBinary(dilate_gray_im, 50);
+thread_local! {
+    static FRAME_BUFFERS: RefCell<Option<FrameBuffers>> = RefCell::new(None);
+}
 
-    let mut feat_im: *mut Pix = pixCreate(width, height, 32);
+/// Run `f` with the frame buffers for this video, allocating them on the
+/// first frame (or when the frame size or kernel changes).
+unsafe fn with_frame_buffers<R>(
+    width: i32,
+    height: i32,
+    kind: FrameKind,
+    f: impl FnOnce(&mut FrameBuffers) -> R,
+) -> R {
+    FRAME_BUFFERS.with(|cell| {
+        let mut slot = cell.borrow_mut();
+        let reuse =
+            matches!(&*slot, Some(b) if b.width == width && b.height == height && b.kind == kind);
+        if !reuse {
+            *slot = None;
+            *slot = Some(FrameBuffers::new(width, height, kind));
+        }
+        f(slot.as_mut().unwrap())
+    })
+}
 
-    for i in (3 * (height / 4))..height {
-        for j in 0..width {
-            let mut p1: u32 = 0;
-            let mut p2: u32 = 0;
+/// Row `i` of `pix` as 32-bit words, in Leptonica's in-memory layout.
+unsafe fn pix_row<'a>(pix: *mut Pix, i: i32) -> &'a mut [u32] {
+    let wpl = pixGetWpl(pix) as usize;
+    std::slice::from_raw_parts_mut(pixGetData(pix).add(i as usize * wpl), wpl)
+}
+
+/// Row `i` of the first plane of `frame`, `bytes` long.
+unsafe fn plane_row<'a>(frame: &AVFrame, bytes: usize, i: i32) -> &'a [u8] {
+    let start = frame.data[0].offset((i * frame.linesize[0]) as isize);
+    std::slice::from_raw_parts(start, bytes)
+}
+
+/// Row `i` of the packed RGB24 frame.
+unsafe fn frame_row<'a>(frame: &AVFrame, width: i32, i: i32) -> &'a [u8] {
+    plane_row(frame, width as usize * 3, i)
+}
 
-            pixGetPixel(edge_im, j, i, &mut p1);
-            pixGetPixel(lum_im, j, i, &mut p2);
+/// Store 8 bpp values into a Leptonica row (big-endian within each word).
+fn store_gray_row(words: &mut [u32], values: &[u8]) {
+    for (word, chunk) in words.iter_mut().zip(values.chunks(4)) {
+        let mut bytes = [0u8; 4];
+        bytes[..chunk.len()].copy_from_slice(chunk);
+        *word = u32::from_be_bytes(bytes);
+    }
+}
 
-            if p1 == 0 && p2 > 0 {
-                pixSetRGBPixel(feat_im, j, i, 255, 255, 255);
+#[inline]
+fn get_data_bit(words: &[u32], n: usize) -> bool {
+    (words[n >> 5] >> (31 - (n & 31))) & 1 != 0
+}
+
+#[inline]
+fn get_data_byte(words: &[u32], n: usize) -> u8 {
+    (words[n >> 2] >> (8 * (3 - (n & 3)))) as u8
+}
+
+/// White text: bright pixels of the bottom rows (from `start_row`) that are
+/// not on a vertical edge. `frame` is the RGB24 conversion, or the decoded
+/// frame itself when the context says its luma plane can be used.
+/// Returns what `ocr` makes of the feature image.
+unsafe fn process_frame_luminance<R>(
+    ctx: *mut lib_hardsubx_ctx,
+    frame: *mut AVFrame,
+    width: i32,
+    height: i32,
+    start_row: i32,
+    italics: bool,
+    ocr: impl FnOnce(*mut Pix) -> R,
+) -> R {
+    let start = Instant::now();
+    let y_thresh = luminance_threshold((*ctx).lum_thresh);
+    let kind = FrameKind::Luminance { start_row };
+    let luma_source = (*ctx).luma_source;
+
+    with_frame_buffers(width, height, kind, |bufs| {
+        let w = width as usize;
+        for i in start_row..height {
+            let lum = &mut bufs.lum[(i - start_row) as usize * w..][..w];
+            if luma_source == HARDSUBX_LUMA_NONE {
+                gray_and_luminance_row(frame_row(&*frame, width, i), y_thresh, &mut bufs.row, lum);
             } else {
-                pixSetRGBPixel(feat_im, j, i, 0, 0, 0);
+                gray_and_luminance_luma_row(
+                    plane_row(&*frame, w, i),
+                    luma_source == HARDSUBX_LUMA_FULL,
+                    y_thresh,
+                    &mut bufs.row,
+                    lum,
+                );
             }
+            store_gray_row(pix_row(bufs.gray, i), &bufs.row);
         }
-    }
 
-    if (*ctx).detect_italics != 0 {
-        (*ctx).ocr_mode = HARDSUBX_OCRMODE_WORD;
-    }
+        let mut sobel_edge_im: *mut Pix = pixSobelEdgeFilter(bufs.gray, L_VERTICAL_EDGES as i32);
+        let mut dilate_gray_im: *mut Pix = pixDilateGray(sobel_edge_im, 21, 11);
+        let mut edge_im: *mut Pix = pixThresholdToBinary(dilate_gray_im, 50);
+
+        for i in start_row..height {
+            let edge = pix_row(edge_im, i);
+            let lum = &bufs.lum[(i - start_row) as usize * w..][..w];
+            let feat = pix_row(bufs.feat, i);
+            for j in 0..w {
+                feat[j] = if !get_data_bit(edge, j) && lum[j] != 0 {
+                    FEATURE_WHITE
+                } else {
+                    0
+                };
+            }
+        }
+
+        if italics && (*ctx).detect_italics != 0 {
+            (*ctx).ocr_mode = HARDSUBX_OCRMODE_WORD;
+        }
 
-    let subtitle_text = dispatch_classifier_functions(ctx, feat_im);
+        (*ctx).classify_time += start.elapsed().as_micros() as i64;
+        let subtitle_text = ocr(bufs.feat);
+
+        pixDestroy(&mut sobel_edge_im as *mut *mut Pix);
+        pixDestroy(&mut dilate_gray_im as *mut *mut Pix);
+        pixDestroy(&mut edge_im as *mut *mut Pix);
+
+        subtitle_text
+    })
+}
 
-    pixDestroy(&mut im as *mut *mut Pix);
-    pixDestroy(&mut gray_im as *mut *mut Pix);
-    pixDestroy(&mut sobel_edge_im as *mut *mut Pix);
-    pixDestroy(&mut dilate_gray_im as *mut *mut Pix);
-    pixDestroy(&mut edge_im as *mut *mut Pix);
-    pixDestroy(&mut lum_im as *mut *mut Pix);
-    pixDestroy(&mut feat_im as *mut *mut Pix);
+/// # Safety
+/// The function dereferences a raw pointer
+/// The function also calls other functions whose safety is not guaranteed
+/// The function returns a raw pointer of a String created in Rust
+/// This has to be deallocated at some point using from_raw() lest it be a memory leak
+#[no_mangle]
+pub unsafe extern "C" fn _process_frame_white_basic(
+    ctx: *mut lib_hardsubx_ctx,
+    frame: *mut AVFrame,
+    width: ::std::os::raw::c_int,
+    height: ::std::os::raw::c_int,
+    _index: ::std::os::raw::c_int,
+) -> *mut ::std::os::raw::c_char {
+    let subtitle_text =
+        process_frame_luminance(ctx, frame, width, height, (*ctx).band_top, true, |feat| {
+            timed_ocr(ctx, feat)
+        });
 
     string_to_c_char(&subtitle_text)
 }
@@ -160,88 +308,135 @@ pub unsafe extern "C" fn _process_frame_color_basic(
     height: ::std::os::raw::c_int,
     _index: ::std::os::raw::c_int,
 ) -> *mut ::std::os::raw::c_char {
-    let mut im: *mut Pix = pixCreate(width, height, 32);
-    let mut hue_im: *mut Pix = pixCreate(width, height, 32);
-    let frame_deref = *frame;
-
-    for i in 0..height {
-        for j in 0..width {
-            let p: isize = (j * 3 + i * frame_deref.linesize[0]) as isize;
-            let r: i32 = (*(frame_deref.data[0]).offset(p)).into();
-            let g: i32 = (*(frame_deref.data[0]).offset(p + 1)).into();
-            let b: i32 = (*(frame_deref.data[0]).offset(p + 2)).into();
-            pixSetRGBPixel(im, j, i, r, g, b);
-
-            let mut H: f32 = 0.0;
-            let mut S: f32 = 0.0;
-            let mut V: f32 = 0.0;
-
-            rgb_to_hsv(r as f32, g as f32, b as f32, &mut H, &mut S, &mut V);
-
-            if ((H - (*ctx).hue).abs()) < 20.0 {
-                pixSetRGBPixel(hue_im, j, i, r, g, b);
-            }
+    let subtitle_text = process_frame_color(ctx, frame, width, height, |feat| timed_ocr(ctx, feat));
+
+    // This is a memory leak
+    // the returned thing needs to be deallocated by caller
+    string_to_c_char(&subtitle_text)
+}
+
+/// Coloured text: pixels of the context's hue that are not on a vertical
+/// edge. `frame` is the RGB24 conversion. Returns what `ocr` makes of the
+/// feature image.
+unsafe fn process_frame_color<R>(
+    ctx: *mut lib_hardsubx_ctx,
+    frame: *mut AVFrame,
+    width: i32,
+    height: i32,
+    ocr: impl FnOnce(*mut Pix) -> R,
+) -> R {
+    let start = Instant::now();
+    let hue = (*ctx).hue;
+    let band_top = (*ctx).band_top;
+
+    with_frame_buffers(width, height, FrameKind::Hue, |bufs| {
+        for i in (*ctx).convert_top..height {
+            gray_and_hue_row(
+                frame_row(&*frame, width, i),
+                hue,
+                &mut bufs.row,
+                &mut bufs.hue_row,
+            );
+            store_gray_row(pix_row(bufs.gray, i), &bufs.row);
+            store_gray_row(pix_row(bufs.hue_gray, i), &bufs.hue_row);
         }
-    }
 
-    let mut gray_im: *mut Pix = pixConvertRGBToGray(im, 0.0, 0.0, 0.0);
-    let mut sobel_edge_im: *mut Pix = pixSobelEdgeFilter(gray_im, L_VERTICAL_EDGES as i32);
-    let mut dilate_gray_im: *mut Pix = pixDilateGray(sobel_edge_im, 21, 1);
-    let mut edge_im: *mut Pix = pixThresholdToBinary(dilate_gray_im, 50);
-
-    let mut gray_im_2: *mut Pix = pixConvertRGBToGray(hue_im, 0.0, 0.0, 0.0);
-    let mut edge_im_2: *mut Pix = pixDilateGray(gray_im_2, 5, 5);
-
-    let mut pixd: *mut Pix = null::<Pix>() as *mut Pix;
-    pixSauvolaBinarize(
-        gray_im_2,
-        15,
-        0.3,
-        1,
-        null::<*mut Pix>() as *mut *mut Pix,
-        null::<*mut Pix>() as *mut *mut Pix,
-        null::<*mut Pix>() as *mut *mut Pix,
-        &mut pixd,
-    );
-
-    let mut feat_im: *mut Pix = pixCreate(width, height, 32);
-
-    for i in (3 * (height / 4))..height {
-        for j in 0..width {
-            let mut p1: u32 = 0;
-            let mut p2: u32 = 0;
-            let mut p3: u32 = 0;
-
-            pixGetPixel(edge_im, j, i, &mut p1);
-            pixGetPixel(pixd, j, i, &mut p2);
-            pixGetPixel(edge_im_2, j, i, &mut p3);
-
-            if p1 == 0 && p2 == 0 && p3 > 0 {
-                pixSetRGBPixel(feat_im, j, i, 255, 255, 255);
+        let mut sobel_edge_im: *mut Pix = pixSobelEdgeFilter(bufs.gray, L_VERTICAL_EDGES as i32);
+        let mut dilate_gray_im: *mut Pix = pixDilateGray(sobel_edge_im, 21, 1);
+        let mut edge_im: *mut Pix = pixThresholdToBinary(dilate_gray_im, 50);
+
+        let mut edge_im_2: *mut Pix = pixDilateGray(bufs.hue_gray, 5, 5);
+
+        let mut pixd: *mut Pix = null::<Pix>() as *mut Pix;
+        pixSauvolaBinarize(
+            bufs.hue_gray,
+            15,
+            0.3,
+            1,
+            null::<*mut Pix>() as *mut *mut Pix,
+            null::<*mut Pix>() as *mut *mut Pix,
+            null::<*mut Pix>() as *mut *mut Pix,
+            &mut pixd,
+        );
+
+        for i in band_top..height {
+            let edge = pix_row(edge_im, i);
+            let sauvola = pix_row(pixd, i);
+            let edge_2 = pix_row(edge_im_2, i);
+            let feat = pix_row(bufs.feat, i);
+            for j in 0..width as usize {
+                feat[j] = if !get_data_bit(edge, j)
+                    && !get_data_bit(sauvola, j)
+                    && get_data_byte(edge_2, j) > 0
+                {
+                    FEATURE_WHITE
+                } else {
+                    0
+                };
             }
         }
-    }
 
-    if (*ctx).detect_italics != 0 {
-        (*ctx).ocr_mode = HARDSUBX_OCRMODE_WORD;
-    }
+        if (*ctx).detect_italics != 0 {
+            (*ctx).ocr_mode = HARDSUBX_OCRMODE_WORD;
+        }
 
-    let subtitle_text = dispatch_classifier_functions(ctx, feat_im);
+        (*ctx).classify_time += start.elapsed().as_micros() as i64;
+        let subtitle_text = ocr(bufs.feat);
 
-    pixDestroy(&mut im as *mut *mut Pix);
-    pixDestroy(&mut hue_im as *mut *mut Pix);
-    pixDestroy(&mut gray_im as *mut *mut Pix);
-    pixDestroy(&mut sobel_edge_im as *mut *mut Pix);
-    pixDestroy(&mut dilate_gray_im as *mut *mut Pix);
-    pixDestroy(&mut edge_im as *mut *mut Pix);
-    pixDestroy(&mut gray_im_2 as *mut *mut Pix);
-    pixDestroy(&mut edge_im_2 as *mut *mut Pix);
-    pixDestroy(&mut pixd as *mut *mut Pix);
-    pixDestroy(&mut feat_im as *mut *mut Pix);
+        pixDestroy(&mut sobel_edge_im as *mut *mut Pix);
+        pixDestroy(&mut dilate_gray_im as *mut *mut Pix);
+        pixDestroy(&mut edge_im as *mut *mut Pix);
+        pixDestroy(&mut edge_im_2 as *mut *mut Pix);
+        pixDestroy(&mut pixd as *mut *mut Pix);
 
-    // This is a memory leak
-    // the returned thing needs to be deallocated by caller
-    string_to_c_char(&subtitle_text)
+        subtitle_text
+    })
+}
+
+/// As `_process_frame_white_basic`, but returns a copy of the feature image
+/// for `_ocr_feature_image` to read later, on another thread.
+///
+/// # Safety
+/// `ctx` and `frame` must be valid. The caller owns the returned Pix.
+#[no_mangle]
+pub unsafe extern "C" fn _feature_image_white_basic(
+    ctx: *mut lib_hardsubx_ctx,
+    frame: *mut AVFrame,
+    width: ::std::os::raw::c_int,
+    height: ::std::os::raw::c_int,
+) -> *mut Pix {
+    process_frame_luminance(ctx, frame, width, height, (*ctx).band_top, true, |feat| {
+        pixCopy(null_mut(), feat)
+    })
+}
+
+/// As `_process_frame_color_basic`, but returns a copy of the feature image
+/// for `_ocr_feature_image` to read later, on another thread.
+///
+/// # Safety
+/// `ctx` and `frame` must be valid. The caller owns the returned Pix.
+#[no_mangle]
+pub unsafe extern "C" fn _feature_image_color_basic(
+    ctx: *mut lib_hardsubx_ctx,
+    frame: *mut AVFrame,
+    width: ::std::os::raw::c_int,
+    height: ::std::os::raw::c_int,
+) -> *mut Pix {
+    process_frame_color(ctx, frame, width, height, |feat| pixCopy(null_mut(), feat))
+}
+
+/// Run OCR on a feature image from `_feature_image_*_basic`, with the
+/// Tesseract instance and OCR mode of `ctx`.
+///
+/// # Safety
+/// `ctx` and `im` must be valid, and `ctx` not used by another thread.
+/// The returned string must be freed with free_rust_c_string().
+#[no_mangle]
+pub unsafe extern "C" fn _ocr_feature_image(
+    ctx: *mut lib_hardsubx_ctx,
+    im: *mut Pix,
+) -> *mut ::std::os::raw::c_char {
+    string_to_c_char(&timed_ocr(ctx, im))
 }
 /// # Safety
 /// The function accepts and dereferences a raw pointer
@@ -255,64 +450,10 @@ pub unsafe extern "C" fn _process_frame_tickertext(
     height: ::std::os::raw::c_int,
     _index: ::std::os::raw::c_int,
 ) -> *mut ::std::os::raw::c_char {
-    let mut im: *mut Pix = pixCreate(width, height, 32);
-    let mut lum_im: *mut Pix = pixCreate(width, height, 32);
-    let frame_deref = *frame;
-
-    for i in ((92 * height) / 100)..height {
-        for j in 0..width {
-            let p: isize = (j * 3 + i * frame_deref.linesize[0]) as isize;
-            let r: i32 = (*(frame_deref.data[0]).offset(p)).into();
-            let g: i32 = (*(frame_deref.data[0]).offset(p + 1)).into();
-            let b: i32 = (*(frame_deref.data[0]).offset(p + 2)).into();
-            pixSetRGBPixel(im, j, i, r, g, b);
-
-            let mut L: f32 = 0.0;
-            let mut A: f32 = 0.0;
-            let mut B: f32 = 0.0;
-
-            rgb_to_lab(r as f32, g as f32, b as f32, &mut L, &mut A, &mut B);
-
-            if L > (*ctx).lum_thresh {
-                pixSetRGBPixel(lum_im, j, i, 255, 255, 255);
-            } else {
-                pixSetRGBPixel(lum_im, j, i, 0, 0, 0);
-            }
-        }
-    }
-
-    let mut gray_im: *mut Pix = pixConvertRGBToGray(im, 0.0, 0.0, 0.0);
-    let mut sobel_edge_im: *mut Pix = pixSobelEdgeFilter(gray_im, L_VERTICAL_EDGES as i32);
-    let mut dilate_gray_im: *mut Pix = pixDilateGray(sobel_edge_im, 21, 11);
-    let mut edge_im: *mut Pix = pixThresholdToBinary(dilate_gray_im, 50);
-
-    let mut feat_im: *mut Pix = pixCreate(width, height, 32);
-
-    for i in ((92 * height) / 100)..height {
-        for j in 0..width {
-            let mut p1: u32 = 0;
-            let mut p2: u32 = 0;
-
-            pixGetPixel(edge_im, j, i, &mut p1);
-            pixGetPixel(lum_im, j, i, &mut p2);
-
-            if p1 == 0 && p2 > 0 {
-                pixSetRGBPixel(feat_im, j, i, 255, 255, 255);
-            } else {
-                pixSetRGBPixel(feat_im, j, i, 0, 0, 0);
-            }
-        }
-    }
-
-    let subtitle_text = dispatch_classifier_functions(ctx, feat_im);
-
-    pixDestroy(&mut im as *mut *mut Pix);
-    pixDestroy(&mut gray_im as *mut *mut Pix);
-    pixDestroy(&mut sobel_edge_im as *mut *mut Pix);
-    pixDestroy(&mut dilate_gray_im as *mut *mut Pix);
-    pixDestroy(&mut edge_im as *mut *mut Pix);
-    pixDestroy(&mut lum_im as *mut *mut Pix);
-    pixDestroy(&mut feat_im as *mut *mut Pix);
+    let subtitle_text =
+        process_frame_luminance(ctx, frame, width, height, (*ctx).band_top, false, |feat| {
+            timed_ocr(ctx, feat)
+        });
 
     string_to_c_char(&subtitle_text)
 }
@@ -36,6 +36,114 @@ pub extern "C" fn rgb_to_lab(R: f32, G: f32, B: f32, L: &mut f32, a: &mut f32, b
     *b = lab_rep.b;
 }
 
+/// Relative luminance weights of linear sRGB, as used by the Lab conversion
+/// in `rgb_to_lab`.
+const LUMA_R: f32 = 0.212_672_9;
+const LUMA_G: f32 = 0.715_152_2;
+const LUMA_B: f32 = 0.072_175;
+
+/// Leptonica's default weights for `pixConvertRGBToGray(pix, 0.0, 0.0, 0.0)`.
+const GRAY_R: f32 = 0.3;
+const GRAY_G: f32 = 0.5;
+const GRAY_B: f32 = 0.2;
+
+/// Lab lightness only depends on luminance and is strictly increasing in it,
+/// so `L > lum_thresh` can be tested on the luminance of the 0-255 RGB
+/// triple directly. Returns that luminance threshold, on the 0-255 scale.
+pub fn luminance_threshold(lum_thresh: f32) -> f32 {
+    let f = (lum_thresh as f64 + 16.0) / 116.0;
+    let delta = 6.0 / 29.0;
+    let y = if f > delta {
+        f * f * f
+    } else {
+        (f - 4.0 / 29.0) * 108.0 / 841.0
+    };
+    (y * 255.0) as f32
+}
+
+/// Hue in degrees (0-360) of an RGB triple, as returned by `rgb_to_hsv`.
+#[inline]
+pub fn rgb_hue(r: f32, g: f32, b: f32) -> f32 {
+    let max = r.max(g).max(b);
+    let min = r.min(g).min(b);
+    let diff = max - min;
+    if diff == 0.0 {
+        return 0.0;
+    }
+    let h = if max == r {
+        (g - b) / diff
+    } else if max == g {
+        (b - r) / diff + 2.0
+    } else {
+        (r - g) / diff + 4.0
+    };
+    let h = h * 60.0;
+    if h < 0.0 {
+        h + 360.0
+    } else {
+        h
+    }
+}
+
+/// Gray value of an RGB triple as computed by Leptonica's default
+/// `pixConvertRGBToGray`.
+#[inline]
+fn rgb_gray(r: f32, g: f32, b: f32) -> u8 {
+    (GRAY_R * r + GRAY_G * g + GRAY_B * b + 0.5) as u8
+}
+
+/// Convert one packed RGB24 row to gray levels and a luminance mask:
+/// `lum[j]` is 255 where Lab lightness exceeds the threshold given by
+/// `luminance_threshold`, 0 elsewhere.
+pub fn gray_and_luminance_row(rgb: &[u8], y_thresh: f32, gray: &mut [u8], lum: &mut [u8]) {
+    for ((px, gray), lum) in rgb.chunks_exact(3).zip(gray.iter_mut()).zip(lum.iter_mut()) {
+        let (r, g, b) = (px[0] as f32, px[1] as f32, px[2] as f32);
+        *gray = rgb_gray(r, g, b);
+        let y = LUMA_R * r + LUMA_G * g + LUMA_B * b;
+        *lum = if y > y_thresh { 255 } else { 0 };
+    }
+}
+
+/// Like `gray_and_luminance_row`, but from a row of the decoder's 8-bit luma
+/// plane, which stands in for both the gray level and the luminance.
+pub fn gray_and_luminance_luma_row(
+    luma: &[u8],
+    full_range: bool,
+    y_thresh: f32,
+    gray: &mut [u8],
+    lum: &mut [u8],
+) {
+    for ((&y, gray), lum) in luma.iter().zip(gray.iter_mut()).zip(lum.iter_mut()) {
+        let value = if full_range {
+            y
+        } else {
+            ((y.saturating_sub(16).min(219) as u32 * 255 + 109) / 219) as u8
+        };
+        *gray = value;
+        *lum = if value as f32 > y_thresh { 255 } else { 0 };
+    }
+}
+
+/// Convert one packed RGB24 row to gray levels, twice: once for the whole
+/// row and once keeping only the pixels whose hue is within 20 degrees of
+/// `hue` (others are 0).
+pub fn gray_and_hue_row(rgb: &[u8], hue: f32, gray: &mut [u8], hue_gray: &mut [u8]) {
+    for ((px, gray), hue_gray) in rgb
+        .chunks_exact(3)
+        .zip(gray.iter_mut())
+        .zip(hue_gray.iter_mut())
+    {
+        let (r, g, b) = (px[0] as f32, px[1] as f32, px[2] as f32);
+        let value = rgb_gray(r, g, b);
+        *gray = value;
+        *hue_gray = if (rgb_hue(r, g, b) - hue).abs() < 20.0 {
+            value
+        } else {
+            0
+        };
+    }
+}
+
 #[cfg(test)]
 mod test {
     use super::*;
@@ -97,4 +205,66 @@ mod test {
         assert_eq!(a.floor(), 0.0);
         assert_eq!(b.floor(), 0.0);
     }
+
+    #[test]
+    fn test_luminance_threshold_matches_lab() {
+        for &thresh in &[20.0_f32, 50.0, 80.0, 95.0] {
+            let y_thresh = luminance_threshold(thresh);
+            let mut gray = [0u8; 1];
+            let mut lum = [0u8; 1];
+            for r in (0..256).step_by(15) {
+                for g in (0..256).step_by(15) {
+                    for b in (0..256).step_by(15) {
+                        let (mut l, mut a, mut bb) = (0.0, 0.0, 0.0);
+                        rgb_to_lab(r as f32, g as f32, b as f32, &mut l, &mut a, &mut bb);
+                        if (l - thresh).abs() < 1e-3 {
+                            continue;
+                        }
+                        gray_and_luminance_row(
+                            &[r as u8, g as u8, b as u8],
+                            y_thresh,
+                            &mut gray,
+                            &mut lum,
+                        );
+                        assert_eq!(lum[0] != 0, l > thresh, "rgb {} {} {}", r, g, b);
+                    }
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn test_rgb_hue_matches_hsv() {
+        let (mut h, mut s, mut v) = (0.0, 0.0, 0.0);
+        for r in (0..256).step_by(17) {
+            for g in (0..256).step_by(17) {
+                for b in (0..256).step_by(17) {
+                    rgb_to_hsv(r as f32, g as f32, b as f32, &mut h, &mut s, &mut v);
+                    let hue = rgb_hue(r as f32, g as f32, b as f32);
+                    assert!(
+                        (hue - h).abs() < 1e-3,
+                        "rgb {} {} {}: {} vs {}",
+                        r,
+                        g,
+                        b,
+                        hue,
+                        h
+                    );
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn test_luma_row_expands_limited_range() {
+        let mut gray = [0u8; 4];
+        let mut lum = [0u8; 4];
+        let y_thresh = luminance_threshold(95.0);
+        gray_and_luminance_luma_row(&[0, 16, 235, 255], false, y_thresh, &mut gray, &mut lum);
+        assert_eq!(gray, [0, 0, 255, 255]);
+        assert_eq!(lum, [0, 0, 255, 255]);
+        gray_and_luminance_luma_row(&[0, 16, 235, 255], true, y_thresh, &mut gray, &mut lum);
+        assert_eq!(gray, [0, 16, 235, 255]);
+        assert_eq!(lum, [0, 0, 255, 255]);
+    }
 }
@@ -54,4 +54,18 @@ pub struct lib_hardsubx_ctx {
     pub conf_thresh: f32,
     pub hue: f32,
     pub lum_thresh: f32,
+    pub sub_band: ::std::os::raw::c_int,
+    pub band_top: ::std::os::raw::c_int,
+    pub convert_top: ::std::os::raw::c_int,
+    pub luma_source: ::std::os::raw::c_int,
+    pub decode_time: i64,
+    pub convert_time: i64,
+    pub classify_time: i64,
+    pub ocr_time: i64,
+    pub sampling: ::std::os::raw::c_int,
+    pub sample_interval: f32,
+    pub frames_decoded: ::std::os::raw::c_int,
+    pub frames_sampled: ::std::os::raw::c_int,
+    pub ocr_workers: *mut *mut TessBaseAPI,
+    pub nb_ocr_workers: ::std::os::raw::c_int,
 }
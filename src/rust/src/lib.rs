@@ -29,9 +29,11 @@ pub mod hlist;
 pub mod libccxr_exports;
 #[cfg(feature = "enable_mp4_ffmpeg")]
 pub mod mp4_ffmpeg_exports;
+pub mod ocr_cache;
 pub mod parser;
 pub mod track_lister;
 pub mod utils;
+pub mod worker_pool;
 
 #[cfg(windows)]
 use std::os::windows::io::{FromRawHandle, RawHandle};
@@ -112,6 +114,7 @@ cfg_if! {
         #[cfg(feature = "enable_ffmpeg")]
         fn init_ffmpeg(path: *const c_char){}
         pub fn start_tcp_srv(_port: *const c_char, _pwd: *const c_char) -> c_int{0}
+        pub fn start_tcp_senders_srv(_port: *const c_char, _pwd: *const c_char, _max: c_int) -> c_int{0}
         pub fn start_upd_srv(_src: *const c_char, _addr: *const c_char, _port: c_uint) -> c_int{0}
         pub fn net_udp_read(
             _socket: c_int,
@@ -180,6 +183,7 @@ extern "C" {
     #[cfg(feature = "enable_ffmpeg")]
     fn init_ffmpeg(path: *const c_char);
     pub fn start_tcp_srv(port: *const c_char, pwd: *const c_char) -> c_int;
+    pub fn start_tcp_senders_srv(port: *const c_char, pwd: *const c_char, max: c_int) -> c_int;
     pub fn start_upd_srv(src: *const c_char, addr: *const c_char, port: c_uint) -> c_int;
     pub fn net_udp_read(
         socket: c_int,
@@ -0,0 +1,379 @@
+//! Text recognized by Tesseract, keyed by a digest of the bitmap it came from.
+//!
+//! DVB and DVD streams resend the same subtitle bitmap with every page
+//! refresh, so `ocr_rect()` hashes the bitmap, its palette and the OCR
+//! parameters (SHA-256, see `ocr_cache_key()` in ocr.c) and asks here before
+//! running Tesseract again. The store is shared by the `--ocr-threads`
+//! workers, hence the mutex.
+//!
+//! With `--ocr-cache FILE` the entries are loaded from FILE when OCR starts and
+//! written back at exit, so re-runs over the same channel reuse them. The first
+//! line of the file records the Tesseract version and settings; a file written
+//! with different ones is ignored rather than trusted.
+//!
+//! At most [`MAX_ENTRIES`] results are held; past that the least recently
+//! used one is dropped, so a long recording cannot grow the store (or the
+//! file) without bound.
+
+use std::collections::{BTreeMap, HashMap};
+use std::ffi::CStr;
+use std::fs;
+use std::io::{self, BufRead, BufReader, BufWriter, Write};
+use std::os::raw::{c_char, c_int, c_uint, c_ulonglong, c_void};
+use std::path::{Path, PathBuf};
+use std::sync::Mutex;
+
+/// Length of a key, a SHA-256 digest.
+pub const KEY_LEN: usize = 32;
+
+pub type Key = [u8; KEY_LEN];
+
+/// Results kept in memory and in the `--ocr-cache` file. Keep in sync with the
+/// `--ocr-cache` help text.
+pub const MAX_ENTRIES: usize = 10000;
+
+const MAGIC: &str = "ccextractor-ocr-cache 1";
+
+#[derive(Default)]
+pub struct OcrCache {
+    /// `None` records a bitmap Tesseract found no text in. The number is the
+    /// entry's position in `recent`.
+    entries: HashMap<Key, (Option<String>, u64)>,
+    /// Keys by last use, oldest first.
+    recent: BTreeMap<u64, Key>,
+    /// Incremented on every use, to order `recent`.
+    tick: u64,
+    hits: u64,
+    misses: u64,
+    /// Where to save the entries, with the settings line to write first.
+    file: Option<(PathBuf, String)>,
+    /// Whether entries were added since loading.
+    dirty: bool,
+}
+
+impl OcrCache {
+    pub fn lookup(&mut self, key: &Key) -> Option<Option<&str>> {
+        match self.entries.get_mut(key) {
+            Some((text, used)) => {
+                self.hits += 1;
+                self.tick += 1;
+                self.recent.remove(used);
+                self.recent.insert(self.tick, *key);
+                *used = self.tick;
+                Some(text.as_deref())
+            }
+            None => {
+                self.misses += 1;
+                None
+            }
+        }
+    }
+
+    pub fn store(&mut self, key: Key, text: Option<String>) {
+        self.tick += 1;
+        if let Some((_, used)) = self.entries.insert(key, (text, self.tick)) {
+            self.recent.remove(&used);
+        }
+        self.recent.insert(self.tick, key);
+        while self.entries.len() > MAX_ENTRIES {
+            match self.recent.pop_first() {
+                Some((_, oldest)) => self.entries.remove(&oldest),
+                None => break,
+            };
+        }
+        self.dirty = true;
+    }
+
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    /// Remember `path` for [`OcrCache::save`] and load the entries it holds if
+    /// it was written with the same `settings`. Returns how many were loaded.
+    pub fn load(&mut self, path: &Path, settings: &str) -> io::Result<usize> {
+        self.file = Some((path.to_path_buf(), settings.to_string()));
+        let file = match fs::File::open(path) {
+            Ok(file) => file,
+            Err(e) if e.kind() == io::ErrorKind::NotFound => return Ok(0),
+            Err(e) => return Err(e),
+        };
+        let mut lines = BufReader::new(file).lines();
+        if lines.next().transpose()? != Some(header_line(settings)) {
+            return Ok(0);
+        }
+
+        // Loaded entries need no saving
+        let dirty = self.dirty;
+        let mut loaded = 0;
+        for line in lines {
+            let line = line?;
+            let (hex, text) = match line.find('\t') {
+                Some(tab) => (&line[..tab], Some(unescape(&line[tab + 1..]))),
+                None => (line.as_str(), None),
+            };
+            if let Some(key) = parse_key(hex) {
+                if !self.entries.contains_key(&key) {
+                    self.store(key, text);
+                    loaded += 1;
+                }
+            }
+        }
+        self.dirty = dirty;
+        Ok(loaded.min(self.entries.len()))
+    }
+
+    /// Write the entries back to the file given to [`OcrCache::load`], if any
+    /// were added. The file is replaced in one go, as `--jobs` may run several
+    /// processes saving to it. Entries are written oldest first, so that
+    /// loading them back keeps the most recently used ones.
+    pub fn save(&mut self) -> io::Result<()> {
+        let (path, settings) = match &self.file {
+            Some(file) if self.dirty => file,
+            _ => return Ok(()),
+        };
+        let mut tmp = path.clone().into_os_string();
+        tmp.push(format!(".{}.tmp", std::process::id()));
+        let tmp = PathBuf::from(tmp);
+        let mut out = BufWriter::new(fs::File::create(&tmp)?);
+        writeln!(out, "{}", header_line(settings))?;
+        for key in self.recent.values() {
+            let (text, _) = &self.entries[key];
+            for byte in key {
+                write!(out, "{:02x}", byte)?;
+            }
+            match text {
+                Some(text) => writeln!(out, "\t{}", escape(text))?,
+                None => writeln!(out)?,
+            }
+        }
+        out.flush()?;
+        drop(out);
+        fs::rename(&tmp, path)?;
+        self.dirty = false;
+        Ok(())
+    }
+}
+
+fn header_line(settings: &str) -> String {
+    format!("{} {}", MAGIC, settings)
+}
+
+fn parse_key(hex: &str) -> Option<Key> {
+    if hex.len() != 2 * KEY_LEN {
+        return None;
+    }
+    let mut key = [0; KEY_LEN];
+    for (i, byte) in key.iter_mut().enumerate() {
+        *byte = u8::from_str_radix(hex.get(2 * i..2 * i + 2)?, 16).ok()?;
+    }
+    Some(key)
+}
+
+/// Recognized text spans several lines; keep each entry on one.
+fn escape(text: &str) -> String {
+    let mut out = String::with_capacity(text.len());
+    for c in text.chars() {
+        match c {
+            '\\' => out.push_str("\\\\"),
+            '\n' => out.push_str("\\n"),
+            '\r' => out.push_str("\\r"),
+            '\t' => out.push_str("\\t"),
+            c => out.push(c),
+        }
+    }
+    out
+}
+
+fn unescape(text: &str) -> String {
+    let mut out = String::with_capacity(text.len());
+    let mut chars = text.chars();
+    while let Some(c) = chars.next() {
+        if c != '\\' {
+            out.push(c);
+            continue;
+        }
+        match chars.next() {
+            Some('n') => out.push('\n'),
+            Some('r') => out.push('\r'),
+            Some('t') => out.push('\t'),
+            Some(c) => out.push(c),
+            None => {}
+        }
+    }
+    out
+}
+
+static CACHE: Mutex<Option<OcrCache>> = Mutex::new(None);
+
+fn with_cache<T>(f: impl FnOnce(&mut OcrCache) -> T) -> T {
+    let mut cache = CACHE.lock().unwrap_or_else(|e| e.into_inner());
+    f(cache.get_or_insert_with(OcrCache::default))
+}
+
+extern "C" {
+    fn malloc(size: usize) -> *mut c_void;
+}
+
+/// Load the entries saved in `path` by an earlier run, if it was made with
+/// the same `settings`, and save to it at [`ccxr_ocr_cache_save`]. Returns the
+/// number of entries loaded, -1 if the file could not be read.
+///
+/// # Safety
+/// `path` and `settings` must be valid NUL-terminated strings.
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_ocr_cache_load(
+    path: *const c_char,
+    settings: *const c_char,
+) -> c_int {
+    let path = CStr::from_ptr(path).to_string_lossy().into_owned();
+    let settings = CStr::from_ptr(settings).to_string_lossy();
+    match with_cache(|cache| cache.load(Path::new(&path), &settings)) {
+        Ok(loaded) => loaded as c_int,
+        Err(_) => -1,
+    }
+}
+
+/// Look `key` up. On a hit returns 1 and sets `*text` to a malloc'd copy of
+/// the recognized text, or NULL if there was none; returns 0 on a miss.
+///
+/// # Safety
+/// `key` must point to [`KEY_LEN`] bytes and `text` must be valid for writes.
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_ocr_cache_lookup(key: *const u8, text: *mut *mut c_char) -> c_int {
+    let key = &*(key as *const Key);
+    with_cache(|cache| match cache.lookup(key) {
+        None => 0,
+        Some(found) => {
+            *text = match found {
+                None => std::ptr::null_mut(),
+                Some(found) => {
+                    let copy = malloc(found.len() + 1) as *mut u8;
+                    if !copy.is_null() {
+                        std::ptr::copy_nonoverlapping(found.as_ptr(), copy, found.len());
+                        *copy.add(found.len()) = 0;
+                    }
+                    copy as *mut c_char
+                }
+            };
+            1
+        }
+    })
+}
+
+/// Remember the text recognized in the bitmap hashed to `key`; `text` may be
+/// NULL when Tesseract found none.
+///
+/// # Safety
+/// `key` must point to [`KEY_LEN`] bytes and `text` must be NULL or a valid
+/// NUL-terminated string.
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_ocr_cache_store(key: *const u8, text: *const c_char) {
+    let key = *(key as *const Key);
+    let text = if text.is_null() {
+        None
+    } else {
+        Some(CStr::from_ptr(text).to_string_lossy().into_owned())
+    };
+    with_cache(|cache| cache.store(key, text));
+}
+
+/// Write the entries back to the file given to [`ccxr_ocr_cache_load`].
+/// Returns 0 on success or when there is nothing to save, -1 on error.
+#[no_mangle]
+pub extern "C" fn ccxr_ocr_cache_save() -> c_int {
+    match with_cache(|cache| cache.save()) {
+        Ok(()) => 0,
+        Err(_) => -1,
+    }
+}
+
+/// Lookups answered from the cache, lookups that were not, and entries held.
+///
+/// # Safety
+/// The pointers must be valid for writes.
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_ocr_cache_stats(
+    hits: *mut c_ulonglong,
+    misses: *mut c_ulonglong,
+    entries: *mut c_uint,
+) {
+    with_cache(|cache| {
+        *hits = cache.hits as c_ulonglong;
+        *misses = cache.misses as c_ulonglong;
+        *entries = cache.len() as c_uint;
+    });
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn key(n: u8) -> Key {
+        let mut key = [0; KEY_LEN];
+        key[0] = n;
+        key[KEY_LEN - 1] = 0xa5;
+        key
+    }
+
+    #[test]
+    fn test_lookup_counts_hits_and_misses() {
+        let mut cache = OcrCache::default();
+        assert_eq!(cache.lookup(&key(1)), None);
+        cache.store(key(1), Some("Hello".to_string()));
+        cache.store(key(2), None);
+        assert_eq!(cache.lookup(&key(1)), Some(Some("Hello")));
+        assert_eq!(cache.lookup(&key(2)), Some(None));
+        assert_eq!((cache.hits, cache.misses), (2, 1));
+    }
+
+    #[test]
+    fn test_save_and_load_round_trip() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("ocr.cache");
+
+        let mut cache = OcrCache::default();
+        assert_eq!(cache.load(&path, "oem 1 psm 3").unwrap(), 0);
+        cache.store(key(1), Some("Two\nlines\twith \\ tab".to_string()));
+        cache.store(key(2), None);
+        cache.save().unwrap();
+
+        let mut reloaded = OcrCache::default();
+        assert_eq!(reloaded.load(&path, "oem 1 psm 3").unwrap(), 2);
+        assert_eq!(
+            reloaded.lookup(&key(1)),
+            Some(Some("Two\nlines\twith \\ tab"))
+        );
+        assert_eq!(reloaded.lookup(&key(2)), Some(None));
+
+        // Results from other OCR settings are not reused
+        let mut other = OcrCache::default();
+        assert_eq!(other.load(&path, "oem 1 psm 7").unwrap(), 0);
+        assert!(other.is_empty());
+    }
+
+    #[test]
+    fn test_store_drops_least_recently_used() {
+        let mut cache = OcrCache::default();
+        for n in 0..MAX_ENTRIES {
+            let mut k = key(0);
+            k[1..9].copy_from_slice(&(n as u64).to_le_bytes());
+            cache.store(k, None);
+        }
+        // Touch the oldest entry, so the second oldest goes first
+        let mut first = key(0);
+        first[1..9].copy_from_slice(&0u64.to_le_bytes());
+        let mut second = key(0);
+        second[1..9].copy_from_slice(&1u64.to_le_bytes());
+        assert_eq!(cache.lookup(&first), Some(None));
+
+        cache.store(key(1), Some("New".to_string()));
+        assert_eq!(cache.len(), MAX_ENTRIES);
+        assert_eq!(cache.lookup(&second), None);
+        assert_eq!(cache.lookup(&first), Some(None));
+        assert_eq!(cache.lookup(&key(1)), Some(Some("New")));
+    }
+}
@@ -146,6 +146,7 @@ fn set_file_buffer_size(size: i32) {
 
 pub trait OptionsExt {
     fn set_output_format_type(&mut self, out_format: OutFormat);
+    fn set_extra_output_formats(&mut self, extra_formats: &[OutFormat]);
     fn set_output_format(&mut self, args: &Args);
     fn set_input_format_type(&mut self, input_format: InFormat);
     fn set_input_format(&mut self, args: &Args);
@@ -220,17 +221,67 @@ impl OptionsExt for Options {
         }
     }
 
+    /// The formats after the first one in `--out`, written from the same
+    /// decoded captions by encoders of their own.
+    fn set_extra_output_formats(&mut self, extra_formats: &[OutFormat]) {
+        if extra_formats.is_empty() {
+            return;
+        }
+        let primary = self.write_format;
+        let mut formats = vec![primary];
+        for &out_format in extra_formats {
+            self.set_output_format_type(out_format);
+            formats.push(self.write_format);
+            self.write_format = primary;
+        }
+
+        for (i, format) in formats.iter().enumerate() {
+            // Raw data, stream reports and transcripts (decoded line by line
+            // instead of by screen) need a pipeline of their own
+            if !matches!(
+                format,
+                OutputFormat::Srt
+                    | OutputFormat::Ssa
+                    | OutputFormat::WebVtt
+                    | OutputFormat::Sami
+                    | OutputFormat::SmpteTt
+                    | OutputFormat::Scc
+                    | OutputFormat::Ccd
+                    | OutputFormat::G608
+                    | OutputFormat::SpuPng
+                    | OutputFormat::SimpleXml
+            ) {
+                fatal!(
+                    cause = ExitCause::IncompatibleParameters;
+                    "--out: {:?} output can't be combined with other formats.\n", format
+                );
+            }
+            if formats[..i]
+                .iter()
+                .any(|f| f.file_extension() == format.file_extension())
+            {
+                fatal!(
+                    cause = ExitCause::IncompatibleParameters;
+                    "--out: each format given must write files with a different extension.\n"
+                );
+            }
+        }
+        self.enc_cfg.extra_write_formats = formats[1..].to_vec();
+    }
+
     fn set_output_format(&mut self, args: &Args) {
         self.write_format_rewritten = true;
 
-        if self.send_to_srv && args.out.unwrap_or(OutFormat::Null) != OutFormat::Bin {
+        let out = args.out.as_deref().unwrap_or_default();
+        if self.send_to_srv && out.first().copied().unwrap_or(OutFormat::Null) != OutFormat::Bin {
             println!("Output format is changed to bin\n");
             self.set_output_format_type(OutFormat::Bin);
             return;
         }
 
-        if let Some(out_format) = args.out {
+        if let Some((&out_format, extra_formats)) = out.split_first() {
             self.set_output_format_type(out_format);
+            self.set_extra_output_formats(extra_formats);
         } else if args.sami {
             self.set_output_format_type(OutFormat::Sami);
         } else if args.webvtt {
@@ -602,6 +653,41 @@ impl OptionsExt for Options {
                     }
                     self.hardsubx_lum_thresh = *value as _;
                 }
+
+                if let Some(value) = args.sub_band {
+                    if !(1..=100).contains(&value) {
+                        fatal!(
+                            cause = ExitCause::MalformedParameter;
+                           "Invalid subtitle band, valid values are between 1 & 100"
+                        );
+                    }
+                    self.hardsubx_sub_band = value;
+                }
+
+                if let Some(ref sampling) = args.sampling {
+                    self.hardsubx_sampling = match sampling.as_str() {
+                        "every" => SamplingMode::Every,
+                        "skip" => SamplingMode::Skip,
+                        "seek" => SamplingMode::Seek,
+                        "adaptive" => SamplingMode::Adaptive,
+                        _ => {
+                            fatal!(
+                                cause = ExitCause::MalformedParameter;
+                               "Invalid sampling mode, valid values are every, skip, seek & adaptive"
+                            );
+                        }
+                    };
+                }
+
+                if let Some(value) = args.sample_interval {
+                    if value <= 0.0 {
+                        fatal!(
+                            cause = ExitCause::MalformedParameter;
+                           "Invalid sample interval, it must be greater than 0"
+                        );
+                    }
+                    self.hardsubx_sample_interval = Timestamp::from_millis((1000.0 * value) as _);
+                }
             }
         } // END OF HARDSUBX
 
@@ -760,6 +846,20 @@ impl OptionsExt for Options {
             self.ocr_blacklist = false;
         }
 
+        if let Some(threads) = args.ocr_threads {
+            if !(1..=64).contains(&threads) {
+                fatal!(
+                    cause = ExitCause::MalformedParameter;
+                   "--ocr-threads must be between 1 and 64"
+                );
+            }
+            self.ocr_threads = threads;
+        }
+
+        if let Some(ref file) = args.ocr_cache {
+            self.ocr_cache_file = Some(file.clone());
+        }
+
         if let Some(ref lang) = args.mkvlang {
             match MkvLangFilter::new(lang.as_str()) {
                 Ok(filter) => self.mkvlang = Some(filter),
@@ -945,6 +1045,10 @@ impl OptionsExt for Options {
             self.demux_cfg.ts_allprogram = true;
         }
 
+        if let Some(jobs) = args.jobs {
+            self.jobs = jobs.max(1);
+        }
+
         if args.list_tracks {
             self.list_tracks_only = true;
         }
@@ -1073,6 +1177,10 @@ impl OptionsExt for Options {
             self.analyze_video_stream = true;
         }
 
+        if args.fast_avc_scan {
+            self.fast_avc_scan = true;
+        }
+
         if args.xds {
             self.transcript_settings.xds = true;
         }
@@ -1268,6 +1376,11 @@ impl OptionsExt for Options {
             self.enc_cfg.force_dropframe = true;
         }
 
+        if args.rcwt_index || args.rcwt_compress {
+            self.enc_cfg.rcwt_index = true;
+            self.enc_cfg.rcwt_compress = args.rcwt_compress;
+        }
+
         if args.no_autotimeref {
             self.noautotimeref = true;
         }
@@ -1429,6 +1542,16 @@ impl OptionsExt for Options {
             self.tcp_desc = Some(tcpdesc.to_string());
         }
 
+        if let Some(senders) = args.tcp_senders {
+            if !(1..=1024).contains(&senders) {
+                fatal!(
+                    cause = ExitCause::MalformedParameter;
+                   "--tcp-senders must be between 1 and 1024"
+                );
+            }
+            self.tcp_senders = senders;
+        }
+
         if let Some(ref font) = args.font {
             self.enc_cfg.render_font = PathBuf::from_str(font).unwrap_or_default();
         }
@@ -1443,6 +1566,9 @@ impl OptionsExt for Options {
             if let Some(ref curlposturl) = args.curlposturl {
                 self.curlposturl = Url::from_str(curlposturl).ok();
             }
+            if let Some(curlbatch) = args.curlbatch {
+                self.curl_batch = curlbatch.max(1);
+            }
         }
 
         if self.demux_cfg.auto_stream == StreamMode::Mp4 && self.input_source == DataSource::Stdin {
@@ -1546,6 +1672,39 @@ impl OptionsExt for Options {
             self.buffer_input = true;
         }
 
+        if self.jobs > 1 && self.input_source != DataSource::File {
+            fatal!(
+                cause = ExitCause::IncompatibleParameters;
+                "--jobs only works with input files"
+            );
+        }
+
+        // --multiprogram names the files per program, so its workers never share one
+        let shares_programs =
+            self.multiprogram && self.inputfile.as_ref().is_some_and(|v| v.len() == 1);
+        if self.jobs > 1
+            && (self.cc_to_stdout || self.output_filename.is_some() && !shares_programs)
+        {
+            fatal!(
+                cause = ExitCause::IncompatibleParameters;
+                "--jobs writes separate output files for each input, it can't be used with -o or --stdout"
+            );
+        }
+
+        if self.tcp_senders > 1 && self.input_source != DataSource::Tcp {
+            fatal!(
+                cause = ExitCause::IncompatibleParameters;
+                "--tcp-senders only works with --tcp"
+            );
+        }
+
+        if self.tcp_senders > 1 && self.cc_to_stdout {
+            fatal!(
+                cause = ExitCause::IncompatibleParameters;
+                "--tcp-senders writes a file for each sender, it can't be used with --stdout"
+            );
+        }
+
         if !self.is_inputfile_empty() && self.input_source == DataSource::Tcp {
             fatal!(
                 cause = ExitCause::TooManyInputFiles;
@@ -1584,6 +1743,22 @@ impl OptionsExt for Options {
             );
         }
 
+        if self.enc_cfg.rcwt_index {
+            // bin can't be one of several -out formats, see set_extra_output_formats()
+            if self.write_format != OutputFormat::Rcwt {
+                fatal!(
+                    cause = ExitCause::IncompatibleParameters;
+                    "--rcwt-index and --rcwt-compress require -out=bin.\n"
+                );
+            }
+            if self.send_to_srv {
+                fatal!(
+                    cause = ExitCause::IncompatibleParameters;
+                    "--rcwt-index and --rcwt-compress can't be used with --sendto.\n"
+                );
+            }
+        }
+
         if self.write_format == OutputFormat::SpuPng && self.cc_to_stdout {
             fatal!(
                 cause = ExitCause::IncompatibleParameters;
@@ -1591,9 +1766,23 @@ impl OptionsExt for Options {
             );
         }
 
-        if self.write_format == OutputFormat::WebVtt && self.enc_cfg.encoding != Encoding::UTF8 {
-            self.enc_cfg.encoding = Encoding::UTF8;
-            println!("Note: Output format is WebVTT, forcing UTF-8");
+        if !self.enc_cfg.extra_write_formats.is_empty() && self.cc_to_stdout {
+            fatal!(
+                cause = ExitCause::IncompatibleParameters;
+                "You cannot write several --out formats to stdout.\n"
+            );
+        }
+
+        // init_encoder() makes each WebVTT encoder UTF-8, the encoders of the
+        // other --out formats keep enc_cfg.encoding
+        if (self.write_format == OutputFormat::WebVtt
+            || self
+                .enc_cfg
+                .extra_write_formats
+                .contains(&OutputFormat::WebVtt))
+            && self.enc_cfg.encoding != Encoding::UTF8
+        {
+            println!("Note: Output format is WebVTT, forcing UTF-8 for it");
         }
 
         // Check WITH_LIBCURL
@@ -1853,6 +2042,17 @@ pub mod tests {
         assert_eq!(options.write_format, OutputFormat::Rcwt);
     }
 
+    #[test]
+    fn test_rcwt_compress_implies_index() {
+        let (options, _) = parse_args(&["--out", "bin", "--rcwt-compress"]);
+        assert!(options.enc_cfg.rcwt_index);
+        assert!(options.enc_cfg.rcwt_compress);
+
+        let (options, _) = parse_args(&["--out", "bin", "--rcwt-index"]);
+        assert!(options.enc_cfg.rcwt_index);
+        assert!(!options.enc_cfg.rcwt_compress);
+    }
+
     #[test]
     fn test_out_txt_sets_transcript_format_with_no_rollup() {
         let (options, _) = parse_args(&["--out", "txt"]);
@@ -1910,6 +2110,23 @@ pub mod tests {
         assert_eq!(options.write_format, OutputFormat::SimpleXml);
     }
 
+    #[test]
+    fn test_out_list_sets_extra_formats() {
+        let (options, _) = parse_args(&["--out", "srt,webvtt,scc"]);
+        assert_eq!(options.write_format, OutputFormat::Srt);
+        assert_eq!(options.enc_cfg.write_format, OutputFormat::Srt);
+        assert_eq!(
+            options.enc_cfg.extra_write_formats,
+            vec![OutputFormat::WebVtt, OutputFormat::Scc]
+        );
+    }
+
+    #[test]
+    fn test_out_list_keeps_encoding_for_other_formats() {
+        let (options, _) = parse_args(&["--out", "srt,webvtt", "--latin1"]);
+        assert_eq!(options.enc_cfg.encoding, Encoding::Latin1);
+    }
+
     #[test]
     fn test_out_null_sets_null_format() {
         let (options, _) = parse_args(&["--out", "null"]);
@@ -2002,6 +2219,19 @@ pub mod tests {
         assert!(options.demux_cfg.ts_allprogram);
     }
 
+    #[test]
+    fn test_jobs_sets_parallel_input_count() {
+        let (options, _) = parse_args(&["--jobs", "4"]);
+        assert_eq!(options.jobs, 4);
+    }
+
+    #[test]
+    fn test_jobs_with_multiprogram_allows_output_name() {
+        let (options, _) = parse_args(&["--multiprogram", "--jobs", "2", "-o", "out.srt"]);
+        assert_eq!(options.jobs, 2);
+        assert_eq!(options.output_filename.as_deref(), Some("out.srt"));
+    }
+
     #[test]
     fn test_datapid_sets_caption_pid() {
         let (options, _) = parse_args(&["--datapid", "1234"]);
@@ -2817,6 +3047,34 @@ pub mod tests {
         assert!(!options.ocr_blacklist);
     }
 
+    #[test]
+    fn test_ocr_threads() {
+        let (options, _) = parse_args(&["--ocr-threads", "4"]);
+        assert_eq!(options.ocr_threads, 4);
+    }
+
+    #[test]
+    fn test_tcp_senders() {
+        // --tcp takes no input file, so not parse_args()
+        let args = Args::try_parse_from(["./ccextractor", "--tcp", "2048", "--tcp-senders", "8"])
+            .expect("Failed to parse arguments");
+        let mut options = Options::default();
+        options.parse_parameters(
+            &args,
+            &mut TeletextConfig::default(),
+            &mut vec![],
+            &mut vec![],
+        );
+        assert_eq!(options.tcp_senders, 8);
+        assert_eq!(options.input_source, DataSource::Tcp);
+    }
+
+    #[test]
+    fn test_ocr_cache_sets_cache_file() {
+        let (options, _) = parse_args(&["--ocr-cache", "ocr.cache"]);
+        assert_eq!(options.ocr_cache_file.as_deref(), Some("ocr.cache"));
+    }
+
     #[test]
     fn test_no_spupngocr_disables_spupng_ocr() {
         let (options, _) = parse_args(&["--no-spupngocr"]);
@@ -2929,6 +3187,12 @@ pub mod tests {
         assert!(options.analyze_video_stream);
     }
 
+    #[test]
+    fn test_fast_avc_scan() {
+        let (options, _) = parse_args(&["--fast-avc-scan"]);
+        assert!(options.fast_avc_scan);
+    }
+
     #[test]
     fn test_screenfuls_sets_screens_to_process() {
         let (options, _) = parse_args(&["--screenfuls", "10"]);
@@ -0,0 +1,265 @@
+//! A fixed set of worker threads running jobs for C code.
+//!
+//! Each worker owns one opaque state pointer (for OCR, a Tesseract instance)
+//! that it hands to every job it runs, so the state is never used by two
+//! threads at once. Jobs are run in any order, but [`WorkerPool::next`] hands
+//! them back in the order they were submitted, which lets the caller encode
+//! their results in presentation order. The caller applies backpressure by
+//! collecting a result before submitting more once [`WorkerPool::pending`]
+//! reaches its limit.
+
+use std::collections::VecDeque;
+use std::os::raw::{c_int, c_uint, c_void};
+use std::sync::{Arc, Condvar, Mutex};
+use std::thread::{self, JoinHandle};
+
+/// A job: runs with the worker's state and the job pointer passed to submit.
+pub type JobFn = unsafe extern "C" fn(state: *mut c_void, job: *mut c_void);
+
+struct Task {
+    run: JobFn,
+    job: usize,
+    seq: u64,
+}
+
+#[derive(Default)]
+struct Queue {
+    /// Jobs not picked up by a worker yet.
+    todo: VecDeque<Task>,
+    /// Every job not yet returned by `next`, oldest first, and whether it has
+    /// finished.
+    order: VecDeque<(usize, bool)>,
+    /// Sequence number of the front of `order`.
+    first_seq: u64,
+    shutdown: bool,
+}
+
+#[derive(Default)]
+struct Shared {
+    queue: Mutex<Queue>,
+    work: Condvar,
+    done: Condvar,
+}
+
+pub struct WorkerPool {
+    shared: Arc<Shared>,
+    workers: Vec<JoinHandle<()>>,
+}
+
+impl WorkerPool {
+    /// Start one worker per state. The states must stay valid until the
+    /// pool is dropped.
+    pub fn new(states: &[*mut c_void]) -> WorkerPool {
+        let shared = Arc::new(Shared::default());
+        let workers = states
+            .iter()
+            .map(|&state| {
+                let shared = Arc::clone(&shared);
+                let state = state as usize;
+                thread::spawn(move || worker_loop(&shared, state as *mut c_void))
+            })
+            .collect();
+        WorkerPool { shared, workers }
+    }
+
+    pub fn submit(&self, run: JobFn, job: *mut c_void) {
+        let mut queue = self.shared.queue.lock().unwrap();
+        let seq = queue.first_seq + queue.order.len() as u64;
+        queue.order.push_back((job as usize, false));
+        queue.todo.push_back(Task {
+            run,
+            job: job as usize,
+            seq,
+        });
+        self.shared.work.notify_one();
+    }
+
+    /// Jobs submitted and not yet returned by `next`.
+    pub fn pending(&self) -> usize {
+        self.shared.queue.lock().unwrap().order.len()
+    }
+
+    /// The oldest job not yet returned, once it has finished. Without `wait`,
+    /// returns `None` if it is still running; with it, blocks until it is
+    /// done. `None` when nothing is pending.
+    pub fn next(&self, wait: bool) -> Option<*mut c_void> {
+        let mut queue = self.shared.queue.lock().unwrap();
+        loop {
+            match queue.order.front() {
+                None => return None,
+                Some(&(job, true)) => {
+                    queue.order.pop_front();
+                    queue.first_seq += 1;
+                    return Some(job as *mut c_void);
+                }
+                Some(_) if !wait => return None,
+                Some(_) => queue = self.shared.done.wait(queue).unwrap(),
+            }
+        }
+    }
+}
+
+impl Drop for WorkerPool {
+    /// Lets the workers finish the jobs already submitted, then stops them.
+    fn drop(&mut self) {
+        self.shared.queue.lock().unwrap().shutdown = true;
+        self.shared.work.notify_all();
+        for worker in self.workers.drain(..) {
+            let _ = worker.join();
+        }
+    }
+}
+
+fn worker_loop(shared: &Shared, state: *mut c_void) {
+    loop {
+        let task = {
+            let mut queue = shared.queue.lock().unwrap();
+            loop {
+                if let Some(task) = queue.todo.pop_front() {
+                    break task;
+                }
+                if queue.shutdown {
+                    return;
+                }
+                queue = shared.work.wait(queue).unwrap();
+            }
+        };
+        unsafe { (task.run)(state, task.job as *mut c_void) };
+
+        let mut queue = shared.queue.lock().unwrap();
+        let index = (task.seq - queue.first_seq) as usize;
+        queue.order[index].1 = true;
+        if index == 0 {
+            shared.done.notify_all();
+        }
+    }
+}
+
+/// Start a pool with one worker thread per entry of `states`.
+///
+/// # Safety
+/// `states` must point to `count` pointers, each valid until the pool is freed.
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_worker_pool_new(
+    states: *const *mut c_void,
+    count: c_uint,
+) -> *mut WorkerPool {
+    if states.is_null() || count == 0 {
+        return std::ptr::null_mut();
+    }
+    let states = std::slice::from_raw_parts(states, count as usize);
+    Box::into_raw(Box::new(WorkerPool::new(states)))
+}
+
+/// Queue `run(state, job)` on the next free worker.
+///
+/// # Safety
+/// `pool` must come from [`ccxr_worker_pool_new`]; `job` must stay valid
+/// until it is returned by [`ccxr_worker_pool_next`].
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_worker_pool_submit(
+    pool: *mut WorkerPool,
+    run: JobFn,
+    job: *mut c_void,
+) {
+    (*pool).submit(run, job);
+}
+
+/// Number of jobs submitted and not yet returned by [`ccxr_worker_pool_next`].
+///
+/// # Safety
+/// `pool` must come from [`ccxr_worker_pool_new`].
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_worker_pool_pending(pool: *mut WorkerPool) -> c_uint {
+    (*pool).pending() as c_uint
+}
+
+/// The oldest submitted job once it has finished, NULL if none is pending
+/// or, unless `wait` is set, if it is still running.
+///
+/// # Safety
+/// `pool` must come from [`ccxr_worker_pool_new`].
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_worker_pool_next(pool: *mut WorkerPool, wait: c_int) -> *mut c_void {
+    (*pool).next(wait != 0).unwrap_or(std::ptr::null_mut())
+}
+
+/// Wait for the submitted jobs to run and stop the workers. Jobs not collected
+/// with [`ccxr_worker_pool_next`] are not freed.
+///
+/// # Safety
+/// `pool` must come from [`ccxr_worker_pool_new`] or be NULL.
+#[no_mangle]
+pub unsafe extern "C" fn ccxr_worker_pool_free(pool: *mut WorkerPool) {
+    if !pool.is_null() {
+        drop(Box::from_raw(pool));
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::atomic::{AtomicUsize, Ordering};
+    use std::time::Duration;
+
+    struct Job {
+        value: u64,
+        result: u64,
+        worker: usize,
+    }
+
+    unsafe extern "C" fn square_slowly(state: *mut c_void, job: *mut c_void) {
+        let job = &mut *(job as *mut Job);
+        // Later jobs finish first, so completion order differs from submission
+        thread::sleep(Duration::from_millis(20 - job.value.min(20)));
+        job.result = job.value * job.value;
+        job.worker = state as usize;
+    }
+
+    #[test]
+    fn test_jobs_come_back_in_submission_order() {
+        let states: Vec<*mut c_void> = (1..=4).map(|i| i as *mut c_void).collect();
+        let pool = WorkerPool::new(&states);
+        let mut jobs: Vec<Box<Job>> = (0..16)
+            .map(|value| {
+                Box::new(Job {
+                    value,
+                    result: 0,
+                    worker: 0,
+                })
+            })
+            .collect();
+        for job in jobs.iter_mut() {
+            pool.submit(square_slowly, &mut **job as *mut Job as *mut c_void);
+        }
+        assert_eq!(pool.pending(), 16);
+
+        for expected in 0..16u64 {
+            let job = pool.next(true).unwrap() as *mut Job;
+            unsafe {
+                assert_eq!((*job).value, expected);
+                assert_eq!((*job).result, expected * expected);
+                assert!((1..=4).contains(&(*job).worker));
+            }
+        }
+        assert_eq!(pool.pending(), 0);
+        assert!(pool.next(true).is_none());
+    }
+
+    static STARTED: AtomicUsize = AtomicUsize::new(0);
+
+    unsafe extern "C" fn count(_state: *mut c_void, _job: *mut c_void) {
+        STARTED.fetch_add(1, Ordering::SeqCst);
+    }
+
+    #[test]
+    fn test_drop_runs_submitted_jobs() {
+        let states = [std::ptr::null_mut(); 2];
+        let pool = WorkerPool::new(&states);
+        for _ in 0..10 {
+            pool.submit(count, std::ptr::null_mut());
+        }
+        drop(pool);
+        assert_eq!(STARTED.load(Ordering::SeqCst), 10);
+    }
+}
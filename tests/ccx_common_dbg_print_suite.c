@@ -0,0 +1,158 @@
+#include <check.h>
+#include <time.h>
+#include "ccx_common_dbg_print_suite.h"
+
+#include "../src/lib_ccx/lib_ccx.h"
+#include "../src/lib_ccx/ccx_common_option.h"
+#include "../src/lib_ccx/utility.h"
+
+// Number of do_cb()-like CBRAW prints timed by the benchmark
+#define DBG_PRINT_BENCH_TRIPLETS 2000000
+
+// -------------------------------------
+// Helpers
+// -------------------------------------
+
+static int evaluated;
+
+static const char * count_evaluation(void)
+{
+	evaluated++;
+	return "";
+}
+
+static double elapsed_ns(struct timespec *start, struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+// -------------------------------------
+// Test preparations
+// -------------------------------------
+
+void dbg_print_setup(void)
+{
+	evaluated = 0;
+	temp_debug = 0;
+	ccx_options.messages_target = CCX_MESSAGES_STDERR;
+	ccx_options.debug_mask = CCX_DMT_GENERIC_NOTICES;
+	ccx_options.debug_mask_on_debug = CCX_DMT_VERBOSE;
+}
+
+void dbg_print_teardown(void)
+{
+	ccx_options.messages_target = 0;
+	ccx_options.debug_mask = 0;
+	ccx_options.debug_mask_on_debug = 0;
+	temp_debug = 0;
+}
+
+// -------------------------------------
+// Tests
+// -------------------------------------
+
+START_TEST(test_dbg_print_disabled_type_skips_arguments)
+{
+	dbg_print(CCX_DMT_CBRAW, "%s", count_evaluation());
+
+	ck_assert_int_eq(evaluated, 0);
+}
+END_TEST
+
+START_TEST(test_dbg_print_quiet_skips_arguments)
+{
+	ccx_options.messages_target = 0;
+	ccx_options.debug_mask = CCX_DMT_CBRAW;
+
+	dbg_print(CCX_DMT_CBRAW, "%s", count_evaluation());
+
+	ck_assert_int_eq(evaluated, 0);
+}
+END_TEST
+
+START_TEST(test_dbg_print_enabled_type_evaluates_arguments)
+{
+	ccx_options.debug_mask = CCX_DMT_CBRAW;
+
+	dbg_print(CCX_DMT_CBRAW, "%s", count_evaluation());
+
+	ck_assert_int_eq(evaluated, 1);
+}
+END_TEST
+
+START_TEST(test_dbg_print_temp_debug_uses_debug_mask_on_debug)
+{
+	ccx_options.debug_mask_on_debug = CCX_DMT_CBRAW;
+
+	dbg_print(CCX_DMT_CBRAW, "%s", count_evaluation());
+	ck_assert_int_eq(evaluated, 0);
+
+	temp_debug = 1;
+	dbg_print(CCX_DMT_CBRAW, "%s", count_evaluation());
+	ck_assert_int_eq(evaluated, 1);
+}
+END_TEST
+
+/*
+ * Times the CBRAW print do_cb() makes for every caption block while that
+ * debug type is off: once through the dbg_print() macro, and once calling
+ * the function directly, which is what every call did before the macro
+ * skipped the argument evaluation.
+ */
+START_TEST(test_dbg_print_fast_path_benchmark)
+{
+	unsigned char cc_block[3] = {0xfc, 0x94, 0x2c};
+	struct timespec start, end;
+	double macro_ns, function_ns;
+	int i;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < DBG_PRINT_BENCH_TRIPLETS; i++)
+	{
+		dbg_print(CCX_DMT_CBRAW, "%s   %d   %02X:%c%c:%02X", print_mstime_static(i), 1,
+			  cc_block[1], cc_block[1] & 0x7f, cc_block[2] & 0x7f, cc_block[2]);
+		dbg_print(CCX_DMT_CBRAW, "    %s\n", debug_608_to_ASC(cc_block, 0));
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	macro_ns = elapsed_ns(&start, &end);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < DBG_PRINT_BENCH_TRIPLETS; i++)
+	{
+		(dbg_print)(CCX_DMT_CBRAW, "%s   %d   %02X:%c%c:%02X", print_mstime_static(i), 1,
+			    cc_block[1], cc_block[1] & 0x7f, cc_block[2] & 0x7f, cc_block[2]);
+		(dbg_print)(CCX_DMT_CBRAW, "    %s\n", debug_608_to_ASC(cc_block, 0));
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	function_ns = elapsed_ns(&start, &end);
+
+	printf("dbg_print() with CBRAW off: %.1f ns per triplet through the macro, %.1f ns calling the function\n",
+	       macro_ns / DBG_PRINT_BENCH_TRIPLETS, function_ns / DBG_PRINT_BENCH_TRIPLETS);
+}
+END_TEST
+
+
+Suite * ccx_common_dbg_print_suite(void)
+{
+	Suite *s;
+	TCase *tc_core;
+
+	s = suite_create("Debug Print");
+
+	tc_core = tcase_create("dbg_print: fast path: ");
+	tcase_add_checked_fixture(tc_core, dbg_print_setup, dbg_print_teardown);
+	tcase_add_test(tc_core, test_dbg_print_disabled_type_skips_arguments);
+	tcase_add_test(tc_core, test_dbg_print_quiet_skips_arguments);
+	tcase_add_test(tc_core, test_dbg_print_enabled_type_evaluates_arguments);
+	tcase_add_test(tc_core, test_dbg_print_temp_debug_uses_debug_mask_on_debug);
+	suite_add_tcase(s, tc_core);
+
+	TCase *tc_benchmark;
+	tc_benchmark = tcase_create("dbg_print: benchmark: ");
+	tcase_add_checked_fixture(tc_benchmark, dbg_print_setup, dbg_print_teardown);
+	tcase_set_timeout(tc_benchmark, 60);
+	tcase_add_test(tc_benchmark, test_dbg_print_fast_path_benchmark);
+	suite_add_tcase(s, tc_benchmark);
+
+	return s;
+}